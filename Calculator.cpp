@@ -1,36 +1,104 @@
 #include "Calculator.hpp"
+#include "CharacterClassifier.hpp"
+#include "LineEditor.hpp"
+
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+namespace {
+
+/// @brief Function for removing the spaces surrounding a part of a command.
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(' '), last = text.find_last_not_of(' ');
+    return (first == std::string::npos) ? std::string() : text.substr(first, last - first + 1);
+}
+
+/// @brief Function for checking that a name only contains lowercase letters, like every name the tokenizer reads.
+bool isLowercaseName(const std::string& name) {
+    return !name.empty() && std::all_of(name.begin(), name.end(), [](char character) { return std::islower(static_cast<unsigned char>(character)); });
+}
+
+/// @brief Function for hashing the fingerprints of user functions together with their names, in the order of the names, so that
+/// different sets of functions give different hashes.
+/// @returns The hash, 0 if there are no functions.
+uint64_t hashFingerprints(const std::map<std::string, uint64_t>& fingerprints) {
+    if (fingerprints.empty()) return 0;
+    const char separator = 0;
+    uint64_t hash = ProgramCacheFile::hashBytes(nullptr, 0);
+    for (const auto& [name, fingerprint] : fingerprints) {
+        hash = ProgramCacheFile::hashBytes(name.data(), name.size(), hash);
+        hash = ProgramCacheFile::hashBytes(&separator, 1, hash);
+        hash = ProgramCacheFile::hashBytes(&fingerprint, sizeof(fingerprint), hash);
+    }
+    return hash;
+}
+
+/// @brief Aggregate functions reducing a CSV column, by name.
+const std::unordered_map<std::string, AggregateFunction> aggregateFunctionLookupTable = {
+    {"sum", AggregateFunction::sum}, {"mean", AggregateFunction::mean}, {"min", AggregateFunction::minimum},
+    {"max", AggregateFunction::maximum}, {"stddev", AggregateFunction::standardDeviation}
+};
+
+/// @brief Function for reading the name of the function an input starts with, e.g. "sum" in "sum(x^2, x in data.csv:price)".
+/// @returns The name, or an empty string if the input does not start with a name followed by '('.
+std::string getCalledFunctionName(const std::string& input) {
+    size_t nameStart = input.find_first_not_of(' ');
+    if (nameStart == std::string::npos) return "";
+    size_t nameEnd = nameStart;
+    while (nameEnd < input.size() && std::islower(static_cast<unsigned char>(input[nameEnd]))) nameEnd++;
+    size_t openingParenthesis = input.find_first_not_of(' ', nameEnd);
+    if (nameEnd == nameStart || openingParenthesis == std::string::npos || input[openingParenthesis] != '(') return "";
+    return input.substr(nameStart, nameEnd - nameStart);
+}
+
+/// @brief Function for checking whether an input starts like a cell assignment: a lowercase name followed by '='.
+bool isCellAssignment(const std::string& input) {
+    size_t nameStart = input.find_first_not_of(' ');
+    if (nameStart == std::string::npos || !std::islower(static_cast<unsigned char>(input[nameStart]))) return false;
+    size_t nameEnd = nameStart;
+    while (nameEnd < input.size() && std::islower(static_cast<unsigned char>(input[nameEnd]))) nameEnd++;
+    size_t equalSign = input.find_first_not_of(' ', nameEnd);
+    return equalSign != std::string::npos && input[equalSign] == '=';
+}
+
+}
 
 double secant(double operand) {
-    if (cos(operand) == 0) {
+    double cosine = cos(operand);
+    if (cosine == 0) {
         std::string errorMessage = "DomainError: sec(";
         std::stringstream errorStringStream;
         errorStringStream << operand;
         errorMessage += errorStringStream.str() + ") is not defined.\n";
         throw std::invalid_argument(errorMessage);
     }
-    return 1 / cos(operand);
+    return 1 / cosine;
 }
 
 double cosecant(double angle){
-    if (sin(angle) == 0) {
+    double sine = sin(angle);
+    if (sine == 0) {
         std::string errorMessage = "DomainError: csc(";
         std::stringstream errorStringStream;
         errorStringStream << angle;
         errorMessage += errorStringStream.str() + ") is not defined.\n";
         throw std::invalid_argument(errorMessage);
     }
-    return 1 / sin(angle);
+    return 1 / sine;
 }
 
 double cotangent(double angle) {
-    if (sin(angle) == 0) {
+    double sine = sin(angle);
+    if (sine == 0) {
         std::string errorMessage = "DomainError: cot(";
         std::stringstream errorStringStream;
         errorStringStream << angle;
         errorMessage += errorStringStream.str() + ") is not defined.\n";
         throw std::invalid_argument(errorMessage);
     }
-    return cos(angle) / sin(angle);
+    return cos(angle) / sine;
 }
 
 double arcsin(double operand) {
@@ -146,33 +214,37 @@ double logarithm(double base, double power){
     return log2(power) / log2(base);
 }
 
+/// @brief Largest n such that n! is finite in double precision.
+static constexpr int largestDoubleFactorial = 170;
+
+/// @brief Table holding n! for 0 <= n <= 170, accumulated in extended precision and rounded once.
+static const std::array<double, largestDoubleFactorial + 1> factorialTable = []() {
+    std::array<double, largestDoubleFactorial + 1> table{};
+    long double product = 1.0L;
+    table[0] = 1.0;
+    for (int index = 1; index <= largestDoubleFactorial; index++) {
+        product *= index;
+        table[index] = static_cast<double>(product);
+    }
+    return table;
+}();
+
 double factorial(double operand){
     // Check if the argument is negative / non integer. If yes, throw invalid_argument error.
     if (operand < 0) {
         throw std::invalid_argument("Math error: Negative input given to factorial function.");
     }
-    if (operand != static_cast<uint64_t>(operand)) {
+    if (operand != std::floor(operand)) {
         throw std::invalid_argument("Math error: Non-integer input given to factorial function.");
     }
 
-    // Convert the argument into a 64-bit unsigned integer.
-    uint64_t inputParameter = static_cast<uint64_t>(operand);
-
-    // Initialize variable to store result.
-    double result = 1.0;
-    for (; inputParameter > 1; inputParameter--) {
-        // Compute the factorial by multiplying the result with the input parameter, and decrementing.
-        // For example, 5 * 4 * 3 * 2 * 1.
-        result *= inputParameter;
-
-        // Check if the input overflows. If yes, throw error
-        if (result == INFINITY) {
-            throw std::overflow_error("Factorial result overflowed.");
-        }
+    // Check if the result overflows. If yes, throw error.
+    if (operand > largestDoubleFactorial) {
+        throw std::overflow_error("Factorial result overflowed.");
     }
 
-    // Return the result of the factorial.
-    return result;    
+    // Look up the factorial instead of multiplying every factor.
+    return factorialTable[static_cast<size_t>(operand)];
 }
 
 double add(double firstOperand, double secondOperand) {
@@ -231,6 +303,50 @@ double negate(double number){
     return (double)-number;
 }
 
+double uncheckedSecant(double angle) {
+    return 1 / cos(angle);
+}
+
+double uncheckedCosecant(double angle) {
+    return 1 / sin(angle);
+}
+
+double uncheckedCotangent(double angle) {
+    return cos(angle) / sin(angle);
+}
+
+double uncheckedFactorial(double operand) {
+    // Negative and non-integer inputs produce nan, results too large for a double produce inf.
+    if (operand < 0 || operand != std::floor(operand)) return NAN;
+    if (operand > largestDoubleFactorial) return INFINITY;
+    return factorialTable[static_cast<size_t>(operand)];
+}
+
+double uncheckedLogarithm(double base, double power) {
+    return log2(power) / log2(base);
+}
+
+double uncheckedDivide(double numerator, double denominator) {
+    return numerator / denominator;
+}
+
+/// @brief Function wrapping a double-double function, so that operands outside the domain of the operator throw the error of its
+/// checked double function. A result that is not finite calls the double function on the high part of the operand.
+template <ExtendedUnaryFunction extendedFunction, UnaryFunction checkedFunction>
+DoubleDouble checkExtendedUnaryDomain(DoubleDouble operand) {
+    DoubleDouble result = extendedFunction(operand);
+    if (!std::isfinite(result.high)) checkedFunction(operand.high);
+    return result;
+}
+
+/// @brief Function wrapping a binary double-double function like checkExtendedUnaryDomain().
+template <ExtendedBinaryFunction extendedFunction, BinaryFunction checkedFunction>
+DoubleDouble checkExtendedBinaryDomain(DoubleDouble firstOperand, DoubleDouble secondOperand) {
+    DoubleDouble result = extendedFunction(firstOperand, secondOperand);
+    if (!std::isfinite(result.high)) checkedFunction(firstOperand.high, secondOperand.high);
+    return result;
+}
+
 // Initialize maps with the corresponding functions and operators. 
 Calculator::Calculator() : numberOfLogsSaved(0), historyLog(LinkedList()), currentValue(0), unaryOperatorLookupTable({
     {"sec", secant}, {"csc", cosecant}, {"cosec", cosecant}, {"cot", cotangent}, {"sqrt", squareRoot}, 
@@ -247,6 +363,31 @@ Calculator::Calculator() : numberOfLogsSaved(0), historyLog(LinkedList()), curre
     {"cos", 2}, {"acos", 2}, {"cosh", 2}, {"acosh", 2}, {"tan", 2}, {"atan", 2},{"tanh", 2}, 
     {"atanh", 2}, {"round", 2}, {"csc", 2}, {"cosec", 2}, {"cot", 2}, {"log_", 2}, {"+", 0}, 
     {"-", 0}, {"*", 1}, {"/", 1}, {"%", 1}, {"^", 2}, {"(", 4}, {"neg", 3}, {"abs", 2}
+}), uncheckedUnaryOperatorLookupTable({
+    {"sec", uncheckedSecant}, {"csc", uncheckedCosecant}, {"cosec", uncheckedCosecant}, {"cot", uncheckedCotangent}, {"sqrt", sqrt}, 
+    {"ln", log}, {"log2", log2}, {"log", log10}, {"cbrt", cbrt}, {"abs", fabs}, 
+    {"!", uncheckedFactorial}, {"exp", exp}, {"ceil", ceil}, {"floor", floor},{"sin", sin}, {"asin", asin}, 
+    {"sinh", sinh}, {"asinh", asinh}, {"cos", cos}, {"acos", acos}, {"cosh", cosh}, {"acosh", acosh}, 
+    {"tan", tan}, {"atan", atan}, {"tanh", tanh}, {"atanh", atanh}, {"round", round}, {"neg", negate}
+}), uncheckedBinaryOperatorLookupTable({
+    {"log_", uncheckedLogarithm}, {"+", add}, {"-", subtract}, {"*", multiply}, {"/", uncheckedDivide}, 
+    {"%", fmod}, {"^", pow}
+}), extendedUnaryOperatorLookupTable({
+    {"sec", checkExtendedUnaryDomain<extendedSecant, secant>}, {"csc", checkExtendedUnaryDomain<extendedCosecant, cosecant>},
+    {"cosec", checkExtendedUnaryDomain<extendedCosecant, cosecant>}, {"cot", checkExtendedUnaryDomain<extendedCotangent, cotangent>},
+    {"sqrt", checkExtendedUnaryDomain<extendedSquareRoot, squareRoot>}, {"ln", checkExtendedUnaryDomain<extendedNaturalLogarithm, naturalLogarithm>},
+    {"log2", checkExtendedUnaryDomain<extendedBase2Logarithm, base2Logarithm>}, {"log", checkExtendedUnaryDomain<extendedBase10Logarithm, base10Logarithm>},
+    {"cbrt", extendedCubeRoot}, {"abs", extendedAbsolute}, {"!", checkExtendedUnaryDomain<extendedFactorial, factorial>},
+    {"exp", extendedExponential}, {"ceil", extendedCeil}, {"floor", extendedFloor}, {"sin", extendedSine},
+    {"asin", checkExtendedUnaryDomain<extendedArcsine, arcsin>}, {"sinh", extendedHyperbolicSine}, {"asinh", extendedHyperbolicArcsine},
+    {"cos", extendedCosine}, {"acos", checkExtendedUnaryDomain<extendedArccosine, arccos>}, {"cosh", extendedHyperbolicCosine},
+    {"acosh", checkExtendedUnaryDomain<extendedHyperbolicArccosine, arccosh>}, {"tan", checkExtendedUnaryDomain<extendedTangent, tangent>},
+    {"atan", extendedArctangent}, {"tanh", extendedHyperbolicTangent}, {"atanh", checkExtendedUnaryDomain<extendedHyperbolicArctangent, arctanh>},
+    {"round", extendedRound}, {"neg", extendedNegate}
+}), extendedBinaryOperatorLookupTable({
+    {"log_", checkExtendedBinaryDomain<extendedLogarithm, logarithm>}, {"+", extendedAdd}, {"-", extendedSubtract}, {"*", extendedMultiply},
+    {"/", checkExtendedBinaryDomain<extendedDivide, divide>}, {"%", checkExtendedBinaryDomain<extendedModulo, modulo>},
+    {"^", checkExtendedBinaryDomain<extendedPower, power>}
 }), functionLookupTable({
     {"abs", 111}, {"asin", 1}, {"acos", 3}, {"atan", 5}, {"asinh", 7}, {"acosh", 9}, {"atanh", 11},
     {"cos", 13}, {"cosh", 15}, {"ceil", 17}, {"cbrt", 19}, {"cot", 21}, {"cosec", 23}, {"csc", 25},
@@ -261,19 +402,6 @@ Calculator::Calculator() : numberOfLogsSaved(0), historyLog(LinkedList()), curre
 }) {}
 
 
-void Calculator::expect(char expectedCharacter, size_t expectedIndex){
-    // Return early if the character at the expected index matches the expected character.
-    if (this->userInput.at(expectedIndex) == expectedCharacter) return;
-    
-    // Initialize a string containing the error message.
-    std::string errorMessage = "MathError: Missing token (expected ";
-    errorMessage += expectedCharacter + ", got " + this->userInput.at(expectedIndex);
-    errorMessage += ").\n";
-
-    // Throw an invalid_argument error with the constructed error message.
-    throw std::invalid_argument(errorMessage);
-}
-
 void Calculator::clearHistory(){
     // Reinitialize the linked list and reset the nodes. 
     // Clear input string.
@@ -288,368 +416,783 @@ void Calculator::printHistory(){
     this->historyLog.traverseLinkedList();
 }
 
+uint64_t Calculator::exportHistory(const std::string& path){
+    // Open the file, throwing invalid_argument error if it cannot be written.
+    std::ofstream output(path, std::ios::binary);
+    std::string errorMessage = "FileError: Failed to write " + path;
+    errorMessage += ".\n";
+    if (!output) throw std::invalid_argument(errorMessage);
+
+    // Write the history in the format matching the extension.
+    uint64_t entryCount = ::exportHistory(this->historyLog, findHistoryFormat(path), output);
+    if (!output) throw std::invalid_argument(errorMessage);
+    return entryCount;
+}
+
 void Calculator::getExpressionFromUser(){
-    // Ask user for input, then store the value inside userInput.
-    std::cout << "Insert expression: ";
-    std::getline(std::cin, this->userInput);
+    // Ask user for input, previewing its value or its error while it is typed, then store the value inside userInput.
+    IncrementalEvaluator evaluator = this->createIncrementalEvaluator();
+    LineEditor::readLine("Insert expression: ", [&evaluator](const std::string& line) -> std::string {
+        if (line.find_first_not_of(' ') == std::string::npos) return "";
+        try {
+            StreamingValue result = evaluator.update(line);
+            std::stringstream preview;
+            if (result.isInteger) preview << "= " << result.integer;
+            else preview << "= " << result.value;
+            return preview.str();
+        } catch (std::invalid_argument& e) {
+            std::string error = e.what();
+            return error.substr(0, error.find('\n'));
+        }
+    }, this->userInput);
 
     // Handle empty string expression.
     if (this->userInput.empty()) std::cout << "Cannot parse empty string. Would you like to try again?\n";
 }
 
-std::vector<std::string> Calculator::tokenizeExpression(){
+std::vector<PostfixInstruction> Calculator::parseToPostfix(const std::string& expression, const std::vector<std::string>& variableNames, const std::string& functionBeingDefined){
+    // Validate the variable names.
+    // Names may only contain lowercase letters (like all other tokens), and cannot shadow functions or constants.
+    for (size_t slot = 0; slot < variableNames.size(); slot++) {
+        const std::string& name = variableNames[slot];
+        if (!isLowercaseName(name) || this->isFunctionName(name) || std::find(variableNames.begin(), variableNames.begin() + slot, name) != variableNames.begin() + slot) {
+            std::string errorMessage = "ParseError: Invalid variable name " + name;
+            errorMessage += " (expected distinct lowercase names that are not functions or constants).\n";
+            throw std::invalid_argument(errorMessage);
+        }
+    }
 
-    // Initialize vector of string objects to store all tokens.
-    std::vector<std::string> tokens;
+    // Parse the expression into postfix bytecode in a single pass.
+    PrattParser parser(this->functionLookupTable, this->operatorPrecedenceLookupTable, this->userFunctionLookupTable);
+    return parser.parse(expression, variableNames, functionBeingDefined);
+}
 
-    // Initialize variable to store length of parsed number and store checkpoints.
-    size_t checkpoint = 0;
+std::vector<PostfixInstruction> Calculator::parseElementwiseExpression(const std::string& expression, const std::vector<std::string>& variableNames, size_t variableValueCount){
+    // Check if every variable has been given a value. If not, throw invalid_argument error.
+    if (variableValueCount != variableNames.size()) {
+        std::string errorMessage = "EvalError: Expected ";
+        errorMessage += std::to_string(variableNames.size()) + " variable value(s), got ";
+        errorMessage += std::to_string(variableValueCount) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+    return this->parseToPostfix(expression, variableNames);
+}
 
-    // Initialize variables to determine the state of the token generator.
-    // Start of expression / after parsing operator -> negative sign.
-    // After parsing number / Before left parentheses / after right parentheses / before / after functions -> subtraction operator. 
-    bool isNegativeSign = true;
+CompiledExpression Calculator::compileExpression(const std::string& expression, const std::vector<std::string>& variableNames, EvaluationMode evaluationMode, MathAccuracy mathAccuracy){
+    // Unchecked programs are built from the raw kernels.
+    ExpressionCompiler compiler(
+        (evaluationMode == EvaluationMode::checked) ? this->unaryOperatorLookupTable : this->uncheckedUnaryOperatorLookupTable,
+        (evaluationMode == EvaluationMode::checked) ? this->binaryOperatorLookupTable : this->uncheckedBinaryOperatorLookupTable
+    );
+    if (this->programCache == nullptr) return compiler.compile(this->parseToPostfix(expression, variableNames), variableNames, evaluationMode, mathAccuracy);
+
+    // Return the cached program if there is one, skipping the parser and the compiler.
+    ProgramCacheKey key{ProgramCacheFile::normalizeSource(expression), variableNames, evaluationMode, mathAccuracy, this->getUserFunctionFingerprint(expression)};
+    CompiledExpression program;
+    if (this->programCache->find(key, compiler, program)) return program;
+
+    // Otherwise compile the expression and add the program to the cache.
+    program = compiler.compile(this->parseToPostfix(expression, variableNames), variableNames, evaluationMode, mathAccuracy);
+    this->programCache->insert(key, program);
+    return program;
+}
 
-    // Declare string variable to temporarily hold parsed token.
-    std::string token, substring;
+CompiledExpression Calculator::compileExpression(const std::string& expression, const std::vector<std::string>& variableNames, const std::vector<Interval>& variableRanges, MathAccuracy mathAccuracy){
+    // Operations proven safe by the interval analysis are lowered to the raw kernels.
+    ExpressionCompiler compiler(this->unaryOperatorLookupTable, this->binaryOperatorLookupTable, this->uncheckedUnaryOperatorLookupTable, this->uncheckedBinaryOperatorLookupTable);
+    return compiler.compile(this->parseToPostfix(expression, variableNames), variableNames, variableRanges, mathAccuracy);
+}
 
-    // Declare string variable to hold error messages.
-    std::string errorMessage;
+bool Calculator::parseVariableDeclarations(const std::string& declarations, std::vector<std::string>& variableNames, std::vector<Interval>& variableRanges){
+    // Initialize the error message used for malformed declarations.
+    const std::string errorMessage = "ParseError: Expected variable declarations of the form \"x in [<lower>, <upper>] y ...\".\n";
+
+    // Split the declarations at the spaces and commas outside brackets, so that the bounds may contain both.
+    std::vector<std::string> tokens(1);
+    int depth = 0;
+    for (char character : declarations) {
+        if (character == '(' || character == '[') depth++;
+        else if (character == ')' || character == ']') depth--;
+        if ((character == ' ' || character == ',' || character == '\t') && depth == 0) {
+            if (!tokens.back().empty()) tokens.emplace_back();
+        } else {
+            tokens.back() += character;
+        }
+    }
+    if (tokens.back().empty()) tokens.pop_back();
+    if (depth != 0) throw std::invalid_argument(errorMessage);
+
+    // Read every name, followed by "in [<lower>, <upper>]" if the variable has a range.
+    bool hasRange = false;
+    for (size_t index = 0; index < tokens.size(); index++) {
+        if (tokens[index] == "in" || tokens[index].front() == '[') throw std::invalid_argument(errorMessage);
+        variableNames.push_back(tokens[index]);
+        variableRanges.emplace_back();
+        if (index + 1 >= tokens.size() || tokens[index + 1] != "in") continue;
+        if (index + 2 >= tokens.size() || tokens[index + 2].front() != '[' || tokens[index + 2].back() != ']') throw std::invalid_argument(errorMessage);
+
+        // Split the bounds at the comma outside parentheses, and evaluate them.
+        std::string bounds = tokens[index + 2].substr(1, tokens[index + 2].size() - 2);
+        size_t comma = std::string::npos;
+        depth = 0;
+        for (size_t position = 0; position < bounds.size(); position++) {
+            if (bounds[position] == '(') depth++;
+            else if (bounds[position] == ')') depth--;
+            else if (bounds[position] == ',' && depth == 0 && comma == std::string::npos) comma = position;
+        }
+        if (comma == std::string::npos) throw std::invalid_argument(errorMessage);
+        Interval& range = variableRanges.back();
+        range.lower = this->compileExpression(bounds.substr(0, comma)).evaluate({});
+        range.upper = this->compileExpression(bounds.substr(comma + 1)).evaluate({});
+
+        // Check if the range is empty. If yes, throw invalid_argument error.
+        if (!(range.lower <= range.upper)) {
+            std::stringstream errorStringStream;
+            errorStringStream << "ParseError: Found an empty range [" << range.lower << ", " << range.upper << "] for variable " << variableNames.back() << ".\n";
+            throw std::invalid_argument(errorStringStream.str());
+        }
+        hasRange = true;
+        index += 2;
+    }
+    return hasRange;
+}
 
-    // Declare string stream to convert number to string using .str() method.
-    std::stringstream numberConverter;
-    
-    // Initialize variables to store number of parenthesis pairs.
-    int64_t numberOfLeftBrackets = 0, numberOfRightBrackets = 0;
-    size_t index = 0;
+void Calculator::setProgramCache(ProgramCacheFile* programCache){
+    this->programCache = programCache;
+}
 
-    // Iterate over the user expression and store parsed tokens into the vector. 
-    for (; index < this->userInput.size(); index++){
-        switch (this->userInput.at(index)) {
-            case ' ':
-                // Go to the next index if whitespace.
-                continue;
+std::shared_ptr<const CompiledExpression> Calculator::compileSharedExpression(const std::string& expression, const std::vector<std::string>& variableNames, EvaluationMode evaluationMode, MathAccuracy mathAccuracy){
+    if (this->sharedProgramCache == nullptr) return std::make_shared<const CompiledExpression>(this->compileExpression(expression, variableNames, evaluationMode, mathAccuracy));
 
-            case '-':
-                // Parse '-' operator / sign according to the state of the tokenizer.
-                // Append the appropriate token to the string variable.
-                if (isNegativeSign == false) {
-                    token += '-';
+    // The key holds the user functions, so calculators defining different functions never share the programs calling them.
+    ProgramCacheKey key{ProgramCacheFile::normalizeSource(expression), variableNames, evaluationMode, mathAccuracy, this->getUserFunctionFingerprint(expression)};
+    return this->sharedProgramCache->findOrCompile(key, [&]() { return this->compileExpression(expression, variableNames, evaluationMode, mathAccuracy); });
+}
 
-                    // Update the state to true as '-' is an operator.
-                    isNegativeSign = true;
-                } else if (isNegativeSign == true){
-                    token += "neg";
-                }
-                break;
+void Calculator::setSharedProgramCache(SharedProgramCache* sharedProgramCache){
+    this->sharedProgramCache = sharedProgramCache;
+}
 
-            case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': case '.': 
-                checkpoint = index;
-                token += this->parseNumberFromInputString(checkpoint, &index, errorMessage, numberConverter);
-                isNegativeSign = false;
-                break;
+bool Calculator::isFunctionName(const std::string& name) const {
+    return this->functionLookupTable.find(name) != this->functionLookupTable.end() || this->userFunctionLookupTable.find(name) != this->userFunctionLookupTable.end();
+}
 
-            case 'p': case 'e': case 'a': case 'c': case 'f': case 's': case 't': case 'r': case 'l':
-                // Parse all non-single character operator.
-                // Set a checkpoint at current index.
-                checkpoint = index;
-                
-                // Iterate over the token and get the length of the character.
-                while (index < this->userInput.size() && std::islower(this->userInput.at(index))) index++;
-
-                // Create a substring to parse the token.
-                substring = this->userInput.substr(checkpoint, index - checkpoint);
-
-                // Handle case if token is "log2", "log10", or "log_".                    
-                if (substring == "log" && (this->userInput.at(index) == '_' || this->userInput.at(index) == '2')) {
-                    substring += this->userInput.at(index);
-                    index++;
-                }
+uint64_t Calculator::getUserFunctionFingerprint(const std::string& expression) const{
+    // Collect the user functions named by the expression, without parsing it: names are runs of lowercase letters.
+    if (this->userFunctionLookupTable.empty()) return 0;
+    std::map<std::string, uint64_t> fingerprints;
+    for (size_t index = 0; index < expression.size();) {
+        if (!std::islower(static_cast<unsigned char>(expression[index]))) {
+            index++;
+            continue;
+        }
+        size_t start = index;
+        while (index < expression.size() && std::islower(static_cast<unsigned char>(expression[index]))) index++;
+        auto function = this->userFunctionLookupTable.find(expression.substr(start, index - start));
+        if (function != this->userFunctionLookupTable.end()) fingerprints.emplace(function->first, function->second->fingerprint);
+    }
+    return hashFingerprints(fingerprints);
+}
 
-                // Throw invalid_argument error if the substring is not a valid token. 
-                if (this->functionLookupTable.find(substring) == this->functionLookupTable.end()) {
-                    // Construct the error message.
-                    errorMessage = "MathError: Unrecognized token " + substring;
-                    errorMessage += " at index ";
+void Calculator::defineFunction(const std::string& definition){
+    // Initialize the error message used for malformed definitions.
+    const std::string errorMessage = "DefinitionError: Expected a definition of the form \"def <name>(<parameter>, ...) = <expression>\".\n";
+
+    // Locate the parts of the definition.
+    size_t keyword = definition.find("def "), leftBracket = definition.find('('), rightBracket = definition.find(')'), equalSign = definition.find('=');
+    if (keyword == std::string::npos || leftBracket == std::string::npos || rightBracket == std::string::npos || equalSign == std::string::npos) throw std::invalid_argument(errorMessage);
+    if (keyword > leftBracket || leftBracket > rightBracket || rightBracket > equalSign) throw std::invalid_argument(errorMessage);
+
+    // Parse the name and check that it does not shadow a built-in function or constant.
+    auto function = std::make_shared<UserFunction>();
+    function->name = trim(definition.substr(keyword + 4, leftBracket - keyword - 4));
+    if (!isLowercaseName(function->name) || this->functionLookupTable.find(function->name) != this->functionLookupTable.end() || this->variableLookupTable.find(function->name) != this->variableLookupTable.end()) {
+        std::string nameErrorMessage = "DefinitionError: Invalid function name " + function->name;
+        nameErrorMessage += " (expected a lowercase name that is not a built-in function, constant or variable).\n";
+        throw std::invalid_argument(nameErrorMessage);
+    }
 
-                    // Convert the index to a string, and append to the error message.
-                    numberConverter << index;
-                    errorMessage += numberConverter.str() + ".\n"; 
+    // Parse the comma separated parameter names.
+    std::stringstream parameterStream(definition.substr(leftBracket + 1, rightBracket - leftBracket - 1));
+    std::string parameterName;
+    while (std::getline(parameterStream, parameterName, ',')) function->parameterNames.push_back(trim(parameterName));
+    if (function->parameterNames.empty()) throw std::invalid_argument(errorMessage);
+
+    // Generate the postfix bytecode of the body. Calls of the function itself are rejected by the parser.
+    // The shadowed definition (if any) is hidden while parsing, so it cannot be mistaken for a parameter clash.
+    std::shared_ptr<const UserFunction> previousDefinition;
+    if (this->userFunctionLookupTable.find(function->name) != this->userFunctionLookupTable.end()) {
+        previousDefinition = this->userFunctionLookupTable.at(function->name);
+        this->userFunctionLookupTable.erase(function->name);
+    }
+    try {
+        function->postfixBody = this->parseToPostfix(definition.substr(equalSign + 1), function->parameterNames, function->name);
+    } catch (...) {
+        if (previousDefinition) this->userFunctionLookupTable.emplace(function->name, previousDefinition);
+        throw;
+    }
 
-                    // Throw invalid_argument error with the constructed error message.
-                    throw std::invalid_argument(errorMessage);
-                }
-                
-                // Handle case where token is "e", "pi", or "log_" using a switch statement.
-                switch (this->functionLookupTable.at(substring)) {
-                    case 272: case 314: case 1618:
-                        // If the token is "e" or "pi", update the state of the tokenizer and break the statement.
-                        isNegativeSign = false;
-                        index--;
-                        break;
-                    case 2:
-                        // If the token is "log_", break the statement.
-                        index--;
-                        break;
-
-                    default:
-                        try {
-                            // Ignore all whitespaces after the index, check if there is a '('.
-                            while (this->userInput.at(index) == ' ') index++;
-                            expect('(', index);
-
-                            // Decrement the index to not skip the '('.
-                            index--;
-                        } catch (std::out_of_range&) {
-                            // Construct error message.
-                            errorMessage = "MathError: Failed to parse " + substring;
-                            errorMessage += "() at index ";
-
-                            // Convert index to string, then append to the error message along with the token.
-                            numberConverter << index;
-                            errorMessage += numberConverter.str() + " (cannot find corresponding parenthesis).\n";
-
-                            // Throw invalid_argument error with the constructed error message.
-                            throw std::invalid_argument(errorMessage);                    
-                        }
-                        break;
-                }
+    // Take snapshots of the user functions called by the body.
+    for (const PostfixInstruction& instruction : function->postfixBody) {
+        if (instruction.operationCode == PostfixOperationCode::callUserFunction) function->callees.emplace(instruction.name, this->userFunctionLookupTable.at(instruction.name));
+    }
 
-                // Append the token to the string variable.
-                token += substring;
-                break;
-    
-            case '/': case '+': case '^': case '*': case '!': case '%':
-                // Parse all single character operators.
-                token += this->userInput.at(index);
-                isNegativeSign = true;
-                break;
+    // Fingerprint the definition together with the snapshots of the callees, which calls inline as well.
+    std::string normalizedDefinition = ProgramCacheFile::normalizeSource(definition);
+    std::map<std::string, uint64_t> fingerprints;
+    for (const auto& [name, callee] : function->callees) fingerprints.emplace(name, callee->fingerprint);
+    uint64_t calleeFingerprints = hashFingerprints(fingerprints);
+    function->fingerprint = ProgramCacheFile::hashBytes(normalizedDefinition.data(), normalizedDefinition.size());
+    function->fingerprint = ProgramCacheFile::hashBytes(&calleeFingerprints, sizeof(calleeFingerprints), function->fingerprint);
+
+    // Compile the body on its own for the interactive evaluator, then store the definition.
+    ExpressionCompiler compiler(this->unaryOperatorLookupTable, this->binaryOperatorLookupTable);
+    function->program = compiler.compile(function->postfixBody, function->parameterNames);
+    this->userFunctionLookupTable[function->name] = function;
+}
+
+void Calculator::assignVariable(const std::string& assignment){
+    // Locate the parts of the assignment.
+    size_t keyword = assignment.find("let "), equalSign = assignment.find('=');
+    if (keyword == std::string::npos || equalSign == std::string::npos || keyword > equalSign) {
+        throw std::invalid_argument("DefinitionError: Expected an assignment of the form \"let <name> = <expression>\".\n");
+    }
 
-            case '(':
-                // Check if there is already a token stored in the string variable.
-                // If yes, push it into the vector and clear the string.
-                // Append the token to the string variable.
-                token += '(';
+    // Parse the name and check that it does not shadow a function or constant.
+    std::string name = trim(assignment.substr(keyword + 4, equalSign - keyword - 4));
+    if (!isLowercaseName(name) || this->isFunctionName(name) || this->spreadsheet.hasCell(name)) {
+        std::string errorMessage = "DefinitionError: Invalid variable name " + name;
+        errorMessage += " (expected a lowercase name that is not a function, constant or cell).\n";
+        throw std::invalid_argument(errorMessage);
+    }
 
-                // Increment the number of left brackets, update the state of the tokenizer, and break the statement.
-                numberOfLeftBrackets++;
-                isNegativeSign = true;
-                break;
+    // Evaluate the value, which may use the other variables (or the previous value of this one).
+    std::vector<std::string> variableNames;
+    std::vector<std::vector<double>> variableValues;
+    for (const auto& [variableName, elements] : this->variableLookupTable) {
+        variableNames.push_back(variableName);
+        variableValues.push_back(elements);
+    }
+    this->variableLookupTable[name] = this->evaluateElementwise(assignment.substr(equalSign + 1), variableNames, variableValues);
+}
 
-            case ')':
-                // Append the token to the string variable.
-                token += ")";
+size_t Calculator::assignCell(const std::string& assignment){
+    // Parse the name and check that it does not shadow a function, constant or variable.
+    size_t equalSign = assignment.find('=');
+    if (equalSign == std::string::npos) throw std::invalid_argument("DefinitionError: Expected a cell assignment of the form \"<name> = <expression>\".\n");
+    std::string name = trim(assignment.substr(0, equalSign));
+    if (!isLowercaseName(name) || this->isFunctionName(name) || this->variableLookupTable.find(name) != this->variableLookupTable.end()) {
+        std::string errorMessage = "DefinitionError: Invalid cell name " + name;
+        errorMessage += " (expected a lowercase name that is not a function, constant or variable).\n";
+        throw std::invalid_argument(errorMessage);
+    }
 
-                // Increment the number of right brackets, update the state of the tokenizer, and break the statement.
-                numberOfRightBrackets++;
-                isNegativeSign = false;
-                break;
-            
-            default:
-                // Handle unrecognized token exception.
-                // Initialize error message to display to the user.
-                errorMessage = "MathError: Found unrecognized token at index ";
-
-                // Convert index to string and append it to the error message string.
-                numberConverter << index;
-                errorMessage += numberConverter.str(); 
-
-                // Tell the user the unrecognized token found. 
-                errorMessage += " (found " + this->userInput.at(index);
-                errorMessage += ").\n";
-
-                // Throw an invalid_argument error with the constructed error message. 
-                throw std::invalid_argument(errorMessage);
+    // Collect the names of the formula which are not functions or constants: they reference cells, defined or not.
+    std::string formula = assignment.substr(equalSign + 1);
+    std::vector<std::string> referencedNames;
+    for (size_t index = 0; index < formula.size();) {
+        if (!std::islower(formula[index])) {
+            index++;
+            continue;
         }
-        
-        // Insert the token at the end of the vector.
-        tokens.push_back(token);
-
-        // Clear the string for reuse.
-        token.clear();
+        size_t start = index;
+        while (index < formula.size() && std::islower(formula[index])) index++;
+        std::string referencedName = formula.substr(start, index - start);
+        if (referencedName == "log" && index < formula.size() && (formula[index] == '_' || formula[index] == '2')) continue;
+        if (!this->isFunctionName(referencedName) && std::find(referencedNames.begin(), referencedNames.end(), referencedName) == referencedNames.end()) referencedNames.push_back(referencedName);
     }
 
-    // Handle no token expression.
-    if (tokens.size() == 0){
-        // Throw invalid_argument error with an appropriate error message. 
-        throw std::invalid_argument("ParseError: Found 0 tokens to parse.\n");  
+    // Compile the formula with the referenced cells as its variables, then update the graph.
+    CompiledExpression program = this->compileExpression(formula, referencedNames);
+    return this->spreadsheet.setCell(name, trim(formula), std::move(program));
+}
+
+std::vector<double> Calculator::evaluateElementwise(const std::string& expression, const std::vector<std::string>& variableNames, const std::vector<std::vector<double>>& variableValues){
+    // Parse the expression once, then apply each operator to whole vectors.
+    std::vector<PostfixInstruction> postfixProgram = this->parseElementwiseExpression(expression, variableNames, variableValues.size());
+    VectorEvaluator evaluator(this->unaryOperatorLookupTable, this->binaryOperatorLookupTable);
+    return evaluator.evaluate(postfixProgram, variableValues);
+}
+
+DoubleDoubleVector Calculator::evaluateExtendedPrecision(const std::string& expression, const std::vector<std::string>& variableNames, const std::vector<DoubleDoubleVector>& variableValues){
+    // Parse the expression once, then apply each operator to whole vectors in double-double.
+    std::vector<PostfixInstruction> postfixProgram = this->parseElementwiseExpression(expression, variableNames, variableValues.size());
+    ExtendedPrecisionEvaluator evaluator(this->extendedUnaryOperatorLookupTable, this->extendedBinaryOperatorLookupTable);
+    return evaluator.evaluate(postfixProgram, variableValues);
+}
+
+double Calculator::aggregateColumn(const std::string& command){
+    // Initialize the error message used for malformed commands.
+    const std::string errorMessage = "ParseError: Expected an aggregate of the form \"<function>(<expression>, <variable> in <file>:<column>)\".\n";
+
+    // Split the command into the function name and its parenthesized arguments.
+    std::string trimmedCommand = trim(command), functionName = getCalledFunctionName(trimmedCommand);
+    if (functionName.empty() || trimmedCommand.back() != ')') throw std::invalid_argument(errorMessage);
+    auto function = aggregateFunctionLookupTable.find(functionName);
+    if (function == aggregateFunctionLookupTable.end()) {
+        std::string unknownFunctionMessage = "ParseError: Unknown aggregate function " + functionName;
+        unknownFunctionMessage += " (expected sum, mean, min, max or stddev).\n";
+        throw std::invalid_argument(unknownFunctionMessage);
     }
 
-    
+    // Split the arguments at the last comma outside parentheses and brackets into the expression and the binding
+    // "<variable> in <file>:<column>". The path may itself contain ' in ' and ':'.
+    size_t openingParenthesis = trimmedCommand.find('(');
+    std::string arguments = trimmedCommand.substr(openingParenthesis + 1, trimmedCommand.size() - openingParenthesis - 2);
+    size_t comma = std::string::npos;
+    int depth = 0;
+    for (size_t index = 0; index < arguments.size(); index++) {
+        if (arguments[index] == '(' || arguments[index] == '[') depth++;
+        else if (arguments[index] == ')' || arguments[index] == ']') depth--;
+        else if (arguments[index] == ',' && depth == 0) comma = index;
+    }
+    if (comma == std::string::npos || depth != 0) throw std::invalid_argument(errorMessage);
+    std::string binding = trim(arguments.substr(comma + 1));
+    size_t keyword = binding.find(" in ");
+    if (keyword == std::string::npos) throw std::invalid_argument(errorMessage);
+    std::string source = trim(binding.substr(keyword + 4));
+    size_t colon = source.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon == source.size() - 1) throw std::invalid_argument(errorMessage);
+
+    // Compile the expression once, then reduce it over the column.
+    CompiledExpression program = this->compileExpression(arguments.substr(0, comma), {trim(binding.substr(0, keyword))});
+    ColumnAggregator aggregator(program);
+    return aggregator.aggregate(function->second, trim(source.substr(0, colon)), trim(source.substr(colon + 1)));
+}
 
-    // Handle mismatching brackets exception.
-    if (numberOfLeftBrackets != numberOfRightBrackets) {
-        // Construct error message to display to the user.
-        errorMessage = "MathError: Found mismatched brackets (found ";
+uint64_t Calculator::evaluateCsv(const std::string& expression, const std::string& path, std::ostream& output, MathAccuracy mathAccuracy){
+    // Offer every column with a valid variable name to the parser.
+    std::vector<std::string> columnNames;
+    {
+        CsvReader reader(path);
+        for (const std::string& name : reader.getColumnNames()) {
+            if (isLowercaseName(name) && !this->isFunctionName(name) && std::find(columnNames.begin(), columnNames.end(), name) == columnNames.end()) {
+                columnNames.push_back(name);
+            }
+        }
+    }
 
-        // Convert the difference between the number of bracket(s) to string and append it to the error message string.
-        numberConverter << abs(numberOfLeftBrackets - numberOfRightBrackets);
-        errorMessage += numberConverter.str() + " unmatched";
+    // Keep the columns the expression references, so the others are never parsed.
+    std::vector<bool> isReferenced(columnNames.size(), false);
+    for (const PostfixInstruction& instruction : this->parseToPostfix(expression, columnNames)) {
+        if (instruction.operationCode == PostfixOperationCode::pushVariable) isReferenced[instruction.variableSlot] = true;
+    }
+    std::vector<std::string> variableNames;
+    for (size_t slot = 0; slot < columnNames.size(); slot++) {
+        if (isReferenced[slot]) variableNames.push_back(columnNames[slot]);
+    }
 
-        // Customize error message string depending on which bracket(S) cannot be matched.
-        (numberOfLeftBrackets > numberOfRightBrackets) ? errorMessage += " left bracket(s)).\n" : errorMessage += " right bracket(s)).\n"; 
+    // Compile the expression once, then evaluate it on every row.
+    // Rows outside the domain are written as nan / inf anyway, so the raw kernels are used.
+    CompiledExpression program = this->compileExpression(expression, variableNames, EvaluationMode::unchecked, mathAccuracy);
+    CsvColumnEvaluator evaluator(program);
+    return evaluator.evaluate(path, output);
+}
 
-        // Throw the error with the constructed error message. 
+uint64_t Calculator::tabulateExpression(const std::string& command, std::ostream& output, unsigned threadCount){
+    // Initialize the error message used for malformed commands.
+    const std::string errorMessage = "ParseError: Expected a table command of the form \"table <expression> <variable>=<start>..<stop> step <step>\".\n";
+
+    // Split the command into whitespace separated words.
+    std::stringstream commandStream(command);
+    std::vector<std::string> words;
+    std::string word;
+    while (commandStream >> word) words.push_back(word);
+
+    // Drop the optional leading "table" keyword, then check for the trailing "<range> step <step>" words.
+    size_t firstWord = (!words.empty() && words.front() == "table") ? 1 : 0;
+    if (words.size() < firstWord + 4 || words[words.size() - 2] != "step") throw std::invalid_argument(errorMessage);
+
+    // Parse the range of the form <variable>=<start>..<stop>.
+    TableRange range;
+    const std::string& rangeWord = words[words.size() - 3];
+    size_t equalSign = rangeWord.find('='), separator = rangeWord.find("..");
+    if (equalSign == std::string::npos || separator == std::string::npos || separator < equalSign) throw std::invalid_argument(errorMessage);
+    range.variableName = rangeWord.substr(0, equalSign);
+    try {
+        size_t length;
+        std::string startString = rangeWord.substr(equalSign + 1, separator - equalSign - 1), stopString = rangeWord.substr(separator + 2);
+        range.start = std::stod(startString, &length);
+        if (length != startString.size()) throw std::invalid_argument(errorMessage);
+        range.stop = std::stod(stopString, &length);
+        if (length != stopString.size()) throw std::invalid_argument(errorMessage);
+        range.step = std::stod(words.back(), &length);
+        if (length != words.back().size()) throw std::invalid_argument(errorMessage);
+    } catch (std::logic_error&) {
         throw std::invalid_argument(errorMessage);
     }
 
-    // Return all tokens parsed.
-    return tokens;
+    // Join the remaining words back into the expression.
+    std::string expression;
+    for (size_t index = firstWord; index < words.size() - 3; index++) expression += words[index] + ' ';
+
+    // Compile the expression once, then evaluate it over the grid.
+    // Points outside the domain are written as nan / inf anyway, so the raw kernels are used.
+    CompiledExpression program = this->compileExpression(expression, {range.variableName}, EvaluationMode::unchecked);
+    TableGenerator generator(program, threadCount);
+    return generator.generate(range, output);
 }
 
-void Calculator::generatePostfixNotation(std::vector<std::string> tokens){
-    // Loop over the token vector and proceed accordingly.
-    for (size_t element = 0; element < tokens.size(); element++){
-        if (std::isdigit(tokens[element][0]) || tokens[element][0] == '.') {
-            this->outputQueue.push_back(tokens[element]);
-            continue;
+std::vector<EquationRoot> Calculator::solveEquation(const std::string& command){
+    // Initialize the error message used for malformed commands.
+    const std::string errorMessage = "ParseError: Expected a solve command of the form \"solve <expression> = <expression> <variable>=<guess>\", "
+        "\"... <variable>=<start>..<stop>\" or \"... <variable>=<start>..<stop> step <step>\".\n";
+
+    // Split the command into whitespace separated words.
+    std::stringstream commandStream(command);
+    std::vector<std::string> words;
+    std::string word;
+    while (commandStream >> word) words.push_back(word);
+
+    // Drop the optional leading "solve" keyword, then find the range, followed by "step <step>" for grids.
+    size_t firstWord = (!words.empty() && words.front() == "solve") ? 1 : 0;
+    bool isGrid = words.size() >= firstWord + 4 && words[words.size() - 2] == "step";
+    size_t rangeWord = words.size() - (isGrid ? 3 : 1);
+    if (words.size() < firstWord + 2) throw std::invalid_argument(errorMessage);
+
+    // Parse the range of the form <variable>=<guess> or <variable>=<start>..<stop>.
+    TableRange range;
+    const std::string& rangeText = words[rangeWord];
+    size_t equalSign = rangeText.find('='), separator = rangeText.find("..");
+    if (equalSign == std::string::npos || equalSign == 0 || (separator != std::string::npos && separator < equalSign)) throw std::invalid_argument(errorMessage);
+    if (isGrid && separator == std::string::npos) throw std::invalid_argument(errorMessage);
+    range.variableName = rangeText.substr(0, equalSign);
+    try {
+        size_t length;
+        std::string startString = rangeText.substr(equalSign + 1, (separator == std::string::npos) ? std::string::npos : separator - equalSign - 1);
+        range.start = std::stod(startString, &length);
+        if (length != startString.size()) throw std::invalid_argument(errorMessage);
+        range.stop = range.start;
+        if (separator != std::string::npos) {
+            std::string stopString = rangeText.substr(separator + 2);
+            range.stop = std::stod(stopString, &length);
+            if (length != stopString.size()) throw std::invalid_argument(errorMessage);
         }
-        switch (this->functionLookupTable.at(tokens[element])) {
-            case 272: case 314: case 1618:
-                this->outputQueue.push_back(tokens[element]);
+        range.step = 0;
+        if (isGrid) {
+            range.step = std::stod(words.back(), &length);
+            if (length != words.back().size()) throw std::invalid_argument(errorMessage);
+        }
+    } catch (std::logic_error&) {
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Join the remaining words back into the equation, and move its right-hand side to the left.
+    std::string equation;
+    for (size_t index = firstWord; index < rangeWord; index++) equation += words[index] + ' ';
+    size_t equationSign = equation.find('=');
+    if (equationSign != equation.rfind('=')) throw std::invalid_argument(errorMessage);
+    std::string expression = equation;
+    if (equationSign != std::string::npos) {
+        std::string leftSide = equation.substr(0, equationSign), rightSide = equation.substr(equationSign + 1);
+        if (leftSide.find_first_not_of(' ') == std::string::npos || rightSide.find_first_not_of(' ') == std::string::npos) throw std::invalid_argument(errorMessage);
+        expression = "(" + leftSide + ") - (" + rightSide + ")";
+    }
+
+    // Compile the expression once. Points outside the domain evaluate to nan, which the solver steps around.
+    CompiledExpression program = this->compileExpression(expression, {range.variableName}, EvaluationMode::unchecked);
+    EquationSolver solver(program);
+    if (isGrid) return solver.solveRange(range);
+    if (separator != std::string::npos) return {solver.solveBracket(range.start, range.stop)};
+    return {solver.solveFromGuess(range.start)};
+}
+
+IntegrationResult Calculator::integrateExpression(const std::string& command, double relativeTolerance, uint64_t maximumEvaluations){
+    // Initialize the error message used for malformed commands.
+    const std::string errorMessage = "ParseError: Expected an integral of the form \"integrate(<expression>, <variable>, <lower>, <upper>)\" "
+        "or \"integrate(<expression>, <variable>=<lower>..<upper>)\".\n";
+
+    // Strip the "integrate(" ... ")" around the arguments.
+    std::string trimmedCommand = trim(command);
+    const std::string keyword = "integrate(";
+    if (trimmedCommand.compare(0, keyword.size(), keyword) != 0 || trimmedCommand.back() != ')') throw std::invalid_argument(errorMessage);
+    std::string arguments = trimmedCommand.substr(keyword.size(), trimmedCommand.size() - keyword.size() - 1);
+
+    // Split the arguments at the commas outside parentheses and brackets, since the expression may call functions of several parameters.
+    std::vector<std::string> parts(1);
+    int depth = 0;
+    for (char character : arguments) {
+        if (character == '(' || character == '[') depth++;
+        else if (character == ')' || character == ']') depth--;
+        if (character == ',' && depth == 0) parts.emplace_back();
+        else parts.back() += character;
+    }
+    if (depth != 0) throw std::invalid_argument(errorMessage);
+
+    // Split a range of the form <variable>=<lower>..<upper>, as taken by the table and solve commands, into the variable and the limits.
+    if (parts.size() == 2) {
+        std::string range = parts[1];
+        size_t equalSign = range.find('='), separator = range.find("..");
+        if (equalSign == std::string::npos || separator == std::string::npos || separator < equalSign) throw std::invalid_argument(errorMessage);
+        parts = {parts[0], range.substr(0, equalSign), range.substr(equalSign + 1, separator - equalSign - 1), range.substr(separator + 2)};
+    }
+    if (parts.size() != 4) throw std::invalid_argument(errorMessage);
+
+    // Evaluate the limits, which are constant expressions, then compile the integrand once.
+    // Nodes outside the domain evaluate to nan, which the integrator reports with the offending point.
+    double lower = this->compileExpression(parts[2]).evaluate({}), upper = this->compileExpression(parts[3]).evaluate({});
+    CompiledExpression program = this->compileExpression(parts[0], {trim(parts[1])}, EvaluationMode::unchecked);
+    NumericalIntegrator integrator(program);
+    return integrator.integrate(lower, upper, relativeTolerance, maximumEvaluations);
+}
+
+std::future<StreamingValue> Calculator::evaluateAsync(const std::string& expression, const EvaluationLimits& limits){
+    // Start the clock now, so the time spent before the evaluation starts counts as well.
+    EvaluationBudget budget(limits);
+
+    // Copy every table the task reads instead of capturing this, so the task neither races with later definitions
+    // nor reads a destroyed calculator. The user functions are shared pointers to immutable compiled bodies.
+    return std::async(std::launch::async, [expression, budget, functions = this->functionLookupTable, precedences = this->operatorPrecedenceLookupTable,
+        unaryOperators = this->unaryOperatorLookupTable, binaryOperators = this->binaryOperatorLookupTable, userFunctions = this->userFunctionLookupTable]() mutable {
+        // Parse the expression while polling the budget, then evaluate it.
+        budget.check();
+        PrattParser parser(functions, precedences, userFunctions);
+        std::vector<PostfixInstruction> postfixProgram = parser.parse(expression, {}, "", &budget);
+        return evaluateScalarProgram(postfixProgram, unaryOperators, binaryOperators, &budget);
+    });
+}
+
+StreamingValue Calculator::evaluateStream(std::istream& input){
+    StreamingEvaluator evaluator(this->unaryOperatorLookupTable, this->binaryOperatorLookupTable, this->operatorPrecedenceLookupTable, this->functionLookupTable, this->userFunctionLookupTable);
+    return evaluator.evaluate(input);
+}
+
+IncrementalEvaluator Calculator::createIncrementalEvaluator() const {
+    return IncrementalEvaluator(StreamingEvaluator(this->unaryOperatorLookupTable, this->binaryOperatorLookupTable, this->operatorPrecedenceLookupTable, this->functionLookupTable, this->userFunctionLookupTable));
+}
+
+void Calculator::evaluateFile(const std::string& path){
+    // Open the file, throwing invalid_argument error if it cannot be read.
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        std::string errorMessage = "FileError: Failed to open " + path;
+        errorMessage += ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Evaluate the expression while reading the file.
+    std::cout << "Calculating...\n";
+    StreamingValue result = this->evaluateStream(input);
+    this->currentValue = result.value;
+
+    // Output the evaluated value. Integer results are printed exactly.
+    if (result.isInteger) std::cout << "Result: " << result.integer << '\n';
+    else std::cout << "Result: " << result.value << '\n';
+
+    // Save the file name instead of its content to the history.
+    if (!historyLog.insertNode("file " + path, this->currentValue)) throw std::runtime_error("Failed to allocate node.\n");
+    this->numberOfLogsSaved++;
+}
+
+StreamingValue Calculator::evaluateScalarProgram(const std::vector<PostfixInstruction>& postfixProgram, const std::unordered_map<std::string, UnaryFunction>& unaryOperators,
+    const std::unordered_map<std::string, BinaryFunction>& binaryOperators, EvaluationBudget* budget) {
+    // Declare lambda variable to check if number is close to 0.
+    auto isZero = [](double number) {
+        return fabs(number) < 0.0000000000001;
+    };
+
+    // Declare the operand stack. The parser only emits well-formed bytecode, so every operator finds its operands.
+    std::vector<StreamingValue> operandStack;
+    operandStack.reserve(postfixProgram.size());
+
+    // Loop over the bytecode and evaluate the expression.
+    for (const PostfixInstruction& instruction : postfixProgram) {
+        // Charge one step per instruction (user function calls are charged below).
+        if (budget != nullptr) budget->consumeSteps(1);
+        StreamingValue result;
+        switch (instruction.operationCode) {
+            // If the instruction is a number, push it into the stack.
+            case PostfixOperationCode::pushNumber:
+                operandStack.push_back({instruction.number, instruction.integer, instruction.isInteger});
                 continue;
 
-            case 90:
-                while(!this->operatorStack.empty() && this->operatorStack.top() != "(") {
-                    this->outputQueue.push_back(this->operatorStack.top());
-                    this->operatorStack.pop();
+            case PostfixOperationCode::pushVariable: case PostfixOperationCode::buildVector:
+                // Vectors and variables are evaluated element-wise, and never reach the scalar path of evaluatePostfixNotation().
+                throw std::invalid_argument("EvalError: Found a vector or variable in a scalar evaluation.\n");
+
+            // If the instruction is a user function call, evaluate its compiled body on the arguments.
+            case PostfixOperationCode::callUserFunction: {
+                // Pop the arguments, the last one being on top of the stack.
+                size_t parameterCount = instruction.userFunction->parameterNames.size();
+                std::vector<double> arguments(parameterCount);
+                for (size_t parameter = 0; parameter < parameterCount; parameter++) {
+                    arguments[parameter] = operandStack[operandStack.size() - parameterCount + parameter].value;
                 }
-                if (!this->operatorStack.empty() && this->operatorStack.top() == "("){
-                    this->operatorStack.pop();
+                operandStack.resize(operandStack.size() - parameterCount);
+                if (budget != nullptr) budget->consumeSteps(instruction.userFunction->program.getInstructions().size());
+                result.value = instruction.userFunction->program.evaluate(arguments);
+                break;
+            }
+
+            case PostfixOperationCode::applyUnaryOperator: {
+                // Take the exact integer path if the operand is an integer and the result fits in 64 bits.
+                StreamingValue operand = operandStack.back();
+                operandStack.pop_back();
+                if (operand.isInteger && integerUnaryOperation(instruction.name, operand.integer, result.integer)) {
+                    result.isInteger = true;
+                    result.value = static_cast<double>(result.integer);
                 } else {
-                    throw std::invalid_argument("MathError: Failed to find parenthesis pair.\n");
+                    result.value = unaryOperators.at(instruction.name)(operand.value);
                 }
                 break;
-            
-            case 23:
-                this->operatorStack.push(tokens[element]);
-                break;
+            }
 
-            default:
-                while (!this->operatorStack.empty() && this->operatorStack.top() != "(" && this->operatorPrecedenceLookupTable.at(this->operatorStack.top()) >= this->operatorPrecedenceLookupTable.at(tokens[element])) {
-                    this->outputQueue.push_back(this->operatorStack.top());
-                    this->operatorStack.pop();
+            case PostfixOperationCode::applyBinaryOperator: {
+                // Take the exact integer path if both operands are integers and the result fits in 64 bits.
+                StreamingValue secondOperand = operandStack.back();
+                operandStack.pop_back();
+                StreamingValue firstOperand = operandStack.back();
+                operandStack.pop_back();
+                if (firstOperand.isInteger && secondOperand.isInteger && integerBinaryOperation(instruction.name, firstOperand.integer, secondOperand.integer, result.integer)) {
+                    result.isInteger = true;
+                    result.value = static_cast<double>(result.integer);
+                } else {
+                    result.value = binaryOperators.at(instruction.name)(firstOperand.value, secondOperand.value);
                 }
-                this->operatorStack.push(tokens[element]);
                 break;
+            }
         }
-    }
 
-    while (!this->operatorStack.empty()) {
-        if (this->operatorStack.top() == "(" || this->operatorStack.top() == ")") {
-            throw std::invalid_argument("MathError: Failed to find parenthesis pair when clearing stack.\n");
-        }
-        this->outputQueue.push_back(this->operatorStack.top());
-        this->operatorStack.pop();
+        // Check if the result is close to 0, if yes, push 0 instead.
+        if (!result.isInteger && isZero(result.value)) result = {0, 0, true};
+        operandStack.push_back(result);
     }
+
+    return operandStack.back();
 }
 
 void Calculator::evaluatePostfixNotation(){
-    // Parse the input string and generate the postfix notation.
-    // Assign the postfixNotation to outputQueue.
-    std::vector<std::string> tokens = this->tokenizeExpression();
-    this->generatePostfixNotation(tokens);
-
-    // Declare variable to store operands and current result.
-    double result = 0; 
-    std::string firstOperand, secondOperand;
+    // Handle function definitions, e.g. "def f(x, y) = sqrt(x^2 + y^2)".
+    if (this->userInput.compare(0, 4, "def ") == 0) {
+        this->defineFunction(this->userInput);
+        std::cout << "Defined function.\n";
+        return;
+    }
 
-    // Declare lambda variable to check if number is close to 0.
-    auto isZero = [](double number) {
-        return fabs(number) < 0.0000000000001;
-    };
+    // Handle variable assignments, e.g. "let v = [1, 2, 3.5]".
+    if (this->userInput.compare(0, 4, "let ") == 0) {
+        this->assignVariable(this->userInput);
+        std::cout << "Assigned variable.\n";
+        return;
+    }
 
-    // Declare string stream variable to convert number to string.
-    std::stringstream numberConverter;
+    // Handle the listing of the cells.
+    if (this->userInput == "cells") {
+        this->spreadsheet.print(std::cout);
+        return;
+    }
 
-    // Loop over outputQueue and evaluate the expression.
-    std::cout << "Calculating...\n";
-    for (auto &token : this->outputQueue){
-        // If the token is a number, push them into the stack.
-        if (token[0] == '.' || std::isdigit(token[0])) {; 
-            this->operatorStack.push(token);
-            continue;
+    // Handle cell assignments, e.g. "b = a*2 + sin(c)", then show the value of the cell or its error.
+    // Other inputs containing '=' are left to the parser, which rejects the '='.
+    if (isCellAssignment(this->userInput)) {
+        size_t recomputedCount = this->assignCell(this->userInput);
+        std::string name = trim(this->userInput.substr(0, this->userInput.find('=')));
+        try {
+            double value = this->spreadsheet.getValue(name);
+            std::cout << "Result: " << value << '\n';
+        } catch (std::invalid_argument &e) {
+            std::cout << "Got " << e.what();
         }
+        std::cout << "Recomputed " << recomputedCount << " cell(s).\n";
+        return;
+    }
 
-        this->functionLookupTable.at(token);
+    // Handle column aggregates, e.g. "sum(x^2, x in data.csv:price)", unless a user function has the name of the aggregate.
+    std::string calledFunctionName = getCalledFunctionName(this->userInput);
+    if (aggregateFunctionLookupTable.find(calledFunctionName) != aggregateFunctionLookupTable.end() && !this->isFunctionName(calledFunctionName)) {
+        std::cout << "Calculating...\n";
+        this->currentValue = this->aggregateColumn(this->userInput);
+        std::cout << "Result: " << this->currentValue << '\n';
+        if (!historyLog.insertNode(this->userInput, this->currentValue)) throw std::runtime_error("Failed to allocate node.\n");
+        this->numberOfLogsSaved++;
+        return;
+    }
 
-        switch (this->functionLookupTable.at(token)) {
-            // If the token is a special constant (e, pi, phi), push them into the stack.
-            case 272:
-                this->operatorStack.push("2.718281828459045235360287471352662498L");
-                continue;
-            case 314:
-                this->operatorStack.push("3.141592653589793238462643383279502884L");
-                continue;
-            case 1618:
-                this->operatorStack.push("1.618033988749894848204586834365638118L");
-                continue;
+    // Handle integrals, e.g. "integrate(sin(x)^2, x, 0, 2*pi)", unless a user function is named integrate.
+    if (calledFunctionName == "integrate" && !this->isFunctionName(calledFunctionName)) {
+        std::cout << "Calculating...\n";
+        IntegrationResult result = this->integrateExpression(this->userInput);
+        this->currentValue = result.value;
+        std::cout << std::setprecision(17) << "Result: " << result.value << " (estimated error " << std::setprecision(3) << result.errorEstimate;
+        std::cout << ", " << result.evaluationCount << " evaluation(s) on " << result.intervalCount << " subinterval(s))\n" << std::setprecision(6);
+        if (!result.isConverged) std::cout << "Warning: The evaluation budget ran out before the requested accuracy was reached.\n";
+        if (!historyLog.insertNode(this->userInput, this->currentValue)) throw std::runtime_error("Failed to allocate node.\n");
+        this->numberOfLogsSaved++;
+        return;
+    }
 
-            default:
-                // If the number assigned is odd, search the unary operator table.
-                // Else, search the binary operator table.
-                if (this->functionLookupTable.at(token) & 1){
-                    // Throw error if there is an excess operand.
-                    if (this->operatorStack.empty()) throw std::invalid_argument("EvalError: Found excess operator(s).\n");
-
-                    // Convert the number string to a double, then call the function on the number.
-                    result = this->unaryOperatorLookupTable.at(token)(std::stod(this->operatorStack.top()));
-                    numberConverter << result;
-                    
-                    // Convert the result to a string and push to the stack.
-                    // Pop the stack after calculating the result.
-                    this->operatorStack.pop();
-
-                    // Check if the result is close to 0, if yes, push 0 instead.
-                    (!isZero(result)) ? this->operatorStack.push(numberConverter.str()) : this->operatorStack.push("0");
-                } else {
-                    // Throw error if there is an excess operand.
-                    if (this->operatorStack.empty()) {
-                        std::string errorMessage = "EvalError: Found excess operator(s) (found " + token;
-                        errorMessage += ").\n"; 
-                        throw std::invalid_argument(errorMessage);
-                    }
-
-                    // Assign the first number to a string variable and pop the stack.
-                    secondOperand = this->operatorStack.top();
-                    this->operatorStack.pop();
-
-                    // Throw error if there is not enough arguments.
-                    if (this->operatorStack.empty()) {
-                        std::string errorMessage = "EvalError: Failed to find second argument for " + token;
-                        errorMessage += ".\n"; 
-                        throw std::invalid_argument(errorMessage);
-                    }
-
-                    // Assign the second number to a string variable and pop the stack.
-                    firstOperand = this->operatorStack.top();
-                    this->operatorStack.pop();
-                    
-                    // Convert the number string to a double, then call the function on the numbers.
-                    result = this->binaryOperatorLookupTable.at(token)(std::stod(firstOperand), std::stod(secondOperand));
-                    
-                    // Convert the result to a string, and push it to the stack.
-                    numberConverter << result;
-
-                    // Check if the result is close to 0, if yes, push 0 instead.
-                    (!isZero(result)) ? this->operatorStack.push(numberConverter.str()) : this->operatorStack.push("0");
-
-                    // Clear the string variables for later use.
-                    firstOperand.clear();
-                    secondOperand.clear();
-                }                
-
-                // Clear the string stream for later use.
-                numberConverter.clear();
-                numberConverter.str("");
-                break;
+    // Parse the input string into postfix bytecode.
+    std::vector<std::string> variableNames;
+    std::vector<std::vector<double>> variableValues;
+    for (const auto& [variableName, elements] : this->variableLookupTable) {
+        variableNames.push_back(variableName);
+        variableValues.push_back(elements);
+    }
+    std::vector<std::string> cellNames;
+    std::vector<double> cellValues;
+    this->spreadsheet.getValidCells(cellNames, cellValues);
+    for (size_t cell = 0; cell < cellNames.size(); cell++) {
+        variableNames.push_back(cellNames[cell]);
+        variableValues.push_back({cellValues[cell]});
+    }
+
+    // Handle double-double evaluations, e.g. "dd 1/3 + pi", printed with 31 significant digits.
+    if (this->userInput.compare(0, 3, "dd ") == 0) {
+        std::cout << "Calculating...\n";
+        std::vector<DoubleDoubleVector> extendedValues(variableValues.size());
+        for (size_t variable = 0; variable < variableValues.size(); variable++) {
+            extendedValues[variable].high = variableValues[variable];
+            extendedValues[variable].low.assign(variableValues[variable].size(), 0);
         }
+        DoubleDoubleVector elements = this->evaluateExtendedPrecision(this->userInput.substr(3), variableNames, extendedValues);
+
+        // Output the elements. The history holds scalar values only, rounded to double.
+        if (elements.size() != 1) {
+            std::cout << "Result: [";
+            for (size_t element = 0; element < elements.size(); element++) std::cout << ((element == 0) ? "" : ", ") << formatDoubleDouble({elements.high[element], elements.low[element]});
+            std::cout << "]\n";
+            return;
+        }
+        this->currentValue = elements.high[0];
+        std::cout << "Result: " << formatDoubleDouble({elements.high[0], elements.low[0]}) << '\n';
+        if (!historyLog.insertNode(this->userInput, this->currentValue)) throw std::runtime_error("Failed to allocate node.\n");
+        this->numberOfLogsSaved++;
+        return;
+    }
+    this->postfixProgram = this->parseToPostfix(this->userInput, variableNames);
+
+    // Evaluate expressions using vectors or variables element-wise, dispatching each operator once for all elements.
+    bool isElementwise = std::any_of(this->postfixProgram.begin(), this->postfixProgram.end(), [](const PostfixInstruction& instruction) {
+        return instruction.operationCode == PostfixOperationCode::buildVector || instruction.operationCode == PostfixOperationCode::pushVariable;
+    });
+    if (isElementwise) {
+        std::cout << "Calculating...\n";
+        VectorEvaluator evaluator(this->unaryOperatorLookupTable, this->binaryOperatorLookupTable);
+        std::vector<double> elements = evaluator.evaluate(this->postfixProgram, variableValues);
+        this->reset();
+
+        // Output the elements. The history holds scalar values only, so vector results are not saved.
+        if (elements.size() != 1) {
+            std::cout << "Result: [";
+            for (size_t element = 0; element < elements.size(); element++) std::cout << ((element == 0) ? "" : ", ") << elements[element];
+            std::cout << "]\n";
+            return;
+        }
+        this->currentValue = elements[0];
+        std::cout << "Result: " << this->currentValue << '\n';
+        if (!historyLog.insertNode(this->userInput, this->currentValue)) throw std::runtime_error("Failed to allocate node.\n");
+        this->numberOfLogsSaved++;
+        return;
     }
 
-    this->currentValue = std::stod(this->operatorStack.top());
-    
-    // Output the evaluated value.
-    std::cout << "Result: " << this->currentValue << '\n';
+    // Evaluate the bytecode.
+    std::cout << "Calculating...\n";
+    StreamingValue result = evaluateScalarProgram(this->postfixProgram, this->unaryOperatorLookupTable, this->binaryOperatorLookupTable, nullptr);
+    this->currentValue = result.value;
+
+    // Output the evaluated value. Integer results are printed exactly.
+    if (result.isInteger) std::cout << "Result: " << result.integer << '\n';
+    else std::cout << "Result: " << this->currentValue << '\n';
 
     // Handle not enough memory exception. 
     if (!historyLog.insertNode(this->userInput, this->currentValue)) throw std::runtime_error("Failed to allocate node.\n");
@@ -675,102 +1218,9 @@ bool Calculator::undoOperation(){
     return true;
 }
 
-std::string Calculator::parseNumberFromInputString(const size_t start, size_t* index, std::string& errorMessage, std::stringstream& numberConverter){
-    // Set a checkpoint at the starting index.
-    size_t length = start;
-    
-    // Get the first decimal digits before the exponent / floating point.
-    while (length < this->userInput.size() && std::isdigit(this->userInput.at(length))) length++;
-    
-    // Handle all valid number formats.
-    // Case 1: no exponent / no floating point.
-    // Case 2: no exponent with floating point.
-    // Case 3: exponent without floating point.
-    // Case 4: exponent with floating point.
-    // Case 5: only floating point.
-    // Check if the end of the string has been reached.
-    if (length < this->userInput.size()) { 
-        // If not, check if the number has a floating point and / or exponent.
-        if (this->userInput.at(length) == '.') {
-            // Increment length, and floating point number.
-            length++;
-
-            // If there is no digit after floating point, throw invalid_argument error.
-            if (length >= this->userInput.size() || !std::isdigit(this->userInput.at(length))) {
-                // Construct the error message.
-                errorMessage = "MathError: Failed to parse number at index ";
-
-                // Convert starting index to a string, and append at the error message.
-                numberConverter << start;
-                errorMessage += numberConverter.str() + "(found floating point without proceeding digit(s)).\n";
-
-                // Throw invalid_argument error with the constructed error message.
-                throw std::invalid_argument(errorMessage);
-            }
-            // Parse the numbers after the floating point.
-            while (length < this->userInput.size() && std::isdigit(this->userInput.at(length))) length++;
-
-            // If there is another floating point, throw invalid_argument error.
-            if (length < this->userInput.size() && this->userInput.at(length) == '.') {
-                // Construct the error message.
-                errorMessage = "MathError: Failed to parse number at index ";
-                
-                // Convert starting index to a string, and append at the error message.
-                numberConverter << start;
-                errorMessage += numberConverter.str() + "(found extra floating point).\n";
-                
-                // Throw invalid_argument error with the constructed error message.
-                throw std::invalid_argument(errorMessage);
-            }
-        }
-
-        // Handle case where the number has an exponent.
-        if (length < this->userInput.size() && this->userInput.at(length) == 'e') {
-            // Increment length, then parse the exponent.
-            length++;
-
-            // If there is no digit after floating point, throw invalid_argument error.
-            if (length >= this->userInput.size() || !(std::isdigit(this->userInput.at(length)) || this->userInput.at(length) == '-' || this->userInput.at(length) == '+')) {
-                // Construct the error message.
-                errorMessage = "MathError: Failed to parse number at index ";
-
-                // Convert starting index to a string, and append at the error message.
-                numberConverter << start;
-                errorMessage += numberConverter.str() + "(found exponent symbol without proceeding digit(s)).\n";
-                
-                // Throw invalid_argument error with the constructed error message.
-                throw std::invalid_argument(errorMessage);
-            }
-
-            // Increment length if there is a preceding '-' or '+' sign.
-            if (this->userInput.at(length) == '-' || this->userInput.at(length) == '+') length++;
-
-            // If there is no digit after '+' or '-' sign, throw invalid_argument error. 
-            if (length >= this->userInput.size()) {
-                errorMessage = "MathError: Failed to parse number at index ";
-                numberConverter << start;
-                errorMessage += numberConverter.str() + "(found +- sign without proceeding digit(s)).\n";
-                throw std::invalid_argument(errorMessage);
-            }
-
-            // Parse the exponent.
-            while (length < this->userInput.size() && std::isdigit(this->userInput.at(length))) length++;
-        } 
-    }        
-
-    // Decrement the length of the parsed string.
-    // Update the index to the next character on the string.
-    *index = length - 1;
-
-    // Return the parsed number.
-    return this->userInput.substr(start, length - start);
-}
-
 void Calculator::reset(){
-    // Reset the output queue, user input string, and operator stack variables.
-    this->outputQueue.clear();
-    std::stack<std::string> empty;
-    this->operatorStack = empty;
+    // Reset the postfix bytecode.
+    this->postfixProgram.clear();
 }
 
 double Calculator::getCurrentValue(){
@@ -780,6 +1230,6 @@ double Calculator::getCurrentValue(){
 }
 
 Calculator::~Calculator() {
-    // Call the destructor for the LinkedLIst object.
-    historyLog.~LinkedList();
+    // The history log frees its nodes in its own destructor, which runs after this one.
+    // Calling it here as well freed every node twice, crashing the program on exit.
 }
\ No newline at end of file
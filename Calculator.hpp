@@ -2,7 +2,24 @@
 #define __CALCULATOR
 
 #include "LinkedList.hpp"
-#include <stack>
+#include "ExpressionCompiler.hpp"
+#include "PrattParser.hpp"
+#include "TableGenerator.hpp"
+#include "IntegerArithmetic.hpp"
+#include "StreamingEvaluator.hpp"
+#include "IncrementalEvaluator.hpp"
+#include "VectorEvaluator.hpp"
+#include "ExtendedPrecisionEvaluator.hpp"
+#include "ColumnAggregator.hpp"
+#include "CsvColumnEvaluator.hpp"
+#include "HistoryExporter.hpp"
+#include "EvaluationBudget.hpp"
+#include "EquationSolver.hpp"
+#include "NumericalIntegrator.hpp"
+#include "Spreadsheet.hpp"
+#include "ProgramCacheFile.hpp"
+#include "SharedProgramCache.hpp"
+#include <future>
 #include <stdexcept>
 #include <iostream>
 
@@ -23,78 +40,277 @@ class Calculator {
 
         /// @brief A lookup table for all functions / operators taking a single parameter.
         /// Maps strings denoting a function / operator to a function pointer using a custom hash function. 
-        std::unordered_map<std::string, std::function<double(double)>> unaryOperatorLookupTable;
+        std::unordered_map<std::string, UnaryFunction> unaryOperatorLookupTable;
 
         /// @brief A lookup table for all functions / operators taking two parameters.
         /// Maps strings denoting a function / operator to a function pointer using a custom hash function.
-        const std::unordered_map<std::string, std::function<double(double, double)>> binaryOperatorLookupTable;
+        const std::unordered_map<std::string, BinaryFunction> binaryOperatorLookupTable;
 
         /// @brief A lookup table containing the precedence of all operators and functions.
         /// Maps strings of function names to their assigned precedence order. 
         const std::unordered_map<std::string, int> operatorPrecedenceLookupTable;
 
+        /// @brief A lookup table for the raw kernels of all functions / operators taking a single parameter.
+        /// Used by unchecked programs: invalid inputs produce nan or inf instead of throwing.
+        const std::unordered_map<std::string, UnaryFunction> uncheckedUnaryOperatorLookupTable;
+
+        /// @brief A lookup table for the raw kernels of all functions / operators taking two parameters.
+        /// Used by unchecked programs: invalid inputs produce nan or inf instead of throwing.
+        const std::unordered_map<std::string, BinaryFunction> uncheckedBinaryOperatorLookupTable;
+
+        /// @brief A lookup table for the double-double functions / operators taking a single parameter, used by "dd" evaluations.
+        /// Operands outside the domain of an operator throw the error of its function in unaryOperatorLookupTable.
+        const std::unordered_map<std::string, ExtendedUnaryFunction> extendedUnaryOperatorLookupTable;
+
+        /// @brief A lookup table for the double-double functions / operators taking two parameters, used by "dd" evaluations.
+        /// Operands outside the domain of an operator throw the error of its function in binaryOperatorLookupTable.
+        const std::unordered_map<std::string, ExtendedBinaryFunction> extendedBinaryOperatorLookupTable;
+
         /// @brief A lookup table for looking up function names. 
         std::unordered_map<std::string, int> functionLookupTable;
 
-        /// @brief A stack containing all parsed operators to be consumed.
-        /// Operators are ordered from lowest to highest precedence.
-        std::stack<std::string> operatorStack;
-
-        /// @brief A vector containing all parsed numbers to be consumed.
-        /// Numbers are ordered from lowest to highest precedence.
-        std::vector<std::string> outputQueue;
-        
-        /// @brief Private method for parsing numbers from the given substring.
-        /// @param start Starting index of the number.
-        /// @param index Pointer to the current index to update.
-        /// @param errorMessage Reference to a string containing an error message.
-        /// @param numberConverter Reference to a stringstream object for converting an index to a number.
-        /// @returns Parsed number in the form of a string.
-        /// @throws invalid_argument error if the string cannot be parsed as a number.
-        /// Examples:
-        /// 100000.00 (valid).
-        /// -1.2e+1 (valid). 
-        /// 1e3 (valid).
-        /// -9.20e-3 (valid).
-        /// 1..0 (invalid).
-        /// 1.-2 (invalid).
-        /// 2ee2 (invalid).
-        /// 223,3 (invalid).
-        /// 23.a (invalid).
-        /// 2e(-12) (invalid). 
-        /// 23e12e (will be parsed as 23e12).
-        std::string parseNumberFromInputString(const size_t start, size_t* index, std::string& errorMessage, std::stringstream& numberConverter);
-
-        /// @brief Private method for checking the validity of a given input string by probing for the expected character.
-        /// @param expectedCharacter Character to expect.
-        /// @param expectedIndex Index of expected character.
-        /// @throws invalid_argument error if the expected character is not found.
-        void expect(char expectedCharacter, size_t expectedIndex);
-
-        /// @brief Private method for getting all tokens in a given expression.
-        /// @returns Vector containing all parsed tokens.
-        std::vector<std::string> tokenizeExpression();
-
-        /// @brief Private method for generating postfix expression from user input.
-        /// @param tokens A vector containing all parsed tokens.
-        /// @throws invalid_argument error if the postfix notation cannot be generated.
-        void generatePostfixNotation(std::vector<std::string> tokens);
+        /// @brief A lookup table for the functions defined by the user during the session.
+        /// Maps function names to immutable definitions, so compiled programs and other definitions can keep them.
+        UserFunctionTable userFunctionLookupTable;
+
+        /// @brief A lookup table for the variables assigned by the user during the session, e.g. "let v = [1, 2, 3]".
+        /// Maps variable names to their elements (a single element for scalars).
+        std::unordered_map<std::string, std::vector<double>> variableLookupTable;
+
+        /// @brief Named cells defined by the user during the session, e.g. "b = a*2 + sin(c)", recomputed when the cells they reference change.
+        Spreadsheet spreadsheet;
+
+        /// @brief Postfix bytecode of the user input being evaluated.
+        std::vector<PostfixInstruction> postfixProgram;
+
+        /// @brief Cache of the programs compiled by compileExpression() (nullptr to always compile).
+        ProgramCacheFile* programCache = nullptr;
+
+        /// @brief Cache of the programs compiled by compileSharedExpression(), shared with the other calculators (nullptr to always compile).
+        SharedProgramCache* sharedProgramCache = nullptr;
+
+        /// @brief Private method for generating the postfix bytecode of an expression without touching the user input.
+        /// @param expression Expression to parse.
+        /// @param variableNames Names of the variables the expression may reference.
+        /// @param functionBeingDefined Name of the function whose body is parsed, which may not call itself (empty otherwise).
+        /// @returns The bytecode.
+        /// @throws invalid_argument error if the expression cannot be parsed or a variable name is invalid.
+        std::vector<PostfixInstruction> parseToPostfix(const std::string& expression, const std::vector<std::string>& variableNames, const std::string& functionBeingDefined = "");
+
+        /// @brief Private method for generating the postfix bytecode of an expression evaluated element-wise, after checking that
+        /// every variable has been given its elements (see evaluateElementwise() and evaluateExtendedPrecision()).
+        /// @param expression Expression to parse.
+        /// @param variableNames Names of the variables the expression may reference.
+        /// @param variableValueCount Number of variables given elements.
+        /// @returns The bytecode.
+        /// @throws invalid_argument error if the counts differ, the expression cannot be parsed or a variable name is invalid.
+        std::vector<PostfixInstruction> parseElementwiseExpression(const std::string& expression, const std::vector<std::string>& variableNames, size_t variableValueCount);
+
+        /// @brief Private method for evaluating scalar postfix bytecode, with exact integer arithmetic where possible.
+        /// Static, so evaluateAsync() can run it on copies of the operator tables without touching the calculator.
+        /// @param postfixProgram Bytecode to evaluate, free of vectors and variables.
+        /// @param unaryOperators Unary operators and functions of the bytecode.
+        /// @param binaryOperators Binary operators of the bytecode.
+        /// @param budget Budget charged one step per instruction (nullptr for an unlimited evaluation).
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if the expression cannot be evaluated or the budget is exceeded.
+        static StreamingValue evaluateScalarProgram(const std::vector<PostfixInstruction>& postfixProgram, const std::unordered_map<std::string, UnaryFunction>& unaryOperators,
+            const std::unordered_map<std::string, BinaryFunction>& binaryOperators, EvaluationBudget* budget);
+
+        /// @brief Private method for checking whether a name denotes a built-in function or constant, or a user function.
+        bool isFunctionName(const std::string& name) const;
+
+        /// @brief Private method for combining the fingerprints of the user functions an expression calls, which the calls compile to.
+        /// Functions are found by name without parsing the expression, so that cached programs are found without parsing it either.
+        /// Defining a function only changes the fingerprints of the expressions naming it.
+        /// @param expression Expression to fingerprint.
+        /// @returns The combined fingerprint, 0 if the expression calls no user function.
+        uint64_t getUserFunctionFingerprint(const std::string& expression) const;
 
     public:
 
         /// @brief Constructor for the calculator class.
         Calculator();
 
-        /// @brief Method for evaluating the generated postfix notation.
+        /// @brief Method for compiling an expression into a register program.
+        /// Common subexpressions are computed once, e.g. sin(x) in "sin(x)^2 + sin(x)*cos(x)".
+        /// Programs are read from the program cache if one has been set (see setProgramCache()).
+        /// @param expression Expression to compile.
+        /// @param variableNames Names of the variables the expression may reference, ordered by their slot.
+        /// @param evaluationMode Whether the program throws on domain errors (checked) or propagates nan / inf (unchecked).
+        /// @param mathAccuracy Accuracy of sin, cos, exp, ln, log2 and log (see FastMath.hpp).
+        /// @returns The compiled program.
+        /// @throws invalid_argument error if the expression cannot be parsed or a variable name is invalid.
+        CompiledExpression compileExpression(const std::string& expression, const std::vector<std::string>& variableNames = {}, EvaluationMode evaluationMode = EvaluationMode::checked, MathAccuracy mathAccuracy = MathAccuracy::library);
+
+        /// @brief Method for compiling an expression into a checked register program, given the range of every variable.
+        /// Operations whose operands provably stay inside their domain, e.g. ln(x) for x in [0.1, 10], call the raw kernels; the
+        /// others keep their checks and are listed by CompiledExpression::getDomainWarnings(). Variables given values outside
+        /// their range may then produce nan or inf instead of domain errors. The program cache is not used, since its keys have no ranges.
+        /// @param expression Expression to compile.
+        /// @param variableNames Names of the variables the expression may reference, ordered by their slot.
+        /// @param variableRanges Ranges of the variables, ordered by their slot (Interval{} for any value).
+        /// @param mathAccuracy Accuracy of sin, cos, exp, ln, log2 and log (see FastMath.hpp).
+        /// @returns The compiled program.
+        /// @throws invalid_argument error if the expression cannot be parsed, a variable name is invalid or a range is missing.
+        CompiledExpression compileExpression(const std::string& expression, const std::vector<std::string>& variableNames, const std::vector<Interval>& variableRanges, MathAccuracy mathAccuracy = MathAccuracy::library);
+
+        /// @brief Method for parsing variable declarations, e.g. "x in [0.1, 10] y" (y takes any value). Declarations are separated
+        /// by spaces or commas, and the bounds are constant expressions.
+        /// @param declarations Declarations to parse.
+        /// @param variableNames Names of the variables, in the order of their declaration.
+        /// @param variableRanges Ranges of the variables, in the order of their declaration.
+        /// @returns true if at least one variable has been given a range.
+        /// @throws invalid_argument error if the declarations are malformed, or a lower bound exceeds its upper bound.
+        bool parseVariableDeclarations(const std::string& declarations, std::vector<std::string>& variableNames, std::vector<Interval>& variableRanges);
+
+        /// @brief Method for setting the cache compileExpression() reads programs from and adds them to, e.g. to skip parsing and
+        /// compiling the expressions of the previous run. The cache is not saved by the calculator.
+        /// @param programCache Cache which must outlive the calculator, or nullptr to always compile.
+        void setProgramCache(ProgramCacheFile* programCache);
+
+        /// @brief Method for compiling an expression into an immutable program shared with the other calculators of the process,
+        /// e.g. by the worker threads of a server evaluating the same formulas. Programs are read from the shared program cache if
+        /// one has been set (see setSharedProgramCache()), and compiled and added to it otherwise.
+        /// @param expression Expression to compile.
+        /// @param variableNames Names of the variables the expression may reference, ordered by their slot.
+        /// @param evaluationMode Whether the program throws on domain errors (checked) or propagates nan / inf (unchecked).
+        /// @param mathAccuracy Accuracy of sin, cos, exp, ln, log2 and log (see FastMath.hpp).
+        /// @returns The compiled program.
+        /// @throws invalid_argument error if the expression cannot be parsed or a variable name is invalid.
+        std::shared_ptr<const CompiledExpression> compileSharedExpression(const std::string& expression, const std::vector<std::string>& variableNames = {}, EvaluationMode evaluationMode = EvaluationMode::checked, MathAccuracy mathAccuracy = MathAccuracy::library);
+
+        /// @brief Method for setting the cache compileSharedExpression() reads programs from and adds them to, which may be shared
+        /// by calculators running on different threads (e.g. SharedProgramCache::getSharedCache()).
+        /// @param sharedProgramCache Cache which must outlive the calculator, or nullptr to always compile.
+        void setSharedProgramCache(SharedProgramCache* sharedProgramCache);
+
+        /// @brief Method for defining (or redefining) a function for the rest of the session.
+        /// Calls are inlined by compileExpression(). The body may call previously defined functions, but not itself.
+        /// @param definition Definition such as "def f(x, y) = sqrt(x^2 + y^2)".
+        /// @throws invalid_argument error if the definition cannot be parsed, shadows a built-in name, or is recursive.
+        void defineFunction(const std::string& definition);
+
+        /// @brief Method for assigning (or reassigning) a variable for the rest of the session.
+        /// Variables are visible to the expressions evaluated by evaluatePostfixNotation(), not to function bodies.
+        /// @param assignment Assignment such as "let v = [1, 2, 3.5]" or "let w = v^2 + 1".
+        /// @throws invalid_argument error if the assignment cannot be parsed or evaluated, or shadows a function name.
+        void assignVariable(const std::string& assignment);
+
+        /// @brief Method for defining (or redefining) a named cell, then recomputing the cells depending on it.
+        /// The formula may reference cells defined later. Cells are visible to the expressions evaluated by evaluatePostfixNotation().
+        /// @param assignment Assignment such as "a = 3" or "b = a*2 + sin(c)".
+        /// @returns Number of cells recomputed, including the assigned one.
+        /// @throws invalid_argument error if the assignment cannot be parsed, shadows a function or variable name, or closes a cycle.
+        size_t assignCell(const std::string& assignment);
+
+        /// @brief Method for evaluating an expression element-wise, e.g. "[1, 2, 3]^2 + x" for a vector x.
+        /// Operators apply to each element, and single-element operands are broadcast to the length of the other operand.
+        /// @param expression Expression to evaluate.
+        /// @param variableNames Names of the variables the expression may reference, ordered by their slot.
+        /// @param variableValues Elements of the variables, ordered by their slot (single-element vectors for scalars).
+        /// @returns Elements of the result.
+        /// @throws invalid_argument error if the expression cannot be parsed or evaluated, or the vector lengths differ.
+        std::vector<double> evaluateElementwise(const std::string& expression, const std::vector<std::string>& variableNames = {}, const std::vector<std::vector<double>>& variableValues = {});
+
+        /// @brief Method for evaluating an expression element-wise in double-double precision (about 32 significant digits),
+        /// e.g. "1/3 + pi". Works like evaluateElementwise(), with decimal literals and constants kept to the same precision.
+        /// @param expression Expression to evaluate.
+        /// @param variableNames Names of the variables the expression may reference, ordered by their slot.
+        /// @param variableValues Elements of the variables, ordered by their slot (single-element vectors for scalars).
+        /// @returns Elements of the result.
+        /// @throws invalid_argument error if the expression cannot be parsed or evaluated, or the vector lengths differ.
+        DoubleDoubleVector evaluateExtendedPrecision(const std::string& expression, const std::vector<std::string>& variableNames = {}, const std::vector<DoubleDoubleVector>& variableValues = {});
+
+        /// @brief Method for reducing an expression of one variable over a numeric column of a CSV file.
+        /// The file is streamed from a memory map and reduced in parallel, with compensated summation for sums and means.
+        /// @param command Aggregate such as "sum(x^2, x in data.csv:price)", where the function is sum, mean, min, max or stddev.
+        /// @returns The reduced value.
+        /// @throws invalid_argument error if the command or the expression cannot be parsed, or the column cannot be reduced.
+        double aggregateColumn(const std::string& command);
+
+        /// @brief Method for evaluating an expression on every row of a CSV file, with the columns as variables.
+        /// Columns whose names are valid variable names (lowercase, not a function or constant) can be referenced.
+        /// @param expression Expression to evaluate, e.g. "price*qty*(1-disc)".
+        /// @param path Path of the CSV file.
+        /// @param output Stream receiving a "result" header followed by one line per row (nan / inf outside the domain).
+        /// @param mathAccuracy Accuracy of sin, cos, exp, ln, log2 and log (see FastMath.hpp).
+        /// @returns Number of rows written.
+        /// @throws invalid_argument error if the expression cannot be parsed or references no column, or the file cannot be read.
+        uint64_t evaluateCsv(const std::string& expression, const std::string& path, std::ostream& output, MathAccuracy mathAccuracy = MathAccuracy::library);
+
+        /// @brief Method for evaluating an expression over a grid and streaming the results.
+        /// @param command Table command, e.g. "table sin(x)*exp(-x/10) x=0..1000 step 1e-4" (the leading "table" is optional).
+        /// @param output Stream receiving one "x,f(x)" line per point.
+        /// @param threadCount Number of worker threads (0 uses the number of hardware threads).
+        /// @returns Number of lines written.
+        /// @throws invalid_argument error if the command or the expression cannot be parsed.
+        uint64_t tabulateExpression(const std::string& command, std::ostream& output, unsigned threadCount = 0);
+
+        /// @brief Method for solving an equation in one variable, compiling it once and refining the roots with Newton's method
+        /// (exact derivatives) safeguarded by Brent's method.
+        /// @param command Solve command, where the range is a starting guess, a bracket, or a grid searched for every root, e.g.
+        /// "solve cos(x) = x x=0.5", "solve x^3 = 2 x=0..2" or "solve sin(x) = 0.5 x=0..20 step 0.1" (the leading "solve" is optional,
+        /// and "= 0" may be left out).
+        /// @returns The roots, in increasing order of the grid for grids.
+        /// @throws invalid_argument error if the command or the expression cannot be parsed, or no root has been found from a guess or in a bracket.
+        std::vector<EquationRoot> solveEquation(const std::string& command);
+
+        /// @brief Method for integrating an expression of one variable over a finite range with adaptive Gauss-Kronrod quadrature.
+        /// @param command Integral such as "integrate(sin(x)^2, x, 0, 2*pi)" or "integrate(sin(x)^2, x=0..2*pi)", where the limits may be
+        /// constant expressions.
+        /// @param relativeTolerance Requested error, relative to the integral of the absolute value of the expression.
+        /// @param maximumEvaluations Budget of evaluations of the expression.
+        /// @returns The integral, its error estimate and the work spent (isConverged is false if the budget ran out).
+        /// @throws invalid_argument error if the command or the expression cannot be parsed, a limit is not finite,
+        /// or the expression is not finite somewhere on the range.
+        IntegrationResult integrateExpression(const std::string& command, double relativeTolerance = 1e-10, uint64_t maximumEvaluations = 1 << 20);
+
+        /// @brief Method for evaluating an expression read from a stream in chunks, without storing its tokens.
+        /// Operators are applied as soon as the shunting-yard emits them, in full double precision.
+        /// @param input Stream holding the expression, e.g. a generated file of hundreds of MB.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if the expression cannot be parsed or evaluated.
+        StreamingValue evaluateStream(std::istream& input);
+
+        /// @brief Method for creating an evaluator re-parsing an expression only from its first edited character, used to preview
+        /// the value of an expression while it is typed. Like evaluateStream(), session variables and cells are not visible.
+        /// @returns The evaluator, which must not outlive the calculator.
+        IncrementalEvaluator createIncrementalEvaluator() const;
+
+        /// @brief Method for evaluating a scalar expression on another thread, e.g. to serve requests without blocking on a pathological one.
+        /// The interpreter charges one step per instruction (and per instruction of called user functions) and checks the
+        /// limits every few hundred steps. The operator tables and the user functions are copied when the call is made, so the task
+        /// never touches the calculator: it may be destroyed, or its functions redefined, while the evaluation runs.
+        /// Session variables are not visible and nothing is saved to the history.
+        /// @param expression Expression to evaluate.
+        /// @param limits Step and time limits, and the token cancelling the evaluation.
+        /// @returns Future holding the value of the expression, or rethrowing invalid_argument error if the expression cannot be
+        /// parsed or evaluated, a limit has been exceeded, or the evaluation has been cancelled ("BudgetError: ...").
+        std::future<StreamingValue> evaluateAsync(const std::string& expression, const EvaluationLimits& limits = EvaluationLimits());
+
+        /// @brief Method for evaluating the expression stored in a file and saving the result to the history.
+        /// @param path Path of the file.
+        /// @throws invalid_argument error if the file cannot be opened, or the expression cannot be parsed or evaluated.
+        void evaluateFile(const std::string& path);
+
+        /// @brief Method for parsing the user input into postfix bytecode and evaluating it.
         /// @throws invalid_argument error if the expression cannot be evaluated.
         void evaluatePostfixNotation();
 
-        /// @brief Method for querying the user for an input string.
+        /// @brief Method for querying the user for an input string. On a terminal, the line is edited one keystroke at a time
+        /// and the value of the expression is previewed after every edit.
         void getExpressionFromUser();
 
         /// @brief Method for printing user history.
         void printHistory();
 
+        /// @brief Method for exporting the history to a file, oldest entry first, with results that read back exactly.
+        /// @param path Path of the file. ".json" files are written as JSON, other files as CSV.
+        /// @returns Number of entries written.
+        /// @throws invalid_argument error if the file cannot be written.
+        uint64_t exportHistory(const std::string& path);
+
         /// @brief Method for undoing an evaluation.
         /// @returns true if the undo action is successful. Returns false otherwise. 
         bool undoOperation();
@@ -102,6 +318,9 @@ class Calculator {
         /// @brief Method for clearing all saved user logs.
         void clearHistory();
 
+        /// @brief Method for resetting the member attributes required for calculations.
+        void reset();
+
         /// @brief Destructor for the calculator class.
         ~Calculator();
 
@@ -239,4 +458,36 @@ double modulo(double divisor, double dividend);
 /// @returns -(operand).
 double negate(double operand);
 
+/// @brief Unchecked kernel for the secant of an angle in radian(s).
+/// @param angle Input angle.
+/// @return 1 / cos(angle), inf if cos(angle) == 0.
+double uncheckedSecant(double angle);
+
+/// @brief Unchecked kernel for the cosecant of an angle in radian(s).
+/// @param angle Input angle.
+/// @return 1 / sin(angle), inf if sin(angle) == 0.
+double uncheckedCosecant(double angle);
+
+/// @brief Unchecked kernel for the cotangent of an angle in radian(s).
+/// @param angle Input angle.
+/// @return cos(angle) / sin(angle), inf if sin(angle) == 0.
+double uncheckedCotangent(double angle);
+
+/// @brief Unchecked kernel for the factorial of a number.
+/// @param operand Input operand.
+/// @return (operand)!, nan if operand < 0 or operand is not an integer, inf if the result overflows.
+double uncheckedFactorial(double operand);
+
+/// @brief Unchecked kernel for the logarithm of a number with a specified base.
+/// @param base Specified logarithm base.
+/// @param power Input operand.
+/// @return log2(power) / log2(base), nan or inf outside the domain.
+double uncheckedLogarithm(double base, double power);
+
+/// @brief Unchecked kernel for dividing two operands.
+/// @param numerator Dividend operand.
+/// @param denominator Divisor operand.
+/// @return numerator / denominator, inf or nan if denominator == 0.
+double uncheckedDivide(double numerator, double denominator);
+
 #endif
\ No newline at end of file
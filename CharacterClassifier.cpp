@@ -0,0 +1,123 @@
+#include "CharacterClassifier.hpp"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define CHARACTER_CLASSIFIER_SSE2
+#if defined(__GNUC__)
+#define CHARACTER_CLASSIFIER_AVX2
+#endif
+#endif
+
+namespace {
+
+/// @brief Classes of characters skipped in bulk.
+enum class CharacterClass { whitespace, digit, lowercaseLetter };
+
+/// @brief Function for testing whether a character belongs to a class.
+template <CharacterClass characterClass>
+inline bool isInClass(unsigned char character) {
+    if constexpr (characterClass == CharacterClass::whitespace) return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+    if constexpr (characterClass == CharacterClass::digit) return static_cast<unsigned char>(character - '0') <= 9;
+    return static_cast<unsigned char>(character - 'a') <= 25;
+}
+
+/// @brief Function for skipping the characters of a class one at a time.
+template <CharacterClass characterClass>
+size_t skipScalar(const char* characters, size_t index, size_t length) {
+    while (index < length && isInClass<characterClass>(characters[index])) index++;
+    return index;
+}
+
+#ifdef CHARACTER_CLASSIFIER_SSE2
+/// @brief Function for computing the mask of the bytes of a 16-byte block belonging to a class (0xff for members).
+template <CharacterClass characterClass>
+inline __m128i classifyBlock(__m128i block) {
+    if constexpr (characterClass == CharacterClass::whitespace) {
+        __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\t')));
+        __m128i newlines = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+        return _mm_or_si128(spaces, newlines);
+    }
+
+    // Shift the range to start at 0, then test (unsigned) offset <= range size - 1 with an unsigned minimum.
+    constexpr char first = (characterClass == CharacterClass::digit) ? '0' : 'a';
+    constexpr char last = (characterClass == CharacterClass::digit) ? 9 : 25;
+    __m128i offset = _mm_sub_epi8(block, _mm_set1_epi8(first));
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(last)), offset);
+}
+
+/// @brief Function for skipping the characters of a class 16 at a time.
+template <CharacterClass characterClass>
+size_t skipSse2(const char* characters, size_t index, size_t length) {
+    for (; index + 16 <= length; index += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + index));
+        uint32_t outsideMask = ~static_cast<uint32_t>(_mm_movemask_epi8(classifyBlock<characterClass>(block))) & 0xffffu;
+        if (outsideMask != 0) return index + std::countr_zero(outsideMask);
+    }
+    return skipScalar<characterClass>(characters, index, length);
+}
+#endif
+
+#ifdef CHARACTER_CLASSIFIER_AVX2
+/// @brief Function for computing the mask of the bytes of a 32-byte block belonging to a class (0xff for members).
+template <CharacterClass characterClass>
+__attribute__((target("avx2"))) inline __m256i classifyBlock(__m256i block) {
+    if constexpr (characterClass == CharacterClass::whitespace) {
+        __m256i spaces = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')));
+        __m256i newlines = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')));
+        return _mm256_or_si256(spaces, newlines);
+    }
+
+    constexpr char first = (characterClass == CharacterClass::digit) ? '0' : 'a';
+    constexpr char last = (characterClass == CharacterClass::digit) ? 9 : 25;
+    __m256i offset = _mm256_sub_epi8(block, _mm256_set1_epi8(first));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(last)), offset);
+}
+
+/// @brief Function for skipping the characters of a class 32 at a time.
+template <CharacterClass characterClass>
+__attribute__((target("avx2"))) size_t skipAvx2(const char* characters, size_t index, size_t length) {
+    for (; index + 32 <= length; index += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(characters + index));
+        uint32_t outsideMask = ~static_cast<uint32_t>(_mm256_movemask_epi8(classifyBlock<characterClass>(block)));
+        if (outsideMask != 0) return index + std::countr_zero(outsideMask);
+    }
+
+    // Clear the upper halves of the registers before running SSE code, since the tail call skips the compiler's vzeroupper.
+    _mm256_zeroupper();
+    return skipSse2<characterClass>(characters, index, length);
+}
+
+/// @brief Whether the processor supports AVX2, checked once.
+const bool isAvx2Supported = __builtin_cpu_supports("avx2");
+#endif
+
+/// @brief Function for skipping the characters of a class with the widest available instructions.
+template <CharacterClass characterClass>
+inline size_t skipCharacters(const char* characters, size_t index, size_t length) {
+    // Short runs (e.g. the digits of small numbers) end within the first bytes, so test them before loading a block.
+    if (index >= length || !isInClass<characterClass>(characters[index])) return index;
+#if defined(CHARACTER_CLASSIFIER_AVX2)
+    if (isAvx2Supported) return skipAvx2<characterClass>(characters, index, length);
+#endif
+#if defined(CHARACTER_CLASSIFIER_SSE2)
+    return skipSse2<characterClass>(characters, index, length);
+#else
+    return skipScalar<characterClass>(characters, index, length);
+#endif
+}
+
+}
+
+size_t skipWhitespace(const char* characters, size_t index, size_t length) {
+    return skipCharacters<CharacterClass::whitespace>(characters, index, length);
+}
+
+size_t skipDigits(const char* characters, size_t index, size_t length) {
+    return skipCharacters<CharacterClass::digit>(characters, index, length);
+}
+
+size_t skipLowercaseLetters(const char* characters, size_t index, size_t length) {
+    return skipCharacters<CharacterClass::lowercaseLetter>(characters, index, length);
+}
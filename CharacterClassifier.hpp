@@ -0,0 +1,32 @@
+#ifndef __CHARACTER_CLASSIFIER
+#define __CHARACTER_CLASSIFIER
+
+#include <cstddef>
+#include <cstdint>
+
+/// Functions classifying the characters of an expression in blocks, used by the tokenizers to skip runs of characters in bulk.
+/// On x86-64, blocks of 32 bytes are classified with AVX2 when the processor supports it (checked once at run time),
+/// and blocks of 16 bytes with SSE2 otherwise. Other targets, and the bytes past the last full block, use a scalar loop.
+
+/// @brief Function for skipping a run of whitespace (' ', '\t', '\n', '\r').
+/// @param characters Pointer to the characters.
+/// @param index Index of the first character to test.
+/// @param length Number of characters.
+/// @returns Index of the first character that is not whitespace, or length.
+size_t skipWhitespace(const char* characters, size_t index, size_t length);
+
+/// @brief Function for skipping a run of decimal digits.
+/// @param characters Pointer to the characters.
+/// @param index Index of the first character to test.
+/// @param length Number of characters.
+/// @returns Index of the first character that is not a digit, or length.
+size_t skipDigits(const char* characters, size_t index, size_t length);
+
+/// @brief Function for skipping a run of lowercase letters (the characters of function, constant and variable names).
+/// @param characters Pointer to the characters.
+/// @param index Index of the first character to test.
+/// @param length Number of characters.
+/// @returns Index of the first character that is not a lowercase letter, or length.
+size_t skipLowercaseLetters(const char* characters, size_t index, size_t length);
+
+#endif
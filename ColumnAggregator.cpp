@@ -0,0 +1,113 @@
+#include "ColumnAggregator.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+/// @brief Function for adding a term to a sum while accumulating the rounding error (Neumaier's variant of Kahan summation).
+/// @param sum Reference to the running sum.
+/// @param compensation Reference to the accumulated rounding error.
+/// @param term Term to add.
+static inline void addCompensated(double& sum, double& compensation, double term) {
+    double newSum = sum + term;
+    compensation += (std::fabs(sum) >= std::fabs(term)) ? (sum - newSum) + term : (term - newSum) + sum;
+    sum = newSum;
+}
+
+void ColumnAggregator::PartialAggregate::add(double value) {
+    this->count++;
+    addCompensated(this->sum, this->compensation, value);
+    this->minimum = std::fmin(this->minimum, value);
+    this->maximum = std::fmax(this->maximum, value);
+
+    // Update the running mean and the squared deviations from it.
+    double delta = value - this->mean;
+    this->mean += delta / static_cast<double>(this->count);
+    this->squaredDeviationSum += delta * (value - this->mean);
+}
+
+void ColumnAggregator::PartialAggregate::merge(const PartialAggregate& other) {
+    // Merging an empty partial result changes nothing, and merging into one copies the other.
+    if (other.count == 0) return;
+    if (this->count == 0) {
+        *this = other;
+        return;
+    }
+
+    // Combine the deviations around the two means (Chan et al.), then the sums and extrema.
+    double totalCount = static_cast<double>(this->count + other.count);
+    double delta = other.mean - this->mean;
+    this->mean += delta * static_cast<double>(other.count) / totalCount;
+    this->squaredDeviationSum += other.squaredDeviationSum + delta * delta * static_cast<double>(this->count) * static_cast<double>(other.count) / totalCount;
+    this->count += other.count;
+    addCompensated(this->sum, this->compensation, other.sum);
+    addCompensated(this->sum, this->compensation, other.compensation);
+    this->minimum = std::fmin(this->minimum, other.minimum);
+    this->maximum = std::fmax(this->maximum, other.maximum);
+}
+
+ColumnAggregator::ColumnAggregator(const CompiledExpression& program, WorkStealingThreadPool& pool) : program(program), pool(pool) {
+    // Check if the program is a function of exactly one variable.
+    if (program.getVariableNames().size() != 1) throw std::invalid_argument("EvalError: Aggregates require an expression of exactly one variable.\n");
+}
+
+ColumnAggregator::PartialAggregate ColumnAggregator::aggregateChunk(const CsvReader& reader, const CsvChunk& chunk, size_t column) const {
+    // Allocate the buffers once per chunk.
+    PartialAggregate partial;
+    std::vector<double> registers(this->program.getRegisterCount()), values;
+    values.reserve(rowsPerBlock);
+    const std::vector<size_t> columns = {column};
+
+    // Parse a block of rows, then evaluate the program on each value while the block is in cache.
+    for (size_t position = chunk.begin; position < chunk.end;) {
+        position = reader.parseRows(position, chunk.end, columns, rowsPerBlock, values);
+        for (double value : values) partial.add(this->program.evaluate(&value, registers.data()));
+    }
+    return partial;
+}
+
+double ColumnAggregator::aggregate(AggregateFunction function, const std::string& path, const std::string& columnName) {
+    // Map the file and split its rows into chunks.
+    CsvReader reader(path);
+    size_t column = reader.findColumn(columnName);
+    std::vector<CsvChunk> chunks = reader.splitIntoChunks(bytesPerChunk);
+
+    // Reduce the chunks in parallel, each into its own partial result.
+    std::vector<PartialAggregate> partials(chunks.size());
+    this->pool.parallelFor(0, chunks.size(), 1, [&](size_t firstChunk, size_t lastChunk) {
+        for (size_t chunk = firstChunk; chunk < lastChunk; chunk++) partials[chunk] = this->aggregateChunk(reader, chunks[chunk], column);
+    });
+
+    // Merge the partial results in file order, so the rounding does not depend on the scheduling.
+    PartialAggregate total;
+    for (const PartialAggregate& partial : partials) total.merge(partial);
+    this->valueCount = total.count;
+
+    // Throw invalid_argument error if a reduction other than the sum has no value to reduce.
+    if (total.count == 0 && function != AggregateFunction::sum) {
+        std::string errorMessage = "EvalError: Column " + columnName;
+        errorMessage += " of " + path + " has no values to aggregate.\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    switch (function) {
+        case AggregateFunction::sum:
+            return total.sum + total.compensation;
+
+        case AggregateFunction::mean:
+            return (total.sum + total.compensation) / static_cast<double>(total.count);
+
+        case AggregateFunction::minimum:
+            return total.minimum;
+
+        case AggregateFunction::maximum:
+            return total.maximum;
+
+        case AggregateFunction::standardDeviation:
+            return std::sqrt(total.squaredDeviationSum / static_cast<double>(total.count));
+    }
+    return NAN;
+}
+
+uint64_t ColumnAggregator::getValueCount() const {
+    return this->valueCount;
+}
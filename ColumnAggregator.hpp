@@ -0,0 +1,99 @@
+#ifndef __COLUMN_AGGREGATOR
+#define __COLUMN_AGGREGATOR
+
+#include "ExpressionCompiler.hpp"
+#include "ThreadPool.hpp"
+#include "CsvReader.hpp"
+#include <cmath>
+
+/// @brief Reductions applied by the column aggregator.
+enum class AggregateFunction : uint8_t {
+    /// @brief Compensated sum of the values (0 for an empty column).
+    sum,
+
+    /// @brief Compensated sum of the values divided by their number.
+    mean,
+
+    /// @brief Smallest value.
+    minimum,
+
+    /// @brief Largest value.
+    maximum,
+
+    /// @brief Population standard deviation of the values, sqrt(sum((value - mean)^2) / count).
+    standardDeviation
+};
+
+/// @brief Class for reducing a compiled expression of one variable over a numeric column of a CSV file,
+/// e.g. "sum(x^2, x in data.csv:price)". The file is memory-mapped and split into chunks of rows reduced in parallel,
+/// each chunk parsing its fields in blocks and keeping its own partial result, so memory use does not depend on the file size.
+/// Sums use compensated (Neumaier) summation and the deviations use Welford's update, and the partial results are merged
+/// in file order, so the result does not depend on the number of threads.
+class ColumnAggregator {
+    public:
+        /// @brief Constructor for the column aggregator class.
+        /// @param program Compiled expression of exactly one variable, evaluated on every value of the column.
+        /// @param pool Thread pool reducing the chunks.
+        /// @throws invalid_argument error if the program does not have exactly one variable.
+        ColumnAggregator(const CompiledExpression& program, WorkStealingThreadPool& pool = WorkStealingThreadPool::getSharedPool());
+
+        /// @brief Method for reducing the program over a column.
+        /// @param function Reduction to apply.
+        /// @param path Path of the CSV file.
+        /// @param columnName Name of the column bound to the variable of the program.
+        /// @returns The reduced value.
+        /// @throws invalid_argument error if the file cannot be read, a field is not a number, an operator is called
+        /// outside its domain, or the column is empty (except for sums).
+        double aggregate(AggregateFunction function, const std::string& path, const std::string& columnName);
+
+        /// @brief Method for accessing the number of values reduced by the last call to aggregate().
+        uint64_t getValueCount() const;
+
+    private:
+        /// @brief Size of the chunks of rows reduced by a single task, in bytes.
+        static constexpr size_t bytesPerChunk = 1 << 20;
+
+        /// @brief Number of rows parsed at once before evaluating the program on them.
+        static constexpr size_t rowsPerBlock = 4096;
+
+        /// @brief Partial result of the reduction of some values.
+        struct PartialAggregate {
+            /// @brief Number of values.
+            uint64_t count = 0;
+
+            /// @brief Sum of the values and the running compensation of its rounding errors.
+            double sum = 0, compensation = 0;
+
+            /// @brief Smallest and largest value.
+            double minimum = HUGE_VAL, maximum = -HUGE_VAL;
+
+            /// @brief Running mean and sum of the squared deviations from it (Welford).
+            double mean = 0, squaredDeviationSum = 0;
+
+            /// @brief Method for adding a value.
+            /// @param value Value to add.
+            void add(double value);
+
+            /// @brief Method for merging the partial result of the values following these ones (Chan et al.).
+            /// @param other Partial result to merge.
+            void merge(const PartialAggregate& other);
+        };
+
+        /// @brief Program evaluated on every value.
+        const CompiledExpression& program;
+
+        /// @brief Thread pool reducing the chunks.
+        WorkStealingThreadPool& pool;
+
+        /// @brief Number of values reduced by the last call to aggregate().
+        uint64_t valueCount = 0;
+
+        /// @brief Private method for reducing one chunk of rows.
+        /// @param reader Reader of the file.
+        /// @param chunk Rows to reduce.
+        /// @param column Index of the column bound to the variable.
+        /// @returns The partial result of the chunk.
+        PartialAggregate aggregateChunk(const CsvReader& reader, const CsvChunk& chunk, size_t column) const;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "CsvColumnEvaluator.hpp"
+
+#include <cmath>
+#include <charconv>
+#include <stdexcept>
+#include <algorithm>
+
+CsvColumnEvaluator::CsvColumnEvaluator(const CompiledExpression& program, WorkStealingThreadPool& pool) : program(program), pool(pool) {
+    // Check if the program reads at least one column, which is what determines the number of rows.
+    if (program.getVariableNames().empty()) throw std::invalid_argument("EvalError: CSV evaluation requires an expression of at least one column.\n");
+}
+
+CsvColumnEvaluator::FormattedChunk CsvColumnEvaluator::evaluateChunk(const CsvReader& reader, const CsvChunk& chunk, const std::vector<size_t>& columns) const {
+    // Allocate the buffers once per chunk: the parsed rows, one block per variable, the block registers and the results.
+    size_t variableCount = columns.size();
+    std::vector<double> values, variableBlocks(variableCount * rowsPerBlock), registers(this->program.getRegisterCount() * rowsPerBlock), results(rowsPerBlock);
+    std::vector<const double*> variableColumns(variableCount);
+    for (size_t slot = 0; slot < variableCount; slot++) variableColumns[slot] = variableBlocks.data() + slot * rowsPerBlock;
+    values.reserve(variableCount * rowsPerBlock);
+
+    FormattedChunk formattedChunk;
+    for (size_t position = chunk.begin; position < chunk.end;) {
+        // Parse a block of rows, then transpose the fields into one contiguous block per variable.
+        position = reader.parseRows(position, chunk.end, columns, rowsPerBlock, values);
+        size_t rowCount = values.size() / variableCount;
+        for (size_t row = 0; row < rowCount; row++) {
+            for (size_t slot = 0; slot < variableCount; slot++) variableBlocks[slot * rowsPerBlock + row] = values[row * variableCount + slot];
+        }
+
+        // Evaluate the whole block. Domain errors of checked programs only tell which rows failed by evaluating them one by one.
+        try {
+            this->program.evaluateBlock(variableColumns.data(), rowCount, registers.data(), results.data());
+        } catch (std::exception&) {
+            for (size_t row = 0; row < rowCount; row++) {
+                try {
+                    results[row] = this->program.evaluate(&values[row * variableCount], registers.data());
+                } catch (std::exception&) {
+                    results[row] = NAN;
+                }
+            }
+        }
+
+        // Write the results using the shortest representation that round-trips, and nan without the sign the hardware gives it.
+        size_t length = formattedChunk.text.size();
+        formattedChunk.text.resize(length + rowCount * charactersPerRow);
+        char* first = formattedChunk.text.data() + length;
+        char* last = formattedChunk.text.data() + formattedChunk.text.size();
+        for (size_t row = 0; row < rowCount; row++) {
+            first = std::to_chars(first, last, std::isnan(results[row]) ? NAN : results[row]).ptr;
+            *first++ = '\n';
+        }
+        formattedChunk.text.resize(static_cast<size_t>(first - formattedChunk.text.data()));
+        formattedChunk.rowCount += rowCount;
+    }
+    return formattedChunk;
+}
+
+uint64_t CsvColumnEvaluator::evaluate(const std::string& path, std::ostream& output) {
+    // Map the file, find the columns of the variables, and split the rows into chunks.
+    CsvReader reader(path);
+    std::vector<size_t> columns;
+    for (const std::string& variableName : this->program.getVariableNames()) columns.push_back(reader.findColumn(variableName));
+    std::vector<CsvChunk> chunks = reader.splitIntoChunks(bytesPerChunk);
+
+    // Evaluate the chunks in rounds of a few chunks per thread, keeping two rounds of buffers:
+    // one is written by this thread while the pool fills the other one.
+    size_t chunksPerRound = 2 * static_cast<size_t>(this->pool.getThreadCount());
+    std::vector<FormattedChunk> rounds[2];
+    auto evaluateRound = [&](size_t firstChunk, std::vector<FormattedChunk>& formattedChunks) {
+        size_t lastChunk = std::min(firstChunk + chunksPerRound, chunks.size());
+        formattedChunks.assign(lastChunk - firstChunk, FormattedChunk());
+        this->pool.parallelFor(firstChunk, lastChunk, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; chunk++) formattedChunks[chunk - firstChunk] = this->evaluateChunk(reader, chunks[chunk], columns);
+        });
+    };
+
+    // Write the header, then every round in file order.
+    uint64_t rowCount = 0;
+    output << "result\n";
+    if (!chunks.empty()) evaluateRound(0, rounds[0]);
+    for (size_t firstChunk = 0, round = 0; firstChunk < chunks.size(); firstChunk += chunksPerRound, round++) {
+        std::vector<FormattedChunk>& current = rounds[round % 2];
+        std::vector<FormattedChunk>& next = rounds[(round + 1) % 2];
+        this->pool.invokeInParallel(
+            [&]() { if (firstChunk + chunksPerRound < chunks.size()) evaluateRound(firstChunk + chunksPerRound, next); },
+            [&]() {
+                for (const FormattedChunk& formattedChunk : current) {
+                    output.write(formattedChunk.text.data(), static_cast<std::streamsize>(formattedChunk.text.size()));
+                    rowCount += formattedChunk.rowCount;
+                }
+            }
+        );
+    }
+    output.flush();
+    return rowCount;
+}
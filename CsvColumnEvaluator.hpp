@@ -0,0 +1,63 @@
+#ifndef __CSV_COLUMN_EVALUATOR
+#define __CSV_COLUMN_EVALUATOR
+
+#include "ExpressionCompiler.hpp"
+#include "ThreadPool.hpp"
+#include "CsvReader.hpp"
+#include <ostream>
+
+/// @brief Class for evaluating a compiled expression on every row of a CSV file, with the variables bound to the columns
+/// of the same name, and streaming the results as a single-column CSV file.
+/// The file is memory-mapped and split into chunks of rows evaluated in parallel. Each chunk parses its fields in blocks,
+/// evaluates the program once per block with SIMD kernels, and formats the results into its own buffer with to_chars.
+/// Buffers are written in file order while the next chunks are evaluated, so memory use does not depend on the file size.
+class CsvColumnEvaluator {
+    public:
+        /// @brief Constructor for the CSV column evaluator class.
+        /// @param program Compiled expression whose variables are named like columns of the file.
+        /// @param pool Thread pool evaluating the chunks.
+        /// @throws invalid_argument error if the program has no variables.
+        CsvColumnEvaluator(const CompiledExpression& program, WorkStealingThreadPool& pool = WorkStealingThreadPool::getSharedPool());
+
+        /// @brief Method for evaluating the program on every row and writing a "result" header followed by one line per row.
+        /// Rows outside the domain of an operator are written as nan (or inf for unchecked programs).
+        /// @param path Path of the CSV file.
+        /// @param output Stream receiving the lines.
+        /// @returns Number of rows written.
+        /// @throws invalid_argument error if the file cannot be read, lacks a column, or a field is not a number.
+        uint64_t evaluate(const std::string& path, std::ostream& output);
+
+    private:
+        /// @brief Size of the chunks of rows evaluated by a single task, in bytes.
+        static constexpr size_t bytesPerChunk = 1 << 20;
+
+        /// @brief Number of rows evaluated at once, small enough for the registers of the block to stay in cache.
+        static constexpr size_t rowsPerBlock = 1024;
+
+        /// @brief Upper bound of the number of characters written per row.
+        static constexpr size_t charactersPerRow = 32;
+
+        /// @brief Rows of a chunk formatted into characters.
+        struct FormattedChunk {
+            /// @brief Lines of the chunk.
+            std::string text;
+
+            /// @brief Number of lines.
+            uint64_t rowCount = 0;
+        };
+
+        /// @brief Program evaluated on every row.
+        const CompiledExpression& program;
+
+        /// @brief Thread pool evaluating the chunks.
+        WorkStealingThreadPool& pool;
+
+        /// @brief Private method for evaluating and formatting one chunk of rows.
+        /// @param reader Reader of the file.
+        /// @param chunk Rows to evaluate.
+        /// @param columns Indices of the columns bound to the variables, ordered by their slot.
+        /// @returns The formatted rows.
+        FormattedChunk evaluateChunk(const CsvReader& reader, const CsvChunk& chunk, const std::vector<size_t>& columns) const;
+};
+
+#endif
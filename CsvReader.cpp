@@ -0,0 +1,141 @@
+#include "CsvReader.hpp"
+
+#include <cstring>
+#include <charconv>
+#include <stdexcept>
+#include <algorithm>
+
+/// @brief Function for removing the spaces and the double quotes surrounding a field.
+/// @param first Reference to the first character of the field.
+/// @param last Reference to the character past the field.
+static void trimField(const char*& first, const char*& last) {
+    while (first < last && (*first == ' ' || *first == '\t')) first++;
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) last--;
+    if (last - first >= 2 && *first == '"' && last[-1] == '"') {
+        first++;
+        last--;
+    }
+}
+
+CsvReader::CsvReader(const std::string& path) : file(path), path(path) {
+    // Find the end of the header line.
+    const char* data = this->file.getData();
+    size_t size = this->file.getSize();
+    const char* headerEnd = (size == 0) ? nullptr : static_cast<const char*>(std::memchr(data, '\n', size));
+    if (headerEnd == nullptr) headerEnd = data + size;
+    this->firstRowOffset = std::min(static_cast<size_t>(headerEnd - data) + 1, size);
+
+    // Split the header into the column names.
+    const char* field = data;
+    while (field != nullptr && field <= headerEnd) {
+        const char* fieldEnd = static_cast<const char*>(std::memchr(field, ',', static_cast<size_t>(headerEnd - field)));
+        if (fieldEnd == nullptr) fieldEnd = headerEnd;
+        const char* first = field;
+        const char* last = fieldEnd;
+        trimField(first, last);
+        this->columnNames.emplace_back(first, last);
+        field = fieldEnd + 1;
+    }
+
+    // Throw invalid_argument error if the header is empty.
+    if (this->columnNames.empty() || (this->columnNames.size() == 1 && this->columnNames[0].empty())) {
+        std::string errorMessage = "CsvError: Found no header in " + path;
+        errorMessage += ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+}
+
+const std::vector<std::string>& CsvReader::getColumnNames() const {
+    return this->columnNames;
+}
+
+size_t CsvReader::findColumn(const std::string& name) const {
+    auto column = std::find(this->columnNames.begin(), this->columnNames.end(), name);
+    if (column == this->columnNames.end()) {
+        std::string errorMessage = "CsvError: Failed to find column " + name;
+        errorMessage += " in " + this->path + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+    return static_cast<size_t>(column - this->columnNames.begin());
+}
+
+std::vector<CsvChunk> CsvReader::splitIntoChunks(size_t chunkSize) const {
+    const char* data = this->file.getData();
+    size_t size = this->file.getSize();
+
+    // Cut the rows every chunkSize bytes, moving each cut past the end of the line it falls in.
+    std::vector<CsvChunk> chunks;
+    for (size_t begin = this->firstRowOffset; begin < size;) {
+        size_t end = std::min(begin + std::max<size_t>(chunkSize, 1), size);
+        if (end < size) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(data + end, '\n', size - end));
+            end = (lineEnd == nullptr) ? size : static_cast<size_t>(lineEnd - data) + 1;
+        }
+        chunks.push_back({begin, end});
+        begin = end;
+    }
+    return chunks;
+}
+
+size_t CsvReader::parseRows(size_t position, size_t end, const std::vector<size_t>& columns, size_t maximumRowCount, std::vector<double>& values) const {
+    const char* data = this->file.getData();
+    values.clear();
+    if (columns.empty()) return end;
+
+    // Map every field index up to the last requested column to its position inside a row of values (-1 if not requested).
+    size_t lastColumn = *std::max_element(columns.begin(), columns.end());
+    std::vector<int64_t> fieldSlots(lastColumn + 1, -1);
+    for (size_t slot = 0; slot < columns.size(); slot++) fieldSlots[columns[slot]] = static_cast<int64_t>(slot);
+
+    for (size_t rowCount = 0; position < end && rowCount < maximumRowCount;) {
+        // Find the end of the line, then skip empty lines.
+        const char* line = data + position;
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - position));
+        size_t nextPosition = (lineEnd == nullptr) ? end : static_cast<size_t>(lineEnd - data) + 1;
+        if (lineEnd == nullptr) lineEnd = data + end;
+        if (lineEnd == line || (lineEnd - line == 1 && *line == '\r')) {
+            position = nextPosition;
+            continue;
+        }
+
+        // Walk the fields up to the last requested column, parsing the requested ones.
+        size_t rowOffset = values.size();
+        values.resize(rowOffset + columns.size());
+        const char* field = line;
+        size_t fieldIndex = 0;
+        for (; fieldIndex <= lastColumn && field <= lineEnd; fieldIndex++) {
+            const char* fieldEnd = static_cast<const char*>(std::memchr(field, ',', static_cast<size_t>(lineEnd - field)));
+            if (fieldEnd == nullptr) fieldEnd = lineEnd;
+
+            if (fieldSlots[fieldIndex] >= 0) {
+                // Parse the number, accepting an explicit '+' sign which from_chars does not.
+                const char* first = field;
+                const char* last = fieldEnd;
+                trimField(first, last);
+                if (first < last && *first == '+') first++;
+                double& value = values[rowOffset + static_cast<size_t>(fieldSlots[fieldIndex])];
+                std::from_chars_result result = std::from_chars(first, last, value);
+                if (first == last || result.ec != std::errc() || result.ptr != last) {
+                    std::string reason = "found \"" + std::string(field, fieldEnd);
+                    reason += "\" in column " + this->columnNames[fieldIndex];
+                    throw this->makeRowError(position, "Failed to parse number (" + reason + ")");
+                }
+            }
+            field = fieldEnd + 1;
+        }
+
+        // Throw invalid_argument error if the row ended before the last requested column.
+        if (fieldIndex <= lastColumn) throw this->makeRowError(position, "Found " + std::to_string(fieldIndex) + " field(s), expected at least " + std::to_string(lastColumn + 1));
+        rowCount++;
+        position = nextPosition;
+    }
+    return position;
+}
+
+std::invalid_argument CsvReader::makeRowError(size_t offset, const std::string& reason) const {
+    // Count the lines before the row, which is only done once an error occurred.
+    size_t lineNumber = 1 + static_cast<size_t>(std::count(this->file.getData(), this->file.getData() + offset, '\n'));
+    std::string errorMessage = "CsvError: " + reason;
+    errorMessage += " at line " + std::to_string(lineNumber) + " of " + this->path + ".\n";
+    return std::invalid_argument(errorMessage);
+}
@@ -0,0 +1,73 @@
+#ifndef __CSV_READER
+#define __CSV_READER
+
+#include "MappedFile.hpp"
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+/// @brief Range of bytes of a CSV file holding whole rows, from the start of a line to the start of another line (or the end).
+struct CsvChunk {
+    /// @brief Offset of the first byte of the chunk.
+    size_t begin;
+
+    /// @brief Offset past the last byte of the chunk.
+    size_t end;
+};
+
+/// @brief Reader for numeric CSV files, parsing fields with from_chars directly from a memory map of the file.
+/// The first line holds the column names. Fields are separated by ',', may be surrounded by spaces or double quotes,
+/// and lines may end with "\n" or "\r\n". Empty lines are skipped. Quoted fields cannot contain ',' or line breaks.
+/// The rows can be split into chunks parsed independently, e.g. by different threads.
+class CsvReader {
+    public:
+        /// @brief Constructor for the CSV reader class. Maps the file and parses its header.
+        /// @param path Path of the file.
+        /// @throws invalid_argument error if the file cannot be opened or has no header.
+        explicit CsvReader(const std::string& path);
+
+        /// @brief Method for accessing the names of the columns, ordered like the fields of a row.
+        const std::vector<std::string>& getColumnNames() const;
+
+        /// @brief Method for finding a column by name.
+        /// @param name Name of the column.
+        /// @returns Index of the column.
+        /// @throws invalid_argument error if the file has no such column.
+        size_t findColumn(const std::string& name) const;
+
+        /// @brief Method for splitting the rows into chunks of about the given size.
+        /// @param chunkSize Size of a chunk in bytes, rounded up to the end of the line.
+        /// @returns The chunks, in file order.
+        std::vector<CsvChunk> splitIntoChunks(size_t chunkSize) const;
+
+        /// @brief Method for parsing the given columns of the next rows of a chunk.
+        /// @param position Offset of the first row to parse (the start of a line).
+        /// @param end Offset past the last byte to parse.
+        /// @param columns Indices of the columns to parse.
+        /// @param maximumRowCount Largest number of rows to parse.
+        /// @param values Vector receiving the fields row by row, in the order of columns (cleared first).
+        /// @returns Offset of the first row not parsed yet (end once the chunk is exhausted).
+        /// @throws invalid_argument error if a row has too few fields or a field is not a number.
+        size_t parseRows(size_t position, size_t end, const std::vector<size_t>& columns, size_t maximumRowCount, std::vector<double>& values) const;
+
+    private:
+        /// @brief Memory map of the file.
+        MappedFile file;
+
+        /// @brief Path of the file, used by error messages.
+        std::string path;
+
+        /// @brief Names of the columns.
+        std::vector<std::string> columnNames;
+
+        /// @brief Offset of the first row following the header.
+        size_t firstRowOffset = 0;
+
+        /// @brief Private method for building the error thrown for a malformed row.
+        /// @param offset Offset of a character of the row.
+        /// @param reason Description of the problem.
+        /// @returns The error, naming the line of the file.
+        std::invalid_argument makeRowError(size_t offset, const std::string& reason) const;
+};
+
+#endif
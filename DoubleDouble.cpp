@@ -0,0 +1,878 @@
+#include "DoubleDouble.hpp"
+
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <charconv>
+#include <limits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define DOUBLE_DOUBLE_VECTORS
+#endif
+
+namespace {
+
+#ifdef DOUBLE_DOUBLE_VECTORS
+/// @brief Lanes of 2 and 4 doubles, and the matching lanes of bits. The kernels are written once with the vector extensions
+/// of GCC / Clang, which lower them to SSE2 and, inside target("avx2,fma") functions, to AVX2 and FMA.
+typedef double DoublePair __attribute__((vector_size(16)));
+typedef uint64_t BitsPair __attribute__((vector_size(16)));
+typedef double DoubleQuad __attribute__((vector_size(32)));
+typedef uint64_t BitsQuad __attribute__((vector_size(32)));
+
+/// @brief Kernels are always inlined, so that they are compiled for the instruction set of the loop calling them.
+#define DOUBLE_DOUBLE_INLINE __attribute__((always_inline)) inline
+
+// Kernels take 4-double lanes by value, which would change their ABI without AVX. They are never called, only inlined.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#else
+#define DOUBLE_DOUBLE_INLINE inline
+#endif
+
+/// @brief Type holding the bits of the lanes.
+template <typename Lanes> struct LaneTraits { typedef uint64_t Bits; };
+#ifdef DOUBLE_DOUBLE_VECTORS
+template <> struct LaneTraits<DoublePair> { typedef BitsPair Bits; };
+template <> struct LaneTraits<DoubleQuad> { typedef BitsQuad Bits; };
+#endif
+
+/// @brief Whether the scalar functions may use fused multiply-adds, i.e. whether the file is compiled for a processor with FMA.
+/// Otherwise they split the operands of products like the SSE2 kernels, which gives the same (exact) error terms.
+#ifdef __FMA__
+constexpr bool isFusedMultiplyAddNative = true;
+#else
+constexpr bool isFusedMultiplyAddNative = false;
+#endif
+
+/// @brief 2^27 + 1, splitting a double into two halves of 26 bits whose products are exact (Dekker).
+constexpr double splitFactor = 134217729.0;
+
+/// @brief Third parts of pi/2 and ln 2 (the first two are the double-double constants), used by the argument reductions.
+constexpr DoubleDouble doubleDoubleHalfPi = {1.5707963267948966, 6.123233995736766e-17};
+constexpr double halfPiThird = -1.4973849048591698e-33;
+constexpr DoubleDouble doubleDoubleLn2 = {0.6931471805599453, 2.3190468138462996e-17};
+constexpr double ln2Third = 5.707708438416212e-34;
+
+/// @brief log2(e) and log10(e), converting natural logarithms.
+constexpr DoubleDouble doubleDoubleLog2E = {1.4426950408889634, 2.0355273740931033e-17};
+constexpr DoubleDouble doubleDoubleLog10E = {0.4342944819032518, 1.098319650216765e-17};
+
+/// @brief Exact powers of 10 representable in double.
+constexpr double exactPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// @brief Function for computing first + second = sum + error exactly (Knuth's TwoSum).
+template <typename Lanes>
+DOUBLE_DOUBLE_INLINE void twoSum(const Lanes& first, const Lanes& second, Lanes& sum, Lanes& error) {
+    sum = first + second;
+    Lanes secondPart = sum - first;
+    error = (first - (sum - secondPart)) + (second - secondPart);
+}
+
+/// @brief Function for computing larger + smaller = sum + error exactly, given |larger| >= |smaller| (Dekker's FastTwoSum).
+template <typename Lanes>
+DOUBLE_DOUBLE_INLINE void fastTwoSum(const Lanes& larger, const Lanes& smaller, Lanes& sum, Lanes& error) {
+    sum = larger + smaller;
+    error = smaller - (sum - larger);
+}
+
+/// @brief Functions computing first * second - product exactly with fused multiply-adds. The lanes are written one at a time,
+/// which lowers to a single vfmsub instruction inside target("fma") functions.
+DOUBLE_DOUBLE_INLINE double fusedProductError(double first, double second, double product) {
+    return std::fma(first, second, -product);
+}
+#ifdef DOUBLE_DOUBLE_VECTORS
+DOUBLE_DOUBLE_INLINE DoublePair fusedProductError(const DoublePair& first, const DoublePair& second, const DoublePair& product) {
+    return DoublePair{__builtin_fma(first[0], second[0], -product[0]), __builtin_fma(first[1], second[1], -product[1])};
+}
+DOUBLE_DOUBLE_INLINE DoubleQuad fusedProductError(const DoubleQuad& first, const DoubleQuad& second, const DoubleQuad& product) {
+    return DoubleQuad{__builtin_fma(first[0], second[0], -product[0]), __builtin_fma(first[1], second[1], -product[1]),
+        __builtin_fma(first[2], second[2], -product[2]), __builtin_fma(first[3], second[3], -product[3])};
+}
+#endif
+
+/// @brief Function for computing first * second = product + error exactly (barring overflow), with a fused multiply-add or
+/// with Dekker's splitting.
+template <bool isFused, typename Lanes>
+DOUBLE_DOUBLE_INLINE void twoProduct(const Lanes& first, const Lanes& second, Lanes& product, Lanes& error) {
+    product = first * second;
+    if constexpr (isFused) {
+        error = fusedProductError(first, second, product);
+    } else {
+        Lanes firstScaled = first * splitFactor, secondScaled = second * splitFactor;
+        Lanes firstHigh = firstScaled - (firstScaled - first), secondHigh = secondScaled - (secondScaled - second);
+        Lanes firstLow = first - firstHigh, secondLow = second - secondHigh;
+        error = ((firstHigh * secondHigh - product) + firstHigh * secondLow + firstLow * secondHigh) + firstLow * secondLow;
+    }
+}
+
+/// @brief Functions computing the square root of every lane. SSE2 has a packed square root, the 4-lane form takes two of them
+/// (which the compiler merges into one AVX instruction inside target("avx2") functions).
+DOUBLE_DOUBLE_INLINE double squareRootLanes(double operand) {
+    return std::sqrt(operand);
+}
+#ifdef DOUBLE_DOUBLE_VECTORS
+DOUBLE_DOUBLE_INLINE DoublePair squareRootLanes(const DoublePair& operand) {
+    return _mm_sqrt_pd(operand);
+}
+DOUBLE_DOUBLE_INLINE DoubleQuad squareRootLanes(const DoubleQuad& operand) {
+    DoublePair lower = _mm_sqrt_pd(DoublePair{operand[0], operand[1]}), upper = _mm_sqrt_pd(DoublePair{operand[2], operand[3]});
+    return DoubleQuad{lower[0], lower[1], upper[0], upper[1]};
+}
+#endif
+
+/// @brief Function for applying a kernel to lanes of double-doubles. Unary kernels ignore the second operand.
+/// Results that are not finite (including 0/0 in the square root of 0) are left to the caller.
+template <ExtendedKernel kernel, bool isFused, typename Lanes>
+DOUBLE_DOUBLE_INLINE void applyLanes(const Lanes& firstHigh, const Lanes& firstLow, const Lanes& secondHigh, const Lanes& secondLow, Lanes& resultHigh, Lanes& resultLow) {
+    if constexpr (kernel == ExtendedKernel::add || kernel == ExtendedKernel::subtract) {
+        // Sum of the high parts and of the low parts, renormalized twice (relative error below 3 * 2^-106, Joldes, Muller and
+        // Popescu, "Tight and rigorous error bounds for basic building blocks of double-word arithmetic", algorithm 6).
+        Lanes otherHigh = secondHigh, otherLow = secondLow;
+        if constexpr (kernel == ExtendedKernel::subtract) {
+            otherHigh = -secondHigh;
+            otherLow = -secondLow;
+        }
+        Lanes sum, sumError, lowSum, lowSumError, high, low;
+        twoSum(firstHigh, otherHigh, sum, sumError);
+        twoSum(firstLow, otherLow, lowSum, lowSumError);
+        fastTwoSum(sum, sumError + lowSum, high, low);
+        fastTwoSum(high, low + lowSumError, resultHigh, resultLow);
+    } else if constexpr (kernel == ExtendedKernel::multiply) {
+        // Exact product of the high parts, plus the cross products (relative error below 5 * 2^-106, algorithm 12).
+        Lanes product, productError;
+        twoProduct<isFused>(firstHigh, secondHigh, product, productError);
+        fastTwoSum(product, productError + (firstHigh * secondLow + firstLow * secondHigh), resultHigh, resultLow);
+    } else if constexpr (kernel == ExtendedKernel::divide) {
+        // Double quotient q, corrected by the remainder (numerator - q * denominator) / denominator.high, where q times the
+        // denominator is computed in double-double (relative error below 15 * 2^-106, algorithm 17).
+        Lanes quotient = firstHigh / secondHigh, product, productError, high, low, remainderHigh, remainderLow;
+        twoProduct<isFused>(secondHigh, quotient, product, productError);
+        fastTwoSum(product, secondLow * quotient, high, low);
+        fastTwoSum(high, low + productError, remainderHigh, remainderLow);
+        Lanes correction = ((firstHigh - remainderHigh) + (firstLow - remainderLow)) / secondHigh;
+        fastTwoSum(quotient, correction, resultHigh, resultLow);
+    } else if constexpr (kernel == ExtendedKernel::squareRoot) {
+        // One Newton step from the double root r: r + (x - r^2) / 2r, with r^2 computed exactly.
+        Lanes root = squareRootLanes(firstHigh), square, squareError;
+        twoProduct<isFused>(root, root, square, squareError);
+        Lanes correction = (((firstHigh - square) - squareError) + firstLow) / (root + root);
+        fastTwoSum(root, correction, resultHigh, resultLow);
+    } else if constexpr (kernel == ExtendedKernel::negate) {
+        resultHigh = -firstHigh;
+        resultLow = -firstLow;
+    } else {
+        // Flip the sign of both parts when the high part is negative.
+        typedef typename LaneTraits<Lanes>::Bits Bits;
+        Bits sign = std::bit_cast<Bits>(firstHigh) & 0x8000000000000000;
+        resultHigh = std::bit_cast<Lanes>(std::bit_cast<Bits>(firstHigh) ^ sign);
+        resultLow = std::bit_cast<Lanes>(std::bit_cast<Bits>(firstLow) ^ sign);
+    }
+}
+
+/// @brief Function for applying a kernel to one double-double, with the scalar instructions of the file.
+template <ExtendedKernel kernel, bool isFused = isFusedMultiplyAddNative>
+inline DoubleDouble applyScalar(DoubleDouble first, DoubleDouble second) {
+    DoubleDouble result;
+    applyLanes<kernel, isFused>(first.high, first.low, second.high, second.low, result.high, result.low);
+    return result;
+}
+
+/// @brief Function for turning a double into a double-double.
+inline DoubleDouble fromDouble(double value) {
+    return {value, 0};
+}
+
+/// @brief Function for computing first * second exactly as a double-double.
+inline DoubleDouble multiplyExactly(double first, double second) {
+    DoubleDouble result;
+    twoProduct<true>(first, second, result.high, result.low);
+    return result;
+}
+
+/// @brief Function for multiplying a double-double by 2^exponent, which is exact barring overflow and underflow.
+inline DoubleDouble scaleByPowerOf2(DoubleDouble operand, int exponent) {
+    return {std::ldexp(operand.high, exponent), std::ldexp(operand.low, exponent)};
+}
+
+/// @brief Function for checking whether a double-double holds an integer.
+inline bool isInteger(DoubleDouble operand) {
+    return std::isfinite(operand.high) && operand.high == std::floor(operand.high) && operand.low == std::floor(operand.low);
+}
+
+/// @brief Operators used by the functions below, so that they read like their double counterparts.
+inline DoubleDouble operator+(DoubleDouble first, DoubleDouble second) { return extendedAdd(first, second); }
+inline DoubleDouble operator-(DoubleDouble first, DoubleDouble second) { return extendedSubtract(first, second); }
+inline DoubleDouble operator*(DoubleDouble first, DoubleDouble second) { return extendedMultiply(first, second); }
+inline DoubleDouble operator/(DoubleDouble first, DoubleDouble second) { return extendedDivide(first, second); }
+inline DoubleDouble operator-(DoubleDouble operand) { return {-operand.high, -operand.low}; }
+inline DoubleDouble operator+(DoubleDouble first, double second) { return extendedAdd(first, fromDouble(second)); }
+inline DoubleDouble operator-(DoubleDouble first, double second) { return extendedSubtract(first, fromDouble(second)); }
+inline DoubleDouble operator*(DoubleDouble first, double second) { return extendedMultiply(first, fromDouble(second)); }
+inline DoubleDouble operator/(DoubleDouble first, double second) { return extendedDivide(first, fromDouble(second)); }
+inline DoubleDouble operator-(double first, DoubleDouble second) { return extendedSubtract(fromDouble(first), second); }
+inline DoubleDouble operator/(double first, DoubleDouble second) { return extendedDivide(fromDouble(first), second); }
+
+/// @brief Function for comparing two double-doubles.
+inline bool isLess(DoubleDouble first, DoubleDouble second) {
+    return first.high < second.high || (first.high == second.high && first.low < second.low);
+}
+
+/// @brief Table holding n! for 0 <= n <= 170, exact up to 27! and accumulated in double-double beyond.
+const std::array<DoubleDouble, 171> factorialTable = []() {
+    std::array<DoubleDouble, 171> table{};
+    table[0] = fromDouble(1);
+    for (size_t index = 1; index < table.size(); index++) table[index] = table[index - 1] * static_cast<double>(index);
+    return table;
+}();
+
+
+/// @brief Table holding 1/n! for 0 <= n <= 29, the coefficients of the Taylor series below.
+const std::array<DoubleDouble, 30> inverseFactorialTable = []() {
+    std::array<DoubleDouble, 30> table{};
+    for (size_t index = 0; index < table.size(); index++) table[index] = 1.0 / factorialTable[index];
+    return table;
+}();
+
+/// @brief Function for computing exp(x) - 1 for |x| <= 1/2, accurate relative to the (possibly tiny) result.
+/// x is divided by 2^9, the Taylor series of exp(r) - 1 is summed up to r^11/11! with Horner's method (the terms from r^6/6!,
+/// below 2^-53 times the result, in double), then the division is undone with exp(2r) - 1 = 2 (exp(r) - 1) + (exp(r) - 1)^2,
+/// which never adds 1 and keeps the relative accuracy.
+DoubleDouble computeReducedExponentialMinusOne(DoubleDouble operand) {
+    DoubleDouble reduced = scaleByPowerOf2(operand, -9);
+    double tail = inverseFactorialTable[11].high;
+    for (int order = 10; order >= 6; order--) tail = tail * reduced.high + inverseFactorialTable[order].high;
+    DoubleDouble sum = fromDouble(tail);
+    for (int order = 5; order >= 2; order--) sum = sum * reduced + inverseFactorialTable[order];
+    sum = reduced + sum * reduced * reduced;
+    for (int doubling = 0; doubling < 9; doubling++) sum = scaleByPowerOf2(sum, 1) + sum * sum;
+    return sum;
+}
+
+/// @brief Function for computing exp(x) - 1, accurate relative to the result for small x.
+DoubleDouble computeExponentialMinusOne(DoubleDouble operand) {
+    if (std::fabs(operand.high) <= 0.5) return computeReducedExponentialMinusOne(operand);
+    return extendedExponential(operand) - 1.0;
+}
+
+/// @brief Function for computing ln(1 + y) for y > -1, accurate relative to the (possibly tiny) result.
+/// One Newton step on exp(x) - 1 = y from the double estimate: x + (y - (exp(x) - 1)) / exp(x).
+DoubleDouble computeLogarithmOnePlus(DoubleDouble operand) {
+    double estimate = std::log1p(operand.high);
+    if (!std::isfinite(estimate) || estimate > 700) return extendedNaturalLogarithm(operand + 1.0);
+    DoubleDouble exponentialMinusOne = computeExponentialMinusOne(fromDouble(estimate));
+    return fromDouble(estimate) + (operand - exponentialMinusOne) / (exponentialMinusOne + 1.0);
+}
+
+/// @brief Function for computing sin(x) and cos(x) together.
+/// x is reduced to r = x - k*pi/2 with |r| <= pi/4 (k*pi/2 is exact in three parts), sin(r) is its Taylor series up to r^29/29!
+/// summed with Horner's method in r^2 (the terms from r^19/19!, below 2^-53 times the result, in double), cos(r) = sqrt(1 - sin(r)^2)
+/// (accurate since cos(r) >= 0.7), and k mod 4 picks the quadrant.
+void computeSineCosine(DoubleDouble angle, DoubleDouble& sine, DoubleDouble& cosine) {
+    if (!std::isfinite(angle.high)) {
+        sine = cosine = fromDouble(NAN);
+        return;
+    }
+    double quadrant = std::round(angle.high / doubleDoubleHalfPi.high);
+    DoubleDouble reduced = ((angle - multiplyExactly(quadrant, doubleDoubleHalfPi.high)) - multiplyExactly(quadrant, doubleDoubleHalfPi.low)) - quadrant * halfPiThird;
+
+    DoubleDouble square = reduced * reduced;
+    double tail = inverseFactorialTable[29].high;
+    for (int order = 27; order >= 19; order -= 2) tail = tail * square.high + ((order % 4 == 1) ? 1 : -1) * inverseFactorialTable[order].high;
+    DoubleDouble series = fromDouble(tail);
+    for (int order = 17; order >= 3; order -= 2) series = series * square + ((order % 4 == 1) ? inverseFactorialTable[order] : -inverseFactorialTable[order]);
+    DoubleDouble reducedSine = reduced + series * square * reduced;
+    DoubleDouble reducedCosine = extendedSquareRoot(1.0 - reducedSine * reducedSine);
+
+    switch (static_cast<int>(quadrant - 4 * std::floor(quadrant / 4))) {
+        case 0: sine = reducedSine; cosine = reducedCosine; break;
+        case 1: sine = reducedCosine; cosine = -reducedSine; break;
+        case 2: sine = -reducedSine; cosine = -reducedCosine; break;
+        default: sine = -reducedCosine; cosine = reducedSine; break;
+    }
+}
+
+/// @brief Function for computing ln(x) + ln(2) for large x, whose square would overflow.
+DoubleDouble computeLargeLogarithm(DoubleDouble operand) {
+    return extendedNaturalLogarithm(operand) + doubleDoubleLn2;
+}
+
+/// @brief Function for computing 10^exponent by squaring (exact up to 10^22, accurate to about 100 bits beyond).
+DoubleDouble computePowerOfTen(int exponent) {
+    if (exponent >= 0 && exponent <= 22) return fromDouble(exactPowersOfTen[exponent]);
+    return extendedPower(fromDouble(10), fromDouble(exponent));
+}
+
+#ifdef DOUBLE_DOUBLE_VECTORS
+/// @brief Function for applying a kernel to a block of lanes, then recomputing the (rare) elements whose result is not finite
+/// with the scalar function. The operands stay in registers, since the result may overwrite them.
+template <ExtendedKernel kernel, bool isFused, typename Lanes>
+DOUBLE_DOUBLE_INLINE void applyBlock(ExtendedUnaryFunction unaryFunction, ExtendedBinaryFunction binaryFunction, const double* firstHigh, const double* firstLow, bool isFirstBroadcast,
+    const double* secondHigh, const double* secondLow, bool isSecondBroadcast, double* resultHigh, double* resultLow) {
+    constexpr size_t width = sizeof(Lanes) / sizeof(double);
+    Lanes firstHighLanes, firstLowLanes, secondHighLanes, secondLowLanes, highLanes, lowLanes;
+    if (isFirstBroadcast) {
+        firstHighLanes = Lanes{} + *firstHigh;
+        firstLowLanes = Lanes{} + *firstLow;
+    } else {
+        std::memcpy(&firstHighLanes, firstHigh, sizeof(Lanes));
+        std::memcpy(&firstLowLanes, firstLow, sizeof(Lanes));
+    }
+    if (isSecondBroadcast) {
+        secondHighLanes = Lanes{} + *secondHigh;
+        secondLowLanes = Lanes{} + *secondLow;
+    } else {
+        std::memcpy(&secondHighLanes, secondHigh, sizeof(Lanes));
+        std::memcpy(&secondLowLanes, secondLow, sizeof(Lanes));
+    }
+    applyLanes<kernel, isFused>(firstHighLanes, firstLowLanes, secondHighLanes, secondLowLanes, highLanes, lowLanes);
+    std::memcpy(resultHigh, &highLanes, sizeof(Lanes));
+    std::memcpy(resultLow, &lowLanes, sizeof(Lanes));
+
+    // x - x is 0 for finite x and nan for inf and nan.
+    typedef typename LaneTraits<Lanes>::Bits Bits;
+    Bits isNotFinite = ~std::bit_cast<Bits>(highLanes - highLanes == 0.0);
+    uint64_t isAnyNotFinite = 0;
+    for (size_t lane = 0; lane < width; lane++) isAnyNotFinite |= isNotFinite[lane];
+    if (isAnyNotFinite == 0) return;
+    for (size_t lane = 0; lane < width; lane++) {
+        if (!isNotFinite[lane]) continue;
+        DoubleDouble first = {firstHighLanes[lane], firstLowLanes[lane]}, second = {secondHighLanes[lane], secondLowLanes[lane]};
+        DoubleDouble result = (unaryFunction != nullptr) ? unaryFunction(first) : binaryFunction(first, second);
+        resultHigh[lane] = result.high;
+        resultLow[lane] = result.low;
+    }
+}
+
+/// @brief Function for applying a kernel 4 elements at a time with AVX2 and FMA.
+/// @returns Index of the first element left to the narrower loops.
+template <ExtendedKernel kernel>
+__attribute__((target("avx2,fma"))) size_t applyAvx2Blocks(ExtendedUnaryFunction unaryFunction, ExtendedBinaryFunction binaryFunction, const double* firstHigh, const double* firstLow, bool isFirstBroadcast,
+    const double* secondHigh, const double* secondLow, bool isSecondBroadcast, double* resultHigh, double* resultLow, size_t count) {
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        size_t firstIndex = isFirstBroadcast ? 0 : index, secondIndex = isSecondBroadcast ? 0 : index;
+        applyBlock<kernel, true, DoubleQuad>(unaryFunction, binaryFunction, firstHigh + firstIndex, firstLow + firstIndex, isFirstBroadcast,
+            secondHigh + secondIndex, secondLow + secondIndex, isSecondBroadcast, resultHigh + index, resultLow + index);
+    }
+    return index;
+}
+
+/// @brief Whether the processor supports AVX2 and FMA, checked once.
+const bool isAvx2Supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+
+/// @brief Function for applying a kernel element-wise with the widest available instructions.
+/// Unary kernels ignore the second operand, which then points at the first one.
+template <ExtendedKernel kernel>
+void applyKernel(ExtendedUnaryFunction unaryFunction, ExtendedBinaryFunction binaryFunction, const double* firstHigh, const double* firstLow, bool isFirstBroadcast,
+    const double* secondHigh, const double* secondLow, bool isSecondBroadcast, double* resultHigh, double* resultLow, size_t count) {
+    size_t index = 0;
+#ifdef DOUBLE_DOUBLE_VECTORS
+    if (isAvx2Supported) {
+        index = applyAvx2Blocks<kernel>(unaryFunction, binaryFunction, firstHigh, firstLow, isFirstBroadcast, secondHigh, secondLow, isSecondBroadcast, resultHigh, resultLow, count);
+    }
+    for (; index + 2 <= count; index += 2) {
+        size_t firstIndex = isFirstBroadcast ? 0 : index, secondIndex = isSecondBroadcast ? 0 : index;
+        applyBlock<kernel, false, DoublePair>(unaryFunction, binaryFunction, firstHigh + firstIndex, firstLow + firstIndex, isFirstBroadcast,
+            secondHigh + secondIndex, secondLow + secondIndex, isSecondBroadcast, resultHigh + index, resultLow + index);
+    }
+#endif
+
+    // Apply the function to the remaining elements one at a time.
+    for (; index < count; index++) {
+        size_t firstIndex = isFirstBroadcast ? 0 : index, secondIndex = isSecondBroadcast ? 0 : index;
+        DoubleDouble first = {firstHigh[firstIndex], firstLow[firstIndex]}, second = {secondHigh[secondIndex], secondLow[secondIndex]};
+        DoubleDouble result = (unaryFunction != nullptr) ? unaryFunction(first) : binaryFunction(first, second);
+        resultHigh[index] = result.high;
+        resultLow[index] = result.low;
+    }
+}
+
+}
+
+DoubleDouble extendedAdd(DoubleDouble firstOperand, DoubleDouble secondOperand) {
+    DoubleDouble result = applyScalar<ExtendedKernel::add>(firstOperand, secondOperand);
+    return std::isfinite(result.high) ? result : fromDouble(firstOperand.high + secondOperand.high);
+}
+
+DoubleDouble extendedSubtract(DoubleDouble firstOperand, DoubleDouble secondOperand) {
+    DoubleDouble result = applyScalar<ExtendedKernel::subtract>(firstOperand, secondOperand);
+    return std::isfinite(result.high) ? result : fromDouble(firstOperand.high - secondOperand.high);
+}
+
+DoubleDouble extendedMultiply(DoubleDouble firstOperand, DoubleDouble secondOperand) {
+    DoubleDouble result = applyScalar<ExtendedKernel::multiply>(firstOperand, secondOperand);
+    if (std::isfinite(result.high)) return result;
+
+    // Splitting overflows for operands above 2^996, where a fused multiply-add still gives the exact error.
+    double product = firstOperand.high * secondOperand.high;
+    if (std::isfinite(product)) result = applyScalar<ExtendedKernel::multiply, true>(firstOperand, secondOperand);
+    return std::isfinite(result.high) ? result : fromDouble(product);
+}
+
+DoubleDouble extendedDivide(DoubleDouble numerator, DoubleDouble denominator) {
+    DoubleDouble result = applyScalar<ExtendedKernel::divide>(numerator, denominator);
+    if (std::isfinite(result.high)) return result;
+
+    // Handle zero and infinite denominators, and quotients whose product by the denominator splits with overflow.
+    double quotient = numerator.high / denominator.high;
+    if (std::isfinite(quotient)) result = applyScalar<ExtendedKernel::divide, true>(numerator, denominator);
+    return std::isfinite(result.high) ? result : fromDouble(quotient);
+}
+
+DoubleDouble extendedModulo(DoubleDouble operand, DoubleDouble divisor) {
+    // Follow fmod: the remainder of the quotient truncated towards 0, with the sign of the operand.
+    if (!std::isfinite(operand.high) || divisor.high == 0 || std::isnan(divisor.high)) return fromDouble(std::fmod(operand.high, divisor.high));
+    if (std::isinf(divisor.high)) return operand;
+    DoubleDouble quotient = operand / divisor;
+    quotient = (quotient.high < 0) ? extendedCeil(quotient) : extendedFloor(quotient);
+    // A quotient held in its high part multiplies each part of the divisor exactly, keeping the remainder accurate relative to
+    // itself when it cancels most of the operand.
+    DoubleDouble remainder = (quotient.low == 0) ? (operand - multiplyExactly(quotient.high, divisor.high)) - multiplyExactly(quotient.high, divisor.low) : operand - quotient * divisor;
+
+    // Correct the rounding of the quotient, which may leave the remainder one divisor off.
+    DoubleDouble step = ((operand.high < 0) == (divisor.high < 0)) ? divisor : -divisor;
+    if (remainder.high != 0 && (remainder.high < 0) != (operand.high < 0)) remainder = remainder + step;
+    if (!isLess(extendedAbsolute(remainder), extendedAbsolute(divisor))) remainder = remainder - step;
+    return remainder;
+}
+
+DoubleDouble extendedPower(DoubleDouble base, DoubleDouble exponent) {
+    // Follow the double power: x^0 = 1^y = 1.
+    if (exponent.high == 0 || (base.high == 1 && base.low == 0)) return fromDouble(1);
+
+    // Compute integer powers by squaring, which handles negative bases.
+    if (isInteger(exponent) && std::fabs(exponent.high) < 0x1p63) {
+        int64_t remainingExponent = static_cast<int64_t>(exponent.high) + static_cast<int64_t>(exponent.low);
+        bool isNegative = remainingExponent < 0;
+        uint64_t magnitude = isNegative ? 0 - static_cast<uint64_t>(remainingExponent) : static_cast<uint64_t>(remainingExponent);
+        DoubleDouble result = fromDouble(1), factor = base;
+        for (; magnitude > 0; magnitude >>= 1) {
+            if (magnitude & 1) result = result * factor;
+            if (magnitude > 1) factor = factor * factor;
+        }
+        return isNegative ? 1.0 / result : result;
+    }
+
+    // Compute other powers as exp(y ln x), defined for positive bases only.
+    if (!(base.high > 0) || std::isinf(base.high) || !std::isfinite(exponent.high)) return fromDouble(std::pow(base.high, exponent.high));
+    return extendedExponential(exponent * extendedNaturalLogarithm(base));
+}
+
+DoubleDouble extendedLogarithm(DoubleDouble base, DoubleDouble power) {
+    return extendedNaturalLogarithm(power) / extendedNaturalLogarithm(base);
+}
+
+DoubleDouble extendedNegate(DoubleDouble operand) {
+    return -operand;
+}
+
+DoubleDouble extendedAbsolute(DoubleDouble operand) {
+    return std::signbit(operand.high) ? -operand : operand;
+}
+
+DoubleDouble extendedFactorial(DoubleDouble operand) {
+    // Negative and non-integer inputs produce nan, results too large for a double produce inf.
+    if (!(operand.high >= 0) || !isInteger(operand)) return fromDouble(NAN);
+    if (operand.high >= factorialTable.size()) return fromDouble(INFINITY);
+    return factorialTable[static_cast<size_t>(operand.high)];
+}
+
+DoubleDouble extendedCeil(DoubleDouble operand) {
+    return -extendedFloor(-operand);
+}
+
+DoubleDouble extendedFloor(DoubleDouble operand) {
+    // The low part only matters when the high part is an integer.
+    double high = std::floor(operand.high);
+    if (high != operand.high || !std::isfinite(high)) return fromDouble(high);
+    DoubleDouble result;
+    fastTwoSum(high, std::floor(operand.low), result.high, result.low);
+    return result;
+}
+
+DoubleDouble extendedRound(DoubleDouble operand) {
+    // Round halves away from 0, like round.
+    DoubleDouble magnitude = extendedAbsolute(operand), result = extendedFloor(magnitude);
+    if (!isLess(magnitude - result, fromDouble(0.5))) result = result + 1.0;
+    return std::signbit(operand.high) ? -result : result;
+}
+
+DoubleDouble extendedSquareRoot(DoubleDouble operand) {
+    // Zero, negative and infinite operands give the double result.
+    if (!(operand.high > 0) || std::isinf(operand.high)) return fromDouble(std::sqrt(operand.high));
+    return applyScalar<ExtendedKernel::squareRoot>(operand, operand);
+}
+
+DoubleDouble extendedCubeRoot(DoubleDouble operand) {
+    // One Newton step from the double root r: r + (x - r^3) / 3r^2.
+    double root = std::cbrt(operand.high);
+    if (root == 0 || !std::isfinite(root)) return fromDouble(root);
+    DoubleDouble square = multiplyExactly(root, root);
+    return fromDouble(root) + (operand - square * root) / (square * 3.0);
+}
+
+DoubleDouble extendedExponential(DoubleDouble operand) {
+    // Handle overflow, underflow and nan.
+    if (std::isnan(operand.high)) return operand;
+    if (operand.high > 709.79) return fromDouble(INFINITY);
+    if (operand.high < -745.2) return fromDouble(0);
+
+    // Reduce x to r = x - k ln(2) with |r| <= ln(2)/2 (k ln(2) is exact in three parts), then scale exp(r) by 2^k.
+    double multiple = std::round(operand.high / doubleDoubleLn2.high);
+    DoubleDouble reduced = ((operand - multiplyExactly(multiple, doubleDoubleLn2.high)) - multiplyExactly(multiple, doubleDoubleLn2.low)) - multiple * ln2Third;
+    DoubleDouble result = scaleByPowerOf2(computeReducedExponentialMinusOne(reduced) + 1.0, static_cast<int>(multiple));
+    return std::isfinite(result.high) ? result : fromDouble(result.high);
+}
+
+DoubleDouble extendedNaturalLogarithm(DoubleDouble operand) {
+    // Zero, negative, infinite and nan operands give the double result.
+    if (!(operand.high > 0) || std::isinf(operand.high)) return fromDouble(std::log(operand.high));
+
+    // Write x = m 2^e with 0.75 <= m < 1.5, so that ln(x) = ln(1 + (m - 1)) + e ln(2), where m - 1 is exact.
+    int exponent;
+    double mantissa = std::frexp(operand.high, &exponent);
+    if (mantissa < 0.75) exponent--;
+    DoubleDouble reduced = scaleByPowerOf2(operand, -exponent) - 1.0;
+    return computeLogarithmOnePlus(reduced) + (multiplyExactly(exponent, doubleDoubleLn2.high) + exponent * doubleDoubleLn2.low);
+}
+
+DoubleDouble extendedBase2Logarithm(DoubleDouble operand) {
+    // Powers of 2 have exact logarithms.
+    int exponent;
+    if (operand.low == 0 && std::isfinite(operand.high) && std::frexp(operand.high, &exponent) == 0.5) return fromDouble(exponent - 1);
+    DoubleDouble logarithm = extendedNaturalLogarithm(operand);
+    return std::isfinite(logarithm.high) ? logarithm * doubleDoubleLog2E : logarithm;
+}
+
+DoubleDouble extendedBase10Logarithm(DoubleDouble operand) {
+    DoubleDouble logarithm = extendedNaturalLogarithm(operand);
+    return std::isfinite(logarithm.high) ? logarithm * doubleDoubleLog10E : logarithm;
+}
+
+DoubleDouble extendedSine(DoubleDouble angle) {
+    DoubleDouble sine, cosine;
+    computeSineCosine(angle, sine, cosine);
+    return sine;
+}
+
+DoubleDouble extendedCosine(DoubleDouble angle) {
+    DoubleDouble sine, cosine;
+    computeSineCosine(angle, sine, cosine);
+    return cosine;
+}
+
+DoubleDouble extendedTangent(DoubleDouble angle) {
+    DoubleDouble sine, cosine;
+    computeSineCosine(angle, sine, cosine);
+    return sine / cosine;
+}
+
+DoubleDouble extendedSecant(DoubleDouble angle) {
+    return 1.0 / extendedCosine(angle);
+}
+
+DoubleDouble extendedCosecant(DoubleDouble angle) {
+    return 1.0 / extendedSine(angle);
+}
+
+DoubleDouble extendedCotangent(DoubleDouble angle) {
+    DoubleDouble sine, cosine;
+    computeSineCosine(angle, sine, cosine);
+    return cosine / sine;
+}
+
+DoubleDouble extendedArcsine(DoubleDouble operand) {
+    // asin(x) = atan(x / sqrt((1 - x)(1 + x))), where 1 - x and 1 + x are exact near +-1.
+    DoubleDouble magnitude = extendedAbsolute(operand);
+    if (isLess(fromDouble(1), magnitude) || std::isnan(operand.high)) return fromDouble(NAN);
+    if (magnitude.high == 1) return (operand.high < 0) ? -doubleDoubleHalfPi : doubleDoubleHalfPi;
+    return extendedArctangent(operand / extendedSquareRoot((1.0 - operand) * (operand + 1.0)));
+}
+
+DoubleDouble extendedArccosine(DoubleDouble operand) {
+    // acos(x) = 2 atan(sqrt((1 - x) / (1 + x))), which gives pi at x = -1.
+    if (isLess(fromDouble(1), extendedAbsolute(operand)) || std::isnan(operand.high)) return fromDouble(NAN);
+    return scaleByPowerOf2(extendedArctangent(extendedSquareRoot((1.0 - operand) / (operand + 1.0))), 1);
+}
+
+DoubleDouble extendedArctangent(DoubleDouble operand) {
+    // Use atan(x) = +-pi/2 - atan(1/x) above 1, where Newton's method would converge slowly.
+    if (std::isnan(operand.high)) return operand;
+    bool isInverted = std::fabs(operand.high) > 1;
+    DoubleDouble reduced = isInverted ? 1.0 / operand : operand;
+
+    // One Newton step on tan(z) = y from the double estimate: z + (y - tan(z)) cos^2(z) = z + (y cos(z) - sin(z)) cos(z).
+    DoubleDouble estimate = fromDouble(std::atan(reduced.high)), sine, cosine;
+    computeSineCosine(estimate, sine, cosine);
+    DoubleDouble result = estimate + (reduced * cosine - sine) * cosine;
+    if (!isInverted) return result;
+    return ((operand.high < 0) ? -doubleDoubleHalfPi : doubleDoubleHalfPi) - result;
+}
+
+DoubleDouble extendedHyperbolicSine(DoubleDouble operand) {
+    // sinh(x) = (exp(x) - 1 + (exp(x) - 1) / exp(x)) / 2 keeps its relative accuracy for small x, and exp(x - ln 2) avoids
+    // the overflow of exp(x) for large x.
+    DoubleDouble magnitude = extendedAbsolute(operand), result;
+    if (std::isnan(operand.high)) return operand;
+    if (magnitude.high > 40) {
+        result = extendedExponential(magnitude - doubleDoubleLn2);
+    } else {
+        DoubleDouble exponentialMinusOne = computeExponentialMinusOne(magnitude);
+        result = scaleByPowerOf2(exponentialMinusOne + exponentialMinusOne / (exponentialMinusOne + 1.0), -1);
+    }
+    return std::signbit(operand.high) ? -result : result;
+}
+
+DoubleDouble extendedHyperbolicCosine(DoubleDouble operand) {
+    DoubleDouble magnitude = extendedAbsolute(operand);
+    if (std::isnan(operand.high)) return operand;
+    if (magnitude.high > 40) return extendedExponential(magnitude - doubleDoubleLn2);
+    DoubleDouble exponential = extendedExponential(magnitude);
+    return scaleByPowerOf2(exponential + 1.0 / exponential, -1);
+}
+
+DoubleDouble extendedHyperbolicTangent(DoubleDouble operand) {
+    // tanh(x) = (exp(2x) - 1) / (exp(2x) + 1), with exp(2x) - 1 accurate for small x.
+    DoubleDouble magnitude = extendedAbsolute(operand), result;
+    if (std::isnan(operand.high)) return operand;
+    if (magnitude.high > 40) {
+        result = fromDouble(1);
+    } else {
+        DoubleDouble exponentialMinusOne = computeExponentialMinusOne(scaleByPowerOf2(magnitude, 1));
+        result = exponentialMinusOne / (exponentialMinusOne + 2.0);
+    }
+    return std::signbit(operand.high) ? -result : result;
+}
+
+DoubleDouble extendedHyperbolicArcsine(DoubleDouble operand) {
+    // asinh(x) = ln(1 + x + x^2 / (1 + sqrt(1 + x^2))), with the logarithm of 1 + y accurate for small y.
+    DoubleDouble magnitude = extendedAbsolute(operand), result;
+    if (!std::isfinite(operand.high)) return operand;
+    if (magnitude.high > 1e150) {
+        result = computeLargeLogarithm(magnitude);
+    } else {
+        DoubleDouble square = magnitude * magnitude;
+        result = computeLogarithmOnePlus(magnitude + square / (extendedSquareRoot(square + 1.0) + 1.0));
+    }
+    return std::signbit(operand.high) ? -result : result;
+}
+
+DoubleDouble extendedHyperbolicArccosine(DoubleDouble operand) {
+    // acosh(x) = ln(1 + t + sqrt(t (t + 2))) with t = x - 1, exact near 1.
+    if (isLess(operand, fromDouble(1)) || std::isnan(operand.high)) return fromDouble(NAN);
+    if (operand.high > 1e150) return computeLargeLogarithm(operand);
+    DoubleDouble difference = operand - 1.0;
+    return computeLogarithmOnePlus(difference + extendedSquareRoot(difference * (difference + 2.0)));
+}
+
+DoubleDouble extendedHyperbolicArctangent(DoubleDouble operand) {
+    // atanh(x) = ln(1 + 2x / (1 - x)) / 2, where 1 - x is exact near 1.
+    DoubleDouble magnitude = extendedAbsolute(operand);
+    if (isLess(fromDouble(1), magnitude) || std::isnan(operand.high)) return fromDouble(NAN);
+    if (magnitude.high == 1 && magnitude.low == 0) return fromDouble(std::copysign(INFINITY, operand.high));
+    DoubleDouble result = scaleByPowerOf2(computeLogarithmOnePlus(scaleByPowerOf2(magnitude, 1) / (1.0 - magnitude)), -1);
+    return std::signbit(operand.high) ? -result : result;
+}
+
+DoubleDouble toDoubleDouble(int64_t integer) {
+    // Both halves of the integer are exact doubles, and so is their sum in double-double.
+    DoubleDouble result;
+    twoSum(static_cast<double>(integer >> 32) * 4294967296.0, static_cast<double>(integer & 0xffffffff), result.high, result.low);
+    return result;
+}
+
+std::from_chars_result parseDoubleDouble(const char* first, const char* last, DoubleDouble& value) {
+    // Collect the first 19 significant digits, the next 15 (at most) apart, and the decimal exponent.
+    uint64_t digits = 0, trailingDigits = 0;
+    int significantDigitCount = 0, decimalExponent = 0;
+    const char* character = first;
+    bool isFraction = false;
+    for (; character != last && *character != 'e'; character++) {
+        if (*character == '.') {
+            isFraction = true;
+            continue;
+        }
+        int digit = *character - '0';
+        if (significantDigitCount == 0 && digit == 0) {
+            decimalExponent -= isFraction;
+            continue;
+        }
+        if (significantDigitCount < 34) {
+            if (significantDigitCount < 19) digits = digits * 10 + digit;
+            else trailingDigits = trailingDigits * 10 + digit;
+            significantDigitCount++;
+            decimalExponent -= isFraction;
+        } else {
+            decimalExponent += !isFraction;
+        }
+    }
+    if (character != last) {
+        // Saturate exponents beyond the range of int, which are out of the range of double either way.
+        int exponent = 0;
+        const char* exponentFirst = character + 1 + (character[1] == '+');
+        std::from_chars_result exponentResult = std::from_chars(exponentFirst, last, exponent);
+        if (exponentResult.ec == std::errc::result_out_of_range) exponent = (*exponentFirst == '-') ? -100000 : 100000;
+        else if (exponentResult.ec != std::errc() || exponentResult.ptr != last) return {exponentFirst, std::errc::invalid_argument};
+        decimalExponent += exponent;
+    }
+
+    // Take the fast path when the digits and the power of 10 are exact doubles: their correctly rounded quotient (or product)
+    // is the double from_chars() gives, and its rounding error is exact with a fused multiply-add.
+    DoubleDouble& result = value;
+    result = DoubleDouble();
+    if (significantDigitCount <= 19 && digits < (uint64_t(1) << 53) && decimalExponent >= -22 && decimalExponent <= 22) {
+        double mantissa = static_cast<double>(digits), scale = exactPowersOfTen[std::abs(decimalExponent)];
+        if (decimalExponent < 0) {
+            result.high = mantissa / scale;
+            result.low = std::fma(-result.high, scale, mantissa) / scale;
+        } else {
+            result.high = mantissa * scale;
+            result.low = std::fma(mantissa, scale, -result.high);
+        }
+        return {last, std::errc()};
+    }
+
+    // Otherwise scale the digits in double-double, keeping the high part from_chars() gives. Out of its range, the number
+    // overflows to inf or underflows to 0 depending on the position of its first significant digit.
+    std::from_chars_result highResult = std::from_chars(first, last, result.high);
+    if (highResult.ec == std::errc::result_out_of_range) {
+        result.high = (decimalExponent + significantDigitCount > 0) ? std::numeric_limits<double>::infinity() : 0.0;
+        return highResult;
+    }
+    if (highResult.ec != std::errc() || highResult.ptr != last) return {highResult.ptr, std::errc::invalid_argument};
+    if (digits == 0 || !std::isfinite(result.high)) return highResult;
+    // 19 digits may exceed the range of int64_t: split them into their double rounding and its (small) remainder.
+    double roundedDigits = static_cast<double>(digits);
+    DoubleDouble mantissa = toDoubleDouble(static_cast<int64_t>(digits - static_cast<uint64_t>(roundedDigits))) + roundedDigits;
+    if (significantDigitCount > 19) mantissa = mantissa * exactPowersOfTen[significantDigitCount - 19] + toDoubleDouble(static_cast<int64_t>(trailingDigits));
+    DoubleDouble scaled = (decimalExponent < 0) ? mantissa / computePowerOfTen(-decimalExponent) : mantissa * computePowerOfTen(decimalExponent);
+    if (std::isfinite(scaled.high) && scaled.high != 0) result.low = (scaled - result.high).high;
+    return highResult;
+}
+
+std::string formatDoubleDouble(DoubleDouble value, int significantDigits) {
+    // Format inf and nan like std::ostream.
+    if (std::isnan(value.high)) return "nan";
+    if (std::isinf(value.high)) return (value.high < 0) ? "-inf" : "inf";
+    if (value.high == 0) return std::signbit(value.high) ? "-0" : "0";
+
+    // Scale the magnitude to [1, 10), in two steps for subnormal numbers whose power of 10 overflows.
+    std::string text = (value.high < 0) ? "-" : "";
+    DoubleDouble magnitude = extendedAbsolute(value);
+    int decimalExponent = static_cast<int>(std::floor(std::log10(magnitude.high)));
+    if (decimalExponent < -300) {
+        magnitude = magnitude * computePowerOfTen(32);
+        decimalExponent += 32;
+        magnitude = magnitude * computePowerOfTen(-decimalExponent);
+        decimalExponent -= 32;
+    } else {
+        magnitude = (decimalExponent < 0) ? magnitude * computePowerOfTen(-decimalExponent) : magnitude / computePowerOfTen(decimalExponent);
+    }
+    if (magnitude.high >= 10) {
+        magnitude = magnitude / 10.0;
+        decimalExponent++;
+    } else if (magnitude.high < 1) {
+        magnitude = magnitude * 10.0;
+        decimalExponent--;
+    }
+
+    // Extract two digits more than needed. A digit may come out as -1 or 10 when the remaining fraction is slightly below 0
+    // or 1 in its rounding error, which the carries below fix.
+    int digitCount = std::clamp(significantDigits, 1, 32) + 2, digits[34];
+    for (int index = 0; index < digitCount; index++) {
+        digits[index] = static_cast<int>(std::floor(magnitude.high));
+        magnitude = (magnitude - static_cast<double>(digits[index])) * 10.0;
+    }
+    for (int index = digitCount - 1; index > 0; index--) {
+        if (digits[index] < 0) {
+            digits[index] += 10;
+            digits[index - 1]--;
+        } else if (digits[index] > 9) {
+            digits[index] -= 10;
+            digits[index - 1]++;
+        }
+    }
+    if (digits[0] == 0) {
+        std::memmove(digits, digits + 1, (digitCount - 1) * sizeof(int));
+        digits[digitCount - 1] = 0;
+        decimalExponent--;
+    }
+
+    // Round to the requested number of digits, half away from 0.
+    digitCount -= 2;
+    if (digits[digitCount] >= 5) {
+        int index = digitCount - 1;
+        while (index >= 0 && ++digits[index] == 10) digits[index--] = 0;
+        if (index < 0) {
+            digits[0] = 1;
+            decimalExponent++;
+        }
+    }
+    while (digitCount > 1 && digits[digitCount - 1] == 0) digitCount--;
+
+    // Write fixed notation for exponents from -4 to the number of digits, scientific notation otherwise.
+    if (decimalExponent >= -4 && decimalExponent < std::clamp(significantDigits, 1, 32)) {
+        if (decimalExponent < 0) text += "0." + std::string(-decimalExponent - 1, '0');
+        for (int index = 0; index < std::max(digitCount, decimalExponent + 1); index++) {
+            if (decimalExponent >= 0 && index == decimalExponent + 1) text += '.';
+            text += static_cast<char>('0' + ((index < digitCount) ? digits[index] : 0));
+        }
+        return text;
+    }
+    text += static_cast<char>('0' + digits[0]);
+    if (digitCount > 1) text += '.';
+    for (int index = 1; index < digitCount; index++) text += static_cast<char>('0' + digits[index]);
+    std::string exponentText = std::to_string(std::abs(decimalExponent));
+    return text + ((decimalExponent < 0) ? "e-" : "e+") + ((exponentText.size() < 2) ? "0" : "") + exponentText;
+}
+
+ExtendedKernel findExtendedKernel(const std::string& name) {
+    if (name == "+") return ExtendedKernel::add;
+    if (name == "-") return ExtendedKernel::subtract;
+    if (name == "*") return ExtendedKernel::multiply;
+    if (name == "/") return ExtendedKernel::divide;
+    if (name == "neg") return ExtendedKernel::negate;
+    if (name == "abs") return ExtendedKernel::absolute;
+    if (name == "sqrt") return ExtendedKernel::squareRoot;
+    return ExtendedKernel::none;
+}
+
+void applyExtendedUnaryElementwise(ExtendedKernel kernel, ExtendedUnaryFunction function, const double* operandHigh, const double* operandLow, double* resultHigh, double* resultLow, size_t count) {
+    switch (kernel) {
+        case ExtendedKernel::negate: applyKernel<ExtendedKernel::negate>(function, nullptr, operandHigh, operandLow, false, operandHigh, operandLow, false, resultHigh, resultLow, count); return;
+        case ExtendedKernel::absolute: applyKernel<ExtendedKernel::absolute>(function, nullptr, operandHigh, operandLow, false, operandHigh, operandLow, false, resultHigh, resultLow, count); return;
+        case ExtendedKernel::squareRoot: applyKernel<ExtendedKernel::squareRoot>(function, nullptr, operandHigh, operandLow, false, operandHigh, operandLow, false, resultHigh, resultLow, count); return;
+        default: break;
+    }
+
+    // Call the function of the operator on every element.
+    for (size_t index = 0; index < count; index++) {
+        DoubleDouble result = function({operandHigh[index], operandLow[index]});
+        resultHigh[index] = result.high;
+        resultLow[index] = result.low;
+    }
+}
+
+void applyExtendedBinaryElementwise(ExtendedKernel kernel, ExtendedBinaryFunction function, const double* firstHigh, const double* firstLow, bool isFirstBroadcast,
+    const double* secondHigh, const double* secondLow, bool isSecondBroadcast, double* resultHigh, double* resultLow, size_t count) {
+    switch (kernel) {
+        case ExtendedKernel::add: applyKernel<ExtendedKernel::add>(nullptr, function, firstHigh, firstLow, isFirstBroadcast, secondHigh, secondLow, isSecondBroadcast, resultHigh, resultLow, count); return;
+        case ExtendedKernel::subtract: applyKernel<ExtendedKernel::subtract>(nullptr, function, firstHigh, firstLow, isFirstBroadcast, secondHigh, secondLow, isSecondBroadcast, resultHigh, resultLow, count); return;
+        case ExtendedKernel::multiply: applyKernel<ExtendedKernel::multiply>(nullptr, function, firstHigh, firstLow, isFirstBroadcast, secondHigh, secondLow, isSecondBroadcast, resultHigh, resultLow, count); return;
+        case ExtendedKernel::divide: applyKernel<ExtendedKernel::divide>(nullptr, function, firstHigh, firstLow, isFirstBroadcast, secondHigh, secondLow, isSecondBroadcast, resultHigh, resultLow, count); return;
+        default: break;
+    }
+
+    // Call the function of the operator on every element.
+    for (size_t index = 0; index < count; index++) {
+        size_t firstIndex = isFirstBroadcast ? 0 : index, secondIndex = isSecondBroadcast ? 0 : index;
+        DoubleDouble result = function({firstHigh[firstIndex], firstLow[firstIndex]}, {secondHigh[secondIndex], secondLow[secondIndex]});
+        resultHigh[index] = result.high;
+        resultLow[index] = result.low;
+    }
+}
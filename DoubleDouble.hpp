@@ -0,0 +1,157 @@
+#ifndef __DOUBLE_DOUBLE
+#define __DOUBLE_DOUBLE
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <charconv>
+
+/// Double-double arithmetic: a number is held as the unevaluated sum of two doubles, high + low, with |low| at most half an ulp
+/// of high, which carries about 106 bits (32 significant digits) at the cost of a few double operations. '+', '-', '*', '/' and
+/// sqrt are built on error-free transforms: the rounding error of a sum is recovered with TwoSum, and the rounding error of
+/// a product with a fused multiply-add (or Dekker's splitting when the processor has no FMA), so their relative error stays within
+/// a few units of 2^-106. The other operators of the lookup tables reduce their argument, sum a Taylor series in double-double,
+/// or refine the double result with one Newton step, and are accurate to about 100 bits on the ranges where the double functions
+/// are accurate themselves. Results that are not finite (overflow, nan) have a low part of 0.
+/// The operators below follow the unchecked functions of the lookup tables: operands outside their domain give nan or inf.
+
+/// @brief Number held as high + low with |low| <= ulp(high) / 2.
+struct DoubleDouble {
+    /// @brief Value rounded to double.
+    double high = 0;
+
+    /// @brief Rounding error of high.
+    double low = 0;
+};
+
+/// @brief Pointer to a double-double function / operator taking a single parameter.
+typedef DoubleDouble (*ExtendedUnaryFunction)(DoubleDouble);
+
+/// @brief Pointer to a double-double function / operator taking two parameters.
+typedef DoubleDouble (*ExtendedBinaryFunction)(DoubleDouble, DoubleDouble);
+
+/// @brief Elements of a vector of double-doubles, with the high and low parts in separate arrays so that the SIMD kernels
+/// load whole registers of either.
+struct DoubleDoubleVector {
+    std::vector<double> high;
+    std::vector<double> low;
+
+    /// @brief Method for accessing the number of elements.
+    size_t size() const { return this->high.size(); }
+
+    /// @brief Method for changing the number of elements.
+    void resize(size_t count) { this->high.resize(count); this->low.resize(count); }
+};
+
+/// @brief Constants rounded to double-double (the low part is the rounding error of the double constant).
+constexpr DoubleDouble doubleDoublePi = {3.141592653589793, 1.2246467991473532e-16};
+constexpr DoubleDouble doubleDoubleE = {2.718281828459045, 1.4456468917292502e-16};
+constexpr DoubleDouble doubleDoublePhi = {1.618033988749895, -5.432115203682506e-17};
+
+/// @brief Arithmetic operators.
+DoubleDouble extendedAdd(DoubleDouble firstOperand, DoubleDouble secondOperand);
+DoubleDouble extendedSubtract(DoubleDouble firstOperand, DoubleDouble secondOperand);
+DoubleDouble extendedMultiply(DoubleDouble firstOperand, DoubleDouble secondOperand);
+DoubleDouble extendedDivide(DoubleDouble numerator, DoubleDouble denominator);
+DoubleDouble extendedModulo(DoubleDouble operand, DoubleDouble divisor);
+DoubleDouble extendedPower(DoubleDouble base, DoubleDouble exponent);
+DoubleDouble extendedLogarithm(DoubleDouble base, DoubleDouble power);
+DoubleDouble extendedNegate(DoubleDouble operand);
+DoubleDouble extendedAbsolute(DoubleDouble operand);
+DoubleDouble extendedFactorial(DoubleDouble operand);
+
+/// @brief Rounding functions.
+DoubleDouble extendedCeil(DoubleDouble operand);
+DoubleDouble extendedFloor(DoubleDouble operand);
+DoubleDouble extendedRound(DoubleDouble operand);
+
+/// @brief Roots, exponentials and logarithms.
+DoubleDouble extendedSquareRoot(DoubleDouble operand);
+DoubleDouble extendedCubeRoot(DoubleDouble operand);
+DoubleDouble extendedExponential(DoubleDouble operand);
+DoubleDouble extendedNaturalLogarithm(DoubleDouble operand);
+DoubleDouble extendedBase2Logarithm(DoubleDouble operand);
+DoubleDouble extendedBase10Logarithm(DoubleDouble operand);
+
+/// @brief Trigonometric functions and their inverses. Arguments are reduced by multiples of pi/2 in double-double, which stays
+/// accurate while |x| is below about 1e15.
+DoubleDouble extendedSine(DoubleDouble angle);
+DoubleDouble extendedCosine(DoubleDouble angle);
+DoubleDouble extendedTangent(DoubleDouble angle);
+DoubleDouble extendedSecant(DoubleDouble angle);
+DoubleDouble extendedCosecant(DoubleDouble angle);
+DoubleDouble extendedCotangent(DoubleDouble angle);
+DoubleDouble extendedArcsine(DoubleDouble operand);
+DoubleDouble extendedArccosine(DoubleDouble operand);
+DoubleDouble extendedArctangent(DoubleDouble operand);
+
+/// @brief Hyperbolic functions and their inverses.
+DoubleDouble extendedHyperbolicSine(DoubleDouble operand);
+DoubleDouble extendedHyperbolicCosine(DoubleDouble operand);
+DoubleDouble extendedHyperbolicTangent(DoubleDouble operand);
+DoubleDouble extendedHyperbolicArcsine(DoubleDouble operand);
+DoubleDouble extendedHyperbolicArccosine(DoubleDouble operand);
+DoubleDouble extendedHyperbolicArctangent(DoubleDouble operand);
+
+/// @brief Function for converting a 64-bit integer to double-double exactly.
+DoubleDouble toDoubleDouble(int64_t integer);
+
+/// @brief Function for parsing a decimal number in the format of the calculator (e.g. "1.5e-3") to double-double.
+/// The high part is the double from_chars() gives, so it matches the double evaluation. The low part is exact to about 106 bits
+/// for numbers of up to 15 digits with a decimal exponent up to 22 in magnitude (the digits divided or multiplied by an exact
+/// power of 10), and accurate to about 100 bits otherwise. Digits beyond the 34th are ignored.
+/// @param first Pointer to the first character of the number.
+/// @param last Pointer past the last character of the number.
+/// @param value Receives the number. Numbers out of the range of double are set to inf (overflow) or 0 (underflow).
+/// @returns The end of the number and std::errc() like from_chars(), or result_out_of_range if the number is out of the range
+/// of double, or invalid_argument if the characters are not a number.
+std::from_chars_result parseDoubleDouble(const char* first, const char* last, DoubleDouble& value);
+
+/// @brief Function for formatting a double-double with the given number of significant digits, like the default format of
+/// std::ostream: fixed notation for decimal exponents from -4 to significantDigits - 1, scientific notation otherwise, trailing
+/// zeros removed.
+/// @param value Number to format.
+/// The scaling by a power of 10 rounds to double-double as well, so the last of 31 digits (the default) may be off by one for about
+/// 1% of the numbers, and the last of 32 digits for about 10%.
+/// @param significantDigits Number of significant digits, between 1 and 32.
+/// @returns The formatted number, e.g. "0.3333333333333333333333333333333" for 1/3.
+std::string formatDoubleDouble(DoubleDouble value, int significantDigits = 31);
+
+/// @brief Operators with a SIMD kernel.
+enum class ExtendedKernel : uint8_t { none, add, subtract, multiply, divide, negate, absolute, squareRoot };
+
+/// @brief Function for finding the SIMD kernel of an operator.
+/// @param name Operator name, e.g. "+" or "sqrt".
+/// @returns The kernel, or ExtendedKernel::none if the operator is applied one element at a time.
+ExtendedKernel findExtendedKernel(const std::string& name);
+
+/// @brief Function for applying a unary double-double operator element-wise. The kernels run 4 elements at a time with AVX2
+/// and FMA when the processor supports them (checked once at run time), and 2 at a time with SSE2 and Dekker's splitting
+/// otherwise, returning the same results. Elements whose result is not finite are recomputed by function, which handles inf,
+/// nan and zero operands.
+/// @param kernel SIMD kernel of the operator (ExtendedKernel::none to call function on every element).
+/// @param function Function of the operator.
+/// @param operandHigh Pointer to the high parts of the operand elements.
+/// @param operandLow Pointer to the low parts of the operand elements.
+/// @param resultHigh Pointer to the high parts of the result elements (may be equal to operandHigh).
+/// @param resultLow Pointer to the low parts of the result elements (may be equal to operandLow).
+/// @param count Number of elements.
+void applyExtendedUnaryElementwise(ExtendedKernel kernel, ExtendedUnaryFunction function, const double* operandHigh, const double* operandLow, double* resultHigh, double* resultLow, size_t count);
+
+/// @brief Function for applying a binary double-double operator element-wise, broadcasting single-element operands, like
+/// applyExtendedUnaryElementwise().
+/// @param kernel SIMD kernel of the operator (ExtendedKernel::none to call function on every element).
+/// @param function Function of the operator.
+/// @param firstHigh Pointer to the high parts of the first operand elements.
+/// @param firstLow Pointer to the low parts of the first operand elements.
+/// @param isFirstBroadcast Whether the first operand is a single element used at every position.
+/// @param secondHigh Pointer to the high parts of the second operand elements.
+/// @param secondLow Pointer to the low parts of the second operand elements.
+/// @param isSecondBroadcast Whether the second operand is a single element used at every position.
+/// @param resultHigh Pointer to the high parts of the result elements (may be equal to those of a non-broadcast operand).
+/// @param resultLow Pointer to the low parts of the result elements (may be equal to those of a non-broadcast operand).
+/// @param count Number of elements.
+void applyExtendedBinaryElementwise(ExtendedKernel kernel, ExtendedBinaryFunction function, const double* firstHigh, const double* firstLow, bool isFirstBroadcast,
+    const double* secondHigh, const double* secondLow, bool isSecondBroadcast, double* resultHigh, double* resultLow, size_t count);
+
+#endif
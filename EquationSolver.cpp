@@ -0,0 +1,302 @@
+#include "EquationSolver.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+EquationSolver::EquationSolver(const CompiledExpression& program, WorkStealingThreadPool& pool) : program(program), pool(pool) {
+    // Check if the program is a function of exactly one variable.
+    if (program.getVariableNames().size() != 1) throw std::invalid_argument("EvalError: Equations require an expression of exactly one variable.\n");
+}
+
+/// @brief Function for formatting a point for error messages.
+/// @param value Point to format.
+/// @returns The point with up to 17 significant digits.
+static std::string formatPoint(double value) {
+    std::stringstream stream;
+    stream << std::setprecision(17) << value;
+    return stream.str();
+}
+
+/// @brief Function for checking whether two values have opposite signs (both non-zero and not nan).
+static inline bool haveOppositeSigns(double first, double second) {
+    return (first < 0 && second > 0) || (first > 0 && second < 0);
+}
+
+/// @brief Function for reporting that the bracket found from a guess holds a discontinuity rather than a root.
+[[noreturn]] static void throwDiscontinuity(double guess, const EquationRoot& root) {
+    std::string errorMessage = "EvalError: No root found around the guess " + formatPoint(guess);
+    errorMessage += " (discontinuity at " + formatPoint(root.value) + ", where the expression is " + formatPoint(root.residual) + ").\n";
+    throw std::invalid_argument(errorMessage);
+}
+
+/// @brief Function for checking whether a refined bracket holds a discontinuity (e.g. the pole of tan(x) or 1/x) rather than a
+/// root: the expression changes sign across it, but its residual exceeds its values at the ends of the bracket.
+static inline bool isDiscontinuity(const EquationRoot& root, double lowerValue, double upperValue) {
+    // An infinite end is a pole itself and gives no scale, so only the finite ends bound the residual.
+    if (!std::isfinite(lowerValue) && !std::isfinite(upperValue)) return !std::isfinite(root.residual);
+    double scale = std::max(std::isfinite(lowerValue) ? std::fabs(lowerValue) : 0.0, std::isfinite(upperValue) ? std::fabs(upperValue) : 0.0);
+    return !(std::fabs(root.residual) <= scale);
+}
+
+EquationRoot EquationSolver::solveBracket(double lower, double upper) const {
+    // Allocate the register and derivative files once for the whole search.
+    std::vector<double> registers(2 * this->program.getRegisterCount());
+    EquationRoot root = {NAN, NAN, 2};
+
+    // Evaluate both ends, which may already be a root.
+    double lowerValue = this->program.evaluate(&lower, registers.data()), upperValue = this->program.evaluate(&upper, registers.data());
+    if (lowerValue == 0 || upperValue == 0) {
+        root.value = (lowerValue == 0) ? lower : upper;
+        root.residual = 0;
+        return root;
+    }
+    if (!haveOppositeSigns(lowerValue, upperValue)) {
+        std::string errorMessage = "EvalError: Expected the expression to change sign between " + formatPoint(lower) + " and " + formatPoint(upper);
+        errorMessage += " (found " + formatPoint(lowerValue) + " and " + formatPoint(upperValue) + ").\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    this->refineBracket(lower, upper, lowerValue, upperValue, registers.data(), root);
+    if (isDiscontinuity(root, lowerValue, upperValue)) {
+        std::string errorMessage = "EvalError: No root in the bracket between " + formatPoint(lower) + " and " + formatPoint(upper);
+        errorMessage += " (discontinuity at " + formatPoint(root.value) + ", where the expression is " + formatPoint(root.residual) + ").\n";
+        throw std::invalid_argument(errorMessage);
+    }
+    return root;
+}
+
+void EquationSolver::refineBracket(double lower, double upper, double lowerValue, double upperValue, double* registers, EquationRoot& root) const {
+    // Start Newton's method from the end with the smaller residual.
+    double* tangents = registers + this->program.getRegisterCount();
+    double point = (std::fabs(lowerValue) < std::fabs(upperValue)) ? lower : upper, previousResidual = INFINITY;
+    uint32_t evaluationLimit = root.evaluationCount + maximumEvaluations;
+    while (root.evaluationCount < evaluationLimit) {
+        double slope, value = this->program.evaluateDerivative(&point, 0, registers, tangents, slope);
+        root.evaluationCount++;
+        if (value == 0) {
+            root.value = point;
+            root.residual = 0;
+            return;
+        }
+
+        // Shrink the bracket around the root. Points where the expression is not defined are left to Brent's method.
+        if (std::isnan(value)) break;
+        if (haveOppositeSigns(value, upperValue)) {
+            lower = point;
+            lowerValue = value;
+        } else {
+            upper = point;
+            upperValue = value;
+        }
+
+        // Hand the bracket over to Brent's method if the step leaves the bracket or the residual has not been halved.
+        double next = point - value / slope;
+        if (!(next > std::min(lower, upper) && next < std::max(lower, upper)) || !(std::fabs(value) <= 0.5 * previousResidual)) break;
+
+        // Stop once the step is below the spacing of doubles around the root.
+        if (std::fabs(next - point) <= 2 * DBL_EPSILON * std::fabs(next)) {
+            root.value = next;
+            root.residual = this->program.evaluate(&next, registers);
+            root.evaluationCount++;
+            return;
+        }
+        previousResidual = std::fabs(value);
+        point = next;
+    }
+    this->refineWithBrent(lower, upper, lowerValue, upperValue, evaluationLimit, registers, root);
+}
+
+void EquationSolver::refineWithBrent(double lower, double upper, double lowerValue, double upperValue, uint32_t evaluationLimit, double* registers, EquationRoot& root) const {
+    // b is the best estimate, a the previous one, and [b, c] always brackets the root.
+    double a = lower, b = upper, c = lower, fa = lowerValue, fb = upperValue, fc = lowerValue;
+    double step = b - a, previousStep = step;
+    while (root.evaluationCount < evaluationLimit) {
+        // Keep c on the other side of the root, and b as the end with the smaller residual.
+        if (!haveOppositeSigns(fb, fc)) {
+            c = a;
+            fc = fa;
+            step = previousStep = b - a;
+        }
+        if (std::fabs(fc) < std::fabs(fb)) {
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+
+        // Stop once the bracket is below the spacing of doubles around the root.
+        double tolerance = 2 * DBL_EPSILON * std::fabs(b) + DBL_MIN, halfWidth = 0.5 * (c - b);
+        if (std::fabs(halfWidth) <= tolerance || fb == 0) {
+            root.value = b;
+            root.residual = fb;
+            return;
+        }
+
+        // Interpolate (inverse quadratic, or secant with two points) if the previous steps converged fast enough, bisect otherwise.
+        if (std::fabs(previousStep) < tolerance || std::fabs(fa) <= std::fabs(fb)) {
+            step = previousStep = halfWidth;
+        } else {
+            double s = fb / fa, p, q;
+            if (a == c) {
+                p = 2 * halfWidth * s;
+                q = 1 - s;
+            } else {
+                double r = fb / fc;
+                q = fa / fc;
+                p = s * (2 * halfWidth * q * (q - r) - (b - a) * (r - 1));
+                q = (q - 1) * (r - 1) * (s - 1);
+            }
+            if (p > 0) q = -q;
+            else p = -p;
+            if (2 * p < std::min(3 * halfWidth * q - std::fabs(tolerance * q), std::fabs(previousStep * q))) {
+                previousStep = step;
+                step = p / q;
+            } else {
+                step = previousStep = halfWidth;
+            }
+        }
+
+        // Move the estimate by at least the tolerance.
+        a = b;
+        fa = fb;
+        b += (std::fabs(step) > tolerance) ? step : std::copysign(tolerance, halfWidth);
+        fb = this->program.evaluate(&b, registers);
+        root.evaluationCount++;
+        if (std::isnan(fb)) throw std::invalid_argument("EvalError: The expression is not defined at " + formatPoint(b) + " inside the bracket.\n");
+    }
+    throw std::invalid_argument("EvalError: No root found after " + std::to_string(maximumEvaluations) + " evaluations.\n");
+}
+
+EquationRoot EquationSolver::solveFromGuess(double guess) const {
+    // Allocate the register and derivative files once for the whole search.
+    std::vector<double> registers(2 * this->program.getRegisterCount());
+    double* tangents = registers.data() + this->program.getRegisterCount();
+    EquationRoot root = {NAN, NAN, 1};
+    double slope, value = this->program.evaluateDerivative(&guess, 0, registers.data(), tangents, slope);
+    if (!std::isfinite(value)) throw std::invalid_argument("EvalError: The expression is not defined at the guess " + formatPoint(guess) + ".\n");
+
+    // Take Newton steps, halving them while they increase the residual or leave the domain, until one crosses the root.
+    double point = guess;
+    while (value != 0 && std::isfinite(slope) && slope != 0 && root.evaluationCount < maximumEvaluations) {
+        double step = value / slope, next = point, nextValue = NAN, nextSlope = NAN;
+        for (int halving = 0; halving < maximumBracketExpansions && root.evaluationCount < maximumEvaluations; halving++, step *= 0.5) {
+            next = point - step;
+            nextValue = this->program.evaluateDerivative(&next, 0, registers.data(), tangents, nextSlope);
+            root.evaluationCount++;
+            if (std::fabs(nextValue) < std::fabs(value) || haveOppositeSigns(value, nextValue)) break;
+        }
+        if (!(std::fabs(nextValue) < std::fabs(value)) && !haveOppositeSigns(value, nextValue)) break;
+
+        // A step crossing the root gives a bracket, refined safely.
+        if (haveOppositeSigns(value, nextValue)) {
+            this->refineBracket(point, next, value, nextValue, registers.data(), root);
+            if (isDiscontinuity(root, value, nextValue)) throwDiscontinuity(guess, root);
+            return root;
+        }
+
+        // Roots of even multiplicity are never crossed: stop once the step is below the spacing of doubles, or negligible next to
+        // the guess for roots at 0, which Newton's method only approaches linearly.
+        if (std::fabs(next - point) <= 2 * DBL_EPSILON * std::fabs(next) + DBL_EPSILON * DBL_EPSILON * std::max(std::fabs(guess), 1.0)) {
+            root.value = next;
+            root.residual = nextValue;
+            return root;
+        }
+        point = next;
+        value = nextValue;
+        slope = nextSlope;
+    }
+    if (value == 0) {
+        root.value = point;
+        root.residual = 0;
+        return root;
+    }
+
+    // Without a usable derivative, step away from the guess in both directions until the expression changes sign.
+    double distance = 0.01 * std::max(std::fabs(guess), 1.0), previousPoints[2] = {guess, guess};
+    value = this->program.evaluate(&guess, registers.data());
+    root.evaluationCount++;
+    for (int expansion = 0; expansion < maximumBracketExpansions; expansion++, distance *= 2) {
+        for (int direction = 0; direction < 2; direction++) {
+            double candidate = (direction == 0) ? guess - distance : guess + distance;
+            double candidateValue = this->program.evaluate(&candidate, registers.data());
+            root.evaluationCount++;
+            if (candidateValue == 0) {
+                root.value = candidate;
+                root.residual = 0;
+                return root;
+            }
+            if (haveOppositeSigns(value, candidateValue)) {
+                // Bracket the root between the candidate and the previous point in the same direction.
+                double previous = previousPoints[direction], previousValue = this->program.evaluate(&previous, registers.data());
+                root.evaluationCount++;
+                this->refineBracket(previous, candidate, previousValue, candidateValue, registers.data(), root);
+                if (isDiscontinuity(root, previousValue, candidateValue)) throwDiscontinuity(guess, root);
+                return root;
+            }
+            if (std::isfinite(candidateValue)) previousPoints[direction] = candidate;
+        }
+    }
+    throw std::invalid_argument("EvalError: No root found around the guess " + formatPoint(guess) + ".\n");
+}
+
+std::vector<EquationRoot> EquationSolver::solveRange(const TableRange& range) const {
+    // Bracket found on the grid: two neighbouring points where the expression changes sign, or a point where it vanishes.
+    struct Bracket {
+        double lower, upper, lowerValue, upperValue;
+    };
+
+    // Sample the grid in blocks, each block also sampling the first point of the next one, and collect the brackets.
+    uint64_t pointCount = range.getPointCount();
+    uint64_t blockCount = (pointCount + pointsPerBlock - 1) / pointsPerBlock;
+    std::vector<std::vector<Bracket>> blockBrackets(blockCount);
+    this->pool.parallelFor(0, blockCount, 1, [&](size_t begin, size_t end) {
+        std::vector<double> registers(this->program.getRegisterCount());
+        for (size_t block = begin; block < end; block++) {
+            uint64_t firstPoint = block * pointsPerBlock, lastPoint = std::min(firstPoint + pointsPerBlock, pointCount - 1);
+            double previous = range.start + static_cast<double>(firstPoint) * range.step;
+            double previousValue = this->program.evaluate(&previous, registers.data());
+            if (previousValue == 0) blockBrackets[block].push_back({previous, previous, 0, 0});
+            for (uint64_t point = firstPoint + 1; point <= lastPoint; point++) {
+                double current = range.start + static_cast<double>(point) * range.step;
+                double currentValue = this->program.evaluate(&current, registers.data());
+                if (haveOppositeSigns(previousValue, currentValue)) blockBrackets[block].push_back({previous, current, previousValue, currentValue});
+                if (currentValue == 0 && point < lastPoint) blockBrackets[block].push_back({current, current, 0, 0});
+                previous = current;
+                previousValue = currentValue;
+            }
+            // The last point of the grid belongs to no next block.
+            if (lastPoint == pointCount - 1 && lastPoint > firstPoint && previousValue == 0) blockBrackets[block].push_back({previous, previous, 0, 0});
+        }
+    });
+    std::vector<Bracket> brackets;
+    for (const std::vector<Bracket>& block : blockBrackets) brackets.insert(brackets.end(), block.begin(), block.end());
+
+    // Refine the brackets in parallel. Brackets around a pole (the residual exceeds the values at the ends) or a point
+    // outside the domain are dropped.
+    std::vector<EquationRoot> roots(brackets.size());
+    std::vector<char> isRoot(brackets.size(), 0);
+    this->pool.parallelFor(0, brackets.size(), 1, [&](size_t begin, size_t end) {
+        std::vector<double> registers(2 * this->program.getRegisterCount());
+        for (size_t index = begin; index < end; index++) {
+            const Bracket& bracket = brackets[index];
+            roots[index] = {bracket.lower, 0, 1};
+            isRoot[index] = 1;
+            if (bracket.lower == bracket.upper) continue;
+            try {
+                this->refineBracket(bracket.lower, bracket.upper, bracket.lowerValue, bracket.upperValue, registers.data(), roots[index]);
+                isRoot[index] = !isDiscontinuity(roots[index], bracket.lowerValue, bracket.upperValue);
+            } catch (std::invalid_argument&) {
+                isRoot[index] = 0;
+            }
+        }
+    });
+
+    // Keep the roots in grid order.
+    std::vector<EquationRoot> result;
+    for (size_t index = 0; index < roots.size(); index++) {
+        if (isRoot[index]) result.push_back(roots[index]);
+    }
+    return result;
+}
@@ -0,0 +1,96 @@
+#ifndef __EQUATION_SOLVER
+#define __EQUATION_SOLVER
+
+#include "ExpressionCompiler.hpp"
+#include "TableGenerator.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief Root found by the equation solver.
+struct EquationRoot {
+    /// @brief Point where the expression vanishes.
+    double value;
+
+    /// @brief Value of the expression at the point (0, or within a few rounding errors of it).
+    double residual;
+
+    /// @brief Number of evaluations of the expression spent on this root.
+    uint32_t evaluationCount;
+};
+
+/// @brief Class for finding the roots of a compiled expression of one variable, e.g. "cos(x) - x" to solve cos(x) = x.
+/// Roots are refined with Newton's method, using the exact derivative computed by forward-mode automatic differentiation
+/// (see CompiledExpression::evaluateDerivative()). Inside a bracket every Newton step is safeguarded: a step leaving the bracket,
+/// a missing derivative (e.g. through floor) or a step which does not halve the residual hands the bracket over to Brent's method,
+/// which always converges. Searches over a range sample the expression on a grid, then refine every sign change in parallel.
+/// Programs should be compiled unchecked, so points outside the domain of an operator produce nan instead of throwing.
+class EquationSolver {
+    public:
+        /// @brief Constructor for the equation solver class.
+        /// @param program Compiled expression of exactly one variable.
+        /// @param pool Thread pool sampling the grid and refining the brackets.
+        /// @throws invalid_argument error if the program does not have exactly one variable.
+        EquationSolver(const CompiledExpression& program, WorkStealingThreadPool& pool = WorkStealingThreadPool::getSharedPool());
+
+        /// @brief Method for finding a root inside a bracket, where the expression changes sign.
+        /// @param lower One end of the bracket.
+        /// @param upper Other end of the bracket.
+        /// @returns The root.
+        /// @throws invalid_argument error if the expression has the same sign at both ends, is not defined inside the bracket, or
+        /// only changes sign across a discontinuity (e.g. tan(x) between 1 and 2).
+        EquationRoot solveBracket(double lower, double upper) const;
+
+        /// @brief Method for finding a root from a starting guess.
+        /// Newton steps are taken until one crosses the root, which then gives a bracket. If the derivative is missing or 0,
+        /// a bracket is searched by stepping away from the guess in both directions with doubling steps.
+        /// @param guess Starting point.
+        /// @returns The root.
+        /// @throws invalid_argument error if no root has been found, or the bracket found holds a discontinuity.
+        EquationRoot solveFromGuess(double guess) const;
+
+        /// @brief Method for finding every root of a range, sampling the expression on a grid and refining each sign change.
+        /// Roots closer to each other than the step can be missed, and so can roots of even multiplicity (e.g. x^2) unless they
+        /// lie on the grid. Sign changes across poles (e.g. tan(x) at pi/2) are discarded.
+        /// @param range Grid to sample, e.g. x=0..10 step 0.1.
+        /// @returns The roots, in increasing order of the grid.
+        /// @throws invalid_argument error if the range is invalid.
+        std::vector<EquationRoot> solveRange(const TableRange& range) const;
+
+    private:
+        /// @brief Largest number of evaluations spent refining a single bracket, or taking Newton steps from a guess.
+        static constexpr uint32_t maximumEvaluations = 200;
+
+        /// @brief Largest number of doublings of the step while searching for a bracket around a guess.
+        static constexpr int maximumBracketExpansions = 64;
+
+        /// @brief Number of grid points sampled by a single task.
+        static constexpr uint64_t pointsPerBlock = 4096;
+
+        /// @brief Program whose roots are searched.
+        const CompiledExpression& program;
+
+        /// @brief Thread pool sampling the grid and refining the brackets.
+        WorkStealingThreadPool& pool;
+
+        /// @brief Private method for refining a bracket with safeguarded Newton steps, then Brent's method if they fail.
+        /// @param lower One end of the bracket.
+        /// @param upper Other end of the bracket.
+        /// @param lowerValue Value of the expression at lower.
+        /// @param upperValue Value of the expression at upper, of the opposite sign.
+        /// @param registers Scratch buffer holding at least 2 * getRegisterCount() doubles (registers, then derivatives).
+        /// @param root Root receiving the result, whose evaluationCount already holds the evaluations spent so far.
+        /// @throws invalid_argument error if the expression is not defined inside the bracket or does not converge.
+        void refineBracket(double lower, double upper, double lowerValue, double upperValue, double* registers, EquationRoot& root) const;
+
+        /// @brief Private method for refining a bracket with Brent's method (inverse quadratic interpolation, secant, bisection).
+        /// @param lower One end of the bracket.
+        /// @param upper Other end of the bracket.
+        /// @param lowerValue Value of the expression at lower.
+        /// @param upperValue Value of the expression at upper, of the opposite sign.
+        /// @param evaluationLimit Value of root.evaluationCount at which the refinement gives up.
+        /// @param registers Scratch register file.
+        /// @param root Root receiving the result, whose evaluationCount already holds the evaluations spent so far.
+        /// @throws invalid_argument error if the expression is not defined inside the bracket or does not converge.
+        void refineWithBrent(double lower, double upper, double lowerValue, double upperValue, uint32_t evaluationLimit, double* registers, EquationRoot& root) const;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "EvaluationBudget.hpp"
+
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+
+CancellationToken::CancellationToken() : isCancelledFlag(std::make_shared<std::atomic<bool>>(false)) {}
+
+void CancellationToken::cancel() const {
+    this->isCancelledFlag->store(true, std::memory_order_relaxed);
+}
+
+bool CancellationToken::isCancelled() const {
+    return this->isCancelledFlag->load(std::memory_order_relaxed);
+}
+
+EvaluationBudget::EvaluationBudget(const EvaluationLimits& limits) : limits(limits) {
+    // Compute the deadline, saturating instead of overflowing for long (or unlimited) time limits.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds remaining = std::chrono::steady_clock::time_point::max() - now;
+    this->deadline = (limits.timeLimit >= remaining) ? std::chrono::steady_clock::time_point::max() : now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(limits.timeLimit);
+}
+
+void EvaluationBudget::check() {
+    // Throw invalid_argument error if the evaluation has exceeded its step limit.
+    if (this->stepCount > this->limits.maximumStepCount) {
+        std::string errorMessage = "BudgetError: Exceeded the budget of " + std::to_string(this->limits.maximumStepCount);
+        errorMessage += " step(s).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Throw invalid_argument error if the evaluation has been cancelled or has run out of time, reporting how far it went.
+    if (this->limits.cancellationToken.isCancelled()) {
+        std::string errorMessage = "BudgetError: Evaluation has been cancelled after " + std::to_string(this->stepCount);
+        errorMessage += " step(s).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+    if (std::chrono::steady_clock::now() > this->deadline) {
+        std::string errorMessage = "BudgetError: Exceeded the time budget of " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(this->limits.timeLimit).count());
+        errorMessage += " us after " + std::to_string(this->stepCount) + " step(s).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Check again after a few more steps, or as soon as the step limit is exceeded.
+    uint64_t stepsUntilLimit = this->limits.maximumStepCount - std::min(this->stepCount, this->limits.maximumStepCount);
+    this->nextCheckStepCount = this->stepCount + std::min(stepsPerCheck - 1, stepsUntilLimit) + 1;
+}
+
+uint64_t EvaluationBudget::getStepCount() const {
+    return this->stepCount;
+}
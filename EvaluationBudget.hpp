@@ -0,0 +1,90 @@
+#ifndef __EVALUATION_BUDGET
+#define __EVALUATION_BUDGET
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+
+/// @brief Token shared between a caller and the evaluations it started, used to cancel them.
+/// Copies share the same state, so cancelling any copy cancels every evaluation holding one.
+class CancellationToken {
+    public:
+        /// @brief Constructor for the cancellation token class. The token starts uncancelled.
+        CancellationToken();
+
+        /// @brief Method for requesting the evaluations holding the token to stop.
+        void cancel() const;
+
+        /// @brief Method for checking whether the token has been cancelled.
+        bool isCancelled() const;
+
+    private:
+        /// @brief Flag shared by the copies of the token.
+        std::shared_ptr<std::atomic<bool>> isCancelledFlag;
+};
+
+/// @brief Limits of a single evaluation. The default limits never stop an evaluation.
+struct EvaluationLimits {
+    /// @brief Largest number of interpreter steps (one per executed instruction).
+    uint64_t maximumStepCount = UINT64_MAX;
+
+    /// @brief Longest duration of the evaluation, counted from the moment it has been requested.
+    std::chrono::nanoseconds timeLimit = std::chrono::nanoseconds::max();
+
+    /// @brief Token cancelling the evaluation.
+    CancellationToken cancellationToken;
+};
+
+/// @brief Budget consumed by an evaluation while it runs.
+/// Consuming steps only adds to a counter: the step limit, the token and the clock are checked every stepsPerCheck steps (or polls),
+/// so the budget costs a compare per instruction and an atomic load and a clock read every few hundred instructions.
+class EvaluationBudget {
+    public:
+        /// @brief Constructor for the evaluation budget class. Starts the clock.
+        /// @param limits Limits of the evaluation.
+        explicit EvaluationBudget(const EvaluationLimits& limits);
+
+        /// @brief Method for consuming interpreter steps.
+        /// @param stepCount Number of steps to consume.
+        /// @throws invalid_argument error if a limit has been exceeded or the evaluation has been cancelled.
+        void consumeSteps(uint64_t stepCount) {
+            this->stepCount += stepCount;
+            if (this->stepCount >= this->nextCheckStepCount) this->check();
+        }
+
+        /// @brief Method for checking the limits every few calls without consuming steps, e.g. while parsing.
+        /// @throws invalid_argument error if a limit has been exceeded or the evaluation has been cancelled.
+        void poll() {
+            if (++this->pollCount % stepsPerCheck == 0) this->check();
+        }
+
+        /// @brief Method for checking the limits right away, e.g. between the phases of an evaluation.
+        /// @throws invalid_argument error if a limit has been exceeded or the evaluation has been cancelled. The messages of the
+        /// time limit and the cancellation give the number of steps consumed, i.e. how far the evaluation went.
+        void check();
+
+        /// @brief Method for accessing the number of steps consumed so far.
+        uint64_t getStepCount() const;
+
+    private:
+        /// @brief Number of steps consumed between two checks of the token and the clock.
+        static constexpr uint64_t stepsPerCheck = 256;
+
+        /// @brief Limits of the evaluation.
+        EvaluationLimits limits;
+
+        /// @brief Moment after which the evaluation is stopped.
+        std::chrono::steady_clock::time_point deadline;
+
+        /// @brief Number of steps consumed so far.
+        uint64_t stepCount = 0;
+
+        /// @brief Number of steps at which the limits are checked next.
+        uint64_t nextCheckStepCount = 0;
+
+        /// @brief Number of calls to poll().
+        uint64_t pollCount = 0;
+};
+
+#endif
@@ -0,0 +1,1443 @@
+#include "ExpressionCompiler.hpp"
+#include "FastMath.hpp"
+#include "IntegerArithmetic.hpp"
+#include "ThreadPool.hpp"
+#include "VectorKernels.hpp"
+
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+double CompiledExpression::evaluate(const std::vector<double>& variableValues) const {
+    // Check if every variable has been given a value. If not, throw invalid_argument error.
+    if (variableValues.size() != this->variableNames.size()) {
+        std::string errorMessage = "EvalError: Expected ";
+        errorMessage += std::to_string(this->variableNames.size()) + " variable value(s), got ";
+        errorMessage += std::to_string(variableValues.size()) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Allocate a register file for this call, then evaluate the program.
+    std::vector<double> registers(this->registerCount);
+    return this->evaluate(variableValues.data(), registers.data());
+}
+
+double CompiledExpression::evaluate(const double* variableValues, double* registers) const {
+    return this->evaluate(variableValues, registers, nullptr);
+}
+
+double CompiledExpression::evaluate(const double* variableValues, double* registers, WorkStealingThreadPool& pool) const {
+    return this->evaluate(variableValues, registers, &pool);
+}
+
+double CompiledExpression::evaluate(const double* variableValues, double* registers, WorkStealingThreadPool* pool) const {
+    // Load the constants and the variables into their registers.
+    std::copy(this->constants.begin(), this->constants.end(), registers);
+    std::copy(variableValues, variableValues + this->variableNames.size(), registers + this->constants.size());
+
+    // Execute the instructions in order. Every operand has been computed by a previous instruction.
+    for (const Instruction& instruction : this->instructions) {
+        registers[instruction.destinationRegister] = this->executeInstruction(instruction, variableValues, registers, pool);
+    }
+
+    // Return the value held by the result register.
+    return registers[this->resultRegister];
+}
+
+double CompiledExpression::evaluate(const double* variableValues, double* registers, EvaluationStatus& status) const {
+    // Load the constants and the variables into their registers.
+    std::copy(this->constants.begin(), this->constants.end(), registers);
+    std::copy(variableValues, variableValues + this->variableNames.size(), registers + this->constants.size());
+
+    // Execute the instructions, keeping the lowest index of an instruction producing nan or inf without branching on it.
+    uint32_t firstInvalidInstruction = status.firstInvalidInstruction;
+    for (uint32_t index = 0; index < this->instructions.size(); index++) {
+        double result = this->executeInstruction(this->instructions[index], variableValues, registers, nullptr);
+        registers[this->instructions[index].destinationRegister] = result;
+        firstInvalidInstruction = std::min(firstInvalidInstruction, std::isfinite(result) ? EvaluationStatus::noInvalidInstruction : index);
+    }
+
+    // Store the sticky status once, then return the value held by the result register.
+    status.firstInvalidInstruction = firstInvalidInstruction;
+    return registers[this->resultRegister];
+}
+
+/// @brief Pointer to the derivative of a unary operator, given its operand and its value at the operand.
+typedef double (*UnaryDerivative)(double operand, double result);
+
+/// @brief Table mapping unary operator names to their derivatives. Piecewise constant operators (ceil, floor, round, !) are missing.
+static const std::unordered_map<std::string, UnaryDerivative> unaryDerivativeLookupTable = {
+    {"neg", [](double, double) { return -1.0; }},
+    {"abs", [](double operand, double) { return (operand > 0) ? 1.0 : (operand < 0) ? -1.0 : NAN; }},
+    {"sqrt", [](double, double result) { return 0.5 / result; }},
+    {"cbrt", [](double, double result) { return 1 / (3 * result * result); }},
+    {"exp", [](double, double result) { return result; }},
+    {"ln", [](double operand, double) { return 1 / operand; }},
+    {"log2", [](double operand, double) { return 1 / (operand * M_LN2); }},
+    {"log", [](double operand, double) { return 1 / (operand * M_LN10); }},
+    {"sin", [](double operand, double) { return std::cos(operand); }},
+    {"cos", [](double operand, double) { return -std::sin(operand); }},
+    {"tan", [](double, double result) { return 1 + result * result; }},
+    {"sec", [](double operand, double result) { return result * std::tan(operand); }},
+    {"csc", [](double operand, double result) { return -result / std::tan(operand); }},
+    {"cosec", [](double operand, double result) { return -result / std::tan(operand); }},
+    {"cot", [](double, double result) { return -(1 + result * result); }},
+    {"asin", [](double operand, double) { return 1 / std::sqrt(1 - operand * operand); }},
+    {"acos", [](double operand, double) { return -1 / std::sqrt(1 - operand * operand); }},
+    {"atan", [](double operand, double) { return 1 / (1 + operand * operand); }},
+    {"sinh", [](double operand, double) { return std::cosh(operand); }},
+    {"cosh", [](double operand, double) { return std::sinh(operand); }},
+    {"tanh", [](double, double result) { return 1 - result * result; }},
+    {"asinh", [](double operand, double) { return 1 / std::sqrt(operand * operand + 1); }},
+    {"acosh", [](double operand, double) { return 1 / std::sqrt(operand * operand - 1); }},
+    {"atanh", [](double operand, double) { return 1 / (1 - operand * operand); }}
+};
+
+/// @brief Function for computing the derivative of a binary operator from the derivatives of its operands.
+/// Operands whose derivative is 0 do not contribute, so e.g. x^3 stays differentiable at negative x.
+/// tan, sec, csc, cot and cotcheck are the binary instructions fed by a sineCosine instruction (see OperationCode::sineCosine).
+/// @param name Operator name.
+/// @param first First operand.
+/// @param second Second operand.
+/// @param result Value of the operator at the operands.
+/// @param firstTangent Derivative of the first operand.
+/// @param secondTangent Derivative of the second operand.
+/// @returns Derivative of the result (nan if the operator has no derivative).
+static double differentiateBinary(const std::string& name, double first, double second, double result, double firstTangent, double secondTangent) {
+    switch (name[0]) {
+        case '+': return firstTangent + secondTangent;
+        case '-': return firstTangent - secondTangent;
+        case '*': return firstTangent * second + first * secondTangent;
+        case '/': return (firstTangent - result * secondTangent) / second;
+        case '%': return firstTangent - std::trunc(first / second) * secondTangent;
+        case '^': {
+            double tangent = (firstTangent == 0) ? 0 : second * std::pow(first, second - 1) * firstTangent;
+            return (secondTangent == 0) ? tangent : tangent + result * std::log(first) * secondTangent;
+        }
+        case 'l': {
+            // log_(base, power) = ln(power) / ln(base).
+            double baseLogarithm = std::log(first);
+            return (secondTangent / second - result * firstTangent / first) / baseLogarithm;
+        }
+        case 't': return (firstTangent - result * secondTangent) / second;
+        case 's': return -result * firstTangent / first;
+        case 'c':
+            // cotcheck passes the sine through.
+            if (name == "cotcheck") return firstTangent;
+            return (name == "cot") ? (firstTangent - result * secondTangent) / second : -result * firstTangent / first;
+    }
+    return NAN;
+}
+
+/// @brief Function for adding a term to a Neumaier (improved Kahan) compensated sum.
+/// @param sum Reference to the running sum.
+/// @param compensation Reference to the running sum of the rounding errors.
+/// @param term Term to add.
+static inline void addCompensated(double& sum, double& compensation, double term) {
+    double newSum = sum + term;
+    compensation += (std::fabs(sum) >= std::fabs(term)) ? (sum - newSum) + term : (term - newSum) + sum;
+    sum = newSum;
+}
+
+/// @brief Function for multiplying two numbers, used by the product instructions of block evaluations.
+/// @param firstOperand First operand.
+/// @param secondOperand Second operand.
+/// @returns firstOperand * secondOperand.
+static double multiplyValues(double firstOperand, double secondOperand) {
+    return firstOperand * secondOperand;
+}
+
+/// @brief Function for throwing the domain error of sec, csc and cot, like the checked kernels of the calculator do.
+/// @param name Operator name.
+/// @param operand Operand of the operator.
+[[noreturn]] static void throwTrigonometricDomainError(const std::string& name, double operand) {
+    std::stringstream errorStringStream;
+    errorStringStream << "DomainError: " << name << '(' << operand << ") is not defined.\n";
+    throw std::invalid_argument(errorStringStream.str());
+}
+
+/// @brief Function computing tan from (sin, cos), or cot from (cos, sin), of a sineCosine instruction.
+/// cos is never 0 at a double, so tan needs no check.
+/// @param numerator sin for tan, cos for cot.
+/// @param denominator cos for tan, sin for cot.
+/// @returns numerator / denominator.
+static double divideTrigonometric(double numerator, double denominator) {
+    return numerator / denominator;
+}
+
+/// @brief Function computing sec from cos, or csc from sin, of a sineCosine instruction (the angle is passed alongside).
+/// @param value cos for sec, sin for csc.
+/// @returns 1 / value.
+static double invertTrigonometric(double value, double) {
+    return 1 / value;
+}
+
+/// @brief Checked form of invertTrigonometric() for sec.
+/// @param cosine cos of the angle.
+/// @param angle Operand of sec, reported by the error.
+static double checkedSecant(double cosine, double angle) {
+    if (cosine == 0) throwTrigonometricDomainError("sec", angle);
+    return 1 / cosine;
+}
+
+/// @brief Checked form of invertTrigonometric() for csc.
+/// @param sine sin of the angle.
+/// @param angle Operand of csc, reported by the error.
+static double checkedCosecant(double sine, double angle) {
+    if (sine == 0) throwTrigonometricDomainError("csc", angle);
+    return 1 / sine;
+}
+
+/// @brief Function checking the denominator of a checked cot before divideTrigonometric() divides by it ("cotcheck" instructions),
+/// since the division has no operand left for the angle.
+/// @param sine sin of the angle.
+/// @param angle Operand of cot, reported by the error.
+/// @returns sine.
+static double checkCotangentDenominator(double sine, double angle) {
+    if (sine == 0) throwTrigonometricDomainError("cot", angle);
+    return sine;
+}
+
+inline double CompiledExpression::executeInstruction(const Instruction& instruction, const double* variableValues, double* registers, WorkStealingThreadPool* pool) const {
+    switch (instruction.operationCode) {
+        case OperationCode::unary:
+            return instruction.unaryFunction(registers[instruction.firstOperandRegister]);
+
+        case OperationCode::approximateUnary:
+            return evaluateFastFunction(static_cast<FastFunction>(instruction.secondOperandRegister), this->mathAccuracy, instruction.unaryFunction, registers[instruction.firstOperandRegister]);
+
+        case OperationCode::binary:
+            return instruction.binaryFunction(registers[instruction.firstOperandRegister], registers[instruction.secondOperandRegister]);
+
+        case OperationCode::sineCosine: {
+            // Store the cosine, then return the sine like any other result.
+            double sine;
+            evaluateSineCosine(this->mathAccuracy, registers[instruction.firstOperandRegister], sine, registers[instruction.secondOperandRegister]);
+            return sine;
+        }
+
+        case OperationCode::sum: {
+            // Add the (possibly negated) operands with compensated summation.
+            double sum = 0, compensation = 0;
+            for (uint32_t index = 0; index < instruction.secondOperandRegister; index++) {
+                uint32_t operand = this->reductionOperands[instruction.firstOperandRegister + index];
+                double term = registers[operand & ~negatedOperandFlag];
+                addCompensated(sum, compensation, (operand & negatedOperandFlag) ? -term : term);
+            }
+            return sum + compensation;
+        }
+
+        case OperationCode::product: {
+            // Multiply the operands.
+            double product = 1;
+            for (uint32_t index = 0; index < instruction.secondOperandRegister; index++) {
+                product *= registers[this->reductionOperands[instruction.firstOperandRegister + index]];
+            }
+            return product;
+        }
+
+        case OperationCode::parallelSum: case OperationCode::parallelProduct: {
+            // Evaluate the subprograms in parallel. Each one computes the partial result of a contiguous group of terms.
+            // The shared pool is only created once a program actually needs it.
+            if (pool == nullptr) pool = &WorkStealingThreadPool::getSharedPool();
+            std::vector<double> partialResults(instruction.secondOperandRegister);
+            pool->parallelFor(0, instruction.secondOperandRegister, 1, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; index++) {
+                    const CompiledExpression& subprogram = *this->subprograms[instruction.firstOperandRegister + index];
+                    std::vector<double> subprogramRegisters(subprogram.registerCount);
+                    partialResults[index] = subprogram.evaluate(variableValues, subprogramRegisters.data(), pool);
+                }
+            });
+
+            // Combine the partial results in order, so the result does not depend on the scheduling.
+            double result = (instruction.operationCode == OperationCode::parallelSum) ? 0 : 1, compensation = 0;
+            for (double partialResult : partialResults) {
+                (instruction.operationCode == OperationCode::parallelSum) ? addCompensated(result, compensation, partialResult) : void(result *= partialResult);
+            }
+            return result + compensation;
+        }
+
+        case OperationCode::polynomial: {
+            // Evaluate the polynomial with Horner's scheme, skipping the missing powers.
+            const std::vector<double>& coefficients = this->polynomialCoefficients[instruction.secondOperandRegister];
+            double operand = registers[instruction.firstOperandRegister], result = coefficients.back();
+            for (size_t degree = coefficients.size() - 1; degree > 0; degree--) {
+                result *= operand;
+                if (coefficients[degree - 1] != 0) result += coefficients[degree - 1];
+            }
+            return result;
+        }
+    }
+    return NAN;
+}
+
+double CompiledExpression::evaluateDerivative(const double* variableValues, uint32_t variableSlot, double* registers, double* tangents, double& derivative) const {
+    // Load the constants and the variables into their registers. Only the differentiated variable has a derivative.
+    uint32_t constantCount = static_cast<uint32_t>(this->constants.size());
+    std::copy(this->constants.begin(), this->constants.end(), registers);
+    std::copy(variableValues, variableValues + this->variableNames.size(), registers + constantCount);
+    std::fill(tangents, tangents + constantCount + this->variableNames.size(), 0.0);
+    tangents[constantCount + variableSlot] = 1;
+
+    for (size_t index = 0; index < this->instructions.size(); index++) {
+        const Instruction& instruction = this->instructions[index];
+        double& tangent = tangents[instruction.destinationRegister];
+        double first = registers[instruction.firstOperandRegister], firstTangent = tangents[instruction.firstOperandRegister];
+
+        // Compute the value the same way as evaluate(), except for the subprograms which also need their derivative.
+        double result = (instruction.operationCode == OperationCode::parallelSum || instruction.operationCode == OperationCode::parallelProduct)
+            ? 0 : this->executeInstruction(instruction, variableValues, registers, nullptr);
+
+        switch (instruction.operationCode) {
+            case OperationCode::unary: case OperationCode::approximateUnary: {
+                // Operands without a derivative contribute nothing, whatever the derivative of the operator.
+                auto iterator = unaryDerivativeLookupTable.find(this->operatorNames[index]);
+                if (firstTangent == 0) tangent = 0;
+                else tangent = (iterator == unaryDerivativeLookupTable.end()) ? NAN : iterator->second(first, result) * firstTangent;
+                break;
+            }
+
+            case OperationCode::sineCosine:
+                // sin' = cos and cos' = -sin.
+                tangents[instruction.secondOperandRegister] = (firstTangent == 0) ? 0 : -result * firstTangent;
+                tangent = (firstTangent == 0) ? 0 : registers[instruction.secondOperandRegister] * firstTangent;
+                break;
+
+            case OperationCode::binary:
+                tangent = differentiateBinary(this->operatorNames[index], first, registers[instruction.secondOperandRegister], result, firstTangent, tangents[instruction.secondOperandRegister]);
+                break;
+
+            case OperationCode::sum:
+                tangent = 0;
+                for (uint32_t operandIndex = 0; operandIndex < instruction.secondOperandRegister; operandIndex++) {
+                    uint32_t operand = this->reductionOperands[instruction.firstOperandRegister + operandIndex];
+                    double term = tangents[operand & ~negatedOperandFlag];
+                    tangent += (operand & negatedOperandFlag) ? -term : term;
+                }
+                break;
+
+            case OperationCode::product: {
+                // Apply the product rule one operand at a time, which stays exact when an operand is 0.
+                double product = 1;
+                tangent = 0;
+                for (uint32_t operandIndex = 0; operandIndex < instruction.secondOperandRegister; operandIndex++) {
+                    uint32_t operand = this->reductionOperands[instruction.firstOperandRegister + operandIndex];
+                    tangent = tangent * registers[operand] + product * tangents[operand];
+                    product *= registers[operand];
+                }
+                break;
+            }
+
+            case OperationCode::parallelSum: case OperationCode::parallelProduct: {
+                // Differentiate the subprograms one after the other, combining them with the sum or the product rule.
+                bool isSum = instruction.operationCode == OperationCode::parallelSum;
+                double compensation = 0;
+                std::vector<double> subprogramRegisters, subprogramTangents;
+                result = isSum ? 0 : 1;
+                tangent = 0;
+                for (uint32_t subprogramIndex = 0; subprogramIndex < instruction.secondOperandRegister; subprogramIndex++) {
+                    const CompiledExpression& subprogram = *this->subprograms[instruction.firstOperandRegister + subprogramIndex];
+                    subprogramRegisters.resize(subprogram.registerCount);
+                    subprogramTangents.resize(subprogram.registerCount);
+                    double partialTangent;
+                    double partialResult = subprogram.evaluateDerivative(variableValues, variableSlot, subprogramRegisters.data(), subprogramTangents.data(), partialTangent);
+                    if (isSum) {
+                        addCompensated(result, compensation, partialResult);
+                        tangent += partialTangent;
+                    } else {
+                        tangent = tangent * partialResult + result * partialTangent;
+                        result *= partialResult;
+                    }
+                }
+                result += compensation;
+                break;
+            }
+
+            case OperationCode::polynomial: {
+                // Evaluate the derivative of the polynomial with Horner's scheme.
+                const std::vector<double>& coefficients = this->polynomialCoefficients[instruction.secondOperandRegister];
+                double slope = 0;
+                for (size_t degree = coefficients.size() - 1; degree > 0; degree--) slope = slope * first + static_cast<double>(degree) * coefficients[degree];
+                tangent = slope * firstTangent;
+                break;
+            }
+        }
+        registers[instruction.destinationRegister] = result;
+    }
+
+    // Return the value and the derivative held by the result register.
+    derivative = tangents[this->resultRegister];
+    return registers[this->resultRegister];
+}
+
+void CompiledExpression::evaluateBlock(const double* const* variableColumns, size_t count, double* registers, double* results) const {
+    this->evaluateBlock(variableColumns, count, registers, results, this->mathAccuracy);
+}
+
+void CompiledExpression::evaluateBlock(const double* const* variableColumns, size_t count, double* registers, double* results, MathAccuracy accuracy) const {
+    // Resolve registers to their elements. Constants are a single element broadcast to every row, variables refer to their
+    // column, and the register of every instruction occupies count elements of the scratch buffer.
+    uint32_t constantCount = static_cast<uint32_t>(this->constants.size());
+    uint32_t firstInstructionRegister = constantCount + static_cast<uint32_t>(this->variableNames.size());
+    auto getElements = [&](uint32_t registerIndex) -> const double* {
+        if (registerIndex < constantCount) return &this->constants[registerIndex];
+        if (registerIndex < firstInstructionRegister) return variableColumns[registerIndex - constantCount];
+        return registers + static_cast<size_t>(registerIndex - firstInstructionRegister) * count;
+    };
+
+    for (size_t index = 0; index < this->instructions.size(); index++) {
+        const Instruction& instruction = this->instructions[index];
+        double* destination = registers + static_cast<size_t>(instruction.destinationRegister - firstInstructionRegister) * count;
+        switch (instruction.operationCode) {
+            case OperationCode::unary: case OperationCode::approximateUnary: {
+                // Approximate the transcendental functions at the accuracy of the call, whichever opcode the program has been compiled to.
+                // Operators applied to a constant (left unfolded because the result is not finite) are computed once.
+                FastFunction function = (accuracy == MathAccuracy::library) ? FastFunction::none : findFastFunction(this->operatorNames[index]);
+                if (instruction.firstOperandRegister < constantCount) {
+                    std::fill(destination, destination + count, evaluateFastFunction(function, accuracy, instruction.unaryFunction, this->constants[instruction.firstOperandRegister]));
+                } else if (function != FastFunction::none) {
+                    applyFastFunctionElementwise(function, accuracy, instruction.unaryFunction, getElements(instruction.firstOperandRegister), destination, count);
+                } else {
+                    applyUnaryElementwise(findVectorKernel(this->operatorNames[index]), instruction.unaryFunction, getElements(instruction.firstOperandRegister), destination, count);
+                }
+                break;
+            }
+
+            case OperationCode::sineCosine: {
+                // The cosine register follows the sine register, so it starts count elements further.
+                double* cosine = registers + static_cast<size_t>(instruction.secondOperandRegister - firstInstructionRegister) * count;
+                if (instruction.firstOperandRegister < constantCount) {
+                    evaluateSineCosine(accuracy, this->constants[instruction.firstOperandRegister], destination[0], cosine[0]);
+                    std::fill(destination + 1, destination + count, destination[0]);
+                    std::fill(cosine + 1, cosine + count, cosine[0]);
+                } else {
+                    applySineCosineElementwise(accuracy, getElements(instruction.firstOperandRegister), destination, cosine, count);
+                }
+                break;
+            }
+
+            case OperationCode::binary:
+                // The quotients of a sincos (tan and cot) take the SIMD division, which falls back to their function on zero denominators.
+                applyBinaryElementwise(
+                    (this->operatorNames[index] == "tan" || this->operatorNames[index] == "cot") ? VectorKernel::divide : findVectorKernel(this->operatorNames[index]),
+                    instruction.binaryFunction,
+                    getElements(instruction.firstOperandRegister), instruction.firstOperandRegister < constantCount,
+                    getElements(instruction.secondOperandRegister), instruction.secondOperandRegister < constantCount,
+                    destination, count
+                );
+                break;
+
+            case OperationCode::sum:
+                // Add the (possibly negated) operands of every row with compensated summation.
+                for (size_t row = 0; row < count; row++) {
+                    double sum = 0, compensation = 0;
+                    for (uint32_t operandIndex = 0; operandIndex < instruction.secondOperandRegister; operandIndex++) {
+                        uint32_t operand = this->reductionOperands[instruction.firstOperandRegister + operandIndex];
+                        uint32_t registerIndex = operand & ~negatedOperandFlag;
+                        double term = getElements(registerIndex)[(registerIndex < constantCount) ? 0 : row];
+                        addCompensated(sum, compensation, (operand & negatedOperandFlag) ? -term : term);
+                    }
+                    destination[row] = sum + compensation;
+                }
+                break;
+
+            case OperationCode::product:
+                // Multiply the operands into the destination, one operand at a time.
+                std::fill(destination, destination + count, 1.0);
+                for (uint32_t operandIndex = 0; operandIndex < instruction.secondOperandRegister; operandIndex++) {
+                    uint32_t registerIndex = this->reductionOperands[instruction.firstOperandRegister + operandIndex];
+                    applyBinaryElementwise(VectorKernel::multiply, multiplyValues, destination, false, getElements(registerIndex), registerIndex < constantCount, destination, count);
+                }
+                break;
+
+            case OperationCode::parallelSum: case OperationCode::parallelProduct: {
+                // Evaluate the subprograms one after the other, combining their partial results in order.
+                bool isSum = instruction.operationCode == OperationCode::parallelSum;
+                std::vector<double> partialResults(count), compensations(isSum ? count : 0, 0.0), subprogramRegisters;
+                std::fill(destination, destination + count, isSum ? 0.0 : 1.0);
+                for (uint32_t subprogramIndex = 0; subprogramIndex < instruction.secondOperandRegister; subprogramIndex++) {
+                    const CompiledExpression& subprogram = *this->subprograms[instruction.firstOperandRegister + subprogramIndex];
+                    subprogramRegisters.resize(subprogram.registerCount * count);
+                    subprogram.evaluateBlock(variableColumns, count, subprogramRegisters.data(), partialResults.data(), accuracy);
+                    for (size_t row = 0; row < count; row++) {
+                        isSum ? addCompensated(destination[row], compensations[row], partialResults[row]) : void(destination[row] *= partialResults[row]);
+                    }
+                }
+                for (size_t row = 0; row < compensations.size(); row++) destination[row] += compensations[row];
+                break;
+            }
+
+            case OperationCode::polynomial: {
+                // Polynomials of a constant (left unfolded because they are not finite) are computed once.
+                const std::vector<double>& coefficients = this->polynomialCoefficients[instruction.secondOperandRegister];
+                if (instruction.firstOperandRegister < constantCount) {
+                    std::vector<double> constantRegisters(this->constants);
+                    std::fill(destination, destination + count, this->executeInstruction(instruction, nullptr, constantRegisters.data(), nullptr));
+                } else {
+                    evaluatePolynomialElementwise(coefficients.data(), coefficients.size(), getElements(instruction.firstOperandRegister), destination, count);
+                }
+                break;
+            }
+        }
+    }
+
+    // Copy the result, broadcasting it if the expression is a constant.
+    const double* result = getElements(this->resultRegister);
+    if (this->resultRegister < constantCount) std::fill(results, results + count, *result);
+    else std::copy(result, result + count, results);
+}
+
+std::string CompiledExpression::describeInvalidInstruction(const EvaluationStatus& status) const {
+    // Return an empty string if no instruction has been recorded.
+    if (status.isValid() || status.firstInvalidInstruction >= this->instructions.size()) return "";
+
+    // Describe the instruction the same way as the listing does.
+    return this->describeInstruction(status.firstInvalidInstruction);
+}
+
+std::string CompiledExpression::describeInstruction(size_t index) const {
+    // Initialize the description with the operator name.
+    const Instruction& instruction = this->instructions[index];
+    std::string description = this->operatorNames[index];
+
+    switch (instruction.operationCode) {
+        case OperationCode::unary: case OperationCode::approximateUnary:
+            description += " r" + std::to_string(instruction.firstOperandRegister);
+            break;
+
+        case OperationCode::binary:
+            description += " r" + std::to_string(instruction.firstOperandRegister) + " r" + std::to_string(instruction.secondOperandRegister);
+            break;
+
+        case OperationCode::sineCosine:
+            description += " r" + std::to_string(instruction.firstOperandRegister) + " (cos in r" + std::to_string(instruction.secondOperandRegister) + ")";
+            break;
+
+        case OperationCode::sum: case OperationCode::product:
+            // List the operands, marking the negated ones with '-'.
+            for (uint32_t operandIndex = 0; operandIndex < instruction.secondOperandRegister; operandIndex++) {
+                uint32_t operand = this->reductionOperands[instruction.firstOperandRegister + operandIndex];
+                description += (operand & negatedOperandFlag) ? " -r" : " r";
+                description += std::to_string(operand & ~negatedOperandFlag);
+            }
+            break;
+
+        case OperationCode::parallelSum: case OperationCode::parallelProduct:
+            description += " of " + std::to_string(instruction.secondOperandRegister) + " subprograms in parallel";
+            break;
+
+        case OperationCode::polynomial: {
+            // List the coefficients, lowest degree first.
+            std::stringstream coefficients;
+            coefficients << std::setprecision(17);
+            for (double coefficient : this->polynomialCoefficients[instruction.secondOperandRegister]) coefficients << (coefficients.tellp() > 0 ? ", " : "") << coefficient;
+            description += " r" + std::to_string(instruction.firstOperandRegister) + " [" + coefficients.str() + "]";
+            break;
+        }
+    }
+    return description;
+}
+
+EvaluationMode CompiledExpression::getEvaluationMode() const {
+    return this->evaluationMode;
+}
+
+MathAccuracy CompiledExpression::getMathAccuracy() const {
+    return this->mathAccuracy;
+}
+
+size_t CompiledExpression::getRegisterCount() const {
+    return this->registerCount;
+}
+
+const std::vector<std::string>& CompiledExpression::getVariableNames() const {
+    return this->variableNames;
+}
+
+const std::vector<Instruction>& CompiledExpression::getInstructions() const {
+    return this->instructions;
+}
+
+const CompilationStatistics& CompiledExpression::getStatistics() const {
+    return this->statistics;
+}
+
+const std::vector<std::string>& CompiledExpression::getDomainWarnings() const {
+    return this->domainWarnings;
+}
+
+size_t CompiledExpression::getMemoryFootprint() const {
+    // Count the capacity of every vector, and the strings too long for the small string buffer.
+    auto getStringBytes = [](const std::vector<std::string>& strings) {
+        size_t bytes = strings.capacity() * sizeof(std::string);
+        for (const std::string& string : strings) bytes += (string.capacity() > 15) ? string.capacity() + 1 : 0;
+        return bytes;
+    };
+    size_t bytes = sizeof(CompiledExpression) + this->instructions.capacity() * sizeof(Instruction) + this->reductionOperands.capacity() * sizeof(uint32_t) +
+        this->constants.capacity() * sizeof(double) + getStringBytes(this->operatorNames) + getStringBytes(this->variableNames) + getStringBytes(this->domainWarnings);
+    bytes += this->polynomialCoefficients.capacity() * sizeof(std::vector<double>);
+    for (const std::vector<double>& coefficients : this->polynomialCoefficients) bytes += coefficients.capacity() * sizeof(double);
+    bytes += this->subprograms.capacity() * sizeof(std::shared_ptr<const CompiledExpression>);
+    for (const auto& subprogram : this->subprograms) bytes += subprogram->getMemoryFootprint();
+    return bytes;
+}
+
+std::string CompiledExpression::disassemble() const {
+    // Declare string stream to build the listing.
+    std::stringstream listing;
+    listing << std::setprecision(17);
+
+    // List the constant and variable registers.
+    for (size_t index = 0; index < this->constants.size(); index++) {
+        listing << 'r' << index << " = " << this->constants[index] << '\n';
+    }
+    for (size_t slot = 0; slot < this->variableNames.size(); slot++) {
+        listing << 'r' << this->constants.size() + slot << " = " << this->variableNames[slot] << '\n';
+    }
+
+    // List the instructions.
+    for (size_t index = 0; index < this->instructions.size(); index++) {
+        listing << 'r' << this->instructions[index].destinationRegister << " = " << this->describeInstruction(index) << '\n';
+    }
+
+    // Append the result register, the mode and the statistics.
+    listing << "result: r" << this->resultRegister << '\n';
+    listing << "mode: " << (this->evaluationMode == EvaluationMode::checked ? "checked" : "unchecked") << '\n';
+    if (this->mathAccuracy != MathAccuracy::library) listing << "accuracy: " << getMathAccuracyName(this->mathAccuracy) << '\n';
+    listing << "operations: " << this->statistics.operationsBeforeElimination << " before CSE, ";
+    listing << this->statistics.operationsAfterElimination << " after CSE (";
+    listing << this->statistics.eliminatedOperations << " eliminated, ";
+    listing << this->statistics.foldedOperations << " folded into constants).\n";
+    if (this->statistics.parallelReductionTerms > 0) {
+        listing << "parallel reductions: " << this->statistics.parallelReductionTerms << " terms in " << this->subprograms.size() << " subprograms.\n";
+    }
+    if (this->statistics.recognizedPolynomials > 0) {
+        listing << "polynomials: " << this->statistics.recognizedPolynomials << " recognized.\n";
+    }
+    if (this->statistics.fusedTrigonometricCalls > 0) {
+        listing << "sincos: " << this->statistics.fusedTrigonometricCalls << " trigonometric calls fused.\n";
+    }
+    if (this->statistics.provenSafeOperations > 0 || !this->domainWarnings.empty()) {
+        listing << "domain analysis: " << this->statistics.provenSafeOperations << " checked operations proven safe, ";
+        listing << this->domainWarnings.size() << " possible violations.\n";
+        for (const std::string& warning : this->domainWarnings) listing << warning << '\n';
+    }
+    return listing.str();
+}
+
+bool ExpressionCompiler::Node::operator==(const Node& other) const {
+    return this->kind == other.kind && this->payload == other.payload && this->firstOperand == other.firstOperand && this->secondOperand == other.secondOperand;
+}
+
+size_t ExpressionCompiler::NodeHash::operator()(const Node& node) const {
+    // Combine all fields of the node, then mix every bit into every other (the finalizer of MurmurHash3), so that the nodes of long
+    // chains, whose operand indices differ in a few low bits, spread over the buckets.
+    uint64_t hash = (node.payload ^ (static_cast<uint64_t>(node.kind) << 56)) * 0x9e3779b97f4a7c15ULL;
+    hash ^= (static_cast<uint64_t>(node.firstOperand) << 32) | node.secondOperand;
+    hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdULL;
+    hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+    return static_cast<size_t>(hash ^ (hash >> 33));
+}
+
+ExpressionCompiler::ExpressionCompiler(
+    const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+    const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable
+) : unaryOperatorLookupTable(unaryOperatorLookupTable), binaryOperatorLookupTable(binaryOperatorLookupTable), operationCount(0), foldedOperationCount(0) {}
+
+ExpressionCompiler::ExpressionCompiler(
+    const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+    const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable,
+    const std::unordered_map<std::string, UnaryFunction>& uncheckedUnaryOperatorLookupTable,
+    const std::unordered_map<std::string, BinaryFunction>& uncheckedBinaryOperatorLookupTable
+) : ExpressionCompiler(unaryOperatorLookupTable, binaryOperatorLookupTable) {
+    this->uncheckedUnaryOperatorLookupTable = &uncheckedUnaryOperatorLookupTable;
+    this->uncheckedBinaryOperatorLookupTable = &uncheckedBinaryOperatorLookupTable;
+}
+
+uint32_t ExpressionCompiler::internNode(const Node& node) {
+    // Look the node up and claim the next index for it in a single probe. Return the existing node if an identical one has
+    // already been created.
+    auto [iterator, isInserted] = this->nodeLookupTable.try_emplace(node, static_cast<uint32_t>(this->nodes.size()));
+    if (!isInserted) return iterator->second;
+
+    // Otherwise append the node to the DAG.
+    this->nodes.push_back(node);
+    return iterator->second;
+}
+
+uint32_t ExpressionCompiler::internOperatorName(const std::string& name) {
+    // Return the index of the name if it has already been interned.
+    auto iterator = std::find(this->operatorNames.begin(), this->operatorNames.end(), name);
+    if (iterator != this->operatorNames.end()) return static_cast<uint32_t>(iterator - this->operatorNames.begin());
+
+    // Otherwise append the name.
+    this->operatorNames.push_back(name);
+    return static_cast<uint32_t>(this->operatorNames.size() - 1);
+}
+
+void ExpressionCompiler::pushConstant(double value) {
+    this->operandStack.push_back(this->internNode({NodeKind::constant, std::bit_cast<uint64_t>(value), 0, 0}));
+}
+
+void ExpressionCompiler::pushInteger(int64_t value) {
+    this->operandStack.push_back(this->internNode({NodeKind::integer, std::bit_cast<uint64_t>(value), 0, 0}));
+}
+
+bool ExpressionCompiler::getConstantValue(uint32_t node, double& value) const {
+    // Read the value of constant and integer nodes. Other nodes are only known at evaluation time.
+    switch (this->nodes[node].kind) {
+        case NodeKind::constant:
+            value = std::bit_cast<double>(this->nodes[node].payload);
+            return true;
+        case NodeKind::integer:
+            value = static_cast<double>(std::bit_cast<int64_t>(this->nodes[node].payload));
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool ExpressionCompiler::foldConstant(double value) {
+    // Keep the operation if it produced nan or inf, so that unchecked evaluations can still report it.
+    if (!std::isfinite(value)) return false;
+
+    // Replace the operand(s) with the folded constant.
+    this->foldedOperationCount++;
+    this->operandStack.back() = this->internNode({NodeKind::constant, std::bit_cast<uint64_t>(value), 0, 0});
+    return true;
+}
+
+void ExpressionCompiler::pushVariable(uint32_t slot) {
+    this->operandStack.push_back(this->internNode({NodeKind::variable, slot, 0, 0}));
+}
+
+void ExpressionCompiler::inlineUserFunction(const UserFunction& function) {
+    // Throw error if there are not enough arguments.
+    if (this->operandStack.size() < function.parameterNames.size()) {
+        std::string errorMessage = "EvalError: Failed to find argument(s) for " + function.name;
+        errorMessage += ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Pop the argument nodes, keeping their order.
+    std::vector<uint32_t> argumentNodes(this->operandStack.end() - function.parameterNames.size(), this->operandStack.end());
+    this->operandStack.resize(this->operandStack.size() - function.parameterNames.size());
+
+    // Build the body with the parameters bound to the arguments. The result is left on the operand stack.
+    this->compileInstructions(function.postfixBody, argumentNodes);
+}
+
+void ExpressionCompiler::applyUnaryOperator(const std::string& name) {
+    // Throw error if there is an excess operator.
+    if (this->operandStack.empty()) throw std::invalid_argument("EvalError: Found excess operator(s).\n");
+
+    this->operationCount++;
+    uint32_t operand = this->operandStack.back();
+
+    // Fold the operation exactly if the operand is an integer and the result fits in 64 bits.
+    int64_t integerResult;
+    if (this->nodes[operand].kind == NodeKind::integer && integerUnaryOperation(name, std::bit_cast<int64_t>(this->nodes[operand].payload), integerResult)) {
+        this->foldedOperationCount++;
+        this->operandStack.back() = this->internNode({NodeKind::integer, std::bit_cast<uint64_t>(integerResult), 0, 0});
+        return;
+    }
+
+    // Otherwise fold the operation in double precision if the operand is a constant inside the operator's domain.
+    double value;
+    if (this->getConstantValue(operand, value)) {
+        try {
+            if (this->foldConstant(this->unaryOperatorLookupTable.at(name)(value))) return;
+        } catch (std::exception&) {
+            // Domain errors are raised at evaluation time, like for any other operand.
+        }
+    }
+
+    // Replace the operand with the (possibly shared) operator node.
+    this->operandStack.back() = this->internNode({NodeKind::unary, this->internOperatorName(name), operand, 0});
+}
+
+void ExpressionCompiler::applyBinaryOperator(const std::string& name) {
+    // Throw error if there are not enough operands.
+    if (this->operandStack.size() < 2) {
+        std::string errorMessage = "EvalError: Failed to find second argument for " + name;
+        errorMessage += ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Pop the second operand, then the first one.
+    this->operationCount++;
+    uint32_t secondOperand = this->operandStack.back();
+    this->operandStack.pop_back();
+    uint32_t firstOperand = this->operandStack.back();
+
+    // Fold the operation exactly if both operands are integers and the result fits in 64 bits.
+    int64_t integerResult;
+    if (this->nodes[firstOperand].kind == NodeKind::integer && this->nodes[secondOperand].kind == NodeKind::integer &&
+        integerBinaryOperation(name, std::bit_cast<int64_t>(this->nodes[firstOperand].payload), std::bit_cast<int64_t>(this->nodes[secondOperand].payload), integerResult)) {
+        this->foldedOperationCount++;
+        this->operandStack.back() = this->internNode({NodeKind::integer, std::bit_cast<uint64_t>(integerResult), 0, 0});
+        return;
+    }
+
+    // Otherwise fold the operation in double precision if both operands are constants inside the operator's domain.
+    double firstValue, secondValue;
+    if (this->getConstantValue(firstOperand, firstValue) && this->getConstantValue(secondOperand, secondValue)) {
+        try {
+            if (this->foldConstant(this->binaryOperatorLookupTable.at(name)(firstValue, secondValue))) return;
+        } catch (std::exception&) {
+            // Domain errors are raised at evaluation time, like for any other operand.
+        }
+    }
+
+    // Order the operands of commutative operators so that "a*b" and "b*a" share a node.
+    if ((name == "+" || name == "*") && firstOperand > secondOperand) std::swap(firstOperand, secondOperand);
+
+    // Replace the first operand with the (possibly shared) operator node.
+    this->operandStack.back() = this->internNode({NodeKind::binary, this->internOperatorName(name), firstOperand, secondOperand});
+}
+
+CompiledExpression ExpressionCompiler::compile(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<std::string>& variableNames, EvaluationMode evaluationMode, MathAccuracy mathAccuracy) {
+    // Reset the state left over from a previous compilation.
+    this->evaluationMode = evaluationMode;
+    this->mathAccuracy = mathAccuracy;
+    this->nodes.clear();
+    this->nodeLookupTable.clear();
+    this->operatorNames.clear();
+    this->operandStack.clear();
+    this->operationCount = 0;
+    this->foldedOperationCount = 0;
+
+    // Every instruction creates at most one node (user function bodies may add more), so size the DAG for the bytecode up front
+    // instead of rehashing the table as it grows.
+    this->nodes.reserve(postfixProgram.size() + variableNames.size());
+    this->nodeLookupTable.reserve(postfixProgram.size() + variableNames.size());
+
+    // Create the variable nodes, then walk the bytecode and build the DAG.
+    std::vector<uint32_t> variableNodes;
+    for (uint32_t slot = 0; slot < variableNames.size(); slot++) {
+        this->pushVariable(slot);
+        variableNodes.push_back(this->operandStack.back());
+        this->operandStack.pop_back();
+    }
+    this->compileInstructions(postfixProgram, variableNodes);
+
+    // Handle empty and excess operand expressions.
+    if (this->operandStack.empty()) throw std::invalid_argument("ParseError: Found 0 tokens to parse.\n");
+    if (this->operandStack.size() > 1) throw std::invalid_argument("EvalError: Found excess operand(s).\n");
+
+    // Emit the program and record the mode of its kernels.
+    CompiledExpression program = this->emitProgram(variableNames);
+    program.evaluationMode = evaluationMode;
+    return program;
+}
+
+CompiledExpression ExpressionCompiler::compile(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<std::string>& variableNames, const std::vector<Interval>& variableRanges, MathAccuracy mathAccuracy) {
+    // Check if every variable has been given a range. If not, throw invalid_argument error.
+    if (variableRanges.size() != variableNames.size()) {
+        std::string errorMessage = "EvalError: Expected ";
+        errorMessage += std::to_string(variableNames.size()) + " variable range(s), got ";
+        errorMessage += std::to_string(variableRanges.size()) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Compile a checked program with the interval analysis, which is only run while the ranges are set.
+    this->variableRanges = &variableRanges;
+    try {
+        CompiledExpression program = this->compile(postfixProgram, variableNames, EvaluationMode::checked, mathAccuracy);
+        this->variableRanges = nullptr;
+        return program;
+    } catch (...) {
+        this->variableRanges = nullptr;
+        throw;
+    }
+}
+
+bool ExpressionCompiler::bindFunctions(CompiledExpression& program, EvaluationMode evaluationMode) const {
+    bool isChecked = evaluationMode == EvaluationMode::checked;
+    for (size_t index = 0; index < program.instructions.size(); index++) {
+        Instruction& instruction = program.instructions[index];
+        const std::string& name = program.operatorNames[index];
+        switch (instruction.operationCode) {
+            case OperationCode::unary: case OperationCode::approximateUnary: {
+                // Approximations must still exist for the operator, since the instruction names them by number.
+                auto function = this->unaryOperatorLookupTable.find(name);
+                if (function == this->unaryOperatorLookupTable.end()) return false;
+                if (instruction.operationCode == OperationCode::approximateUnary && (program.mathAccuracy == MathAccuracy::library ||
+                    static_cast<FastFunction>(instruction.secondOperandRegister) != findFastFunction(name))) return false;
+                instruction.unaryFunction = function->second;
+                break;
+            }
+
+            case OperationCode::binary: {
+                // Binary tan, cot, sec and csc are fed by a sineCosine instruction, like emitSubprogram() does.
+                if (name == "tan" || name == "cot") instruction.binaryFunction = divideTrigonometric;
+                else if (name == "cotcheck") instruction.binaryFunction = checkCotangentDenominator;
+                else if (name == "sec") instruction.binaryFunction = isChecked ? checkedSecant : invertTrigonometric;
+                else if (name == "csc" || name == "cosec") instruction.binaryFunction = isChecked ? checkedCosecant : invertTrigonometric;
+                else {
+                    auto function = this->binaryOperatorLookupTable.find(name);
+                    if (function == this->binaryOperatorLookupTable.end()) return false;
+                    instruction.binaryFunction = function->second;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+void ExpressionCompiler::compileInstructions(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<uint32_t>& boundNodes) {
+    // Walk the bytecode and build the DAG, mirroring Calculator::evaluatePostfixNotation.
+    for (const PostfixInstruction& instruction : postfixProgram) {
+        switch (instruction.operationCode) {
+            case PostfixOperationCode::pushNumber:
+                // Push the number as an exact integer if possible, or as a constant.
+                instruction.isInteger ? this->pushInteger(instruction.integer) : this->pushConstant(instruction.number);
+                break;
+
+            case PostfixOperationCode::pushVariable:
+                // Push the node the variable / parameter is bound to.
+                this->operandStack.push_back(boundNodes.at(instruction.variableSlot));
+                break;
+
+            case PostfixOperationCode::applyUnaryOperator:
+                this->applyUnaryOperator(instruction.name);
+                break;
+
+            case PostfixOperationCode::applyBinaryOperator:
+                this->applyBinaryOperator(instruction.name);
+                break;
+
+            case PostfixOperationCode::callUserFunction:
+                // Inline the body of the function.
+                this->inlineUserFunction(*instruction.userFunction);
+                break;
+
+            case PostfixOperationCode::buildVector:
+                // Registers hold scalars, vectors are evaluated by VectorEvaluator.
+                throw std::invalid_argument("EvalError: Found vector literal in a compiled expression (vectors are only supported by the interactive evaluator).\n");
+        }
+    }
+}
+
+CompiledExpression ExpressionCompiler::emitProgram(const std::vector<std::string>& variableNames) {
+    // Find the nodes reachable from the result, since folding leaves unused ones behind.
+    std::vector<bool> isReachable(this->nodes.size(), false);
+    isReachable[this->operandStack.back()] = true;
+    size_t reachableOperationCount = 0;
+    for (size_t index = this->nodes.size(); index > 0; index--) {
+        const Node& node = this->nodes[index - 1];
+        if (!isReachable[index - 1] || (node.kind != NodeKind::unary && node.kind != NodeKind::binary)) continue;
+        reachableOperationCount++;
+        isReachable[node.firstOperand] = true;
+        if (node.kind == NodeKind::binary) isReachable[node.secondOperand] = true;
+    }
+
+    // Collect the polynomials, split the large associative chains into groups, then emit the program computing the result.
+    this->polynomials.clear();
+    this->emittedPolynomialCount = 0;
+    this->fusedTrigonometricCallCount = 0;
+    this->findPolynomials(isReachable);
+    this->parallelChainTerms.clear();
+    this->findParallelChains(isReachable);
+    this->analyzeDomains(isReachable, variableNames);
+    CompiledExpression program = this->emitSubprogram({this->operandStack.back()}, OperationCode::unary, variableNames);
+
+    // Store the statistics. Operations of the chains count once, even though the subprograms replace them with reductions.
+    program.statistics.operationsBeforeElimination = this->operationCount;
+    program.statistics.operationsAfterElimination = reachableOperationCount;
+    program.statistics.foldedOperations = this->foldedOperationCount;
+    program.statistics.eliminatedOperations = this->operationCount - this->foldedOperationCount - reachableOperationCount;
+    for (const auto& [root, terms] : this->parallelChainTerms) program.statistics.parallelReductionTerms += terms.size();
+    program.statistics.recognizedPolynomials = this->emittedPolynomialCount;
+    program.statistics.fusedTrigonometricCalls = this->fusedTrigonometricCallCount;
+    program.statistics.provenSafeOperations = static_cast<size_t>(std::count(this->provenSafeNodes.begin(), this->provenSafeNodes.end(), true));
+    program.domainWarnings = std::move(this->domainWarnings);
+    return program;
+}
+
+/// @brief Function for bounding the error of the approximations of an accuracy tier, relative to the magnitude of their result plus 1
+/// (generously, since the tiers are specified in ulps of the result, and tan, cot, sec and csc divide two approximations).
+static double getApproximationTolerance(MathAccuracy mathAccuracy) {
+    switch (mathAccuracy) {
+        case MathAccuracy::library: return 0;
+        case MathAccuracy::oneUlp: return 1e-15;
+        case MathAccuracy::fourUlps: return 4e-15;
+        case MathAccuracy::approximate: return 1e-6;
+    }
+    return 1e-6;
+}
+
+void ExpressionCompiler::analyzeDomains(const std::vector<bool>& isReachable, const std::vector<std::string>& variableNames) {
+    this->provenSafeNodes.assign(this->nodes.size(), false);
+    this->domainWarnings.clear();
+    if (this->variableRanges == nullptr) return;
+
+    // Propagate the intervals children first. Constants are points and variables take their declared range.
+    std::vector<Interval> intervals(this->nodes.size());
+    for (uint32_t index = 0; index < this->nodes.size(); index++) {
+        if (!isReachable[index]) continue;
+        const Node& node = this->nodes[index];
+        double value;
+        if (this->getConstantValue(index, value)) {
+            if (!std::isnan(value)) intervals[index] = {value, value};
+            continue;
+        }
+        if (node.kind == NodeKind::variable) {
+            intervals[index] = (*this->variableRanges)[node.payload];
+            continue;
+        }
+
+        // Compute the interval of the result, and whether the operands always lie inside the domain.
+        const std::string& name = this->operatorNames[node.payload];
+        Interval first = intervals[node.firstOperand], second;
+        bool isSafe;
+        if (node.kind == NodeKind::unary) {
+            isSafe = isUnaryDomainSafe(name, first);
+            intervals[index] = propagateUnaryInterval(name, first);
+        } else {
+            second = intervals[node.secondOperand];
+            isSafe = isBinaryDomainSafe(name, first, second);
+            intervals[index] = propagateBinaryInterval(name, first, second);
+        }
+
+        // Enclose the error of the approximations, and the rounding of the instructions replacing the operators: polynomials
+        // evaluate their coefficients, and parallel chains sum or multiply their terms in another order.
+        Interval& result = intervals[index];
+        double tolerance = getApproximationTolerance(this->mathAccuracy), slack = 0;
+        if (tolerance > 0 && (findFastFunction(name) != FastFunction::none || name == "tan" || name == "cot" || name == "sec" || name == "csc" || name == "cosec")) {
+            slack = tolerance * (1 + std::max(std::fabs(result.lower), std::fabs(result.upper)));
+        }
+        auto polynomial = this->polynomials.find(index);
+        if (polynomial != this->polynomials.end()) result = propagatePolynomialInterval(polynomial->second.coefficients, intervals[polynomial->second.base]);
+        auto chain = this->parallelChainTerms.find(index);
+        if (chain != this->parallelChainTerms.end()) {
+            double magnitude = std::max(std::fabs(result.lower), std::fabs(result.upper));
+            if (name != "*") {
+                magnitude = 0;
+                for (uint32_t term : chain->second) {
+                    const Interval& termInterval = intervals[term & ~CompiledExpression::negatedOperandFlag];
+                    magnitude += std::max(std::fabs(termInterval.lower), std::fabs(termInterval.upper));
+                }
+            }
+            slack = static_cast<double>(chain->second.size()) * std::ldexp(magnitude, -52);
+        }
+        if (slack > 0) result = {result.lower - slack, result.upper + slack};
+
+        // Record the operations whose checked kernel may throw: the proven ones are lowered, the others are reported.
+        const char* condition = getDomainCondition(name);
+        if (condition == nullptr) continue;
+        if (isSafe) {
+            this->provenSafeNodes[index] = true;
+            continue;
+        }
+        std::stringstream warning;
+        warning << "DomainWarning: " << this->describeNode(index, variableNames) << " may be called outside its domain (" << condition << "): ";
+        if (node.kind == NodeKind::unary) {
+            warning << "its operand lies in [" << first.lower << ", " << first.upper << "].";
+        } else {
+            warning << "its operands lie in [" << first.lower << ", " << first.upper << "] and [" << second.lower << ", " << second.upper << "].";
+        }
+        this->domainWarnings.push_back(warning.str());
+    }
+}
+
+std::string ExpressionCompiler::describeNode(uint32_t node, const std::vector<std::string>& variableNames) const {
+    // Precedence of the notation of every node: sums, products, negations, powers, factorials, then atoms and function calls.
+    auto getPrecedence = [this](uint32_t index) {
+        const Node& operatorNode = this->nodes[index];
+        double value;
+        if (this->getConstantValue(index, value)) return (value < 0) ? 3 : 6;
+        if (operatorNode.kind != NodeKind::unary && operatorNode.kind != NodeKind::binary) return 6;
+        const std::string& name = this->operatorNames[operatorNode.payload];
+        if (name == "+" || name == "-") return 1;
+        if (name == "*" || name == "/" || name == "%") return 2;
+        if (name == "neg") return 3;
+        if (name == "^") return 4;
+        if (name == "!") return 5;
+        return 6;
+    };
+    auto describeOperand = [&](uint32_t operand, bool isParenthesized) {
+        return isParenthesized ? "(" + this->describeNode(operand, variableNames) + ")" : this->describeNode(operand, variableNames);
+    };
+
+    // Write the constants and the variables.
+    const Node& current = this->nodes[node];
+    if (current.kind == NodeKind::integer) return std::to_string(std::bit_cast<int64_t>(current.payload));
+    if (current.kind == NodeKind::constant) {
+        double value;
+        this->getConstantValue(node, value);
+        std::stringstream constant;
+        constant << value;
+        return constant.str();
+    }
+    if (current.kind == NodeKind::variable) return variableNames.at(current.payload);
+
+    // Write the operators, parenthesizing the operands which bind less tightly (or as tightly on the side the operator does not group).
+    const std::string& name = this->operatorNames[current.payload];
+    int precedence = getPrecedence(node);
+    if (current.kind == NodeKind::unary) {
+        if (name == "neg") return "-" + describeOperand(current.firstOperand, getPrecedence(current.firstOperand) <= precedence);
+        if (name == "!") return describeOperand(current.firstOperand, getPrecedence(current.firstOperand) < 6) + "!";
+        return name + "(" + this->describeNode(current.firstOperand, variableNames) + ")";
+    }
+    if (name == "log_") {
+        return "log_" + describeOperand(current.firstOperand, getPrecedence(current.firstOperand) < 6) + "(" + this->describeNode(current.secondOperand, variableNames) + ")";
+    }
+    bool isRightGrouping = (name == "^");
+    return describeOperand(current.firstOperand, getPrecedence(current.firstOperand) < precedence + isRightGrouping) + " " + name + " " +
+        describeOperand(current.secondOperand, getPrecedence(current.secondOperand) < precedence + !isRightGrouping);
+}
+
+UnaryFunction ExpressionCompiler::findUnaryFunction(uint32_t node, const std::string& name) const {
+    if (this->uncheckedUnaryOperatorLookupTable != nullptr && this->provenSafeNodes[node]) return this->uncheckedUnaryOperatorLookupTable->at(name);
+    return this->unaryOperatorLookupTable.at(name);
+}
+
+BinaryFunction ExpressionCompiler::findBinaryFunction(uint32_t node, const std::string& name) const {
+    if (this->uncheckedBinaryOperatorLookupTable != nullptr && this->provenSafeNodes[node]) return this->uncheckedBinaryOperatorLookupTable->at(name);
+    return this->binaryOperatorLookupTable.at(name);
+}
+
+void ExpressionCompiler::findParallelChains(const std::vector<bool>& isReachable) {
+    // Identify the additive ('+', '-') and multiplicative ('*') operators. Other operators end a chain.
+    auto getFamily = [this](uint32_t index) {
+        const Node& node = this->nodes[index];
+        if (node.kind != NodeKind::binary) return 0;
+        const std::string& name = this->operatorNames[node.payload];
+        return (name == "+" || name == "-") ? 1 : (name == "*") ? 2 : 0;
+    };
+
+    // Count the uses of every reachable node. The result counts as a use, so it is never merged into a parent.
+    std::vector<uint32_t> useCounts(this->nodes.size(), 0), parents(this->nodes.size(), 0);
+    useCounts[this->operandStack.back()]++;
+    for (uint32_t index = 0; index < this->nodes.size(); index++) {
+        const Node& node = this->nodes[index];
+        if (!isReachable[index] || (node.kind != NodeKind::unary && node.kind != NodeKind::binary)) continue;
+        useCounts[node.firstOperand]++;
+        parents[node.firstOperand] = index;
+        if (node.kind == NodeKind::binary) {
+            useCounts[node.secondOperand]++;
+            parents[node.secondOperand] = index;
+        }
+    }
+
+    // A node continues its parent's chain if it is its only use and has the same family.
+    auto isChainInterior = [&](uint32_t index) {
+        return useCounts[index] == 1 && getFamily(parents[index]) == getFamily(index);
+    };
+
+    // Flatten every chain from its root, left to right. Subtracting a subchain flips the sign of its terms.
+    for (uint32_t root = 0; root < this->nodes.size(); root++) {
+        if (!isReachable[root] || getFamily(root) == 0 || isChainInterior(root) || this->polynomials.count(root)) continue;
+
+        std::vector<uint32_t> terms;
+        std::vector<std::pair<uint32_t, bool>> pending{{root, false}};
+        while (!pending.empty()) {
+            auto [index, isNegated] = pending.back();
+            pending.pop_back();
+
+            // Keep the node as a term unless it is part of the chain.
+            if (index != root && !isChainInterior(index)) {
+                terms.push_back(index | (isNegated ? CompiledExpression::negatedOperandFlag : 0));
+                continue;
+            }
+
+            // Visit the first operand before the second one.
+            const Node& node = this->nodes[index];
+            pending.emplace_back(node.secondOperand, isNegated != (this->operatorNames[node.payload] == "-"));
+            pending.emplace_back(node.firstOperand, isNegated);
+        }
+
+        // Only chains long enough to amortize the scheduling are evaluated in parallel.
+        if (terms.size() >= parallelChainThreshold) this->parallelChainTerms.emplace(root, std::move(terms));
+    }
+}
+
+void ExpressionCompiler::findPolynomials(const std::vector<bool>& isReachable) {
+    // Form of a node as a polynomial in a base node. Constants have no base, and nodes that are neither constants nor sums
+    // or products of monomials (e.g. "x", "sin(x)", "(x+1)^2") are the polynomial 0 + 1*node in themselves.
+    constexpr uint32_t noBase = UINT32_MAX;
+    struct PolynomialForm {
+        uint32_t base = noBase;
+        std::vector<double> coefficients;
+        bool isMonomial = true;
+        bool hasPower = false;
+    };
+    auto isConstant = [](const PolynomialForm& form) { return form.base == noBase; };
+    auto scale = [](const PolynomialForm& form, double factor, bool isDivided) {
+        PolynomialForm scaled = form;
+        for (double& coefficient : scaled.coefficients) coefficient = isDivided ? coefficient / factor : coefficient * factor;
+        return scaled;
+    };
+
+    // Combine the forms of the operands of a binary operator, returning false if the result is not a polynomial in one base.
+    auto combine = [&](const std::string& name, const PolynomialForm& first, const PolynomialForm& second, PolynomialForm& result) {
+        if (!isConstant(first) && !isConstant(second) && first.base != second.base) return false;
+        if (name == "+" || name == "-") {
+            result.coefficients.assign(std::max(first.coefficients.size(), second.coefficients.size()), 0.0);
+            for (size_t degree = 0; degree < first.coefficients.size(); degree++) result.coefficients[degree] += first.coefficients[degree];
+            for (size_t degree = 0; degree < second.coefficients.size(); degree++) {
+                result.coefficients[degree] += (name == "-") ? -second.coefficients[degree] : second.coefficients[degree];
+            }
+            result.isMonomial = false;
+        } else if (name == "*" && isConstant(first)) {
+            result = scale(second, first.coefficients.front(), false);
+        } else if (name == "*" && isConstant(second)) {
+            result = scale(first, second.coefficients.front(), false);
+        } else if (name == "*" && first.isMonomial && second.isMonomial) {
+            result.coefficients.assign(first.coefficients.size() + second.coefficients.size() - 1, 0.0);
+            result.coefficients.back() = first.coefficients.back() * second.coefficients.back();
+        } else if (name == "/" && isConstant(second) && second.coefficients.front() != 0) {
+            result = scale(first, second.coefficients.front(), true);
+        } else if (name == "^" && isConstant(second) && !isConstant(first) && first.isMonomial) {
+            // Only small non-negative integer exponents of monomials, e.g. "(3*x^2)^3".
+            double exponent = second.coefficients.front();
+            if (exponent != std::floor(exponent) || exponent < 0 || (first.coefficients.size() - 1) * exponent > maximumPolynomialDegree) return false;
+            result.coefficients.assign((first.coefficients.size() - 1) * static_cast<size_t>(exponent) + 1, 0.0);
+            result.coefficients.back() = std::pow(first.coefficients.back(), exponent);
+            result.hasPower = true;
+        } else {
+            return false;
+        }
+        result.base = isConstant(first) ? second.base : first.base;
+        result.hasPower = result.hasPower || first.hasPower || second.hasPower;
+        return true;
+    };
+
+    // Compute the forms children first, recording the operator nodes that are polynomials worth a single instruction:
+    // a degree of 2 or more, and at least one power, so that sums and products of the base keep their own instructions.
+    std::vector<PolynomialForm> forms(this->nodes.size());
+    for (uint32_t index = 0; index < this->nodes.size(); index++) {
+        if (!isReachable[index]) continue;
+        const Node& node = this->nodes[index];
+        PolynomialForm& form = forms[index];
+        double value;
+        if (this->getConstantValue(index, value)) {
+            form.coefficients = {value};
+            continue;
+        }
+
+        bool isPolynomial = false;
+        if (node.kind == NodeKind::unary && this->operatorNames[node.payload] == "neg") {
+            form = scale(forms[node.firstOperand], -1.0, false);
+            isPolynomial = true;
+        } else if (node.kind == NodeKind::binary) {
+            isPolynomial = combine(this->operatorNames[node.payload], forms[node.firstOperand], forms[node.secondOperand], form);
+        }
+
+        // Drop the vanishing leading coefficients, then fall back to the node itself if the polynomial is too large or not finite.
+        while (isPolynomial && form.coefficients.size() > 1 && form.coefficients.back() == 0) form.coefficients.pop_back();
+        isPolynomial = isPolynomial && form.coefficients.size() <= maximumPolynomialDegree + 1 &&
+            std::all_of(form.coefficients.begin(), form.coefficients.end(), [](double coefficient) { return std::isfinite(coefficient); });
+        if (!isPolynomial) {
+            form = PolynomialForm{index, {0.0, 1.0}, true, false};
+            continue;
+        }
+        if (!isConstant(form) && form.coefficients.size() >= 3 && form.hasPower) this->polynomials[index] = Polynomial{form.base, form.coefficients};
+    }
+}
+
+std::unordered_map<uint32_t, uint32_t> ExpressionCompiler::findTrigonometricPairs(const std::vector<uint32_t>& neededNodes) const {
+    // Group the trigonometric calls by operand. Calls of a group are distinct nodes, so distinct functions.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> callsByOperand;
+    for (uint32_t index : neededNodes) {
+        const Node& node = this->nodes[index];
+        if (node.kind != NodeKind::unary) continue;
+        const std::string& name = this->operatorNames[node.payload];
+        if (name == "sin" || name == "cos" || name == "tan" || name == "sec" || name == "csc" || name == "cosec" || name == "cot") {
+            callsByOperand[node.firstOperand].push_back(index);
+        }
+    }
+
+    // Fuse the groups of at least two calls. The first call of a group comes first in topological order.
+    std::unordered_map<uint32_t, uint32_t> pairs;
+    for (const auto& [operand, calls] : callsByOperand) {
+        if (calls.size() < 2) continue;
+        for (uint32_t call : calls) pairs[call] = calls.front();
+    }
+    return pairs;
+}
+
+CompiledExpression ExpressionCompiler::emitSubprogram(const std::vector<uint32_t>& terms, OperationCode combiningCode, const std::vector<std::string>& variableNames) {
+    // Initialize the program and the mapping from node index to register.
+    CompiledExpression program;
+    program.variableNames = variableNames;
+    program.mathAccuracy = this->mathAccuracy;
+    std::unordered_map<uint32_t, uint32_t> nodeRegisters;
+
+    // Collect the nodes the terms depend on. The terms of the parallel chains are computed by their own subprograms,
+    // and polynomials only depend on their base.
+    std::vector<uint32_t> neededNodes, pending;
+    std::vector<bool> isNeeded(this->nodes.size(), false);
+    for (uint32_t term : terms) pending.push_back(term & ~CompiledExpression::negatedOperandFlag);
+    while (!pending.empty()) {
+        uint32_t index = pending.back();
+        pending.pop_back();
+        if (isNeeded[index]) continue;
+        isNeeded[index] = true;
+        neededNodes.push_back(index);
+
+        const Node& node = this->nodes[index];
+        if ((node.kind != NodeKind::unary && node.kind != NodeKind::binary) || this->parallelChainTerms.count(index)) continue;
+        auto polynomial = this->polynomials.find(index);
+        if (polynomial != this->polynomials.end()) {
+            pending.push_back(polynomial->second.base);
+            continue;
+        }
+        pending.push_back(node.firstOperand);
+        if (node.kind == NodeKind::binary) pending.push_back(node.secondOperand);
+    }
+    std::sort(neededNodes.begin(), neededNodes.end());
+
+    // Assign the first registers to the constants. Integers are rounded to double only here.
+    for (uint32_t index : neededNodes) {
+        double value;
+        if (!this->getConstantValue(index, value)) continue;
+        nodeRegisters[index] = static_cast<uint32_t>(program.constants.size());
+        program.constants.push_back(value);
+    }
+
+    // Assign the following registers to the variables, ordered by slot.
+    uint32_t nextRegister = static_cast<uint32_t>(program.constants.size() + variableNames.size());
+    for (uint32_t index : neededNodes) {
+        if (this->nodes[index].kind == NodeKind::variable) nodeRegisters[index] = static_cast<uint32_t>(program.constants.size() + this->nodes[index].payload);
+    }
+
+    // Emit one instruction per operator node. Nodes are already in topological order.
+    std::unordered_map<uint32_t, uint32_t> trigonometricPairs = this->findTrigonometricPairs(neededNodes), sineRegisters;
+    for (uint32_t index : neededNodes) {
+        const Node& node = this->nodes[index];
+        if (node.kind != NodeKind::unary && node.kind != NodeKind::binary) continue;
+        const std::string& name = this->operatorNames[node.payload];
+
+        auto pair = trigonometricPairs.find(index);
+        if (pair != trigonometricPairs.end()) {
+            // Emit the sincos instruction of the operand at its first fused call, with the cosine in the register after the sine.
+            if (pair->second == index) {
+                Instruction sineCosine{};
+                sineCosine.operationCode = OperationCode::sineCosine;
+                sineCosine.destinationRegister = sineRegisters[index] = nextRegister;
+                sineCosine.firstOperandRegister = nodeRegisters[node.firstOperand];
+                sineCosine.secondOperandRegister = nextRegister + 1;
+                nextRegister += 2;
+                program.instructions.push_back(sineCosine);
+                program.operatorNames.push_back("sincos");
+            }
+            this->fusedTrigonometricCallCount++;
+
+            // sin and cos are the registers themselves, the other functions divide or invert them.
+            // The angle is passed to the checks, so their errors report the same operand as the interpreter.
+            uint32_t sineRegister = sineRegisters[pair->second], cosineRegister = sineRegister + 1, angleRegister = nodeRegisters[node.firstOperand];
+            if (name == "sin" || name == "cos") {
+                nodeRegisters[index] = (name == "sin") ? sineRegister : cosineRegister;
+                continue;
+            }
+            bool isChecked = this->evaluationMode == EvaluationMode::checked && !this->provenSafeNodes[index];
+            Instruction instruction{};
+            instruction.operationCode = OperationCode::binary;
+            if (name == "tan") {
+                instruction.firstOperandRegister = sineRegister;
+                instruction.secondOperandRegister = cosineRegister;
+                instruction.binaryFunction = divideTrigonometric;
+            } else if (name == "cot") {
+                // Check the sine in an instruction of its own, then divide by the checked copy.
+                uint32_t denominatorRegister = sineRegister;
+                if (isChecked) {
+                    Instruction check{};
+                    check.operationCode = OperationCode::binary;
+                    check.destinationRegister = denominatorRegister = nextRegister++;
+                    check.firstOperandRegister = sineRegister;
+                    check.secondOperandRegister = angleRegister;
+                    check.binaryFunction = checkCotangentDenominator;
+                    program.instructions.push_back(check);
+                    program.operatorNames.push_back("cotcheck");
+                }
+                instruction.firstOperandRegister = cosineRegister;
+                instruction.secondOperandRegister = denominatorRegister;
+                instruction.binaryFunction = divideTrigonometric;
+            } else if (name == "sec") {
+                instruction.firstOperandRegister = cosineRegister;
+                instruction.secondOperandRegister = angleRegister;
+                instruction.binaryFunction = isChecked ? checkedSecant : invertTrigonometric;
+            } else {
+                instruction.firstOperandRegister = sineRegister;
+                instruction.secondOperandRegister = angleRegister;
+                instruction.binaryFunction = isChecked ? checkedCosecant : invertTrigonometric;
+            }
+            instruction.destinationRegister = nodeRegisters[index] = nextRegister++;
+            program.instructions.push_back(instruction);
+            program.operatorNames.push_back(name);
+            continue;
+        }
+
+        Instruction instruction{};
+        instruction.destinationRegister = nodeRegisters[index] = nextRegister++;
+
+        auto chain = this->parallelChainTerms.find(index);
+        auto polynomial = this->polynomials.find(index);
+        if (polynomial != this->polynomials.end()) {
+            // Evaluate the subtree as a polynomial in the register of its base.
+            instruction.operationCode = OperationCode::polynomial;
+            instruction.firstOperandRegister = nodeRegisters[polynomial->second.base];
+            instruction.secondOperandRegister = static_cast<uint32_t>(program.polynomialCoefficients.size());
+            program.polynomialCoefficients.push_back(polynomial->second.coefficients);
+            program.operatorNames.push_back("poly");
+            this->emittedPolynomialCount++;
+        } else if (chain != this->parallelChainTerms.end()) {
+            // Compile every group of terms of a parallel chain into a subprogram computing its partial result.
+            bool isSum = (name != "*");
+            instruction.operationCode = isSum ? OperationCode::parallelSum : OperationCode::parallelProduct;
+            instruction.firstOperandRegister = static_cast<uint32_t>(program.subprograms.size());
+            for (size_t first = 0; first < chain->second.size(); first += termsPerSubprogram) {
+                std::vector<uint32_t> group(chain->second.begin() + first, chain->second.begin() + std::min(first + termsPerSubprogram, chain->second.size()));
+                program.subprograms.push_back(std::make_shared<const CompiledExpression>(
+                    this->emitSubprogram(group, isSum ? OperationCode::sum : OperationCode::product, variableNames)));
+            }
+            instruction.secondOperandRegister = static_cast<uint32_t>(program.subprograms.size()) - instruction.firstOperandRegister;
+            program.operatorNames.push_back(isSum ? "sum" : "product");
+        } else {
+            // Fill in the instruction with the registers of the operands.
+            instruction.firstOperandRegister = nodeRegisters[node.firstOperand];
+            if (node.kind == NodeKind::unary) {
+                // Approximate the transcendental functions unless the program uses the library ones. The function of the
+                // lookup table stays in the instruction, as the fallback of the approximation.
+                FastFunction function = (this->mathAccuracy == MathAccuracy::library) ? FastFunction::none : findFastFunction(name);
+                instruction.operationCode = (function == FastFunction::none) ? OperationCode::unary : OperationCode::approximateUnary;
+                instruction.secondOperandRegister = static_cast<uint32_t>(function);
+                instruction.unaryFunction = this->findUnaryFunction(index, name);
+            } else {
+                instruction.operationCode = OperationCode::binary;
+                instruction.secondOperandRegister = nodeRegisters[node.secondOperand];
+                instruction.binaryFunction = this->findBinaryFunction(index, name);
+            }
+            program.operatorNames.push_back(name);
+        }
+        program.instructions.push_back(instruction);
+    }
+
+    // Combine the terms of a group with a single reduction, or return the register of the single term.
+    if (combiningCode == OperationCode::sum || combiningCode == OperationCode::product) {
+        Instruction instruction{};
+        instruction.operationCode = combiningCode;
+        instruction.destinationRegister = nextRegister++;
+        instruction.firstOperandRegister = static_cast<uint32_t>(program.reductionOperands.size());
+        instruction.secondOperandRegister = static_cast<uint32_t>(terms.size());
+        for (uint32_t term : terms) {
+            program.reductionOperands.push_back(nodeRegisters[term & ~CompiledExpression::negatedOperandFlag] | (term & CompiledExpression::negatedOperandFlag));
+        }
+        program.instructions.push_back(instruction);
+        program.operatorNames.push_back(combiningCode == OperationCode::sum ? "sum" : "product");
+        program.resultRegister = instruction.destinationRegister;
+    } else {
+        program.resultRegister = nodeRegisters[terms.front()];
+    }
+    program.registerCount = nextRegister;
+    return program;
+}
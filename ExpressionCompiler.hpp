@@ -0,0 +1,651 @@
+#ifndef __EXPRESSION_COMPILER
+#define __EXPRESSION_COMPILER
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+#include "IntervalArithmetic.hpp"
+
+class WorkStealingThreadPool;
+
+/// @brief Pointer to a function / operator taking a single parameter.
+typedef double (*UnaryFunction)(double);
+
+/// @brief Pointer to a function / operator taking two parameters.
+typedef double (*BinaryFunction)(double, double);
+
+struct UserFunction;
+
+/// @brief Kinds of postfix bytecode instructions emitted by the parser.
+enum class PostfixOperationCode : uint8_t {
+    /// @brief Push a number or a constant (e, pi, phi).
+    pushNumber,
+
+    /// @brief Push the variable / parameter bound to variableSlot.
+    pushVariable,
+
+    /// @brief Apply the unary operator called name to the top of the stack.
+    applyUnaryOperator,
+
+    /// @brief Apply the binary operator called name to the top two entries of the stack.
+    applyBinaryOperator,
+
+    /// @brief Call userFunction on the top entries of the stack (one per parameter).
+    callUserFunction,
+
+    /// @brief Replace the top elementCount entries of the stack with a vector holding them, e.g. "[1, 2, 3.5]".
+    buildVector
+};
+
+/// @brief Instruction of the postfix bytecode consumed by the compiler and the interactive evaluator.
+struct PostfixInstruction {
+    /// @brief Kind of the instruction.
+    PostfixOperationCode operationCode = PostfixOperationCode::pushNumber;
+
+    /// @brief Whether the pushed number is an exact 64-bit integer.
+    bool isInteger = false;
+
+    /// @brief Slot of the pushed variable.
+    uint32_t variableSlot = 0;
+
+    /// @brief Number of elements of the built vector.
+    uint32_t elementCount = 0;
+
+    /// @brief Pushed number (rounded to double for integers).
+    double number = 0;
+
+    /// @brief Rounding error of number, so that number + numberLow holds a decimal literal or constant to about 106 bits
+    /// (see DoubleDouble.hpp). Only read by the extended precision evaluator.
+    double numberLow = 0;
+
+    /// @brief Pushed integer, only meaningful if isInteger is true.
+    int64_t integer = 0;
+
+    /// @brief Name of the operator or of the user function.
+    std::string name;
+
+    /// @brief Called user function. Kept alive by the table it has been looked up in, or by UserFunction::callees.
+    const UserFunction* userFunction = nullptr;
+};
+
+/// @brief Kinds of instructions understood by the compiled expression interpreter.
+enum class OperationCode : uint8_t {
+    /// @brief destination = unaryFunction(first).
+    unary,
+
+    /// @brief destination = binaryFunction(first, second).
+    binary,
+
+    /// @brief destination = compensated sum of the (possibly negated) registers listed in reductionOperands[first, first + second).
+    sum,
+
+    /// @brief destination = product of the registers listed in reductionOperands[first, first + second).
+    product,
+
+    /// @brief destination = compensated sum of the results of subprograms[first, first + second), evaluated in parallel.
+    parallelSum,
+
+    /// @brief destination = product of the results of subprograms[first, first + second), evaluated in parallel.
+    parallelProduct,
+
+    /// @brief destination = polynomialCoefficients[second] evaluated at first (Horner's scheme, Estrin's scheme for blocks).
+    polynomial,
+
+    /// @brief destination = approximation of FastFunction second at first, at the accuracy of the program (see FastMath.hpp).
+    /// unaryFunction is called for the operands outside the range of the approximation.
+    approximateUnary,
+
+    /// @brief destination = sin(first) and register second = cos(first), computed together at the accuracy of the program.
+    /// Shared by every sin, cos, tan, sec, csc and cot of the same operand: tan and cot become binary instructions dividing the
+    /// two registers, sec and csc binary instructions inverting one of them (with the operand as their second operand, reported by
+    /// their domain errors). Checked cot divides by the result of a cotcheck instruction, which checks the sine against the operand.
+    sineCosine
+};
+
+/// @brief Modes a program can be compiled in.
+enum class EvaluationMode : uint8_t {
+    /// @brief Operators are domain-checked and throw on invalid input.
+    checked,
+
+    /// @brief Operators call the raw kernels. Invalid input produces nan or inf, recorded by EvaluationStatus.
+    unchecked
+};
+
+/// @brief Accuracy tiers of the transcendental functions (sin, cos, exp, ln, log2 and log) of a program, see FastMath.hpp.
+enum class MathAccuracy : uint8_t {
+    /// @brief Functions of the lookup tables, i.e. of the C library, called one element at a time.
+    library,
+
+    /// @brief Polynomial approximations with errors of at most 1 ulp in block evaluation, vectorized. sin and cos, and every function
+    /// evaluated one row at a time, call the C library.
+    oneUlp,
+
+    /// @brief Polynomial approximations with errors of at most 4 ulps in block evaluation, vectorized. sin and cos, and every function
+    /// evaluated one row at a time, call the C library.
+    fourUlps,
+
+    /// @brief Polynomial approximations with relative errors of about 1e-7 (single precision), vectorized.
+    approximate
+};
+
+/// @brief Sticky status of unchecked evaluations. Can be shared by many calls and checked once at the end.
+struct EvaluationStatus {
+    /// @brief Value of firstInvalidInstruction while every value produced so far is finite.
+    static constexpr uint32_t noInvalidInstruction = UINT32_MAX;
+
+    /// @brief Index of the earliest instruction that produced nan or inf.
+    uint32_t firstInvalidInstruction = noInvalidInstruction;
+
+    /// @brief Method for checking whether every value produced so far is finite.
+    bool isValid() const { return this->firstInvalidInstruction == noInvalidInstruction; }
+};
+
+/// @brief Single register machine instruction of a compiled expression.
+struct Instruction {
+    /// @brief Kind of the instruction.
+    OperationCode operationCode;
+
+    /// @brief Register receiving the result of the instruction.
+    uint32_t destinationRegister;
+
+    /// @brief Register holding the first operand (offset of the operand list for reductions).
+    uint32_t firstOperandRegister;
+
+    /// @brief Register holding the second operand (unused by unary instructions, length of the operand list for reductions).
+    uint32_t secondOperandRegister;
+
+    /// @brief Function called by unary instructions.
+    UnaryFunction unaryFunction;
+
+    /// @brief Function called by binary instructions.
+    BinaryFunction binaryFunction;
+};
+
+/// @brief Statistics gathered while compiling an expression.
+struct CompilationStatistics {
+    /// @brief Number of operations found in the postfix notation (before common subexpression elimination).
+    size_t operationsBeforeElimination = 0;
+
+    /// @brief Number of operations emitted into the compiled program.
+    size_t operationsAfterElimination = 0;
+
+    /// @brief Number of operations removed by common subexpression elimination.
+    size_t eliminatedOperations = 0;
+
+    /// @brief Number of operations on constants evaluated at compile time (exactly, for pure-integer subexpressions).
+    size_t foldedOperations = 0;
+
+    /// @brief Number of terms of the associative chains rebalanced into parallel reductions.
+    size_t parallelReductionTerms = 0;
+
+    /// @brief Number of polynomial subexpressions collected into a single polynomial instruction.
+    size_t recognizedPolynomials = 0;
+
+    /// @brief Number of sin, cos, tan, sec, csc and cot calls computed from a sineCosine instruction shared with another call.
+    size_t fusedTrigonometricCalls = 0;
+
+    /// @brief Number of domain-checked operations proven never to throw by the interval analysis, and compiled to unchecked kernels.
+    size_t provenSafeOperations = 0;
+};
+
+/// @brief Expression compiled into a register program, where every distinct subexpression is computed once.
+/// Registers are laid out as constants first, then variables, then one register per emitted instruction.
+/// Unlike the interactive evaluator, intermediate results are kept as doubles and are never rounded towards 0.
+class CompiledExpression {
+    friend class ExpressionCompiler;
+    friend class ProgramCacheFile;
+
+    public:
+        /// @brief Method for evaluating the program with the given variable values.
+        /// @param variableValues Values of the variables, ordered like getVariableNames().
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if the number of values does not match the number of variables,
+        /// or if an operator is called outside its domain.
+        double evaluate(const std::vector<double>& variableValues) const;
+
+        /// @brief Method for evaluating the program using a caller-provided register file.
+        /// Does not allocate, which makes it suitable for evaluating the same program in a loop.
+        /// @param variableValues Pointer to the values of the variables, ordered like getVariableNames().
+        /// @param registers Pointer to a scratch buffer holding at least getRegisterCount() doubles.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if an operator is called outside its domain.
+        double evaluate(const double* variableValues, double* registers) const;
+
+        /// @brief Method for evaluating the program using a caller-provided register file and thread pool.
+        /// The pool evaluates large associative chains (e.g. sums of hundreds of thousands of terms) in parallel.
+        /// Other overloads use the pool shared by the whole process.
+        /// @param variableValues Pointer to the values of the variables, ordered like getVariableNames().
+        /// @param registers Pointer to a scratch buffer holding at least getRegisterCount() doubles.
+        /// @param pool Thread pool used by parallel reductions.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if an operator is called outside its domain.
+        double evaluate(const double* variableValues, double* registers, WorkStealingThreadPool& pool) const;
+
+        /// @brief Method for evaluating the program while recording the first instruction producing nan or inf.
+        /// Meant for unchecked programs, where it never throws. The status is only ever lowered, so one status
+        /// can be passed to a whole batch of evaluations and checked once at the end.
+        /// @param variableValues Pointer to the values of the variables, ordered like getVariableNames().
+        /// @param registers Pointer to a scratch buffer holding at least getRegisterCount() doubles.
+        /// @param status Sticky status updated by the evaluation.
+        /// @returns Value of the expression.
+        double evaluate(const double* variableValues, double* registers, EvaluationStatus& status) const;
+
+        /// @brief Method for evaluating the program together with its derivative with respect to one variable (forward-mode
+        /// automatic differentiation). Every register carries the derivative of its value, propagated with the derivative of each
+        /// operator (e.g. cos for sin), so the derivative is exact up to rounding. Operators without a usable derivative (ceil, floor,
+        /// round, !) make the derivative nan if the result depends on them.
+        /// @param variableValues Pointer to the values of the variables, ordered like getVariableNames().
+        /// @param variableSlot Slot of the variable to differentiate with respect to.
+        /// @param registers Pointer to a scratch buffer holding at least getRegisterCount() doubles.
+        /// @param tangents Pointer to a scratch buffer holding at least getRegisterCount() doubles, receiving the derivative of every register.
+        /// @param derivative Reference receiving the derivative of the expression.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if an operator is called outside its domain (checked programs only).
+        double evaluateDerivative(const double* variableValues, uint32_t variableSlot, double* registers, double* tangents, double& derivative) const;
+
+        /// @brief Method for evaluating the program on a block of rows, dispatching each instruction once for the whole block.
+        /// '+', '-', '*', '/', neg, abs and sqrt run on SIMD kernels (see VectorKernels.hpp), and so do the transcendental functions
+        /// of programs compiled with a MathAccuracy other than library (see FastMath.hpp). Other operators are called per row.
+        /// Parallel reductions evaluate their subprograms one after the other, since the caller already spreads rows across threads.
+        /// @param variableColumns Pointers to the values of the variables, ordered like getVariableNames(), count values each.
+        /// @param count Number of rows.
+        /// @param registers Pointer to a scratch buffer holding at least getRegisterCount() * count doubles.
+        /// @param results Pointer receiving the value of the expression for each row.
+        /// @throws invalid_argument error if an operator is called outside its domain (checked programs only).
+        void evaluateBlock(const double* const* variableColumns, size_t count, double* registers, double* results) const;
+
+        /// @brief Method for evaluating the program on a block of rows with the transcendental functions at the given accuracy,
+        /// whichever accuracy the program has been compiled with.
+        /// @param variableColumns Pointers to the values of the variables, ordered like getVariableNames(), count values each.
+        /// @param count Number of rows.
+        /// @param registers Pointer to a scratch buffer holding at least getRegisterCount() * count doubles.
+        /// @param results Pointer receiving the value of the expression for each row.
+        /// @param accuracy Accuracy of sin, cos, exp, ln, log2 and log for this call.
+        /// @throws invalid_argument error if an operator is called outside its domain (checked programs only).
+        void evaluateBlock(const double* const* variableColumns, size_t count, double* registers, double* results, MathAccuracy accuracy) const;
+
+        /// @brief Method for describing the instruction recorded by an evaluation status.
+        /// @param status Status filled by evaluate().
+        /// @returns Description such as "sqrt r4", or an empty string if the status is valid.
+        std::string describeInvalidInstruction(const EvaluationStatus& status) const;
+
+        /// @brief Method for accessing the mode the program was compiled in.
+        EvaluationMode getEvaluationMode() const;
+
+        /// @brief Method for accessing the accuracy of the transcendental functions the program was compiled with.
+        MathAccuracy getMathAccuracy() const;
+
+        /// @brief Method for accessing the number of registers used by the program.
+        size_t getRegisterCount() const;
+
+        /// @brief Method for accessing the names of the variables, ordered by their slot.
+        const std::vector<std::string>& getVariableNames() const;
+
+        /// @brief Method for accessing the emitted instructions.
+        const std::vector<Instruction>& getInstructions() const;
+
+        /// @brief Method for accessing the compilation statistics.
+        const CompilationStatistics& getStatistics() const;
+
+        /// @brief Method for accessing the warnings of the interval analysis, one per operation which may be called outside its
+        /// domain for the declared variable ranges, e.g. "DomainWarning: ln(x - 1) may be called outside its domain (x > 0): ...".
+        /// Empty if the program has been compiled without variable ranges.
+        const std::vector<std::string>& getDomainWarnings() const;
+
+        /// @brief Method for estimating the heap memory held by the program and its subprograms, e.g. to bound the size of a cache.
+        /// @returns The estimate in bytes, including the program object itself.
+        size_t getMemoryFootprint() const;
+
+        /// @brief Method for generating a human readable listing of the program and its statistics.
+        /// @returns The listing, one instruction per line.
+        std::string disassemble() const;
+
+    private:
+        /// @brief Flag set on the operands of sum instructions which are subtracted instead of added.
+        static constexpr uint32_t negatedOperandFlag = 0x80000000u;
+
+        /// @brief Emitted instructions in evaluation order.
+        std::vector<Instruction> instructions;
+
+        /// @brief Operand lists of the sum and product instructions.
+        std::vector<uint32_t> reductionOperands;
+
+        /// @brief Coefficients of the polynomial instructions, lowest degree first.
+        std::vector<std::vector<double>> polynomialCoefficients;
+
+        /// @brief Subprograms of the parallel reductions, each computing the partial result of a group of terms.
+        std::vector<std::shared_ptr<const CompiledExpression>> subprograms;
+
+        /// @brief Operator names of the emitted instructions, used for the listing.
+        std::vector<std::string> operatorNames;
+
+        /// @brief Values of the constant registers (registers [0, constants.size())).
+        std::vector<double> constants;
+
+        /// @brief Names of the variables bound to the registers following the constants.
+        std::vector<std::string> variableNames;
+
+        /// @brief Register holding the value of the whole expression.
+        uint32_t resultRegister = 0;
+
+        /// @brief Total number of registers.
+        uint32_t registerCount = 0;
+
+        /// @brief Mode the program was compiled in.
+        EvaluationMode evaluationMode = EvaluationMode::checked;
+
+        /// @brief Accuracy of the approximateUnary instructions.
+        MathAccuracy mathAccuracy = MathAccuracy::library;
+
+        /// @brief Statistics gathered while compiling the program.
+        CompilationStatistics statistics;
+
+        /// @brief Warnings of the interval analysis.
+        std::vector<std::string> domainWarnings;
+
+        /// @brief Private method for evaluating the program with the given pool (nullptr for the shared pool).
+        double evaluate(const double* variableValues, double* registers, WorkStealingThreadPool* pool) const;
+
+        /// @brief Private method for executing a single instruction.
+        /// @param instruction Instruction to execute.
+        /// @param variableValues Pointer to the values of the variables, passed on to subprograms.
+        /// @param registers Pointer to the register file. sineCosine instructions write their cosine register directly.
+        /// @param pool Thread pool used by parallel reductions (nullptr for the shared pool).
+        /// @returns Value of the destination register.
+        double executeInstruction(const Instruction& instruction, const double* variableValues, double* registers, WorkStealingThreadPool* pool) const;
+
+        /// @brief Private method for describing an instruction, e.g. "sqrt r4".
+        /// @param index Index of the instruction.
+        /// @returns The description.
+        std::string describeInstruction(size_t index) const;
+};
+
+/// @brief Function defined by the user, e.g. "def f(x, y) = sqrt(x^2 + y^2)".
+struct UserFunction {
+    /// @brief Name of the function.
+    std::string name;
+
+    /// @brief Names of the parameters, ordered by their position.
+    std::vector<std::string> parameterNames;
+
+    /// @brief Body of the function in postfix bytecode. Parameters are pushed as variables, ordered by their position.
+    std::vector<PostfixInstruction> postfixBody;
+
+    /// @brief Snapshots of the user functions called by the body, taken at definition time.
+    /// Redefining a callee later does not change this function, which rules out recursion.
+    std::unordered_map<std::string, std::shared_ptr<const UserFunction>> callees;
+
+    /// @brief Body compiled on its own, used by the interactive evaluator.
+    CompiledExpression program;
+
+    /// @brief Hash of the definition and of the fingerprints of the callees, i.e. of everything calls to the function compile to.
+    /// Keys the programs of a ProgramCacheFile together with the expression.
+    uint64_t fingerprint = 0;
+};
+
+/// @brief Table mapping user function names to their (immutable) definitions.
+typedef std::unordered_map<std::string, std::shared_ptr<const UserFunction>> UserFunctionTable;
+
+/// @brief Compiler turning postfix bytecode into a DAG of hash-consed nodes and emitting a register program.
+/// Identical subtrees (including commuted operands of '+' and '*') are merged, so each distinct subexpression is computed once.
+/// Calls to user functions are inlined, so they cost nothing at evaluation time and take part in the merging.
+/// Chains of at least parallelChainThreshold terms joined by '+' / '-' or '*' are split into groups compiled as subprograms,
+/// which are evaluated in parallel and combined with compensated summation. Operations on constants are folded at compile time.
+/// Pure-integer subexpressions (e.g. "2^62 + 17 % 5", "20!") are folded exactly in 64-bit integers, falling back to double
+/// precision on overflow or non-integer operations. Polynomials written in expanded form, e.g. "3*x^4 - 2*x^3 + x - 7",
+/// are collected into their coefficients and evaluated with a single polynomial instruction instead of calls to power.
+/// Trigonometric functions of the same operand, e.g. "sin(x)^2 + tan(x)", share a single sincos instruction.
+/// Given the range of every variable, e.g. "x in [0.1, 10]", checked programs propagate intervals through the DAG: operations proven
+/// never to throw (e.g. ln(x + 1)) call the unchecked kernels, and the others keep their checks and are reported as warnings.
+class ExpressionCompiler {
+    public:
+        /// @brief Constructor for the expression compiler class.
+        /// @param unaryOperatorLookupTable Table mapping unary operator names to their functions (checked or unchecked kernels).
+        /// @param binaryOperatorLookupTable Table mapping binary operator names to their functions (checked or unchecked kernels).
+        ExpressionCompiler(
+            const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+            const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable
+        );
+
+        /// @brief Constructor for the expression compiler class, with the unchecked kernels the operations proven safe by the
+        /// interval analysis are compiled to.
+        /// @param unaryOperatorLookupTable Table mapping unary operator names to their checked functions.
+        /// @param binaryOperatorLookupTable Table mapping binary operator names to their checked functions.
+        /// @param uncheckedUnaryOperatorLookupTable Table mapping unary operator names to their unchecked functions.
+        /// @param uncheckedBinaryOperatorLookupTable Table mapping binary operator names to their unchecked functions.
+        ExpressionCompiler(
+            const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+            const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable,
+            const std::unordered_map<std::string, UnaryFunction>& uncheckedUnaryOperatorLookupTable,
+            const std::unordered_map<std::string, BinaryFunction>& uncheckedBinaryOperatorLookupTable
+        );
+
+        /// @brief Method for compiling postfix bytecode into a register program.
+        /// @param postfixProgram Bytecode emitted by the parser.
+        /// @param variableNames Names of the variables, ordered by their slot.
+        /// @param evaluationMode Mode matching the kernels held by the lookup tables.
+        /// @param mathAccuracy Accuracy of sin, cos, exp, ln, log2 and log. Tiers other than library approximate them with polynomials.
+        /// @returns The compiled program.
+        /// @throws invalid_argument error if the bytecode has excess operators or operands.
+        CompiledExpression compile(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<std::string>& variableNames, EvaluationMode evaluationMode = EvaluationMode::checked, MathAccuracy mathAccuracy = MathAccuracy::library);
+
+        /// @brief Method for compiling postfix bytecode into a checked register program, given the range of every variable.
+        /// Intervals are propagated through the DAG. Operations whose operands always lie inside their domain call the unchecked
+        /// kernels (if the compiler has been given them), and the others are listed by CompiledExpression::getDomainWarnings().
+        /// @param postfixProgram Bytecode emitted by the parser.
+        /// @param variableNames Names of the variables, ordered by their slot.
+        /// @param variableRanges Ranges of the variables, ordered by their slot.
+        /// @param mathAccuracy Accuracy of sin, cos, exp, ln, log2 and log.
+        /// @returns The compiled program.
+        /// @throws invalid_argument error if the bytecode has excess operators or operands, or if the number of ranges does not match.
+        CompiledExpression compile(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<std::string>& variableNames, const std::vector<Interval>& variableRanges, MathAccuracy mathAccuracy = MathAccuracy::library);
+
+        /// @brief Method for restoring the functions of the instructions of a program read back from a file, which only holds
+        /// their operator names (see ProgramCacheFile.hpp). Subprograms are not visited.
+        /// @param program Program whose unary and binary instructions are bound to the functions of the lookup tables.
+        /// @param evaluationMode Mode of the whole program, selecting the kernels of the fused trigonometric functions.
+        /// @returns false if an operator is missing from the lookup tables or does not match its instruction.
+        bool bindFunctions(CompiledExpression& program, EvaluationMode evaluationMode) const;
+
+    private:
+        /// @brief Smallest number of terms of an associative chain evaluated in parallel.
+        static constexpr size_t parallelChainThreshold = 8192;
+
+        /// @brief Number of terms of an associative chain evaluated by each subprogram.
+        static constexpr size_t termsPerSubprogram = 4096;
+
+        /// @brief Kinds of nodes stored in the expression DAG.
+        enum class NodeKind : uint8_t { constant, integer, variable, unary, binary };
+
+        /// @brief Node of the expression DAG.
+        struct Node {
+            /// @brief Kind of the node.
+            NodeKind kind;
+
+            /// @brief Constant value (bits of a double or of an int64_t), variable slot, or operator name index depending on the kind.
+            uint64_t payload;
+
+            /// @brief Indices of the operand nodes.
+            uint32_t firstOperand, secondOperand;
+
+            /// @brief Method for comparing two nodes structurally.
+            bool operator==(const Node& other) const;
+        };
+
+        /// @brief Custom hash function for DAG nodes.
+        struct NodeHash {
+            size_t operator()(const Node& node) const;
+        };
+
+        /// @brief Table mapping unary operator names to their functions.
+        const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable;
+
+        /// @brief Table mapping binary operator names to their functions.
+        const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable;
+
+        /// @brief Table mapping unary operator names to the unchecked functions of the operations proven safe (nullptr if not given).
+        const std::unordered_map<std::string, UnaryFunction>* uncheckedUnaryOperatorLookupTable = nullptr;
+
+        /// @brief Table mapping binary operator names to the unchecked functions of the operations proven safe (nullptr if not given).
+        const std::unordered_map<std::string, BinaryFunction>* uncheckedBinaryOperatorLookupTable = nullptr;
+
+        /// @brief Ranges of the variables of the program being compiled, nullptr to skip the interval analysis.
+        const std::vector<Interval>* variableRanges = nullptr;
+
+        /// @brief Whether each node is a domain-checked operation proven safe by the interval analysis (empty without analysis).
+        std::vector<bool> provenSafeNodes;
+
+        /// @brief Warnings of the interval analysis of the program being compiled.
+        std::vector<std::string> domainWarnings;
+
+        /// @brief All distinct nodes of the DAG, children always preceding their parents.
+        std::vector<Node> nodes;
+
+        /// @brief Hash-consing table mapping a node to its index inside the node vector.
+        std::unordered_map<Node, uint32_t, NodeHash> nodeLookupTable;
+
+        /// @brief Interned operator names referenced by the operator nodes.
+        std::vector<std::string> operatorNames;
+
+        /// @brief Stack of node indices used while walking the bytecode.
+        std::vector<uint32_t> operandStack;
+
+        /// @brief Number of operators seen while walking the bytecode.
+        size_t operationCount;
+
+        /// @brief Number of operations folded into constants.
+        size_t foldedOperationCount;
+
+        /// @brief Number of polynomial instructions emitted, including the ones of the subprograms.
+        size_t emittedPolynomialCount = 0;
+
+        /// @brief Number of trigonometric calls sharing a sincos instruction, including the ones of the subprograms.
+        size_t fusedTrigonometricCallCount = 0;
+
+        /// @brief Mode of the program being compiled, selecting the kernels of the fused trigonometric functions.
+        EvaluationMode evaluationMode = EvaluationMode::checked;
+
+        /// @brief Accuracy of the transcendental functions of the program being compiled.
+        MathAccuracy mathAccuracy = MathAccuracy::library;
+
+        /// @brief Terms of the associative chains evaluated in parallel, keyed by the root node of the chain.
+        /// Terms are node indices, with CompiledExpression::negatedOperandFlag set on subtracted terms.
+        std::unordered_map<uint32_t, std::vector<uint32_t>> parallelChainTerms;
+
+        /// @brief Polynomials replacing subtrees of the DAG, keyed by the root node of the subtree.
+        struct Polynomial {
+            /// @brief Node the polynomial is evaluated at (e.g. a variable).
+            uint32_t base;
+
+            /// @brief Coefficients, lowest degree first.
+            std::vector<double> coefficients;
+        };
+        std::unordered_map<uint32_t, Polynomial> polynomials;
+
+        /// @brief Private method for returning the index of a node, inserting it if it does not exist yet.
+        /// @param node Node to look up.
+        /// @returns Index of the (possibly shared) node.
+        uint32_t internNode(const Node& node);
+
+        /// @brief Private method for interning an operator name.
+        /// @param name Operator name.
+        /// @returns Index of the name inside operatorNames.
+        uint32_t internOperatorName(const std::string& name);
+
+        /// @brief Private method for pushing a constant onto the operand stack.
+        /// @param value Constant value.
+        void pushConstant(double value);
+
+        /// @brief Private method for pushing an exact integer constant onto the operand stack.
+        /// @param value Integer value.
+        void pushInteger(int64_t value);
+
+        /// @brief Private method for reading the value of a constant node.
+        /// @param node Index of the node.
+        /// @param value Reference to the value (rounded to double for integer nodes).
+        /// @returns true if the node is a constant or an integer, false otherwise.
+        bool getConstantValue(uint32_t node, double& value) const;
+
+        /// @brief Private method for replacing the top of the operand stack with a folded constant.
+        /// @param value Double value computed at compile time.
+        /// @returns true if the value has been folded (it is finite), false otherwise.
+        bool foldConstant(double value);
+
+        /// @brief Private method for pushing a variable onto the operand stack.
+        /// @param slot Variable slot.
+        void pushVariable(uint32_t slot);
+
+        /// @brief Private method for applying a unary operator to the top of the operand stack.
+        /// @param name Operator name.
+        /// @throws invalid_argument error if the operand stack is empty.
+        void applyUnaryOperator(const std::string& name);
+
+        /// @brief Private method for applying a binary operator to the top two entries of the operand stack.
+        /// @param name Operator name.
+        /// @throws invalid_argument error if the operand stack holds less than two entries.
+        void applyBinaryOperator(const std::string& name);
+
+        /// @brief Private method for walking postfix bytecode and building the DAG.
+        /// @param postfixProgram Bytecode to walk.
+        /// @param boundNodes Nodes the variable slots of the bytecode refer to.
+        /// @throws invalid_argument error if the bytecode has excess operators.
+        void compileInstructions(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<uint32_t>& boundNodes);
+
+        /// @brief Private method for inlining a user function call, consuming its arguments from the operand stack.
+        /// @param function Definition of the called function.
+        /// @throws invalid_argument error if the operand stack holds less arguments than the function has parameters.
+        void inlineUserFunction(const UserFunction& function);
+
+        /// @brief Private method for emitting the register program from the DAG.
+        /// @param variableNames Names of the variables, ordered by their slot.
+        /// @returns The compiled program.
+        CompiledExpression emitProgram(const std::vector<std::string>& variableNames);
+
+        /// @brief Private method for finding the associative chains large enough to be evaluated in parallel.
+        /// Only nodes used once are merged into a chain, since shared nodes must keep their own value.
+        /// @param isReachable Reachability of every node from the result.
+        void findParallelChains(const std::vector<bool>& isReachable);
+
+        /// @brief Private method for finding the subtrees that are polynomials of degree 2 or more in a single node and raise it to
+        /// a power, e.g. "3*x^4 - 2*x^3 + x - 7". Only sums of monomials are collected, e.g. "(x+1)^2" is left as it is, since
+        /// expanding it would lose precision near its roots.
+        /// @param isReachable Reachability of every node from the result.
+        void findPolynomials(const std::vector<bool>& isReachable);
+
+        /// @brief Private method for propagating the variable ranges through the reachable nodes, marking the domain-checked
+        /// operations whose operands always lie inside their domain, and writing a warning for every other one.
+        /// @param isReachable Reachability of every node from the result.
+        /// @param variableNames Names of the variables, ordered by their slot.
+        void analyzeDomains(const std::vector<bool>& isReachable, const std::vector<std::string>& variableNames);
+
+        /// @brief Private method for writing the subexpression of a node in infix notation, e.g. "ln(x - 1)".
+        /// @param node Index of the node.
+        /// @param variableNames Names of the variables, ordered by their slot.
+        /// @returns The subexpression.
+        std::string describeNode(uint32_t node, const std::vector<std::string>& variableNames) const;
+
+        /// @brief Private method for finding the function an operator node is compiled to: the unchecked one if the node has been
+        /// proven safe, the one of the lookup table otherwise.
+        /// @param node Index of the node.
+        /// @param name Operator name.
+        UnaryFunction findUnaryFunction(uint32_t node, const std::string& name) const;
+        BinaryFunction findBinaryFunction(uint32_t node, const std::string& name) const;
+
+        /// @brief Private method for finding the trigonometric calls which share a sincos instruction: the sin, cos, tan, sec,
+        /// csc and cot nodes of an operand with at least two distinct such calls.
+        /// @param neededNodes Nodes computed by the program, in topological order.
+        /// @returns Table mapping each fused call to the first fused call of its operand, where the sincos instruction is emitted.
+        std::unordered_map<uint32_t, uint32_t> findTrigonometricPairs(const std::vector<uint32_t>& neededNodes) const;
+
+        /// @brief Private method for emitting a program computing the given nodes.
+        /// @param terms Nodes to compute, with negatedOperandFlag set on subtracted terms.
+        /// @param combiningCode sum or product to combine several terms, unary for a single term.
+        /// @param variableNames Names of the variables, ordered by their slot.
+        /// @returns The program.
+        CompiledExpression emitSubprogram(const std::vector<uint32_t>& terms, OperationCode combiningCode, const std::vector<std::string>& variableNames);
+};
+
+#endif
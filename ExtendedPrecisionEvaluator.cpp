@@ -0,0 +1,129 @@
+#include "ExtendedPrecisionEvaluator.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+ExtendedPrecisionEvaluator::ExtendedPrecisionEvaluator(
+    const std::unordered_map<std::string, ExtendedUnaryFunction>& extendedUnaryOperatorLookupTable,
+    const std::unordered_map<std::string, ExtendedBinaryFunction>& extendedBinaryOperatorLookupTable
+) : extendedUnaryOperatorLookupTable(extendedUnaryOperatorLookupTable), extendedBinaryOperatorLookupTable(extendedBinaryOperatorLookupTable) {}
+
+DoubleDoubleVector ExtendedPrecisionEvaluator::evaluate(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<DoubleDoubleVector>& variableValues) {
+    // Bind the variable slots to the given values.
+    std::vector<const DoubleDoubleVector*> boundVariables;
+    boundVariables.reserve(variableValues.size());
+    for (const DoubleDoubleVector& value : variableValues) boundVariables.push_back(&value);
+
+    Operand result = this->evaluateInstructions(postfixProgram, boundVariables);
+    return (result.variable != nullptr) ? *result.variable : std::move(result.temporary);
+}
+
+ExtendedPrecisionEvaluator::Operand ExtendedPrecisionEvaluator::evaluateInstructions(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<const DoubleDoubleVector*>& boundVariables) {
+    // Walk the bytecode like VectorEvaluator. The parser only emits well-formed bytecode.
+    std::vector<Operand> operandStack;
+    for (const PostfixInstruction& instruction : postfixProgram) {
+        switch (instruction.operationCode) {
+            case PostfixOperationCode::pushNumber: {
+                // Push integers exactly, and other numbers with the rounding error of their double.
+                DoubleDouble number = instruction.isInteger ? toDoubleDouble(instruction.integer) : DoubleDouble{instruction.number, instruction.numberLow};
+                operandStack.push_back({nullptr, {{number.high}, {number.low}}});
+                break;
+            }
+
+            case PostfixOperationCode::pushVariable:
+                // Refer to the elements of the variable instead of copying them.
+                operandStack.push_back({boundVariables.at(instruction.variableSlot), {}});
+                break;
+
+            case PostfixOperationCode::buildVector: {
+                // Gather the elements of the literal, each of which must be a scalar.
+                Operand literal;
+                literal.temporary.resize(instruction.elementCount);
+                for (size_t element = 0; element < instruction.elementCount; element++) {
+                    const DoubleDoubleVector& elements = operandStack[operandStack.size() - instruction.elementCount + element].getElements();
+                    if (elements.size() != 1) throw std::invalid_argument("EvalError: Found vector inside a vector literal (expected scalar elements).\n");
+                    literal.temporary.high[element] = elements.high[0];
+                    literal.temporary.low[element] = elements.low[0];
+                }
+                operandStack.resize(operandStack.size() - instruction.elementCount);
+                operandStack.push_back(std::move(literal));
+                break;
+            }
+
+            case PostfixOperationCode::applyUnaryOperator: {
+                Operand result = this->applyUnaryOperator(instruction.name, operandStack.back());
+                operandStack.back() = std::move(result);
+                break;
+            }
+
+            case PostfixOperationCode::applyBinaryOperator: {
+                Operand secondOperand = std::move(operandStack.back());
+                operandStack.pop_back();
+                Operand result = this->applyBinaryOperator(instruction.name, operandStack.back(), secondOperand);
+                operandStack.back() = std::move(result);
+                break;
+            }
+
+            case PostfixOperationCode::callUserFunction: {
+                // Evaluate the body of the function with its parameters bound to the arguments.
+                size_t parameterCount = instruction.userFunction->parameterNames.size();
+                std::vector<Operand> arguments(std::make_move_iterator(operandStack.end() - parameterCount), std::make_move_iterator(operandStack.end()));
+                operandStack.resize(operandStack.size() - parameterCount);
+                std::vector<const DoubleDoubleVector*> boundArguments;
+                for (const Operand& argument : arguments) boundArguments.push_back(&argument.getElements());
+
+                // Copy the result if it refers to an argument, which goes out of scope.
+                Operand result = this->evaluateInstructions(instruction.userFunction->postfixBody, boundArguments);
+                if (result.variable != nullptr) result = {nullptr, *result.variable};
+                operandStack.push_back(std::move(result));
+                break;
+            }
+        }
+    }
+    return std::move(operandStack.back());
+}
+
+ExtendedPrecisionEvaluator::Operand ExtendedPrecisionEvaluator::applyUnaryOperator(const std::string& name, Operand& operand) const {
+    // Write over the operand if it is a temporary, otherwise allocate the result once.
+    // Moving a vector keeps its buffer, so the operand elements stay where they are.
+    const DoubleDoubleVector& elements = operand.getElements();
+    const double* operandHigh = elements.high.data();
+    const double* operandLow = elements.low.data();
+    size_t count = elements.size();
+    Operand result;
+    if (operand.variable == nullptr) result.temporary = std::move(operand.temporary);
+    else result.temporary.resize(count);
+
+    applyExtendedUnaryElementwise(findExtendedKernel(name), this->extendedUnaryOperatorLookupTable.at(name), operandHigh, operandLow, result.temporary.high.data(), result.temporary.low.data(), count);
+    return result;
+}
+
+ExtendedPrecisionEvaluator::Operand ExtendedPrecisionEvaluator::applyBinaryOperator(const std::string& name, Operand& firstOperand, Operand& secondOperand) const {
+    const DoubleDoubleVector& firstElements = firstOperand.getElements();
+    const DoubleDoubleVector& secondElements = secondOperand.getElements();
+
+    // Broadcast single-element operands to the length of the other one.
+    size_t count = std::max(firstElements.size(), secondElements.size());
+    bool isFirstBroadcast = firstElements.size() == 1 && count != 1, isSecondBroadcast = secondElements.size() == 1 && count != 1;
+    if ((firstElements.size() != count && !isFirstBroadcast) || (secondElements.size() != count && !isSecondBroadcast)) {
+        std::string errorMessage = "EvalError: Cannot apply " + name;
+        errorMessage += " element-wise to vectors of lengths " + std::to_string(firstElements.size()) + " and ";
+        errorMessage += std::to_string(secondElements.size()) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Write over a temporary operand of the result length, otherwise allocate the result once.
+    // Moving a vector keeps its buffer, so the operand elements stay where they are.
+    const double* firstHigh = firstElements.high.data();
+    const double* firstLow = firstElements.low.data();
+    const double* secondHigh = secondElements.high.data();
+    const double* secondLow = secondElements.low.data();
+    Operand result;
+    if (firstOperand.variable == nullptr && !isFirstBroadcast) result.temporary = std::move(firstOperand.temporary);
+    else if (secondOperand.variable == nullptr && !isSecondBroadcast) result.temporary = std::move(secondOperand.temporary);
+    else result.temporary.resize(count);
+
+    applyExtendedBinaryElementwise(findExtendedKernel(name), this->extendedBinaryOperatorLookupTable.at(name), firstHigh, firstLow, isFirstBroadcast,
+        secondHigh, secondLow, isSecondBroadcast, result.temporary.high.data(), result.temporary.low.data(), count);
+    return result;
+}
@@ -0,0 +1,66 @@
+#ifndef __EXTENDED_PRECISION_EVALUATOR
+#define __EXTENDED_PRECISION_EVALUATOR
+
+#include "ExpressionCompiler.hpp"
+#include "DoubleDouble.hpp"
+
+/// @brief Evaluator applying postfix bytecode element-wise in double-double precision (about 32 significant digits, see
+/// DoubleDouble.hpp), e.g. "dd 1/3 + pi". It works like VectorEvaluator: single-element values are broadcast, and each operation
+/// costs one dispatch for the whole vector, so a long vector (or a block of rows) keeps the SIMD kernels of '+', '-', '*', '/',
+/// neg, abs and sqrt busy. Numbers and constants are pushed with the rounding error the parser kept (PostfixInstruction::numberLow),
+/// and integers exactly. Unlike the interactive scalar path, results close to 0 are not flushed to 0.
+class ExtendedPrecisionEvaluator {
+    public:
+        /// @brief Constructor for the extended precision evaluator class.
+        /// @param extendedUnaryOperatorLookupTable Table mapping unary operator names to their double-double functions.
+        /// @param extendedBinaryOperatorLookupTable Table mapping binary operator names to their double-double functions.
+        ExtendedPrecisionEvaluator(
+            const std::unordered_map<std::string, ExtendedUnaryFunction>& extendedUnaryOperatorLookupTable,
+            const std::unordered_map<std::string, ExtendedBinaryFunction>& extendedBinaryOperatorLookupTable
+        );
+
+        /// @brief Method for evaluating bytecode element-wise.
+        /// @param postfixProgram Bytecode emitted by the parser.
+        /// @param variableValues Values of the variables, ordered by their slot (single-element vectors for scalars).
+        /// @returns Elements of the result (a single element if every operand is a scalar).
+        /// @throws invalid_argument error if the lengths of two operands differ, or if an operator is called outside its domain.
+        DoubleDoubleVector evaluate(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<DoubleDoubleVector>& variableValues);
+
+    private:
+        /// @brief Value on the operand stack, either referring to a variable or owning its elements.
+        struct Operand {
+            /// @brief Elements of the variable the operand refers to (nullptr for temporaries).
+            const DoubleDoubleVector* variable = nullptr;
+
+            /// @brief Elements owned by a temporary.
+            DoubleDoubleVector temporary;
+
+            /// @brief Method for accessing the elements.
+            const DoubleDoubleVector& getElements() const { return (this->variable != nullptr) ? *this->variable : this->temporary; }
+        };
+
+        const std::unordered_map<std::string, ExtendedUnaryFunction>& extendedUnaryOperatorLookupTable;
+        const std::unordered_map<std::string, ExtendedBinaryFunction>& extendedBinaryOperatorLookupTable;
+
+        /// @brief Private method for evaluating bytecode with variables bound to the given elements.
+        /// @param postfixProgram Bytecode to evaluate.
+        /// @param boundVariables Elements the variable slots of the bytecode refer to.
+        /// @returns The result.
+        Operand evaluateInstructions(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<const DoubleDoubleVector*>& boundVariables);
+
+        /// @brief Private method for applying a unary operator element-wise.
+        /// @param name Operator name.
+        /// @param operand Operand, overwritten if it is a temporary.
+        /// @returns The result.
+        Operand applyUnaryOperator(const std::string& name, Operand& operand) const;
+
+        /// @brief Private method for applying a binary operator element-wise, broadcasting single-element operands.
+        /// @param name Operator name.
+        /// @param firstOperand First operand, overwritten if it is a temporary of the result length.
+        /// @param secondOperand Second operand, overwritten if it is a temporary of the result length.
+        /// @returns The result.
+        /// @throws invalid_argument error if the lengths of the operands differ and neither has a single element.
+        Operand applyBinaryOperator(const std::string& name, Operand& firstOperand, Operand& secondOperand) const;
+};
+
+#endif
@@ -0,0 +1,463 @@
+#include "FastMath.hpp"
+
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__)
+#define FAST_MATH_VECTORS
+#if defined(__x86_64__)
+#define FAST_MATH_AVX2
+#endif
+#endif
+
+namespace {
+
+#ifdef FAST_MATH_VECTORS
+/// @brief Lanes of 2 and 4 doubles, and the matching lanes of bits. The kernels are written once with the vector extensions
+/// of GCC / Clang, which lower them to SSE2 (or NEON) and, inside target("avx2") functions, to AVX2.
+typedef double DoublePair __attribute__((vector_size(16)));
+typedef uint64_t BitsPair __attribute__((vector_size(16)));
+typedef double DoubleQuad __attribute__((vector_size(32)));
+typedef uint64_t BitsQuad __attribute__((vector_size(32)));
+
+/// @brief Kernels are always inlined, so that they are compiled for the instruction set of the loop calling them.
+#define FAST_MATH_INLINE __attribute__((always_inline)) inline
+
+// Kernels take 4-double lanes by value, which would change their ABI without AVX. They are never called, only inlined.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#else
+#define FAST_MATH_INLINE inline
+#endif
+
+/// @brief Type holding the bits of the lanes.
+template <typename Lanes> struct LaneTraits { typedef uint64_t Bits; };
+#ifdef FAST_MATH_VECTORS
+template <> struct LaneTraits<DoublePair> { typedef BitsPair Bits; };
+template <> struct LaneTraits<DoubleQuad> { typedef BitsQuad Bits; };
+#endif
+
+template <typename Lanes>
+FAST_MATH_INLINE typename LaneTraits<Lanes>::Bits toBits(const Lanes& value) {
+    return std::bit_cast<typename LaneTraits<Lanes>::Bits>(value);
+}
+
+template <typename Lanes>
+FAST_MATH_INLINE Lanes fromBits(const typename LaneTraits<Lanes>::Bits& bits) {
+    return std::bit_cast<Lanes>(bits);
+}
+
+/// @brief Function for evaluating a polynomial with Horner's scheme, which keeps the rounding error of the sum small.
+/// @param coefficients Coefficients, lowest degree first.
+template <typename Lanes, size_t coefficientCount>
+FAST_MATH_INLINE Lanes evaluateHorner(const double (&coefficients)[coefficientCount], const Lanes& x) {
+    Lanes result = Lanes{} + coefficients[coefficientCount - 1];
+    for (size_t degree = coefficientCount - 1; degree > 0; degree--) result = result * x + coefficients[degree - 1];
+    return result;
+}
+
+/// @brief Adding and subtracting 1.5 * 2^52 rounds a double below 2^51 to the nearest integer, which then sits in the low bits.
+constexpr double roundingShift = 6755399441055744.0;
+constexpr uint64_t roundingShiftBits = std::bit_cast<uint64_t>(roundingShift);
+
+/// @brief 2/pi, and pi/2 split into two 33-bit parts and a remainder, so that k * pio2First and k * pio2Second are exact for |k| < 2^20.
+constexpr double twoOverPi = 0.6366197723675814;
+constexpr double pio2First = 1.5707963267341256, pio2Second = 6.077100506303966e-11, pio2Third = 2.0222662487959506e-21;
+
+/// @brief log2(e), and ln 2 split into a 32-bit part and a remainder, so that k * ln2High is exact for |k| < 2^21.
+constexpr double log2e = 1.4426950408889634;
+constexpr double ln2High = 0.6931471806019545, ln2Low = -4.2009150726810846e-11;
+
+/// @brief log2(e), log10(e) and log10(2) split into 32-bit parts and remainders, used by the compensated logarithms.
+constexpr double log2eHigh = 1.4426950407214463, log2eLow = 1.6751713164886512e-10;
+constexpr double log10e = 0.4342944819032518, log10eHigh = 0.4342944818781689, log10eLow = 2.5082946711645275e-11;
+constexpr double log10Two = 0.30102999566398120, log10TwoHigh = 0.3010299956658855, log10TwoLow = -1.9043128467164274e-12;
+
+/// @brief Offset moving the exponent field of x by one exactly when its mantissa reaches sqrt(2), i.e. bits(1) - bits(sqrt(1/2)).
+constexpr uint64_t logarithmOffset = 0x3ff0000000000000 - 0x3fe6a09e667f3bcd;
+
+/// @brief Coefficients of the polynomials of each tier, lowest degree first, obtained by Chebyshev economization of the Taylor series:
+/// sin(r) = r + r*z*sine(z) and cos(r) = 1 - z/2 + z^2*cosine(z) with z = r^2 <= (pi/4)^2 (1e-7 tier only, see isApproximated),
+/// exp(r) = 1 + r + r^2*exponential(r) with |r| <= ln(2)/2,
+/// ln(1+f) = 2s + s*z*logarithm(z) with s = f/(2+f) and z = s^2 <= 0.02944.
+template <MathAccuracy accuracy> struct Coefficients;
+
+template <> struct Coefficients<MathAccuracy::oneUlp> {
+    static constexpr double exponential[] = {
+        0.5, 0.1666666666666667, 0.04166666666666668, 0.008333333333325551, 0.0013888888888878277, 0.00019841269876842176,
+        2.480158733854189e-05, 2.7557252861387166e-06, 2.7557261054133115e-07, 2.5106263269311678e-08, 2.0918952794979583e-09
+    };
+    static constexpr double logarithm[] = {
+        0.6666666666666666, 0.40000000000000885, 0.2857142857080076, 0.22222222392303262, 0.18181795582103566,
+        0.15386242634932326, 0.13268699694889355, 0.130873486686174
+    };
+};
+
+template <> struct Coefficients<MathAccuracy::fourUlps> {
+    static constexpr double exponential[] = {
+        0.5000000000000001, 0.1666666666666667, 0.04166666666662067, 0.008333333333325551, 0.0013888888918920927,
+        0.00019841269876842176, 2.48015186696279e-05, 2.7557252861387166e-06, 2.7621325347067737e-07, 2.5106263269311678e-08
+    };
+    static constexpr double logarithm[] = {
+        0.666666666666667, 0.3999999999989895, 0.28571428626199113, 0.22222211101879027, 0.18182891314269, 0.15331654528864483,
+        0.1461722010170369
+    };
+};
+
+template <> struct Coefficients<MathAccuracy::approximate> {
+    static constexpr double sine[] = {-0.16666664664640482, 0.008332748540750425, -0.0001958792958498758};
+    static constexpr double cosine[] = {0.04166666466136213, -0.0013888303245565272, 2.4547970982892713e-05};
+    static constexpr double exponential[] = {0.5000000014281447, 0.16666573400056595, 0.0416664568723299, 0.00836376961434607, 0.001393453424566623};
+    static constexpr double logarithm[] = {0.6666668515771126, 0.39988747602333424, 0.2958109508463983};
+};
+
+/// @brief Function for reducing x to r = x - k*pi/2 with |r| <= pi/4, and approximating sin(r) and cos(r), for |x| <= 5e5.
+/// @param shifted Receives x * 2/pi + roundingShift, whose low bits hold k.
+template <MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE void approximateQuadrant(const Lanes& x, Lanes& shifted, Lanes& sine, Lanes& cosine) {
+    // The first subtraction is exact.
+    shifted = x * twoOverPi + roundingShift;
+    Lanes k = shifted - roundingShift;
+    Lanes r = ((x - k * pio2First) - k * pio2Second) - k * pio2Third, z = r * r;
+    sine = r + r * z * evaluateHorner(Coefficients<accuracy>::sine, z);
+    cosine = (1.0 - 0.5 * z) + z * z * evaluateHorner(Coefficients<accuracy>::cosine, z);
+}
+
+/// @brief Function for picking sin(x + quadrantOffset * pi/2) from the results of approximateQuadrant(): sin(r), cos(r), -sin(r),
+/// -cos(r) for k = 0, 1, 2, 3 (mod 4). The low bits of the shifted value hold k, so this only takes integer operations.
+template <typename Lanes>
+FAST_MATH_INLINE Lanes selectQuadrant(const Lanes& shifted, const Lanes& sine, const Lanes& cosine, uint64_t quadrantOffset) {
+    typedef typename LaneTraits<Lanes>::Bits Bits;
+    Bits quadrant = toBits(shifted) + quadrantOffset;
+    Bits isOdd = Bits{} - (quadrant & 1);
+    Bits result = (isOdd & toBits(cosine)) | (~isOdd & toBits(sine));
+    return fromBits<Lanes>(result ^ ((quadrant & 2) << 62));
+}
+
+/// @brief Function for approximating sin(x + quadrantOffset * pi/2) for |x| <= 5e5.
+template <MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE Lanes approximateSine(const Lanes& x, uint64_t quadrantOffset) {
+    Lanes shifted, sine, cosine;
+    approximateQuadrant<accuracy>(x, shifted, sine, cosine);
+    return selectQuadrant(shifted, sine, cosine, quadrantOffset);
+}
+
+/// @brief Function for approximating sin(x) and cos(x) together for |x| <= 5e5. Both polynomials are needed by either function,
+/// so the pair costs little more than one of them, and each result is bit-identical to approximateSine().
+template <MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE void approximateSineCosine(const Lanes& x, Lanes& sine, Lanes& cosine) {
+    Lanes shifted, sinePolynomial, cosinePolynomial;
+    approximateQuadrant<accuracy>(x, shifted, sinePolynomial, cosinePolynomial);
+    sine = selectQuadrant(shifted, sinePolynomial, cosinePolynomial, 0);
+    cosine = selectQuadrant(shifted, sinePolynomial, cosinePolynomial, 1);
+}
+
+/// @brief Function for approximating exp(x) for |x| <= 708, where the result and 2^k are normal numbers.
+template <MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE Lanes approximateExponential(const Lanes& x) {
+    // Reduce x to r = x - k*ln(2) with |r| <= ln(2)/2, then scale exp(r) by 2^k, built directly in the exponent field.
+    Lanes shifted = x * log2e + roundingShift;
+    Lanes k = shifted - roundingShift;
+    Lanes r = (x - k * ln2High) - k * ln2Low;
+    Lanes result = 1.0 + (r + r * r * evaluateHorner(Coefficients<accuracy>::exponential, r));
+    return result * fromBits<Lanes>((toBits(shifted) - roundingShiftBits + 1023) << 52);
+}
+
+/// @brief Function for approximating a logarithm of a positive normal x, in base e, 2 or 10.
+template <MathAccuracy accuracy, FastFunction function, typename Lanes>
+FAST_MATH_INLINE Lanes approximateLogarithm(const Lanes& x) {
+    typedef typename LaneTraits<Lanes>::Bits Bits;
+
+    // Split x into 2^e * m with m in [sqrt(1/2), sqrt(2)). The exponent is converted to double through the bits of 2^52 + e + 1023.
+    Bits bits = toBits(x);
+    Bits exponentBits = (bits + logarithmOffset) >> 52;
+    Lanes e = fromBits<Lanes>(exponentBits | std::bit_cast<uint64_t>(4503599627370496.0)) - (4503599627370496.0 + 1023);
+    Lanes f = fromBits<Lanes>(bits - ((exponentBits - 1023) << 52)) - 1.0;
+
+    // Approximate ln(1+f) = f - hfsq + s*(hfsq + R) with s = f/(2+f), hfsq = f^2/2 and R = 2s^3/3 + 2s^5/5 + ... (as fdlibm does).
+    Lanes s = f / (2.0 + f), z = s * s;
+    Lanes polynomial = z * evaluateHorner(Coefficients<accuracy>::logarithm, z);
+    Lanes hfsq = 0.5 * f * f;
+    if constexpr (function == FastFunction::naturalLogarithm) {
+        return e * ln2High - ((hfsq - (s * (hfsq + polynomial) + e * ln2Low)) - f);
+    } else if constexpr (accuracy == MathAccuracy::oneUlp) {
+        // Split ln(1+f) into a 21-bit high part and a low part, so that its product with the high part of the constant is exact.
+        Lanes high = fromBits<Lanes>(toBits(f - hfsq) & 0xffffffff00000000);
+        Lanes low = (f - high) - hfsq + s * (hfsq + polynomial);
+        Lanes integerPart, valueHigh, valueLow;
+        if constexpr (function == FastFunction::base2Logarithm) {
+            integerPart = e;
+            valueHigh = high * log2eHigh;
+            valueLow = (low + high) * log2eLow + low * log2eHigh;
+        } else {
+            integerPart = e * log10TwoHigh;
+            valueHigh = high * log10eHigh;
+            valueLow = e * log10TwoLow + (low + high) * log10eLow + low * log10eHigh;
+        }
+        Lanes sum = integerPart + valueHigh;
+        return (valueLow + ((integerPart - sum) + valueHigh)) + sum;
+    } else {
+        Lanes logarithm = f - (hfsq - s * (hfsq + polynomial));
+        if constexpr (function == FastFunction::base2Logarithm) return e + logarithm * log2e;
+        else return e * log10Two + logarithm * log10e;
+    }
+}
+
+/// @brief Function for approximating a function, without checking the range of the operands.
+template <FastFunction function, MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE Lanes approximate(const Lanes& x) {
+    if constexpr (function == FastFunction::sine) return approximateSine<accuracy>(x, 0);
+    else if constexpr (function == FastFunction::cosine) return approximateSine<accuracy>(x, 1);
+    else if constexpr (function == FastFunction::exponential) return approximateExponential<accuracy>(x);
+    else return approximateLogarithm<accuracy, function>(x);
+}
+
+/// @brief Function for checking whether an operand is inside the range of the approximation (nan never is).
+/// Zero sines are left to the fallback, which keeps the sign of -0.
+template <FastFunction function>
+FAST_MATH_INLINE bool isInsideRange(double operand) {
+    if constexpr (function == FastFunction::sine) return std::fabs(operand) > 0 && std::fabs(operand) <= 5e5;
+    else if constexpr (function == FastFunction::cosine) return std::fabs(operand) <= 5e5;
+    else if constexpr (function == FastFunction::exponential) return std::fabs(operand) <= 708;
+    else return operand >= DBL_MIN && operand <= DBL_MAX;
+}
+
+/// @brief Whether a tier approximates a function. The sin and cos polynomials of the 1 ulp and 4 ulps tiers were slower than the
+/// C library in both the scalar and the SIMD forms (see benchmarks/TranscendentalAccuracyBenchmark.cpp), so these tiers call
+/// the fallback for sin and cos, which also keeps the results within half an ulp.
+template <FastFunction function, MathAccuracy accuracy>
+constexpr bool isApproximated = (function != FastFunction::sine && function != FastFunction::cosine) || accuracy == MathAccuracy::approximate;
+
+/// @brief Whether the scalar form of a tier approximates a function. One operand at a time, the exp and logarithm polynomials of
+/// the 1 ulp and 4 ulps tiers were slower than the C library (0.5x to 0.8x, see benchmarks/TranscendentalAccuracyBenchmark.cpp),
+/// so these tiers only pay off in the element-wise form and their scalar form calls the fallback, which is at least as accurate.
+template <FastFunction function, MathAccuracy accuracy>
+constexpr bool isScalarApproximated = isApproximated<function, accuracy> && accuracy == MathAccuracy::approximate;
+
+/// @brief Function for approximating a function at one operand, calling the fallback outside the range of the approximation.
+template <FastFunction function, MathAccuracy accuracy>
+double approximateScalar(UnaryFunction fallback, double operand) {
+    if constexpr (!isScalarApproximated<function, accuracy>) return fallback(operand);
+    else return isInsideRange<function>(operand) ? approximate<function, accuracy>(operand) : fallback(operand);
+}
+
+/// @brief Function calling the fallback, used for FastFunction::none and MathAccuracy::library.
+double callFallback(UnaryFunction fallback, double operand) {
+    return fallback(operand);
+}
+
+/// @brief Function for computing sin and cos with the C library, in a single call where it has one (sincos of glibc).
+void computeLibrarySineCosine(double operand, double& sine, double& cosine) {
+#ifdef __GLIBC__
+    ::sincos(operand, &sine, &cosine);
+#else
+    sine = std::sin(operand);
+    cosine = std::cos(operand);
+#endif
+}
+
+/// @brief Function for approximating sin and cos at one operand, calling the C library outside the range of the sine.
+template <MathAccuracy accuracy>
+void approximateSineCosineScalar(double operand, double& sine, double& cosine) {
+    if constexpr (!isScalarApproximated<FastFunction::sine, accuracy>) computeLibrarySineCosine(operand, sine, cosine);
+    else if (isInsideRange<FastFunction::sine>(operand)) approximateSineCosine<accuracy>(operand, sine, cosine);
+    else computeLibrarySineCosine(operand, sine, cosine);
+}
+
+#ifdef FAST_MATH_VECTORS
+/// @brief Function for checking which lanes are outside the range of the approximation, like isInsideRange().
+/// @returns All bits set in the lanes outside the range.
+template <FastFunction function, typename Lanes>
+FAST_MATH_INLINE typename LaneTraits<Lanes>::Bits findLanesOutsideRange(const Lanes& x) {
+    typedef typename LaneTraits<Lanes>::Bits Bits;
+    Lanes magnitude = fromBits<Lanes>(toBits(x) & 0x7fffffffffffffff);
+    Bits isInside;
+    if constexpr (function == FastFunction::sine) isInside = std::bit_cast<Bits>(magnitude > 0.0) & std::bit_cast<Bits>(magnitude <= 5e5);
+    else if constexpr (function == FastFunction::cosine) isInside = std::bit_cast<Bits>(magnitude <= 5e5);
+    else if constexpr (function == FastFunction::exponential) isInside = std::bit_cast<Bits>(magnitude <= 708.0);
+    else isInside = std::bit_cast<Bits>(x >= DBL_MIN) & std::bit_cast<Bits>(x <= DBL_MAX);
+    return ~isInside;
+}
+
+/// @brief Function for approximating a block of lanes, then recomputing the (rare) elements outside the range with the fallback.
+/// The operands stay in registers, since the result may overwrite them.
+template <FastFunction function, MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE void approximateBlock(UnaryFunction fallback, const double* operand, double* result) {
+    constexpr size_t width = sizeof(Lanes) / sizeof(double);
+    Lanes x;
+    std::memcpy(&x, operand, sizeof(x));
+    Lanes block = approximate<function, accuracy>(x);
+    std::memcpy(result, &block, sizeof(block));
+
+    typename LaneTraits<Lanes>::Bits isOutside = findLanesOutsideRange<function>(x);
+    uint64_t isAnyOutside = 0;
+    for (size_t lane = 0; lane < width; lane++) isAnyOutside |= isOutside[lane];
+    if (isAnyOutside == 0) return;
+    for (size_t lane = 0; lane < width; lane++) {
+        if (isOutside[lane]) result[lane] = fallback(x[lane]);
+    }
+}
+
+/// @brief Function for approximating sin and cos of a block of lanes, like approximateBlock().
+template <MathAccuracy accuracy, typename Lanes>
+FAST_MATH_INLINE void approximateSineCosineBlock(const double* operand, double* sine, double* cosine) {
+    constexpr size_t width = sizeof(Lanes) / sizeof(double);
+    Lanes x, sineBlock, cosineBlock;
+    std::memcpy(&x, operand, sizeof(x));
+    approximateSineCosine<accuracy>(x, sineBlock, cosineBlock);
+    std::memcpy(sine, &sineBlock, sizeof(sineBlock));
+    std::memcpy(cosine, &cosineBlock, sizeof(cosineBlock));
+
+    typename LaneTraits<Lanes>::Bits isOutside = findLanesOutsideRange<FastFunction::sine>(x);
+    uint64_t isAnyOutside = 0;
+    for (size_t lane = 0; lane < width; lane++) isAnyOutside |= isOutside[lane];
+    if (isAnyOutside == 0) return;
+    for (size_t lane = 0; lane < width; lane++) {
+        if (isOutside[lane]) computeLibrarySineCosine(x[lane], sine[lane], cosine[lane]);
+    }
+}
+#endif
+
+#ifdef FAST_MATH_AVX2
+/// @brief Function for approximating a function 4 elements at a time.
+/// @returns Index of the first element left to the narrower loops.
+template <FastFunction function, MathAccuracy accuracy>
+__attribute__((target("avx2"))) size_t approximateAvx2Blocks(UnaryFunction fallback, const double* operand, double* result, size_t count) {
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4) approximateBlock<function, accuracy, DoubleQuad>(fallback, operand + index, result + index);
+    return index;
+}
+
+/// @brief Function for approximating sin and cos 4 elements at a time.
+/// @returns Index of the first element left to the narrower loops.
+template <MathAccuracy accuracy>
+__attribute__((target("avx2"))) size_t approximateSineCosineAvx2Blocks(const double* operand, double* sine, double* cosine, size_t count) {
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4) approximateSineCosineBlock<accuracy, DoubleQuad>(operand + index, sine + index, cosine + index);
+    return index;
+}
+
+/// @brief Whether the processor supports AVX2, checked once.
+const bool isAvx2Supported = __builtin_cpu_supports("avx2");
+#endif
+
+/// @brief Function for approximating a function element-wise with the widest available instructions.
+template <FastFunction function, MathAccuracy accuracy>
+void approximateElementwise(UnaryFunction fallback, const double* operand, double* result, size_t count) {
+    size_t index = 0;
+    if constexpr (isApproximated<function, accuracy>) {
+#ifdef FAST_MATH_AVX2
+        if (isAvx2Supported) index = approximateAvx2Blocks<function, accuracy>(fallback, operand, result, count);
+#endif
+#ifdef FAST_MATH_VECTORS
+        for (; index + 2 <= count; index += 2) approximateBlock<function, accuracy, DoublePair>(fallback, operand + index, result + index);
+#endif
+    }
+    for (; index < count; index++) result[index] = approximateScalar<function, accuracy>(fallback, operand[index]);
+}
+
+/// @brief Function for approximating sin and cos element-wise with the widest available instructions.
+template <MathAccuracy accuracy>
+void approximateSineCosineElementwise(const double* operand, double* sine, double* cosine, size_t count) {
+    size_t index = 0;
+    if constexpr (isApproximated<FastFunction::sine, accuracy>) {
+#ifdef FAST_MATH_AVX2
+        if (isAvx2Supported) index = approximateSineCosineAvx2Blocks<accuracy>(operand, sine, cosine, count);
+#endif
+#ifdef FAST_MATH_VECTORS
+        for (; index + 2 <= count; index += 2) approximateSineCosineBlock<accuracy, DoublePair>(operand + index, sine + index, cosine + index);
+#endif
+    }
+    for (; index < count; index++) approximateSineCosineScalar<accuracy>(operand[index], sine[index], cosine[index]);
+}
+
+/// @brief Function calling the fallback on every element, used for FastFunction::none and MathAccuracy::library.
+void callFallbackElementwise(UnaryFunction fallback, const double* operand, double* result, size_t count) {
+    for (size_t index = 0; index < count; index++) result[index] = fallback(operand[index]);
+}
+
+/// @brief Approximations of a tier, indexed by FastFunction.
+typedef double (*ScalarApproximation)(UnaryFunction, double);
+typedef void (*ElementwiseApproximation)(UnaryFunction, const double*, double*, size_t);
+template <MathAccuracy accuracy>
+struct ApproximationTable {
+    static constexpr ScalarApproximation scalar[] = {
+        callFallback, approximateScalar<FastFunction::sine, accuracy>, approximateScalar<FastFunction::cosine, accuracy>,
+        approximateScalar<FastFunction::exponential, accuracy>, approximateScalar<FastFunction::naturalLogarithm, accuracy>,
+        approximateScalar<FastFunction::base2Logarithm, accuracy>, approximateScalar<FastFunction::base10Logarithm, accuracy>
+    };
+    static constexpr ElementwiseApproximation elementwise[] = {
+        callFallbackElementwise, approximateElementwise<FastFunction::sine, accuracy>, approximateElementwise<FastFunction::cosine, accuracy>,
+        approximateElementwise<FastFunction::exponential, accuracy>, approximateElementwise<FastFunction::naturalLogarithm, accuracy>,
+        approximateElementwise<FastFunction::base2Logarithm, accuracy>, approximateElementwise<FastFunction::base10Logarithm, accuracy>
+    };
+};
+
+}
+
+FastFunction findFastFunction(const std::string& name) {
+    if (name == "sin") return FastFunction::sine;
+    if (name == "cos") return FastFunction::cosine;
+    if (name == "exp") return FastFunction::exponential;
+    if (name == "ln") return FastFunction::naturalLogarithm;
+    if (name == "log2") return FastFunction::base2Logarithm;
+    if (name == "log") return FastFunction::base10Logarithm;
+    return FastFunction::none;
+}
+
+MathAccuracy findMathAccuracy(const std::string& name) {
+    if (name == "libm") return MathAccuracy::library;
+    if (name == "1ulp") return MathAccuracy::oneUlp;
+    if (name == "4ulp") return MathAccuracy::fourUlps;
+    if (name == "1e-7") return MathAccuracy::approximate;
+    std::string errorMessage = "EvalError: Unknown accuracy " + name;
+    errorMessage += " (expected libm, 1ulp, 4ulp or 1e-7).\n";
+    throw std::invalid_argument(errorMessage);
+}
+
+const char* getMathAccuracyName(MathAccuracy accuracy) {
+    switch (accuracy) {
+        case MathAccuracy::oneUlp: return "1ulp";
+        case MathAccuracy::fourUlps: return "4ulp";
+        case MathAccuracy::approximate: return "1e-7";
+        default: return "libm";
+    }
+}
+
+double evaluateFastFunction(FastFunction function, MathAccuracy accuracy, UnaryFunction fallback, double operand) {
+    switch (accuracy) {
+        case MathAccuracy::oneUlp: return ApproximationTable<MathAccuracy::oneUlp>::scalar[static_cast<size_t>(function)](fallback, operand);
+        case MathAccuracy::fourUlps: return ApproximationTable<MathAccuracy::fourUlps>::scalar[static_cast<size_t>(function)](fallback, operand);
+        case MathAccuracy::approximate: return ApproximationTable<MathAccuracy::approximate>::scalar[static_cast<size_t>(function)](fallback, operand);
+        default: return fallback(operand);
+    }
+}
+
+void applyFastFunctionElementwise(FastFunction function, MathAccuracy accuracy, UnaryFunction fallback, const double* operand, double* result, size_t count) {
+    switch (accuracy) {
+        case MathAccuracy::oneUlp: ApproximationTable<MathAccuracy::oneUlp>::elementwise[static_cast<size_t>(function)](fallback, operand, result, count); return;
+        case MathAccuracy::fourUlps: ApproximationTable<MathAccuracy::fourUlps>::elementwise[static_cast<size_t>(function)](fallback, operand, result, count); return;
+        case MathAccuracy::approximate: ApproximationTable<MathAccuracy::approximate>::elementwise[static_cast<size_t>(function)](fallback, operand, result, count); return;
+        default: callFallbackElementwise(fallback, operand, result, count);
+    }
+}
+
+void evaluateSineCosine(MathAccuracy accuracy, double operand, double& sine, double& cosine) {
+    switch (accuracy) {
+        case MathAccuracy::oneUlp: approximateSineCosineScalar<MathAccuracy::oneUlp>(operand, sine, cosine); return;
+        case MathAccuracy::fourUlps: approximateSineCosineScalar<MathAccuracy::fourUlps>(operand, sine, cosine); return;
+        case MathAccuracy::approximate: approximateSineCosineScalar<MathAccuracy::approximate>(operand, sine, cosine); return;
+        default: computeLibrarySineCosine(operand, sine, cosine);
+    }
+}
+
+void applySineCosineElementwise(MathAccuracy accuracy, const double* operand, double* sine, double* cosine, size_t count) {
+    switch (accuracy) {
+        case MathAccuracy::oneUlp: approximateSineCosineElementwise<MathAccuracy::oneUlp>(operand, sine, cosine, count); return;
+        case MathAccuracy::fourUlps: approximateSineCosineElementwise<MathAccuracy::fourUlps>(operand, sine, cosine, count); return;
+        case MathAccuracy::approximate: approximateSineCosineElementwise<MathAccuracy::approximate>(operand, sine, cosine, count); return;
+        default: for (size_t index = 0; index < count; index++) computeLibrarySineCosine(operand[index], sine[index], cosine[index]);
+    }
+}
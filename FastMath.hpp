@@ -0,0 +1,74 @@
+#ifndef __FAST_MATH
+#define __FAST_MATH
+
+#include "ExpressionCompiler.hpp"
+
+/// Polynomial approximations of sin, cos, exp, ln, log2 and log (base 10) at the accuracy tiers of MathAccuracy, in scalar
+/// and SIMD forms. sin and cos are only approximated by the 1e-7 tier: at the 1 ulp and 4 ulps tiers their polynomials were
+/// slower than the C library, which these tiers call instead. Arguments are first reduced to a small interval around 0: by multiples of pi/2 (three-part Cody-Waite
+/// reduction) for sin and cos, by multiples of ln 2 for exp, and by powers of 2 for the logarithms. On that interval a polynomial
+/// approximates the function. Its coefficients come from Chebyshev economization of the Taylor series. The tiers differ only
+/// in the degree of the polynomials and in a few compensation terms kept by the 1 ulp tier for the logarithms.
+/// Some arguments fall outside the range where the reduction is accurate: nan, inf, |x| > 5e5 for sin and cos, 0 for sin, |x| > 708
+/// for exp, and zero, negative or subnormal operands of the logarithms. These are passed to a fallback function, normally
+/// the function of the lookup table, so domain errors, nan and inf behave exactly like the scalar function. The SIMD forms
+/// run 4 elements at a time with AVX2, 2 otherwise. One operand at a time the polynomials of the 1 ulp and 4 ulps tiers were slower
+/// than the C library, so these tiers only apply to the element-wise forms (block and CSV evaluation) and their scalar forms call
+/// the fallback. The scalar form of the 1e-7 tier runs the same operations as its SIMD forms and returns bit-identical results.
+/// sin and cos of the same operand can also be computed together, sharing the reduction and the polynomials.
+
+/// @brief Functions with polynomial approximations.
+enum class FastFunction : uint8_t { none, sine, cosine, exponential, naturalLogarithm, base2Logarithm, base10Logarithm };
+
+/// @brief Function for finding the approximation of an operator.
+/// @param name Operator name, e.g. "sin" or "ln".
+/// @returns The function, or FastFunction::none if the operator has no approximation.
+FastFunction findFastFunction(const std::string& name);
+
+/// @brief Function for finding an accuracy tier by name.
+/// @param name "libm", "1ulp", "4ulp" or "1e-7".
+/// @returns The tier.
+/// @throws invalid_argument error if the name is not a tier.
+MathAccuracy findMathAccuracy(const std::string& name);
+
+/// @brief Function for naming an accuracy tier, the inverse of findMathAccuracy().
+/// @param accuracy Tier to name.
+/// @returns "libm", "1ulp", "4ulp" or "1e-7".
+const char* getMathAccuracyName(MathAccuracy accuracy);
+
+/// @brief Function for approximating a function at one operand. Only the 1e-7 tier approximates: the other tiers call the fallback.
+/// @param function Function to approximate (FastFunction::none to call the fallback).
+/// @param accuracy Accuracy tier (MathAccuracy::library to call the fallback).
+/// @param fallback Function called for operands outside the range of the approximation.
+/// @param operand Operand.
+/// @returns Approximate value of the function.
+/// @throws invalid_argument error if fallback throws.
+double evaluateFastFunction(FastFunction function, MathAccuracy accuracy, UnaryFunction fallback, double operand);
+
+/// @brief Function for approximating a function element-wise.
+/// @param function Function to approximate (FastFunction::none to call the fallback on every element).
+/// @param accuracy Accuracy tier (MathAccuracy::library to call the fallback on every element).
+/// @param fallback Function called for the elements outside the range of the approximation.
+/// @param operand Pointer to the operand elements.
+/// @param result Pointer to the result elements (may be equal to operand).
+/// @param count Number of elements.
+/// @throws invalid_argument error if fallback throws on an element.
+void applyFastFunctionElementwise(FastFunction function, MathAccuracy accuracy, UnaryFunction fallback, const double* operand, double* result, size_t count);
+
+/// @brief Function for computing sin and cos of one operand together. The results are bit-identical to separate calls to
+/// evaluateFastFunction() at the same tier.
+/// @param accuracy Accuracy tier (MathAccuracy::library for the C library, a single sincos call where it has one).
+/// @param operand Operand.
+/// @param sine Reference receiving sin(operand).
+/// @param cosine Reference receiving cos(operand).
+void evaluateSineCosine(MathAccuracy accuracy, double operand, double& sine, double& cosine);
+
+/// @brief Function for computing sin and cos together element-wise.
+/// @param accuracy Accuracy tier (MathAccuracy::library for the C library).
+/// @param operand Pointer to the operand elements.
+/// @param sine Pointer to the sine elements (may be equal to operand).
+/// @param cosine Pointer to the cosine elements (distinct from sine, may be equal to operand).
+/// @param count Number of elements.
+void applySineCosineElementwise(MathAccuracy accuracy, const double* operand, double* sine, double* cosine, size_t count);
+
+#endif
@@ -0,0 +1,101 @@
+#include "HistoryExporter.hpp"
+
+#include <charconv>
+
+/// @brief Size of the buffer after which the formatted entries are written.
+static constexpr size_t bytesPerWrite = 1 << 20;
+
+/// @brief Function for appending an equation to a CSV line, quoting it if needed.
+/// @param buffer Buffer receiving the field.
+/// @param equation Equation to append.
+static void appendCsvField(std::string& buffer, const std::string& equation) {
+    // Append plain equations as they are.
+    if (equation.find_first_of(",\"\n\r") == std::string::npos) {
+        buffer += equation;
+        return;
+    }
+
+    // Quote the others, doubling the quotes they hold.
+    buffer += '"';
+    for (char character : equation) {
+        if (character == '"') buffer += '"';
+        buffer += character;
+    }
+    buffer += '"';
+}
+
+/// @brief Function for appending an equation to a JSON object as an escaped string.
+/// @param buffer Buffer receiving the string.
+/// @param equation Equation to append.
+static void appendJsonString(std::string& buffer, const std::string& equation) {
+    static const char hexadecimalDigits[] = "0123456789abcdef";
+    buffer += '"';
+    for (char character : equation) {
+        switch (character) {
+            case '"': buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                // Escape the remaining control characters. Other bytes (e.g. UTF-8 sequences) are copied as they are.
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    buffer += "\\u00";
+                    buffer += hexadecimalDigits[static_cast<unsigned char>(character) >> 4];
+                    buffer += hexadecimalDigits[static_cast<unsigned char>(character) & 0xf];
+                } else {
+                    buffer += character;
+                }
+        }
+    }
+    buffer += '"';
+}
+
+/// @brief Function for appending a result using the shortest representation that round-trips.
+/// @param buffer Buffer receiving the number.
+/// @param result Result to append.
+static void appendNumber(std::string& buffer, double result) {
+    char characters[32];
+    buffer.append(characters, std::to_chars(characters, characters + sizeof(characters), result).ptr);
+}
+
+HistoryFormat findHistoryFormat(const std::string& path) {
+    return (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) ? HistoryFormat::json : HistoryFormat::csv;
+}
+
+uint64_t exportHistory(const LinkedList& history, HistoryFormat format, std::ostream& output) {
+    // Collect the entries, which the list holds from the newest to the oldest.
+    std::vector<const Node*> entries;
+    history.forEachNode([&](const Node& node) { entries.push_back(&node); });
+
+    // Format the entries oldest first, writing the buffer whenever it is full.
+    std::string buffer;
+    buffer.reserve(bytesPerWrite + 4096);
+    buffer += (format == HistoryFormat::csv) ? "equation,result\n" : "[";
+    for (auto entry = entries.rbegin(); entry != entries.rend(); entry++) {
+        if (format == HistoryFormat::csv) {
+            appendCsvField(buffer, (*entry)->equation);
+            buffer += ',';
+            appendNumber(buffer, (*entry)->result);
+            buffer += '\n';
+        } else {
+            buffer += (entry == entries.rbegin()) ? "\n  {\"equation\": " : ",\n  {\"equation\": ";
+            appendJsonString(buffer, (*entry)->equation);
+            buffer += ", \"result\": ";
+            if (std::isfinite((*entry)->result)) appendNumber(buffer, (*entry)->result);
+            else buffer += "null";
+            buffer += '}';
+        }
+
+        if (buffer.size() >= bytesPerWrite) {
+            output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+    // Close the array, then write the rest of the buffer and flush once.
+    if (format == HistoryFormat::json) buffer += entries.empty() ? "]\n" : "\n]\n";
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    output.flush();
+    return entries.size();
+}
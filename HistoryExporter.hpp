@@ -0,0 +1,34 @@
+#ifndef __HISTORY_EXPORTER
+#define __HISTORY_EXPORTER
+
+#include "LinkedList.hpp"
+#include <ostream>
+
+/// Functions writing the history of a session to a stream, oldest entry first.
+/// Results use the shortest representation that round-trips (to_chars), so exported values read back exactly.
+/// Entries are formatted into a buffer written in chunks of about 1 MiB, without flushing per line.
+
+/// @brief Formats the history can be exported to.
+enum class HistoryFormat : uint8_t {
+    /// @brief "equation,result" header followed by one line per entry. Equations holding ',', '"' or line breaks
+    /// are quoted, with '"' doubled (RFC 4180). Non-finite results are written as nan, inf or -inf.
+    csv,
+
+    /// @brief Array of {"equation": ..., "result": ...} objects. Equations are escaped, and non-finite results,
+    /// which JSON cannot represent, are written as null.
+    json
+};
+
+/// @brief Function for choosing the format of a file from its extension.
+/// @param path Path of the file.
+/// @returns HistoryFormat::json for ".json" files, HistoryFormat::csv otherwise.
+HistoryFormat findHistoryFormat(const std::string& path);
+
+/// @brief Function for writing the history to a stream.
+/// @param history History to export.
+/// @param format Format of the output.
+/// @param output Stream receiving the history.
+/// @returns Number of entries written.
+uint64_t exportHistory(const LinkedList& history, HistoryFormat format, std::ostream& output);
+
+#endif
@@ -0,0 +1,42 @@
+#include "IncrementalEvaluator.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+IncrementalEvaluator::IncrementalEvaluator(const StreamingEvaluator& evaluator) : checkpoints({evaluator}), state(evaluator) {}
+
+StreamingValue IncrementalEvaluator::update(const std::string& text) {
+    // Find the first character that changed by comparing blocks with memcmp, each 16 times smaller than the previous ones,
+    // then drop the states saved after it.
+    size_t commonLength = std::min(this->text.size(), text.size()), prefixLength = 0;
+    for (size_t blockSize = comparedBlockSize; blockSize > 0; blockSize /= 16) {
+        while (prefixLength + blockSize <= commonLength && std::memcmp(this->text.data() + prefixLength, text.data() + prefixLength, blockSize) == 0) prefixLength += blockSize;
+    }
+    this->checkpoints.erase(this->checkpoints.begin() + std::min(this->checkpoints.size(), prefixLength / checkpointInterval + 1), this->checkpoints.end());
+
+    // Resume from the state of the previous text if the edit is after it, or from the last saved state before the edit.
+    if (!this->isStateValid || this->stateLength > prefixLength) {
+        this->state = this->checkpoints.back();
+        this->stateLength = (this->checkpoints.size() - 1) * checkpointInterval;
+    }
+    this->text = text;
+    this->parsedCharacterCount = text.size() - this->stateLength;
+
+    // Feed the rest of the text up to each checkpoint, saving the state there. A failure leaves the state halfway.
+    this->isStateValid = false;
+    while (this->stateLength < text.size()) {
+        size_t end = std::min(text.size(), (this->stateLength / checkpointInterval + 1) * checkpointInterval);
+        this->state.feed(text.data() + this->stateLength, end - this->stateLength);
+        this->stateLength = end;
+        if (end == this->checkpoints.size() * checkpointInterval) this->checkpoints.push_back(this->state);
+    }
+    this->isStateValid = true;
+
+    // Finish a copy, so the state can still be resumed by the next edit.
+    StreamingEvaluator evaluator = this->state;
+    return evaluator.finish();
+}
+
+size_t IncrementalEvaluator::getParsedCharacterCount() const {
+    return this->parsedCharacterCount;
+}
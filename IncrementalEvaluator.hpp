@@ -0,0 +1,53 @@
+#ifndef __INCREMENTAL_EVALUATOR
+#define __INCREMENTAL_EVALUATOR
+
+#include "StreamingEvaluator.hpp"
+
+/// @brief Class for re-evaluating an expression after every edit, e.g. to preview its value while it is typed.
+/// The parse and evaluation state of a StreamingEvaluator is saved every checkpointInterval characters. An edit keeps the
+/// checkpoints before the first changed character, resumes from the last of them and only feeds the characters after it.
+/// Appending characters (typing at the end) resumes from the state reached after the previous text, so it only parses the new
+/// characters. Edits in the middle parse at most checkpointInterval characters before the edit, plus the rest of the text.
+class IncrementalEvaluator {
+    public:
+        /// @brief Number of characters between two saved states.
+        static constexpr size_t checkpointInterval = 256;
+
+        /// @brief Constructor for the incremental evaluator class.
+        /// @param evaluator Empty evaluator holding the lookup tables, copied into the saved states.
+        explicit IncrementalEvaluator(const StreamingEvaluator& evaluator);
+
+        /// @brief Method for evaluating the new text of the expression, parsing it from the first character that changed since
+        /// the previous call.
+        /// @param text Whole text of the expression.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if the expression is incomplete or cannot be parsed or evaluated.
+        StreamingValue update(const std::string& text);
+
+        /// @brief Method for accessing the number of characters parsed by the last call to update().
+        size_t getParsedCharacterCount() const;
+
+    private:
+        /// @brief Largest number of characters compared at once while looking for the first changed character (a power of 16).
+        static constexpr size_t comparedBlockSize = 4096;
+
+        /// @brief Text of the previous call.
+        std::string text;
+
+        /// @brief States of the evaluator after the first index * checkpointInterval characters of the text.
+        std::vector<StreamingEvaluator> checkpoints;
+
+        /// @brief State of the evaluator after the first stateLength characters of the text.
+        StreamingEvaluator state;
+
+        /// @brief Number of characters fed to state.
+        size_t stateLength = 0;
+
+        /// @brief Whether state can be resumed (feeding the text may have failed halfway).
+        bool isStateValid = true;
+
+        /// @brief Number of characters parsed by the last call to update().
+        size_t parsedCharacterCount = 0;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "IntegerArithmetic.hpp"
+
+#include <array>
+#include <limits>
+#include <charconv>
+
+/// @brief Table holding n! for 0 <= n <= 20.
+static const std::array<int64_t, largestInteger64Factorial + 1> integerFactorialTable = []() {
+    std::array<int64_t, largestInteger64Factorial + 1> table{};
+    table[0] = 1;
+    for (int64_t index = 1; index <= largestInteger64Factorial; index++) table[index] = table[index - 1] * index;
+    return table;
+}();
+
+/// @brief Function for narrowing a 128-bit intermediate result to 64 bits.
+/// @param wideResult Intermediate result.
+/// @param result Reference to the narrowed result.
+/// @return true if the intermediate result fits in 64 bits, false otherwise.
+static bool narrowToInteger64(__int128 wideResult, int64_t& result) {
+    if (wideResult < std::numeric_limits<int64_t>::min() || wideResult > std::numeric_limits<int64_t>::max()) return false;
+    result = static_cast<int64_t>(wideResult);
+    return true;
+}
+
+bool parseInteger64(const std::string& token, int64_t& value) {
+    // Parse the token, and only accept it if every character has been consumed.
+    const char* end = token.data() + token.size();
+    std::from_chars_result parseResult = std::from_chars(token.data(), end, value);
+    return parseResult.ec == std::errc() && parseResult.ptr == end;
+}
+
+bool integerUnaryOperation(const std::string& name, int64_t operand, int64_t& result) {
+    // Negation only overflows for the smallest 64-bit integer.
+    if (name == "neg") return narrowToInteger64(-static_cast<__int128>(operand), result);
+    if (name == "abs") return narrowToInteger64(operand < 0 ? -static_cast<__int128>(operand) : operand, result);
+
+    // Rounding an integer does not change it.
+    if (name == "ceil" || name == "floor" || name == "round") {
+        result = operand;
+        return true;
+    }
+
+    // Look up the factorial if it fits in 64 bits.
+    if (name == "!") {
+        if (operand < 0 || operand > largestInteger64Factorial) return false;
+        result = integerFactorialTable[operand];
+        return true;
+    }
+
+    // All other operators are evaluated in double precision.
+    return false;
+}
+
+bool integerBinaryOperation(const std::string& name, int64_t firstOperand, int64_t secondOperand, int64_t& result) {
+    // Widen the operands so that the intermediate results cannot overflow.
+    __int128 first = firstOperand, second = secondOperand;
+
+    if (name == "+") return narrowToInteger64(first + second, result);
+    if (name == "-") return narrowToInteger64(first - second, result);
+    if (name == "*") return narrowToInteger64(first * second, result);
+
+    // Division is only exact if there is no remainder. The remainder has the sign of the dividend, like fmod.
+    if (name == "/") return second != 0 && first % second == 0 && narrowToInteger64(first / second, result);
+    if (name == "%") return second != 0 && narrowToInteger64(first % second, result);
+
+    if (name == "^") {
+        // Anything raised to 0 is 1, like power(). Negative exponents give fractions.
+        if (second == 0) {
+            result = 1;
+            return true;
+        }
+        if (second < 0) return false;
+
+        // Compute the power by squaring, stopping as soon as an intermediate result leaves the 64-bit range.
+        __int128 wideResult = 1, base = first;
+        for (int64_t exponent = secondOperand; exponent > 0; exponent >>= 1) {
+            if (exponent & 1) {
+                wideResult *= base;
+                if (!narrowToInteger64(wideResult, result)) return false;
+            }
+            if (exponent > 1) {
+                base *= base;
+                if (!narrowToInteger64(base, result)) return false;
+            }
+        }
+        return narrowToInteger64(wideResult, result);
+    }
+
+    // All other operators are evaluated in double precision.
+    return false;
+}
@@ -0,0 +1,34 @@
+#ifndef __INTEGER_ARITHMETIC
+#define __INTEGER_ARITHMETIC
+
+#include <string>
+#include <cstdint>
+
+/// @brief Largest n such that n! fits in a signed 64-bit integer.
+constexpr int64_t largestInteger64Factorial = 20;
+
+/// @brief Function for parsing a token as a signed 64-bit integer.
+/// @param token Number token, e.g. "17".
+/// @param value Reference to the parsed value.
+/// @return true if the whole token is a plain decimal integer that fits in 64 bits, false otherwise (e.g. "1.5", "1e3").
+bool parseInteger64(const std::string& token, int64_t& value);
+
+/// @brief Function for applying a unary operator to an integer exactly.
+/// @param name Operator name ("neg", "!", "abs", "ceil", "floor", "round").
+/// @param operand Input operand.
+/// @param result Reference to the exact result.
+/// @return true if the operator is supported, the operand is inside its domain, and the result fits in 64 bits.
+/// Returns false otherwise, in which case the caller falls back to double precision.
+bool integerUnaryOperation(const std::string& name, int64_t operand, int64_t& result);
+
+/// @brief Function for applying a binary operator to two integers exactly, using 128-bit intermediates.
+/// Exponentiation uses exponentiation by squaring, division only succeeds if it is exact.
+/// @param name Operator name ("+", "-", "*", "/", "%", "^").
+/// @param firstOperand First operand.
+/// @param secondOperand Second operand.
+/// @param result Reference to the exact result.
+/// @return true if the operator is supported, the operands are inside its domain, and the result fits in 64 bits.
+/// Returns false otherwise, in which case the caller falls back to double precision.
+bool integerBinaryOperation(const std::string& name, int64_t firstOperand, int64_t secondOperand, int64_t& result);
+
+#endif
@@ -0,0 +1,217 @@
+#include "IntervalArithmetic.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+/// @brief Largest n such that n! is finite in double precision.
+static constexpr double largestDoubleFactorial = 170;
+
+/// @brief Function for widening an interval by a number of ulps on both sides, to enclose the rounding errors of the functions
+/// computing its bounds. Infinite bounds stay infinite, and nan bounds give the whole line.
+static Interval widen(Interval interval, int ulps) {
+    if (std::isnan(interval.lower) || std::isnan(interval.upper)) return Interval{};
+    for (int step = 0; step < ulps; step++) {
+        interval.lower = std::nextafter(interval.lower, -INFINITY);
+        interval.upper = std::nextafter(interval.upper, INFINITY);
+    }
+    return interval;
+}
+
+/// @brief Function for intersecting an interval with another one. An empty intersection gives the whole line, since the operation
+/// always throws and its result is never used.
+static Interval intersect(Interval interval, double lower, double upper) {
+    Interval result{std::max(interval.lower, lower), std::min(interval.upper, upper)};
+    return (result.lower <= result.upper) ? result : Interval{};
+}
+
+/// @brief Function for applying a non-decreasing function to the bounds of an interval.
+static Interval applyIncreasing(double (*function)(double), Interval operand, int ulps = 2) {
+    return widen({function(operand.lower), function(operand.upper)}, ulps);
+}
+
+/// @brief Function for checking whether an interval may contain offset + k * period for some integer k.
+/// The slack accounts for the rounding of the multiples, so the answer errs towards true.
+static bool containsMultiple(Interval interval, double offset, double period) {
+    if (!std::isfinite(interval.lower) || !std::isfinite(interval.upper) || interval.upper - interval.lower >= period) return true;
+    double slack = 1e-12 * (1 + std::max(std::fabs(interval.lower), std::fabs(interval.upper)));
+    double multiple = offset + std::ceil((interval.lower - slack - offset) / period) * period;
+    return multiple <= interval.upper + slack;
+}
+
+/// @brief Function for computing the interval of sin (phase 0) or cos (phase pi/2), shifting the extrema by the phase.
+static Interval propagatePeriodic(double (*function)(double), Interval operand, double phase) {
+    constexpr double period = 2 * std::numbers::pi;
+    Interval result = widen({std::min(function(operand.lower), function(operand.upper)), std::max(function(operand.lower), function(operand.upper))}, 2);
+    if (containsMultiple(operand, std::numbers::pi / 2 - phase, period)) result.upper = 1;
+    if (containsMultiple(operand, -std::numbers::pi / 2 - phase, period)) result.lower = -1;
+    return intersect(result, -1, 1);
+}
+
+/// @brief Function for computing the interval of 1 / x.
+static Interval reciprocal(Interval operand) {
+    if (operand.lower > 0 || operand.upper < 0) return {1 / operand.upper, 1 / operand.lower};
+    if (operand.lower == 0 && operand.upper > 0) return {1 / operand.upper, INFINITY};
+    if (operand.upper == 0 && operand.lower < 0) return {-INFINITY, 1 / operand.lower};
+    return Interval{};
+}
+
+/// @brief Function for computing the interval of the extrema of a function at the four corners of two intervals.
+/// A nan corner (e.g. inf - inf, 0 * inf) gives the whole line.
+static Interval applyAtCorners(double (*function)(double, double), Interval firstOperand, Interval secondOperand, int ulps) {
+    double corners[] = {function(firstOperand.lower, secondOperand.lower), function(firstOperand.lower, secondOperand.upper),
+        function(firstOperand.upper, secondOperand.lower), function(firstOperand.upper, secondOperand.upper)};
+    if (std::any_of(std::begin(corners), std::end(corners), [](double corner) { return std::isnan(corner); })) return Interval{};
+    return widen({*std::min_element(std::begin(corners), std::end(corners)), *std::max_element(std::begin(corners), std::end(corners))}, ulps);
+}
+
+/// @brief Function for checking whether an interval holds a single integer.
+static bool isIntegerPoint(Interval interval) {
+    return interval.lower == interval.upper && std::isfinite(interval.lower) && interval.lower == std::floor(interval.lower);
+}
+
+Interval propagateUnaryInterval(const std::string& name, Interval operand) {
+    // Sign and rounding operators are exact.
+    if (name == "neg") return {-operand.upper, -operand.lower};
+    if (name == "abs") {
+        if (operand.lower >= 0) return operand;
+        if (operand.upper <= 0) return {-operand.upper, -operand.lower};
+        return {0, std::max(-operand.lower, operand.upper)};
+    }
+    if (name == "ceil") return {std::ceil(operand.lower), std::ceil(operand.upper)};
+    if (name == "floor") return {std::floor(operand.lower), std::floor(operand.upper)};
+    if (name == "round") return {std::round(operand.lower), std::round(operand.upper)};
+
+    // Monotonic functions, restricted to their domain. sqrt is correctly rounded, the rounding of the other library functions is
+    // enclosed by two ulps.
+    if (name == "sqrt") return applyIncreasing(std::sqrt, intersect(operand, 0, INFINITY), 0);
+    if (name == "cbrt") return applyIncreasing(std::cbrt, operand);
+    if (name == "exp") return intersect(applyIncreasing(std::exp, operand), 0, INFINITY);
+    if (name == "ln") return applyIncreasing(std::log, intersect(operand, 0, INFINITY));
+    if (name == "log2") return applyIncreasing(std::log2, intersect(operand, 0, INFINITY));
+    if (name == "log") return applyIncreasing(std::log10, intersect(operand, 0, INFINITY));
+    if (name == "sinh") return applyIncreasing(std::sinh, operand);
+    if (name == "asinh") return applyIncreasing(std::asinh, operand);
+    if (name == "tanh") return intersect(applyIncreasing(std::tanh, operand), -1, 1);
+    if (name == "atan") return intersect(applyIncreasing(std::atan, operand), -std::numbers::pi / 2, std::numbers::pi / 2);
+    if (name == "asin") return applyIncreasing(std::asin, intersect(operand, -1, 1));
+    if (name == "acos") {
+        Interval clamped = intersect(operand, -1, 1);
+        return widen({std::acos(clamped.upper), std::acos(clamped.lower)}, 2);
+    }
+    if (name == "acosh") return intersect(applyIncreasing(std::acosh, intersect(operand, 1, INFINITY)), 0, INFINITY);
+    if (name == "atanh") return applyIncreasing(std::atanh, intersect(operand, -1, 1));
+    if (name == "cosh") {
+        Interval magnitude = propagateUnaryInterval("abs", operand);
+        return intersect(applyIncreasing(std::cosh, magnitude), 1, INFINITY);
+    }
+
+    // Trigonometric functions, whose extrema and poles are found from the multiples of pi/2 the interval contains.
+    if (name == "sin") return propagatePeriodic(std::sin, operand, 0);
+    if (name == "cos") return propagatePeriodic(std::cos, operand, std::numbers::pi / 2);
+    if (name == "tan") return containsMultiple(operand, std::numbers::pi / 2, std::numbers::pi) ? Interval{} : applyIncreasing(std::tan, operand);
+    if (name == "cot") return containsMultiple(operand, 0, std::numbers::pi) ? Interval{} : widen({1 / std::tan(operand.upper), 1 / std::tan(operand.lower)}, 3);
+    if (name == "sec") return reciprocal(propagateUnaryInterval("cos", operand));
+    if (name == "csc" || name == "cosec") return reciprocal(propagateUnaryInterval("sin", operand));
+
+    // The operands of '!' that do not throw are the integers from 0 to 170.
+    if (name == "!") return {1, INFINITY};
+    return Interval{};
+}
+
+Interval propagateBinaryInterval(const std::string& name, Interval firstOperand, Interval secondOperand) {
+    // Arithmetic operators take their extrema at the corners. Rounding to nearest is monotonic, so the rounded results at the
+    // corners enclose the rounded results inside without widening.
+    if (name == "+") return applyAtCorners([](double first, double second) { return first + second; }, firstOperand, secondOperand, 0);
+    if (name == "-") return applyAtCorners([](double first, double second) { return first - second; }, firstOperand, secondOperand, 0);
+    if (name == "*") return applyAtCorners([](double first, double second) { return first * second; }, firstOperand, secondOperand, 0);
+    if (name == "/") {
+        if (secondOperand.lower <= 0 && secondOperand.upper >= 0) return Interval{};
+        return applyAtCorners([](double first, double second) { return first / second; }, firstOperand, secondOperand, 0);
+    }
+
+    // fmod is exact: its result has the sign of the operand, and is smaller than both the operand and the divisor in magnitude.
+    if (name == "%") {
+        double largestDivisor = std::max(std::fabs(secondOperand.lower), std::fabs(secondOperand.upper));
+        return {(firstOperand.lower < 0) ? std::max(firstOperand.lower, -largestDivisor) : 0, (firstOperand.upper > 0) ? std::min(firstOperand.upper, largestDivisor) : 0};
+    }
+
+    // log_b(p) = log2(p) / log2(b), restricted to the domain.
+    if (name == "log_") return propagateBinaryInterval("/", propagateUnaryInterval("log2", secondOperand), propagateUnaryInterval("log2", firstOperand));
+
+    if (name == "^") {
+        // Integer exponents. Even powers only depend on the magnitude, and x^n is monotonic on either side of 0, so away from 0
+        // its extrema are at the bounds. The kernel is pow, whose rounding is enclosed by two ulps like the other library functions.
+        if (isIntegerPoint(secondOperand)) {
+            double exponent = secondOperand.lower;
+            if (exponent == 0) return {1, 1};
+            Interval base = (std::fmod(exponent, 2) == 0) ? propagateUnaryInterval("abs", firstOperand) : firstOperand;
+            if (exponent > 0 || base.lower > 0 || base.upper < 0) {
+                double lower = std::pow(base.lower, exponent), upper = std::pow(base.upper, exponent);
+                return widen({std::min(lower, upper), std::max(lower, upper)}, 2);
+            }
+
+            // Negative exponents of bases around 0 have a pole at 0.
+            return reciprocal(widen({std::pow(base.lower, -exponent), std::pow(base.upper, -exponent)}, 2));
+        }
+
+        // Non-negative bases: x^y = exp(y ln x) is bilinear in y and ln x, so its extrema lie at the corners. Negative bases
+        // with non-integer exponents throw, so the bases that do not throw are the non-negative ones unless the exponent is an integer.
+        if (firstOperand.lower >= 0 || secondOperand.lower == secondOperand.upper) {
+            return applyAtCorners([](double base, double exponent) { return std::pow(base, exponent); }, intersect(firstOperand, 0, INFINITY), secondOperand, 2);
+        }
+        return Interval{};
+    }
+    return Interval{};
+}
+
+Interval propagatePolynomialInterval(const std::vector<double>& coefficients, Interval operand) {
+    // Evaluate the polynomial with Horner's scheme on intervals, and bound the magnitude of its terms.
+    double magnitude = std::max(std::fabs(operand.lower), std::fabs(operand.upper)), termBound = 0, power = 1;
+    Interval result{coefficients.back(), coefficients.back()};
+    for (size_t degree = coefficients.size() - 1; degree > 0; degree--) {
+        result = propagateBinaryInterval("*", result, operand);
+        result = propagateBinaryInterval("+", result, {coefficients[degree - 1], coefficients[degree - 1]});
+    }
+    for (double coefficient : coefficients) {
+        termBound += std::fabs(coefficient) * power;
+        power *= magnitude;
+    }
+
+    // Every scheme rounds each product and sum once, so it is within 2 * degree roundings of the sum of the term magnitudes.
+    double slack = 2.0 * static_cast<double>(coefficients.size()) * std::ldexp(termBound, -52);
+    return widen({result.lower - slack, result.upper + slack}, 1);
+}
+
+bool isUnaryDomainSafe(const std::string& name, Interval operand) {
+    if (name == "sqrt" || name == "ln" || name == "log2" || name == "log") return operand.lower > 0;
+    if (name == "asin" || name == "acos") return operand.lower >= -1 && operand.upper <= 1;
+    if (name == "acosh") return operand.lower >= 1;
+    if (name == "atanh") return operand.lower > -1 && operand.upper < 1;
+    if (name == "tan" || name == "sec") return !containsMultiple(operand, std::numbers::pi / 2, std::numbers::pi);
+    if (name == "cot" || name == "csc" || name == "cosec") return !containsMultiple(operand, 0, std::numbers::pi);
+    if (name == "!") return isIntegerPoint(operand) && operand.lower >= 0 && operand.lower <= largestDoubleFactorial;
+    return true;
+}
+
+bool isBinaryDomainSafe(const std::string& name, Interval firstOperand, Interval secondOperand) {
+    if (name == "/" || name == "%") return secondOperand.lower > 0 || secondOperand.upper < 0;
+    if (name == "log_") return secondOperand.lower > 0 && firstOperand.lower > 0 && (firstOperand.lower > 1 || firstOperand.upper < 1);
+    if (name == "^") return firstOperand.lower >= 0 || isIntegerPoint(secondOperand);
+    return true;
+}
+
+const char* getDomainCondition(const std::string& name) {
+    if (name == "sqrt" || name == "ln" || name == "log2" || name == "log") return "x > 0";
+    if (name == "asin" || name == "acos") return "-1 <= x <= 1";
+    if (name == "acosh") return "x >= 1";
+    if (name == "atanh") return "-1 < x < 1";
+    if (name == "tan" || name == "sec") return "x != pi/2 + k*pi";
+    if (name == "cot" || name == "csc" || name == "cosec") return "x != k*pi";
+    if (name == "!") return "x integer, 0 <= x <= 170";
+    if (name == "/") return "denominator != 0";
+    if (name == "%") return "divisor != 0";
+    if (name == "log_") return "base > 0, base != 1, power > 0";
+    if (name == "^") return "base >= 0 or integer exponent";
+    return nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef __INTERVAL_ARITHMETIC
+#define __INTERVAL_ARITHMETIC
+
+#include <string>
+#include <vector>
+#include <limits>
+
+/// @brief Closed range of doubles, e.g. the values a variable is declared to take ("x in [0.1, 10]").
+/// Intervals enclose every value an expression may take except nan: no checked operator throws on nan (other than '!', which
+/// is never proven safe), so nan operands never decide whether an operation is safe. Bounds may be infinite.
+struct Interval {
+    /// @brief Smallest value.
+    double lower = -std::numeric_limits<double>::infinity();
+
+    /// @brief Largest value.
+    double upper = std::numeric_limits<double>::infinity();
+};
+
+/// @brief Function for computing an interval enclosing the results of a unary operator on an interval.
+/// Bounds are rounded outwards. Operands outside the domain of the operator are left out, since the checked operator throws on them.
+/// @param name Operator name, e.g. "sqrt".
+/// @param operand Interval of the operand.
+/// @returns Interval of the result (the whole line for unknown operators).
+Interval propagateUnaryInterval(const std::string& name, Interval operand);
+
+/// @brief Function for computing an interval enclosing the results of a binary operator on two intervals.
+/// @param name Operator name, e.g. "/".
+/// @param firstOperand Interval of the first operand (the base for "log_" and "^").
+/// @param secondOperand Interval of the second operand.
+/// @returns Interval of the result (the whole line for unknown operators).
+Interval propagateBinaryInterval(const std::string& name, Interval firstOperand, Interval secondOperand);
+
+/// @brief Function for computing an interval enclosing the results of a polynomial instruction (Horner's scheme for rows, Estrin's
+/// scheme for blocks, see OperationCode::polynomial) on an interval, which may differ by a few roundings from the operators it replaces.
+/// @param coefficients Coefficients of the polynomial, lowest degree first.
+/// @param operand Interval of the base.
+/// @returns Interval of the result.
+Interval propagatePolynomialInterval(const std::vector<double>& coefficients, Interval operand);
+
+/// @brief Function for checking whether the checked kernel of a unary operator can never throw on an interval, so that the
+/// unchecked kernel gives the same results. Poles of the trigonometric functions count as outside their domain.
+/// @param name Operator name.
+/// @param operand Interval of the operand.
+/// @returns true if every operand of the interval is inside the domain of the operator.
+bool isUnaryDomainSafe(const std::string& name, Interval operand);
+
+/// @brief Function for checking whether the checked kernel of a binary operator can never throw on two intervals.
+/// @param name Operator name.
+/// @param firstOperand Interval of the first operand.
+/// @param secondOperand Interval of the second operand.
+/// @returns true if every pair of operands of the intervals is inside the domain of the operator.
+bool isBinaryDomainSafe(const std::string& name, Interval firstOperand, Interval secondOperand);
+
+/// @brief Function for describing the domain of an operator whose checked kernel may throw.
+/// @param name Operator name.
+/// @returns The condition on the operands, e.g. "x > 0" for ln, or nullptr if the checked kernel never throws.
+const char* getDomainCondition(const std::string& name);
+
+#endif
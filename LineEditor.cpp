@@ -0,0 +1,215 @@
+#include "LineEditor.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <conio.h>
+#include <io.h>
+#include <cstdio>
+#else
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace {
+
+/// @brief Terminal switched to reading keystrokes without echo, restored when the object is destroyed.
+/// Signals (Ctrl-C) are left enabled.
+class RawMode {
+    public:
+        RawMode() {
+#ifdef _WIN32
+            // Let the console interpret the escape sequences used to redraw the line.
+            HANDLE outputHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+            GetConsoleMode(outputHandle, &this->originalOutputMode);
+            SetConsoleMode(outputHandle, this->originalOutputMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#else
+            tcgetattr(STDIN_FILENO, &this->originalMode);
+            termios rawMode = this->originalMode;
+            rawMode.c_lflag &= ~(ICANON | ECHO);
+            rawMode.c_cc[VMIN] = 1;
+            rawMode.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &rawMode);
+#endif
+        }
+
+        ~RawMode() {
+#ifdef _WIN32
+            SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), this->originalOutputMode);
+#else
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &this->originalMode);
+#endif
+        }
+
+        RawMode(const RawMode&) = delete;
+        RawMode& operator=(const RawMode&) = delete;
+
+    private:
+#ifdef _WIN32
+        /// @brief Mode of the console output before switching.
+        DWORD originalOutputMode = 0;
+#else
+        /// @brief Mode of the terminal before switching.
+        termios originalMode;
+#endif
+};
+
+/// @brief Function for reading one byte of input.
+/// @returns The byte, or -1 at the end of the input.
+int readByte() {
+#ifdef _WIN32
+    return _getch();
+#else
+    unsigned char byte;
+    return (read(STDIN_FILENO, &byte, 1) == 1) ? byte : -1;
+#endif
+}
+
+/// @brief Function for finding the number of columns of the terminal (80 if it cannot be found).
+size_t getTerminalWidth() {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO information;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &information)) return information.srWindow.Right - information.srWindow.Left + 1;
+#else
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) return size.ws_col;
+#endif
+    return 80;
+}
+
+/// @brief Function for redrawing the line, scrolled so that the cursor is visible, followed by as much of the preview as fits.
+/// The last column stays empty, so the terminal never wraps.
+/// @param offset Reference to the index of the first character shown, updated to keep the cursor visible.
+void redraw(const std::string& prompt, const std::string& line, size_t cursor, const std::string& preview, size_t& offset) {
+    size_t width = getTerminalWidth();
+    size_t available = (width > prompt.size() + 21) ? width - 1 - prompt.size() : 20;
+    std::string shownPreview = preview.empty() ? "" : "  " + preview;
+    size_t lineWidth = std::min(line.size() + 1, available - std::min(shownPreview.size(), available / 2));
+
+    // Scroll the line as little as possible.
+    offset = std::min(offset, line.size() + 1 - lineWidth);
+    if (cursor < offset) offset = cursor;
+    if (cursor >= offset + lineWidth) offset = cursor + 1 - lineWidth;
+
+    std::string shownLine = line.substr(offset, lineWidth);
+    std::string output = "\r" + prompt + shownLine + shownPreview.substr(0, available - shownLine.size()) + "\033[K\r";
+    size_t column = prompt.size() + cursor - offset;
+    if (column > 0) output += "\033[" + std::to_string(column) + "C";
+    std::cout << output << std::flush;
+}
+
+}
+
+bool LineEditor::isInteractive() {
+#ifdef _WIN32
+    return _isatty(_fileno(stdin)) && _isatty(_fileno(stdout));
+#else
+    return isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+#endif
+}
+
+LineEditor::Key LineEditor::decodeKey(const ByteSource& readByte, char& character) {
+    int byte = readByte();
+    if (byte < 0) return Key::endOfFile;
+#ifdef _WIN32
+    // Special keys come as 0 or 224 followed by a scan code.
+    if (byte == 0 || byte == 224) {
+        switch (readByte()) {
+            case 75: return Key::left;
+            case 77: return Key::right;
+            case 71: return Key::home;
+            case 79: return Key::end;
+            case 83: return Key::deleteCharacter;
+            default: return Key::ignored;
+        }
+    }
+#else
+    // Special keys come as ESC [ or ESC O, then a letter or a number ending with '~'.
+    if (byte == 27) {
+        int introducer = readByte();
+        if (introducer != '[' && introducer != 'O') return Key::ignored;
+        int code = readByte(), number = 0;
+        while (code >= '0' && code <= '9') {
+            number = number * 10 + (code - '0');
+            code = readByte();
+        }
+        switch (code) {
+            case 'C': return Key::right;
+            case 'D': return Key::left;
+            case 'H': return Key::home;
+            case 'F': return Key::end;
+            case '~': return (number == 1 || number == 7) ? Key::home : (number == 4 || number == 8) ? Key::end : (number == 3) ? Key::deleteCharacter : Key::ignored;
+            default: return Key::ignored;
+        }
+    }
+#endif
+    switch (byte) {
+        case '\r': case '\n': return Key::enter;
+        case 127: case 8: return Key::backspace;
+        case 1: return Key::home;
+        case 4: return Key::endOfTransmission;
+        case 5: return Key::end;
+        case 21: return Key::clear;
+    }
+    if (byte < 32 || byte > 126) return Key::ignored;
+    character = static_cast<char>(byte);
+    return Key::character;
+}
+
+LineEditor::EditResult LineEditor::applyKey(Key key, char character, std::string& line, size_t& cursor) {
+    switch (key) {
+        case Key::character: line.insert(cursor++, 1, character); break;
+        case Key::backspace: if (cursor > 0) line.erase(--cursor, 1); break;
+        case Key::deleteCharacter: if (cursor < line.size()) line.erase(cursor, 1); break;
+        case Key::left: if (cursor > 0) cursor--; break;
+        case Key::right: if (cursor < line.size()) cursor++; break;
+        case Key::home: cursor = 0; break;
+        case Key::end: cursor = line.size(); break;
+        case Key::clear: line.clear(); cursor = 0; break;
+        case Key::ignored: break;
+        case Key::enter: return EditResult::accepted;
+
+        case Key::endOfTransmission:
+            // Ctrl-D ends the input on an empty line, and deletes the character under the cursor otherwise.
+            if (line.empty()) return EditResult::ended;
+            if (cursor < line.size()) line.erase(cursor, 1);
+            break;
+
+        case Key::endOfFile:
+            // No key can follow the end of the input, so the line typed so far is entered, if any.
+            return line.empty() ? EditResult::ended : EditResult::accepted;
+    }
+    return EditResult::editing;
+}
+
+bool LineEditor::readLine(const std::string& prompt, const PreviewFunction& preview, std::string& line) {
+    // Read a whole line from pipes and files, which cannot be edited.
+    line.clear();
+    if (!isInteractive()) {
+        std::cout << prompt;
+        return static_cast<bool>(std::getline(std::cin, line));
+    }
+
+    // Apply keystrokes until Enter, recomputing the preview after every change of the line.
+    RawMode rawMode;
+    size_t cursor = 0, offset = 0;
+    std::string shownPreview = preview(line);
+    redraw(prompt, line, cursor, shownPreview, offset);
+    while (true) {
+        char character = 0;
+        size_t previousLength = line.size();
+        EditResult result = applyKey(decodeKey(readByte, character), character, line, cursor);
+        if (result != EditResult::editing) {
+            std::cout << '\n';
+            return result == EditResult::accepted;
+        }
+        if (line.size() != previousLength) shownPreview = preview(line);
+        redraw(prompt, line, cursor, shownPreview, offset);
+    }
+}
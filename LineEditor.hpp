@@ -0,0 +1,52 @@
+#ifndef __LINE_EDITOR
+#define __LINE_EDITOR
+
+#include <string>
+#include <cstdint>
+#include <functional>
+
+/// @brief Class for reading a line from the terminal one keystroke at a time, showing a preview computed from the line after
+/// every edit (e.g. the value of the expression being typed). Lines longer than the terminal scroll horizontally around the cursor.
+/// Supports the arrow keys, Home / End (also Ctrl-A / Ctrl-E), Backspace, Delete and Ctrl-U (clear the line).
+/// Uses raw mode through termios on POSIX systems and the console API on Windows.
+class LineEditor {
+    public:
+        /// @brief Function computing the preview of a line.
+        typedef std::function<std::string(const std::string&)> PreviewFunction;
+
+        /// @brief Function reading one byte of input, returning -1 at the end of the input.
+        typedef std::function<int()> ByteSource;
+
+        /// @brief Keys understood by the editor. endOfTransmission is Ctrl-D, while endOfFile means the input has been closed.
+        enum class Key : uint8_t { character, enter, backspace, deleteCharacter, left, right, home, end, clear, endOfTransmission, endOfFile, ignored };
+
+        /// @brief Results of applying a key to the line.
+        enum class EditResult : uint8_t { editing, accepted, ended };
+
+        /// @brief Function for checking whether the standard input and output are terminals, i.e. whether lines can be edited.
+        static bool isInteractive();
+
+        /// @brief Function for reading a line. Falls back to reading a whole line without preview if isInteractive() is false.
+        /// @param prompt Text shown before the line.
+        /// @param preview Function computing the preview shown after the line.
+        /// @param line Reference receiving the line.
+        /// @returns false if the input ended (Ctrl-D on an empty line, or end of file) before a line was entered.
+        static bool readLine(const std::string& prompt, const PreviewFunction& preview, std::string& line);
+
+        /// @brief Function for reading a keystroke, decoding the escape sequences of the special keys.
+        /// @param readByte Function reading the bytes of the keystroke.
+        /// @param character Reference receiving the character typed, for Key::character.
+        /// @returns The key, Key::endOfFile if the input ended before the keystroke.
+        static Key decodeKey(const ByteSource& readByte, char& character);
+
+        /// @brief Function for applying a key to the line being edited.
+        /// @param key Key pressed.
+        /// @param character Character typed, for Key::character.
+        /// @param line Reference to the line.
+        /// @param cursor Reference to the index of the cursor in the line.
+        /// @returns EditResult::accepted on Enter, or at the end of the input after a non-empty line (like std::getline),
+        /// EditResult::ended on Ctrl-D or at the end of the input with an empty line, EditResult::editing otherwise.
+        static EditResult applyKey(Key key, char character, std::string& line, size_t& cursor);
+};
+
+#endif
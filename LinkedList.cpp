@@ -90,6 +90,13 @@ void LinkedList::traverseLinkedList() {
     std::cout << '\n' << std::endl;
 }
 
+void LinkedList::forEachNode(const std::function<void(const Node&)>& visitor) const {
+    // Iterate over the linked list, skipping the empty nodes kept while the list holds less than two logs.
+    for (const Node* node = this->headNode; node != nullptr; node = node->nextNodePtr) {
+        if (!node->equation.empty()) visitor(*node);
+    }
+}
+
 void LinkedList::deleteTailNode() {
     // Initialize a temporary node pointer to traverse the list.
     Node* tempNodePointer = this->headNode;
@@ -53,6 +53,10 @@ class LinkedList{
         /// @returns a pointer to the currently accessed node. 
         void traverseLinkedList();
 
+        /// @brief Method for visiting the nodes holding a log, from the newest to the oldest.
+        /// @param visitor Function called with every node.
+        void forEachNode(const std::function<void(const Node&)>& visitor) const;
+
         /// @brief Method for deleting the last node on the list. 
         void deleteTailNode();
 
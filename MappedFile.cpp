@@ -0,0 +1,93 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/// @brief Function for building the error thrown when a file cannot be mapped.
+static std::invalid_argument makeFileError(const std::string& path) {
+    std::string errorMessage = "FileError: Failed to open " + path;
+    errorMessage += ".\n";
+    return std::invalid_argument(errorMessage);
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    // Open the file and get its size.
+    HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) throw makeFileError(path);
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        throw makeFileError(path);
+    }
+    this->size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Empty files cannot be mapped, and have nothing to read anyway.
+    if (this->size == 0) {
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    // Map the whole file. The mapping object keeps the file open, so the file handle can be closed right away.
+    this->mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fileHandle);
+    if (this->mappingHandle == nullptr) throw makeFileError(path);
+    this->data = static_cast<const char*>(MapViewOfFile(this->mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (this->data == nullptr) {
+        CloseHandle(this->mappingHandle);
+        throw makeFileError(path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (this->data != nullptr) UnmapViewOfFile(this->data);
+    if (this->mappingHandle != nullptr) CloseHandle(this->mappingHandle);
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    // Open the file and get its size.
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) throw makeFileError(path);
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode)) {
+        close(fileDescriptor);
+        throw makeFileError(path);
+    }
+    this->size = static_cast<size_t>(fileStatus.st_size);
+
+    // Empty files cannot be mapped, and have nothing to read anyway.
+    if (this->size == 0) {
+        close(fileDescriptor);
+        return;
+    }
+
+    // Map the whole file. The mapping keeps the file open, so the descriptor can be closed right away.
+    void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    if (mapping == MAP_FAILED) throw makeFileError(path);
+    madvise(mapping, this->size, MADV_SEQUENTIAL);
+    this->data = static_cast<const char*>(mapping);
+}
+
+MappedFile::~MappedFile() {
+    if (this->data != nullptr) munmap(const_cast<char*>(this->data), this->size);
+}
+#endif
+
+const char* MappedFile::getData() const {
+    return this->data;
+}
+
+size_t MappedFile::getSize() const {
+    return this->size;
+}
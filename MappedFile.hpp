@@ -0,0 +1,43 @@
+#ifndef __MAPPED_FILE
+#define __MAPPED_FILE
+
+#include <string>
+#include <cstddef>
+
+/// @brief Read-only memory map of a whole file, released when the object is destroyed.
+/// Pages are read on demand by the operating system, so files larger than the memory can be scanned,
+/// and the kernel is told the file is read sequentially (POSIX) to read ahead aggressively.
+/// Uses mmap on POSIX systems and CreateFileMapping / MapViewOfFile on Windows.
+class MappedFile {
+    public:
+        /// @brief Constructor for the mapped file class.
+        /// @param path Path of the file.
+        /// @throws invalid_argument error if the file cannot be opened or mapped.
+        explicit MappedFile(const std::string& path);
+
+        /// @brief Destructor for the mapped file class. Unmaps the file.
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// @brief Method for accessing the characters of the file (nullptr for empty files).
+        const char* getData() const;
+
+        /// @brief Method for accessing the size of the file in bytes.
+        size_t getSize() const;
+
+    private:
+        /// @brief First character of the mapping.
+        const char* data = nullptr;
+
+        /// @brief Size of the file in bytes.
+        size_t size = 0;
+
+#ifdef _WIN32
+        /// @brief Handle of the mapping object, kept open while the view is mapped.
+        void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include "NumericalIntegrator.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+/// @brief Kronrod nodes on [-1, 1] (positive half, the last one is the center). Odd indices are the Gauss nodes.
+static constexpr double kronrodNodes[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851, 0.864864423359769072789712788640926,
+    0.741531185599394439863864773280788, 0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.0
+};
+
+/// @brief Weights of the 15-point Kronrod rule, matching kronrodNodes.
+static constexpr double kronrodWeights[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204, 0.104790010322250183839876322541518,
+    0.140653259715525918745189590510238, 0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+
+/// @brief Weights of the 7-point Gauss rule, matching kronrodNodes[1], [3], [5] and [7].
+static constexpr double gaussWeights[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780, 0.381830050505118944950369775488975,
+    0.417959183673469387755102040816327
+};
+
+NumericalIntegrator::NumericalIntegrator(const CompiledExpression& program, WorkStealingThreadPool& pool) : program(program), pool(pool) {
+    // Check if the program is a function of exactly one variable.
+    if (program.getVariableNames().size() != 1) throw std::invalid_argument("EvalError: Integrals require an expression of exactly one variable.\n");
+}
+
+void NumericalIntegrator::evaluateIntervals(std::vector<Interval>& intervals) const {
+    size_t blockCount = (intervals.size() + intervalsPerBlock - 1) / intervalsPerBlock;
+    this->pool.parallelFor(0, blockCount, 1, [&](size_t begin, size_t end) {
+        // Allocate the buffers once per task: the nodes of every subinterval of a block, and their values.
+        std::vector<double> nodes(intervalsPerBlock * nodesPerInterval), values(nodes.size());
+        std::vector<double> registers(this->program.getRegisterCount() * nodes.size());
+        for (size_t block = begin; block < end; block++) {
+            size_t firstInterval = block * intervalsPerBlock, intervalCount = std::min(intervalsPerBlock, intervals.size() - firstInterval);
+
+            // Lay out the nodes of each subinterval: the center, then the pairs symmetric around it.
+            for (size_t index = 0; index < intervalCount; index++) {
+                const Interval& interval = intervals[firstInterval + index];
+                double center = 0.5 * (interval.lower + interval.upper), halfLength = 0.5 * (interval.upper - interval.lower);
+                double* intervalNodes = &nodes[index * nodesPerInterval];
+                intervalNodes[0] = center;
+                for (size_t node = 0; node < 7; node++) {
+                    intervalNodes[1 + 2 * node] = center - halfLength * kronrodNodes[node];
+                    intervalNodes[2 + 2 * node] = center + halfLength * kronrodNodes[node];
+                }
+            }
+
+            // Evaluate the integrand at every node of the block at once.
+            const double* columns[1] = {nodes.data()};
+            size_t nodeCount = intervalCount * nodesPerInterval;
+            this->program.evaluateBlock(columns, nodeCount, registers.data(), values.data());
+            for (size_t node = 0; node < nodeCount; node++) {
+                if (!std::isfinite(values[node])) {
+                    std::stringstream errorStream;
+                    errorStream << std::setprecision(17) << "EvalError: The integrand is " << values[node] << " at " << nodes[node] << ".\n";
+                    throw std::invalid_argument(errorStream.str());
+                }
+            }
+
+            // Combine the values into the Kronrod and Gauss estimates, and the error estimate of QUADPACK.
+            for (size_t index = 0; index < intervalCount; index++) {
+                Interval& interval = intervals[firstInterval + index];
+                const double* intervalValues = &values[index * nodesPerInterval];
+                double centerValue = intervalValues[0];
+                double kronrod = kronrodWeights[7] * centerValue, gauss = gaussWeights[3] * centerValue, absoluteKronrod = kronrodWeights[7] * std::fabs(centerValue);
+                for (size_t node = 0; node < 7; node++) {
+                    double left = intervalValues[1 + 2 * node], right = intervalValues[2 + 2 * node];
+                    kronrod += kronrodWeights[node] * (left + right);
+                    absoluteKronrod += kronrodWeights[node] * (std::fabs(left) + std::fabs(right));
+                    if (node % 2 == 1) gauss += gaussWeights[node / 2] * (left + right);
+                }
+
+                // Measure how far the integrand strays from its mean, which scales the raw |Kronrod - Gauss| difference.
+                double mean = 0.5 * kronrod, deviation = kronrodWeights[7] * std::fabs(centerValue - mean);
+                for (size_t node = 0; node < 7; node++) {
+                    deviation += kronrodWeights[node] * (std::fabs(intervalValues[1 + 2 * node] - mean) + std::fabs(intervalValues[2 + 2 * node] - mean));
+                }
+                double halfLength = 0.5 * (interval.upper - interval.lower);
+                interval.value = kronrod * halfLength;
+                interval.absoluteValue = absoluteKronrod * std::fabs(halfLength);
+                deviation *= std::fabs(halfLength);
+                double error = std::fabs((kronrod - gauss) * halfLength);
+                if (deviation != 0 && error != 0) error = deviation * std::min(1.0, std::pow(200 * error / deviation, 1.5));
+                if (interval.absoluteValue > DBL_MIN / (50 * DBL_EPSILON)) error = std::max(50 * DBL_EPSILON * interval.absoluteValue, error);
+                interval.error = error;
+            }
+        }
+    });
+}
+
+IntegrationResult NumericalIntegrator::integrate(double lower, double upper, double relativeTolerance, uint64_t maximumEvaluations) const {
+    // Check the limits, then estimate the integral over the whole range.
+    if (!std::isfinite(lower) || !std::isfinite(upper)) throw std::invalid_argument("EvalError: Limits of integration must be finite.\n");
+    IntegrationResult result = {0, 0, nodesPerInterval, 1, true};
+    if (lower == upper) {
+        result.evaluationCount = 0;
+        return result;
+    }
+    std::vector<Interval> intervals = {{lower, upper, 0, 0, 0}}, finishedIntervals;
+    this->evaluateIntervals(intervals);
+
+    // Subintervals too narrow to be bisected are set aside in finishedIntervals.
+    while (true) {
+        // Sum the estimates over every subinterval, with compensated summation.
+        double value = 0, valueCompensation = 0, error = 0, absoluteValue = 0;
+        for (const std::vector<Interval>* group : {&intervals, &finishedIntervals}) {
+            for (const Interval& interval : *group) {
+                double newValue = value + interval.value;
+                valueCompensation += (std::fabs(value) >= std::fabs(interval.value)) ? (value - newValue) + interval.value : (interval.value - newValue) + value;
+                value = newValue;
+                error += interval.error;
+                absoluteValue += interval.absoluteValue;
+            }
+        }
+        result.value = value + valueCompensation;
+        result.errorEstimate = error;
+        result.intervalCount = intervals.size() + finishedIntervals.size();
+
+        // Stop once the error fits the tolerance, or when nothing can be bisected or the budget does not allow another round.
+        double tolerance = relativeTolerance * absoluteValue;
+        result.isConverged = error <= tolerance;
+        if (result.isConverged || intervals.empty() || result.evaluationCount + 2 * nodesPerInterval > maximumEvaluations) return result;
+
+        // Bisect the worst subintervals until the error of the others fits the tolerance.
+        std::sort(intervals.begin(), intervals.end(), [](const Interval& first, const Interval& second) { return first.error > second.error; });
+        size_t roundCount = std::min<uint64_t>({maximumIntervalsPerRound, (maximumEvaluations - result.evaluationCount) / (2 * nodesPerInterval), intervals.size()});
+        size_t bisectedCount = 0;
+        double remainingError = error;
+        std::vector<Interval> halves;
+        while (bisectedCount < roundCount && remainingError > tolerance) {
+            const Interval& interval = intervals[bisectedCount++];
+            remainingError -= interval.error;
+            double middle = 0.5 * (interval.lower + interval.upper);
+            if (std::fabs(interval.upper - interval.lower) <= 4 * DBL_EPSILON * std::fabs(middle) || middle == interval.lower || middle == interval.upper) {
+                finishedIntervals.push_back(interval);
+                continue;
+            }
+            halves.push_back({interval.lower, middle, 0, 0, 0});
+            halves.push_back({middle, interval.upper, 0, 0, 0});
+        }
+        this->evaluateIntervals(halves);
+        result.evaluationCount += halves.size() * nodesPerInterval;
+
+        // Replace the bisected subintervals with their halves.
+        intervals.erase(intervals.begin(), intervals.begin() + bisectedCount);
+        intervals.insert(intervals.end(), halves.begin(), halves.end());
+    }
+}
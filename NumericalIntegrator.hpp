@@ -0,0 +1,83 @@
+#ifndef __NUMERICAL_INTEGRATOR
+#define __NUMERICAL_INTEGRATOR
+
+#include "ExpressionCompiler.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief Result of a numerical integration.
+struct IntegrationResult {
+    /// @brief Estimated value of the integral.
+    double value;
+
+    /// @brief Estimated absolute error of the value.
+    double errorEstimate;
+
+    /// @brief Number of evaluations of the integrand.
+    uint64_t evaluationCount;
+
+    /// @brief Number of subintervals the range has been split into.
+    uint64_t intervalCount;
+
+    /// @brief Whether the requested tolerance has been reached before the evaluation budget ran out.
+    bool isConverged;
+};
+
+/// @brief Class for integrating a compiled expression of one variable over a finite range with globally adaptive
+/// Gauss-Kronrod quadrature (7-point Gauss, 15-point Kronrod rule, with the error estimate of QUADPACK).
+/// Every round bisects the subintervals with the largest error estimates, just enough of them for the others to fit the
+/// tolerance. The 15 nodes of all the new subintervals are evaluated together with CompiledExpression::evaluateBlock() (SIMD),
+/// split into blocks spread over the thread pool. Nodes never include the ends of the range, so integrable singularities
+/// there (e.g. 1/sqrt(x) on 0..1) are handled, if slowly.
+class NumericalIntegrator {
+    public:
+        /// @brief Constructor for the numerical integrator class.
+        /// @param program Compiled expression of exactly one variable (preferably unchecked, see integrate()).
+        /// @param pool Thread pool evaluating the subintervals.
+        /// @throws invalid_argument error if the program does not have exactly one variable.
+        NumericalIntegrator(const CompiledExpression& program, WorkStealingThreadPool& pool = WorkStealingThreadPool::getSharedPool());
+
+        /// @brief Method for integrating the program from lower to upper.
+        /// @param lower Lower limit of integration.
+        /// @param upper Upper limit of integration (may be smaller than lower, which negates the integral).
+        /// @param relativeTolerance Requested error, relative to the integral of the absolute value of the integrand
+        /// (so integrals which cancel to 0 converge too).
+        /// @param maximumEvaluations Budget of evaluations of the integrand, after which the best estimate is returned unconverged.
+        /// @returns The integral, its error estimate and the work spent.
+        /// @throws invalid_argument error if a limit is not finite, or the integrand is nan or inf at a node.
+        IntegrationResult integrate(double lower, double upper, double relativeTolerance = 1e-10, uint64_t maximumEvaluations = 1 << 20) const;
+
+    private:
+        /// @brief Number of nodes of the Kronrod rule.
+        static constexpr size_t nodesPerInterval = 15;
+
+        /// @brief Number of subintervals evaluated by a single task.
+        static constexpr size_t intervalsPerBlock = 64;
+
+        /// @brief Largest number of subintervals bisected in one round.
+        static constexpr size_t maximumIntervalsPerRound = 1024;
+
+        /// @brief Subinterval with the Kronrod estimate of its integral.
+        struct Interval {
+            /// @brief Limits of the subinterval.
+            double lower, upper;
+
+            /// @brief Kronrod estimate of the integral and its error estimate.
+            double value, error;
+
+            /// @brief Integral of the absolute value of the integrand (Kronrod estimate).
+            double absoluteValue;
+        };
+
+        /// @brief Program integrated.
+        const CompiledExpression& program;
+
+        /// @brief Thread pool evaluating the subintervals.
+        WorkStealingThreadPool& pool;
+
+        /// @brief Private method for applying the Gauss-Kronrod rule to subintervals, filling their estimates.
+        /// @param intervals Subintervals whose lower and upper limits are set.
+        /// @throws invalid_argument error if the integrand is nan or inf at a node.
+        void evaluateIntervals(std::vector<Interval>& intervals) const;
+};
+
+#endif
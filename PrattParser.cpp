@@ -0,0 +1,375 @@
+#include "PrattParser.hpp"
+#include "CharacterClassifier.hpp"
+#include "DoubleDouble.hpp"
+
+#include <charconv>
+#include <numbers>
+#include <stdexcept>
+#include <algorithm>
+
+PrattParser::PrattParser(
+    const std::unordered_map<std::string, int>& functionLookupTable,
+    const std::unordered_map<std::string, int>& operatorPrecedenceLookupTable,
+    const UserFunctionTable& userFunctionLookupTable
+) : functionLookupTable(functionLookupTable), operatorPrecedenceLookupTable(operatorPrecedenceLookupTable), userFunctionLookupTable(userFunctionLookupTable) {}
+
+std::vector<PostfixInstruction> PrattParser::parse(const std::string& expression, const std::vector<std::string>& variableNames, const std::string& functionBeingDefined, EvaluationBudget* budget) {
+    // Initialize the state of the parser. Tokens take two characters on average (e.g. "x*2+" or "sin("), so reserve one
+    // instruction per two characters instead of growing the bytecode of long expressions many times.
+    std::vector<PostfixInstruction> postfixProgram;
+    postfixProgram.reserve(expression.size() / 2 + 1);
+    this->input = expression.data();
+    this->length = expression.size();
+    this->index = 0;
+    this->variableNames = &variableNames;
+    this->functionBeingDefined = &functionBeingDefined;
+    this->output = &postfixProgram;
+    this->budget = budget;
+    this->openParenthesisCount = this->nestingDepth = 0;
+
+    // Handle no token expression.
+    if (!this->skipWhitespaceAndCheckMore()) throw std::invalid_argument("ParseError: Found 0 tokens to parse.\n");
+
+    // Parse the whole expression, which must consume every character.
+    this->parseExpression(0);
+    if (this->skipWhitespaceAndCheckMore()) {
+        if (this->input[this->index] == ')') throw std::invalid_argument("MathError: Failed to find parenthesis pair.\n");
+        throw this->makeUnexpectedCharacterError();
+    }
+    return postfixProgram;
+}
+
+void PrattParser::parseExpression(int minimumPrecedence) {
+    // Reject expressions nested deep enough to exhaust the stack.
+    if (++this->nestingDepth > maximumNestingDepth) {
+        throw std::invalid_argument("ParseError: Found expression nested deeper than " + std::to_string(maximumNestingDepth) + " levels.\n");
+    }
+
+    this->parseOperand();
+    this->parseOperators(minimumPrecedence);
+    this->nestingDepth--;
+}
+
+void PrattParser::parseOperand() {
+    // Poll the budget, so parsing a huge expression can be stopped as well.
+    if (this->budget != nullptr) this->budget->poll();
+
+    // Handle a missing operand, e.g. "(" or "-" at the end of the input.
+    if (!this->skipWhitespaceAndCheckMore()) {
+        if (this->openParenthesisCount > 0) {
+            std::string errorMessage = "MathError: Found mismatched brackets (found " + std::to_string(this->openParenthesisCount);
+            errorMessage += " unmatched left bracket(s)).\n";
+            throw std::invalid_argument(errorMessage);
+        }
+        throw std::invalid_argument("EvalError: Found excess operator(s).\n");
+    }
+
+    char character = this->input[this->index];
+    switch (character) {
+        case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': case '.':
+            this->parseNumber();
+            break;
+
+        case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+        case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
+            this->parseName();
+            break;
+
+        case '-':
+            // A '-' in front of an operand is a negative sign, binding tighter than every binary operator.
+            this->index++;
+            this->parseExpression(this->operatorPrecedenceLookupTable.at("neg") + 1);
+            this->emitOperator(PostfixOperationCode::applyUnaryOperator, "neg");
+            break;
+
+        case '(':
+            // Parse the parenthesized expression from the lowest precedence.
+            this->index++;
+            this->openParenthesisCount++;
+            this->parseExpression(0);
+            this->expectClosingParenthesis();
+            break;
+
+        case '[':
+            this->parseVectorLiteral();
+            break;
+
+        case '+': case '*': case '/': case '%': case '^': case '!': case ')': case ']': {
+            // Handle an operator found where an operand is expected.
+            std::string errorMessage = "EvalError: Found excess operator(s) (found ";
+            errorMessage += character;
+            errorMessage += ").\n";
+            throw std::invalid_argument(errorMessage);
+        }
+
+        default:
+            throw this->makeUnexpectedCharacterError();
+    }
+}
+
+void PrattParser::parseOperators(int minimumPrecedence) {
+    while (this->skipWhitespaceAndCheckMore()) {
+        // Stop at anything that is not an infix or postfix operator, e.g. ')' or ','.
+        char character = this->input[this->index];
+        if (character != '+' && character != '-' && character != '*' && character != '/' && character != '%' && character != '^' && character != '!') return;
+
+        // Stop at operators binding looser than the operator the operand belongs to.
+        std::string name(1, character);
+        int precedence = this->operatorPrecedenceLookupTable.at(name);
+        if (precedence < minimumPrecedence) return;
+        this->index++;
+
+        // Apply the postfix factorial right away.
+        if (character == '!') {
+            this->emitOperator(PostfixOperationCode::applyUnaryOperator, name);
+            continue;
+        }
+
+        // Parse the second operand along with the operators binding tighter, so that equal precedences associate to the left.
+        if (!this->skipWhitespaceAndCheckMore()) throw std::invalid_argument("EvalError: Failed to find second argument for " + name + ".\n");
+        this->parseExpression(precedence + 1);
+        this->emitOperator(PostfixOperationCode::applyBinaryOperator, name);
+    }
+}
+
+void PrattParser::parseName() {
+    // Parse all non-single character operator and variable names.
+    size_t start = this->index;
+    this->index = skipLowercaseLetters(this->input, this->index, this->length);
+    std::string name(this->input + start, this->index - start);
+
+    // Handle case if token is "log2" or "log_".
+    if (name == "log" && this->index < this->length && (this->input[this->index] == '_' || this->input[this->index] == '2')) name += this->input[this->index++];
+
+    // Handle case where the name is a variable of the expression (or a parameter of the function being defined).
+    auto variable = std::find(this->variableNames->begin(), this->variableNames->end(), name);
+    if (variable != this->variableNames->end()) {
+        PostfixInstruction instruction;
+        instruction.operationCode = PostfixOperationCode::pushVariable;
+        instruction.variableSlot = static_cast<uint32_t>(variable - this->variableNames->begin());
+        this->output->push_back(instruction);
+        return;
+    }
+
+    // Reject calls of the function being defined, which would make it recursive.
+    if (name == *this->functionBeingDefined) {
+        std::string errorMessage = "DefinitionError: Recursive call to " + name;
+        errorMessage += " inside its own definition.\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Handle calls of user functions.
+    auto userFunction = this->userFunctionLookupTable.find(name);
+    if (userFunction != this->userFunctionLookupTable.end()) {
+        this->parseUserFunctionCall(*userFunction->second);
+        return;
+    }
+
+    // Throw invalid_argument error if the name is not a valid token.
+    auto function = this->functionLookupTable.find(name);
+    if (function == this->functionLookupTable.end()) {
+        std::string errorMessage = "MathError: Unrecognized token " + name;
+        errorMessage += " at index " + std::to_string(start) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    PostfixInstruction instruction;
+    instruction.operationCode = PostfixOperationCode::pushNumber;
+    switch (function->second) {
+        // Push the special constants (e, pi, phi) as numbers.
+        case 272:
+            instruction.number = std::numbers::e;
+            instruction.numberLow = doubleDoubleE.low;
+            this->output->push_back(instruction);
+            break;
+        case 314:
+            instruction.number = std::numbers::pi;
+            instruction.numberLow = doubleDoublePi.low;
+            this->output->push_back(instruction);
+            break;
+        case 1618:
+            instruction.number = std::numbers::phi;
+            instruction.numberLow = doubleDoublePhi.low;
+            this->output->push_back(instruction);
+            break;
+
+        case 2:
+            // "log_" takes the base, then the argument, e.g. "log_2(8)".
+            this->parseExpression(this->operatorPrecedenceLookupTable.at(name) + 1);
+            this->parseExpression(this->operatorPrecedenceLookupTable.at(name) + 1);
+            this->emitOperator(PostfixOperationCode::applyBinaryOperator, name);
+            break;
+
+        default:
+            // Functions are applied to the parenthesized expression following them, along with the operators binding tighter.
+            this->expectOpeningParenthesis(name);
+            this->parseExpression(this->operatorPrecedenceLookupTable.at(name) + 1);
+            this->emitOperator(PostfixOperationCode::applyUnaryOperator, name);
+            break;
+    }
+}
+
+void PrattParser::parseUserFunctionCall(const UserFunction& function) {
+    // Parse the comma separated arguments.
+    this->expectOpeningParenthesis(function.name);
+    this->index++;
+    this->openParenthesisCount++;
+    size_t argumentCount = 0;
+    while (true) {
+        this->parseExpression(0);
+        argumentCount++;
+        if (!this->skipWhitespaceAndCheckMore() || this->input[this->index] != ',') break;
+        this->index++;
+    }
+    this->expectClosingParenthesis();
+
+    // Check if the function has been given the right number of arguments.
+    if (argumentCount != function.parameterNames.size()) {
+        std::string errorMessage = "ParseError: " + function.name + " expects ";
+        errorMessage += std::to_string(function.parameterNames.size()) + " argument(s), got ";
+        errorMessage += std::to_string(argumentCount) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Apply the operators binding tighter than the call to the last argument, like for the built-in functions.
+    this->parseOperators(userFunctionPrecedence + 1);
+
+    PostfixInstruction instruction;
+    instruction.operationCode = PostfixOperationCode::callUserFunction;
+    instruction.name = function.name;
+    instruction.userFunction = &function;
+    this->output->push_back(instruction);
+}
+
+void PrattParser::parseVectorLiteral() {
+    // Handle empty vectors, which have no element to broadcast.
+    size_t start = this->index++;
+    if (this->skipWhitespaceAndCheckMore() && this->input[this->index] == ']') throw std::invalid_argument("ParseError: Found empty vector literal at index " + std::to_string(start) + ".\n");
+
+    // Parse the comma separated elements.
+    uint32_t elementCount = 0;
+    while (true) {
+        this->parseExpression(0);
+        elementCount++;
+        if (!this->skipWhitespaceAndCheckMore() || this->input[this->index] != ',') break;
+        this->index++;
+    }
+
+    // Handle a missing ']', e.g. "[1, 2" or "[1 2]".
+    if (!this->skipWhitespaceAndCheckMore()) throw std::invalid_argument("ParseError: Failed to find ']' closing the vector literal at index " + std::to_string(start) + ".\n");
+    if (this->input[this->index] != ']') throw this->makeUnexpectedCharacterError();
+    this->index++;
+
+    PostfixInstruction instruction;
+    instruction.operationCode = PostfixOperationCode::buildVector;
+    instruction.elementCount = elementCount;
+    this->output->push_back(instruction);
+}
+
+void PrattParser::parseNumber() {
+    // Set a checkpoint at the starting index.
+    size_t start = this->index, end = start;
+
+    // Build the error thrown for malformed numbers.
+    auto makeError = [&](const char* reason) {
+        std::string errorMessage = "MathError: Failed to parse number at index " + std::to_string(start);
+        errorMessage += " (found ";
+        errorMessage += reason;
+        errorMessage += ").\n";
+        return std::invalid_argument(errorMessage);
+    };
+
+    // Get the first decimal digits, then the floating point and the digits following it.
+    end = skipDigits(this->input, end, this->length);
+    if (end < this->length && this->input[end] == '.') {
+        end++;
+        if (end >= this->length || static_cast<unsigned char>(this->input[end] - '0') > 9) throw makeError("floating point without proceeding digit(s)");
+        end = skipDigits(this->input, end, this->length);
+        if (end < this->length && this->input[end] == '.') throw makeError("extra floating point");
+    }
+
+    // Handle case where the number has an exponent.
+    if (end < this->length && this->input[end] == 'e') {
+        end++;
+        if (end >= this->length || !(static_cast<unsigned char>(this->input[end] - '0') <= 9 || this->input[end] == '-' || this->input[end] == '+')) {
+            throw makeError("exponent symbol without proceeding digit(s)");
+        }
+        if (this->input[end] == '-' || this->input[end] == '+') end++;
+        if (end >= this->length) throw makeError("+- sign without proceeding digit(s)");
+        end = skipDigits(this->input, end, this->length);
+    }
+
+    // Keep the number exactly if it is a 64-bit integer, otherwise keep its rounding error for the extended precision evaluator.
+    PostfixInstruction instruction;
+    instruction.operationCode = PostfixOperationCode::pushNumber;
+    const char* first = this->input + start;
+    const char* last = this->input + end;
+    std::from_chars_result integerResult = std::from_chars(first, last, instruction.integer);
+    instruction.isInteger = integerResult.ec == std::errc() && integerResult.ptr == last;
+    if (instruction.isInteger) instruction.number = static_cast<double>(instruction.integer);
+    else {
+        DoubleDouble number;
+        if (parseDoubleDouble(first, last, number).ec == std::errc::result_out_of_range) {
+            throw std::invalid_argument("ParseError: Found number out of the range of double at index " + std::to_string(start) + ".\n");
+        }
+        instruction.number = number.high;
+        instruction.numberLow = number.low;
+    }
+    this->output->push_back(instruction);
+    this->index = end;
+}
+
+void PrattParser::expectClosingParenthesis() {
+    // Handle the end of the input inside parentheses.
+    if (!this->skipWhitespaceAndCheckMore()) {
+        std::string errorMessage = "MathError: Found mismatched brackets (found " + std::to_string(this->openParenthesisCount);
+        errorMessage += " unmatched left bracket(s)).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Handle anything else, e.g. the operand following an operand in "(1 2)".
+    if (this->input[this->index] != ')') throw this->makeUnexpectedCharacterError();
+
+    this->index++;
+    this->openParenthesisCount--;
+}
+
+void PrattParser::expectOpeningParenthesis(const std::string& name) {
+    // Ignore all whitespaces after the name, check if there is a '('.
+    if (!this->skipWhitespaceAndCheckMore() || this->input[this->index] != '(') {
+        std::string errorMessage = "MathError: Failed to parse " + name;
+        errorMessage += "() at index " + std::to_string(this->index) + " (cannot find corresponding parenthesis).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+}
+
+bool PrattParser::skipWhitespaceAndCheckMore() {
+    this->index = skipWhitespace(this->input, this->index, this->length);
+    return this->index < this->length;
+}
+
+std::invalid_argument PrattParser::makeUnexpectedCharacterError() const {
+    // Handle separators outside of user function calls.
+    char character = this->input[this->index];
+    if (character == ',') return std::invalid_argument("ParseError: Found ',' outside of a user function call or vector literal.\n");
+    if (character == '=') return std::invalid_argument("ParseError: Found '=' at index " + std::to_string(this->index) + " outside of a cell assignment of the form \"<name> = <expression>\".\n");
+
+    // An operand following an operand has no operator to combine them.
+    if (character == '.' || character == '(' || character == '[' || static_cast<unsigned char>(character - '0') <= 9 || static_cast<unsigned char>(character - 'a') <= 25) {
+        return std::invalid_argument("EvalError: Found excess operand(s) at index " + std::to_string(this->index) + ".\n");
+    }
+
+    // Handle unrecognized token exception.
+    std::string errorMessage = "MathError: Found unrecognized token at index " + std::to_string(this->index);
+    errorMessage += " (found ";
+    errorMessage += character;
+    errorMessage += ").\n";
+    return std::invalid_argument(errorMessage);
+}
+
+void PrattParser::emitOperator(PostfixOperationCode operationCode, const std::string& name) {
+    PostfixInstruction instruction;
+    instruction.operationCode = operationCode;
+    instruction.name = name;
+    this->output->push_back(instruction);
+}
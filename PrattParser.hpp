@@ -0,0 +1,104 @@
+#ifndef __PRATT_PARSER
+#define __PRATT_PARSER
+
+#include "ExpressionCompiler.hpp"
+#include "EvaluationBudget.hpp"
+
+/// @brief Single-pass precedence-climbing (Pratt) parser turning an expression into postfix bytecode.
+/// Characters are consumed once: tokens are recognized, bracket pairs matched and instructions emitted in the same pass,
+/// without an intermediate token vector or operator stack. Operators follow the precedence table of the calculator:
+/// '+', '-' (0) < '*', '/', '%' (1) < '^', functions, "log_" (2) < negation, '!' (3). Binary operators are left associative,
+/// a prefix operator of precedence p applies to the following operand and the operators of precedence above p
+/// (so "-2^2" = (-2)^2, "2^3!" = 2^(3!), "sin(x)^2" = (sin x)^2, "sin(x)!" = sin(x!)), and "log_" takes two operands
+/// ("log_2(8)" = 3).
+class PrattParser {
+    public:
+        /// @brief Largest nesting depth of parentheses, prefix operators and operator precedence levels.
+        static constexpr size_t maximumNestingDepth = 4096;
+
+        /// @brief Constructor for the Pratt parser class.
+        /// @param functionLookupTable Codes of the operators, functions and constants (odd = unary, even = binary).
+        /// @param operatorPrecedenceLookupTable Precedence of the built-in operators and functions.
+        /// @param userFunctionLookupTable Functions defined during the session.
+        PrattParser(
+            const std::unordered_map<std::string, int>& functionLookupTable,
+            const std::unordered_map<std::string, int>& operatorPrecedenceLookupTable,
+            const UserFunctionTable& userFunctionLookupTable
+        );
+
+        /// @brief Method for parsing an expression into postfix bytecode.
+        /// @param expression Expression to parse.
+        /// @param variableNames Names of the variables the expression may reference, ordered by their slot.
+        /// @param functionBeingDefined Name of the function whose body is parsed, which may not call itself (empty otherwise).
+        /// @param budget Budget polled once per operand (nullptr for an unlimited parse).
+        /// @returns The bytecode.
+        /// @throws invalid_argument error if the expression cannot be parsed, or the budget is exceeded.
+        std::vector<PostfixInstruction> parse(const std::string& expression, const std::vector<std::string>& variableNames = {}, const std::string& functionBeingDefined = "", EvaluationBudget* budget = nullptr);
+
+    private:
+        /// @brief Precedence of user functions, which bind like the built-in functions.
+        static constexpr int userFunctionPrecedence = 2;
+
+        const std::unordered_map<std::string, int>& functionLookupTable;
+        const std::unordered_map<std::string, int>& operatorPrecedenceLookupTable;
+        const UserFunctionTable& userFunctionLookupTable;
+
+        /// @brief State of the expression being parsed.
+        const char* input = nullptr;
+        size_t length = 0, index = 0;
+        const std::vector<std::string>* variableNames = nullptr;
+        const std::string* functionBeingDefined = nullptr;
+        std::vector<PostfixInstruction>* output = nullptr;
+        EvaluationBudget* budget = nullptr;
+
+        /// @brief Number of open parentheses and current nesting depth.
+        size_t openParenthesisCount = 0, nestingDepth = 0;
+
+        /// @brief Private method for parsing an operand followed by the operators of at least the given precedence.
+        /// @param minimumPrecedence Lowest precedence of the operators applied to the operand.
+        void parseExpression(int minimumPrecedence);
+
+        /// @brief Private method for parsing a number, constant, variable, vector literal, parenthesized expression or prefix operator application.
+        void parseOperand();
+
+        /// @brief Private method for applying the infix and postfix operators of at least the given precedence to the parsed operand.
+        /// @param minimumPrecedence Lowest precedence of the operators to apply.
+        void parseOperators(int minimumPrecedence);
+
+        /// @brief Private method for parsing a name (function, constant or variable) and what it applies to.
+        void parseName();
+
+        /// @brief Private method for parsing the arguments of a user function call, starting at its '('.
+        /// @param function Called function.
+        void parseUserFunctionCall(const UserFunction& function);
+
+        /// @brief Private method for parsing a vector literal, e.g. "[1, 2, 3.5]", starting at its '['.
+        void parseVectorLiteral();
+
+        /// @brief Private method for parsing a number, mirroring the number format of the calculator (e.g. "1.5e-3").
+        void parseNumber();
+
+        /// @brief Private method for consuming the ')' closing a parenthesized expression or argument list.
+        /// @throws invalid_argument error describing what has been found instead.
+        void expectClosingParenthesis();
+
+        /// @brief Private method for consuming the '(' following a function name.
+        /// @param name Name of the function.
+        /// @throws invalid_argument error if the next character is not '('.
+        void expectOpeningParenthesis(const std::string& name);
+
+        /// @brief Private method for skipping whitespace.
+        /// @returns true if a character follows, false at the end of the input.
+        bool skipWhitespaceAndCheckMore();
+
+        /// @brief Private method for building the error thrown for an unexpected character.
+        /// @returns The error.
+        std::invalid_argument makeUnexpectedCharacterError() const;
+
+        /// @brief Private method for appending an operator instruction to the bytecode.
+        /// @param operationCode applyUnaryOperator or applyBinaryOperator.
+        /// @param name Name of the operator.
+        void emitOperator(PostfixOperationCode operationCode, const std::string& name);
+};
+
+#endif
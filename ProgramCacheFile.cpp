@@ -0,0 +1,386 @@
+#include "ProgramCacheFile.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+/// @brief First bytes of every cache file.
+static constexpr char fileMagic[8] = {'C', 'A', 'L', 'C', 'P', 'R', 'G', '\0'};
+
+/// @brief Value written in the byte order of the writer, to ignore files written on machines of another byte order.
+static constexpr uint32_t byteOrderMark = 0x01020304;
+
+/// @brief Size of the file header: magic, format version, byte order mark and entry count.
+static constexpr size_t fileHeaderSize = sizeof(fileMagic) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+/// @brief Size of the header of an entry: hash of the key, checksum of the payload and size of the payload.
+static constexpr size_t entryHeaderSize = 3 * sizeof(uint64_t);
+
+/// @brief Number of temporary files created by this process, making their names unique among its threads.
+static std::atomic<uint64_t> temporaryFileCount = 0;
+
+/// @brief Function for building the name of a temporary file next to a file, unique among the processes and threads saving it.
+/// @param path Path of the file.
+/// @returns The path followed by ".<process id>.<count>.tmp".
+static std::string makeTemporaryPath(const std::string& path) {
+#ifdef _WIN32
+    long long processId = _getpid();
+#else
+    long long processId = getpid();
+#endif
+    return path + "." + std::to_string(processId) + "." + std::to_string(temporaryFileCount++) + ".tmp";
+}
+
+/// @brief Function for appending the bytes of a value to a buffer.
+template <typename T>
+static void appendValue(std::string& buffer, T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// @brief Function for appending a string to a buffer, preceded by its length.
+static void appendString(std::string& buffer, const std::string& text) {
+    appendValue(buffer, static_cast<uint32_t>(text.size()));
+    buffer += text;
+}
+
+/// @brief Reader of the values appended by appendValue() and appendString().
+class ProgramCacheFile::ByteReader {
+    public:
+        explicit ByteReader(std::string_view bytes) : position(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+        /// @brief Method for reading a value.
+        /// @returns false if there are not enough bytes left.
+        template <typename T>
+        bool read(T& value) {
+            if (static_cast<size_t>(this->end - this->position) < sizeof(T)) return false;
+            std::memcpy(&value, this->position, sizeof(T));
+            this->position += sizeof(T);
+            return true;
+        }
+
+        /// @brief Method for reading the number of elements of a list, checking that the bytes left can hold them.
+        /// @param count Reference receiving the number of elements.
+        /// @param elementSize Smallest number of bytes taken by an element.
+        /// @returns false if the list would not fit in the bytes left.
+        bool readCount(uint32_t& count, size_t elementSize) {
+            return this->read(count) && static_cast<uint64_t>(count) * elementSize <= static_cast<size_t>(this->end - this->position);
+        }
+
+        /// @brief Method for reading a string preceded by its length.
+        /// @returns false if there are not enough bytes left.
+        bool readString(std::string& text) {
+            uint32_t size;
+            if (!this->readCount(size, 1)) return false;
+            text.assign(this->position, size);
+            this->position += size;
+            return true;
+        }
+
+        /// @brief Method for checking whether every byte has been read.
+        bool isAtEnd() const {
+            return this->position == this->end;
+        }
+
+    private:
+        /// @brief Next byte to read.
+        const char* position;
+
+        /// @brief Byte past the last one.
+        const char* end;
+};
+
+/// @brief Function for serializing a key. The hash of these bytes is the hash of the key.
+/// @param key Key to serialize.
+/// @returns The bytes, which also start the payload of the entry.
+static std::string serializeKey(const ProgramCacheKey& key) {
+    std::string buffer;
+    appendString(buffer, key.source);
+    appendValue(buffer, static_cast<uint32_t>(key.variableNames.size()));
+    for (const std::string& name : key.variableNames) appendString(buffer, name);
+    appendValue(buffer, key.evaluationMode);
+    appendValue(buffer, key.mathAccuracy);
+    appendValue(buffer, key.userFunctionFingerprint);
+    return buffer;
+}
+
+std::string ProgramCacheFile::normalizeSource(const std::string& expression) {
+    // Write the characters into a buffer of the largest length, then cut it, since the lookups of shared caches normalize every expression.
+    std::string source(expression.size(), '\0');
+    size_t length = 0;
+    bool isAfterSpace = false;
+    for (char character : expression) {
+        if (character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\v' || character == '\f') {
+            isAfterSpace = true;
+            continue;
+        }
+        if (isAfterSpace && length > 0) source[length++] = ' ';
+        isAfterSpace = false;
+        source[length++] = character;
+    }
+    source.resize(length);
+    return source;
+}
+
+uint64_t ProgramCacheFile::hashBytes(const void* data, size_t size, uint64_t hash) {
+    // Hash 8 bytes per multiplication, then the remaining bytes one at a time.
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t index = 0;
+    for (; index + sizeof(uint64_t) <= size; index += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + index, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    for (; index < size; index++) hash = (hash ^ bytes[index]) * 0x100000001b3ULL;
+    return hash ^ (hash >> 32);
+}
+
+void ProgramCacheFile::serializeProgram(std::string& buffer, const CompiledExpression& program) {
+    // Write the instructions, each with its operator name.
+    appendValue(buffer, static_cast<uint32_t>(program.instructions.size()));
+    for (size_t index = 0; index < program.instructions.size(); index++) {
+        const Instruction& instruction = program.instructions[index];
+        appendValue(buffer, instruction.operationCode);
+        appendValue(buffer, instruction.destinationRegister);
+        appendValue(buffer, instruction.firstOperandRegister);
+        appendValue(buffer, instruction.secondOperandRegister);
+        appendString(buffer, program.operatorNames[index]);
+    }
+
+    // Write the operand lists, polynomials and subprograms referenced by the instructions.
+    appendValue(buffer, static_cast<uint32_t>(program.reductionOperands.size()));
+    for (uint32_t operand : program.reductionOperands) appendValue(buffer, operand);
+    appendValue(buffer, static_cast<uint32_t>(program.polynomialCoefficients.size()));
+    for (const std::vector<double>& coefficients : program.polynomialCoefficients) {
+        appendValue(buffer, static_cast<uint32_t>(coefficients.size()));
+        for (double coefficient : coefficients) appendValue(buffer, coefficient);
+    }
+    appendValue(buffer, static_cast<uint32_t>(program.subprograms.size()));
+    for (const auto& subprogram : program.subprograms) serializeProgram(buffer, *subprogram);
+
+    // Write the register layout, the mode and the statistics.
+    appendValue(buffer, static_cast<uint32_t>(program.constants.size()));
+    for (double constant : program.constants) appendValue(buffer, constant);
+    appendValue(buffer, static_cast<uint32_t>(program.variableNames.size()));
+    for (const std::string& name : program.variableNames) appendString(buffer, name);
+    appendValue(buffer, program.resultRegister);
+    appendValue(buffer, program.registerCount);
+    appendValue(buffer, program.evaluationMode);
+    appendValue(buffer, program.mathAccuracy);
+    const CompilationStatistics& statistics = program.statistics;
+    for (size_t value : {statistics.operationsBeforeElimination, statistics.operationsAfterElimination, statistics.eliminatedOperations,
+        statistics.foldedOperations, statistics.parallelReductionTerms, statistics.recognizedPolynomials, statistics.fusedTrigonometricCalls}) {
+        appendValue(buffer, static_cast<uint64_t>(value));
+    }
+}
+
+bool ProgramCacheFile::deserializeProgram(ByteReader& reader, const ExpressionCompiler& compiler, EvaluationMode evaluationMode, CompiledExpression& program) {
+    // Read the instructions.
+    uint32_t count;
+    if (!reader.readCount(count, sizeof(uint8_t) + 4 * sizeof(uint32_t))) return false;
+    program.instructions.resize(count);
+    program.operatorNames.resize(count);
+    for (uint32_t index = 0; index < count; index++) {
+        Instruction& instruction = program.instructions[index];
+        if (!reader.read(instruction.operationCode) || !reader.read(instruction.destinationRegister) || !reader.read(instruction.firstOperandRegister) ||
+            !reader.read(instruction.secondOperandRegister) || !reader.readString(program.operatorNames[index])) return false;
+    }
+
+    // Read the operand lists, polynomials and subprograms.
+    if (!reader.readCount(count, sizeof(uint32_t))) return false;
+    program.reductionOperands.resize(count);
+    for (uint32_t& operand : program.reductionOperands) reader.read(operand);
+    if (!reader.readCount(count, sizeof(uint32_t))) return false;
+    program.polynomialCoefficients.resize(count);
+    for (std::vector<double>& coefficients : program.polynomialCoefficients) {
+        if (!reader.readCount(count, sizeof(double)) || count == 0) return false;
+        coefficients.resize(count);
+        for (double& coefficient : coefficients) reader.read(coefficient);
+    }
+    if (!reader.readCount(count, sizeof(uint32_t))) return false;
+    for (uint32_t index = 0; index < count; index++) {
+        CompiledExpression subprogram;
+        if (!deserializeProgram(reader, compiler, evaluationMode, subprogram)) return false;
+        program.subprograms.push_back(std::make_shared<const CompiledExpression>(std::move(subprogram)));
+    }
+
+    // Read the register layout, the mode and the statistics.
+    if (!reader.readCount(count, sizeof(double))) return false;
+    program.constants.resize(count);
+    for (double& constant : program.constants) reader.read(constant);
+    if (!reader.readCount(count, sizeof(uint32_t))) return false;
+    program.variableNames.resize(count);
+    for (std::string& name : program.variableNames) {
+        if (!reader.readString(name)) return false;
+    }
+    if (!reader.read(program.resultRegister) || !reader.read(program.registerCount) || !reader.read(program.evaluationMode) || !reader.read(program.mathAccuracy)) return false;
+    CompilationStatistics& statistics = program.statistics;
+    for (size_t* value : {&statistics.operationsBeforeElimination, &statistics.operationsAfterElimination, &statistics.eliminatedOperations,
+        &statistics.foldedOperations, &statistics.parallelReductionTerms, &statistics.recognizedPolynomials, &statistics.fusedTrigonometricCalls}) {
+        uint64_t statistic;
+        if (!reader.read(statistic)) return false;
+        *value = static_cast<size_t>(statistic);
+    }
+
+    // Check that the instructions only reference registers, lists, polynomials and subprograms that exist.
+    uint32_t registerCount = program.registerCount;
+    size_t firstInstructionRegister = program.constants.size() + program.variableNames.size();
+    if (firstInstructionRegister > registerCount || program.resultRegister >= registerCount) return false;
+    if (static_cast<uint8_t>(program.mathAccuracy) > static_cast<uint8_t>(MathAccuracy::approximate)) return false;
+    for (const Instruction& instruction : program.instructions) {
+        if (instruction.destinationRegister < firstInstructionRegister || instruction.destinationRegister >= registerCount) return false;
+        uint32_t first = instruction.firstOperandRegister, second = instruction.secondOperandRegister;
+        bool isValid = false;
+        switch (instruction.operationCode) {
+            case OperationCode::unary: case OperationCode::approximateUnary: isValid = first < registerCount; break;
+            case OperationCode::binary: isValid = first < registerCount && second < registerCount; break;
+            case OperationCode::sineCosine: isValid = first < registerCount && second >= firstInstructionRegister && second < registerCount; break;
+            case OperationCode::polynomial: isValid = first < registerCount && second < program.polynomialCoefficients.size(); break;
+            case OperationCode::sum: case OperationCode::product: isValid = first <= program.reductionOperands.size() && second <= program.reductionOperands.size() - first; break;
+            case OperationCode::parallelSum: case OperationCode::parallelProduct: isValid = first <= program.subprograms.size() && second <= program.subprograms.size() - first; break;
+        }
+        if (!isValid) return false;
+    }
+    for (uint32_t operand : program.reductionOperands) {
+        if ((operand & ~CompiledExpression::negatedOperandFlag) >= registerCount) return false;
+    }
+    for (const auto& subprogram : program.subprograms) {
+        if (subprogram->variableNames.size() != program.variableNames.size()) return false;
+    }
+
+    // Bind the functions of the instructions.
+    return compiler.bindFunctions(program, evaluationMode);
+}
+
+ProgramCacheFile::ProgramCacheFile(const std::string& path) : path(path) {
+    this->load();
+}
+
+void ProgramCacheFile::load() {
+    // Map the file. A missing file gives an empty cache.
+    try {
+        this->file = std::make_unique<MappedFile>(this->path);
+    } catch (std::invalid_argument&) {
+        return;
+    }
+
+    // Ignore files written by another format version or on a machine of another byte order.
+    const char* data = this->file->getData();
+    size_t size = this->file->getSize();
+    uint32_t version = 0, order = 0;
+    uint64_t entryCount = 0;
+    if (size >= fileHeaderSize) {
+        std::memcpy(&version, data + sizeof(fileMagic), sizeof(version));
+        std::memcpy(&order, data + sizeof(fileMagic) + sizeof(version), sizeof(order));
+        std::memcpy(&entryCount, data + sizeof(fileMagic) + 2 * sizeof(uint32_t), sizeof(entryCount));
+    }
+    if (size < fileHeaderSize || std::memcmp(data, fileMagic, sizeof(fileMagic)) != 0 || version != formatVersion || order != byteOrderMark) {
+        this->file.reset();
+        return;
+    }
+
+    // Index the entries without reading their payloads. A truncated file keeps the entries before the cut.
+    size_t offset = fileHeaderSize;
+    for (uint64_t index = 0; index < entryCount && size - offset >= entryHeaderSize; index++) {
+        uint64_t header[3];
+        std::memcpy(header, data + offset, entryHeaderSize);
+        offset += entryHeaderSize;
+        if (header[2] > size - offset) break;
+        this->entries[header[0]] = {header[1], std::string_view(data + offset, static_cast<size_t>(header[2]))};
+        offset += static_cast<size_t>(header[2]);
+    }
+    this->statistics.loadedEntries = this->entries.size();
+}
+
+bool ProgramCacheFile::find(const ProgramCacheKey& key, const ExpressionCompiler& compiler, CompiledExpression& program) {
+    // Look up the entry of the key. Entries of another key with the same hash are misses, replaced by the next insert().
+    std::string keyBytes = serializeKey(key);
+    uint64_t hash = hashBytes(keyBytes.data(), keyBytes.size());
+    auto entry = this->entries.find(hash);
+    if (entry == this->entries.end() || entry->second.payload.substr(0, keyBytes.size()) != keyBytes) {
+        this->statistics.misses++;
+        return false;
+    }
+
+    // Check the checksum, then read the program back. Drop the entry if anything does not check out.
+    const Entry& found = entry->second;
+    ByteReader reader(found.payload.substr(keyBytes.size()));
+    CompiledExpression loadedProgram;
+    bool isValid = hashBytes(found.payload.data(), found.payload.size()) == found.checksum && deserializeProgram(reader, compiler, key.evaluationMode, loadedProgram) &&
+        reader.isAtEnd() && loadedProgram.evaluationMode == key.evaluationMode && loadedProgram.mathAccuracy == key.mathAccuracy &&
+        loadedProgram.variableNames == key.variableNames;
+    if (!isValid) {
+        this->entries.erase(entry);
+        this->insertedPayloads.erase(hash);
+        this->statistics.staleEntries++;
+        this->statistics.misses++;
+        return false;
+    }
+    this->statistics.hits++;
+    program = std::move(loadedProgram);
+    return true;
+}
+
+void ProgramCacheFile::insert(const ProgramCacheKey& key, const CompiledExpression& program) {
+    // The payload is the key followed by the program, stored until the next save().
+    std::string payload = serializeKey(key);
+    uint64_t hash = hashBytes(payload.data(), payload.size());
+    serializeProgram(payload, program);
+    std::string& storedPayload = this->insertedPayloads[hash] = std::move(payload);
+    this->entries[hash] = {hashBytes(storedPayload.data(), storedPayload.size()), storedPayload};
+}
+
+void ProgramCacheFile::save() {
+    // Write the header, then every entry, to a temporary file next to the cache file. Its name is unique, so that processes
+    // saving the same cache at once never write to each other's temporary file before renaming it.
+    std::string temporaryPath = makeTemporaryPath(this->path);
+    {
+        std::ofstream output(temporaryPath, std::ios::binary);
+        std::string header(fileMagic, sizeof(fileMagic));
+        appendValue(header, formatVersion);
+        appendValue(header, byteOrderMark);
+        appendValue(header, static_cast<uint64_t>(this->entries.size()));
+        output.write(header.data(), static_cast<std::streamsize>(header.size()));
+        for (const auto& [hash, entry] : this->entries) {
+            uint64_t entryHeader[3] = {hash, entry.checksum, entry.payload.size()};
+            output.write(reinterpret_cast<const char*>(entryHeader), entryHeaderSize);
+            output.write(entry.payload.data(), static_cast<std::streamsize>(entry.payload.size()));
+        }
+        output.flush();
+        if (!output) {
+            std::remove(temporaryPath.c_str());
+            throw std::invalid_argument("FileError: Failed to write " + temporaryPath + ".\n");
+        }
+    }
+
+    // Unmap the old file (Windows cannot replace mapped files), replace it, then map the new one.
+    this->entries.clear();
+    this->insertedPayloads.clear();
+    this->file.reset();
+#ifdef _WIN32
+    std::remove(this->path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), this->path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        this->load();
+        throw std::invalid_argument("FileError: Failed to write " + this->path + ".\n");
+    }
+    this->load();
+}
+
+size_t ProgramCacheFile::getEntryCount() const {
+    return this->entries.size();
+}
+
+const ProgramCacheStatistics& ProgramCacheFile::getStatistics() const {
+    return this->statistics;
+}
@@ -0,0 +1,143 @@
+#ifndef __PROGRAM_CACHE_FILE
+#define __PROGRAM_CACHE_FILE
+
+#include "ExpressionCompiler.hpp"
+#include "MappedFile.hpp"
+
+#include <string_view>
+
+/// @brief Everything the compiled program of an expression depends on.
+struct ProgramCacheKey {
+    /// @brief Expression with its whitespace normalized (see ProgramCacheFile::normalizeSource()).
+    std::string source;
+
+    /// @brief Names of the variables, ordered by their slot.
+    std::vector<std::string> variableNames;
+
+    /// @brief Mode the program is compiled in.
+    EvaluationMode evaluationMode = EvaluationMode::checked;
+
+    /// @brief Accuracy of the transcendental functions of the program.
+    MathAccuracy mathAccuracy = MathAccuracy::library;
+
+    /// @brief Fingerprint of the user functions the expression calls, hashed with their names (see UserFunction::fingerprint), 0 if it calls none.
+    uint64_t userFunctionFingerprint = 0;
+};
+
+/// @brief Counters of a program cache file.
+struct ProgramCacheStatistics {
+    /// @brief Number of entries found in the file when it was last mapped.
+    size_t loadedEntries = 0;
+
+    /// @brief Number of lookups answered from the cache.
+    size_t hits = 0;
+
+    /// @brief Number of lookups without an entry for the key.
+    size_t misses = 0;
+
+    /// @brief Number of entries found corrupted or incompatible with this build, dropped to be recompiled.
+    size_t staleEntries = 0;
+};
+
+/// @brief Cache of compiled programs stored in a file, so a process compiling the same expressions at every start only parses
+/// and optimizes them once. The file is memory-mapped when the cache is created and only indexed: an entry is read back when it is
+/// looked up, which skips parsing and compilation entirely.
+/// Entries are keyed by a 64-bit FNV-1a hash of their ProgramCacheKey, and hold the whole key to rule out collisions, a checksum,
+/// and the program: instructions with their operator names, constants, variable slots, reduction operands, polynomial coefficients,
+/// subprograms and compilation statistics. Function pointers are not stored but bound again to the lookup tables of the compiler.
+/// Files written by another format version or byte order are ignored, and entries whose checksum, registers or operators do not
+/// check out are reported as misses and dropped, so the caller recompiles them. Not thread-safe.
+class ProgramCacheFile {
+    public:
+        /// @brief Version of the file format. Changes to the format, or to the programs the compiler emits, must increase it.
+        static constexpr uint32_t formatVersion = 3;
+
+        /// @brief Constructor for the program cache file class.
+        /// @param path Path of the file. A missing or incompatible file gives an empty cache, written by save().
+        explicit ProgramCacheFile(const std::string& path);
+
+        /// @brief Function for normalizing the whitespace of an expression, so that formatting differences share an entry.
+        /// Leading and trailing whitespace is removed, and every other run of whitespace becomes a single space.
+        /// @param expression Expression to normalize.
+        /// @returns The normalized expression.
+        static std::string normalizeSource(const std::string& expression);
+
+        /// @brief Function for hashing bytes with FNV-1a, taking 8 bytes per step (the tail one byte at a time).
+        /// @param data Pointer to the bytes.
+        /// @param size Number of bytes.
+        /// @param hash Hash of the preceding bytes, to hash data in several calls.
+        /// @returns The hash.
+        static uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL);
+
+        /// @brief Method for looking up the program of a key.
+        /// @param key Key of the program.
+        /// @param compiler Compiler holding the lookup tables of the evaluation mode of the key, used to bind the functions.
+        /// @param program Reference receiving the program.
+        /// @returns true if the program has been read back, false if there is no valid entry for the key.
+        bool find(const ProgramCacheKey& key, const ExpressionCompiler& compiler, CompiledExpression& program);
+
+        /// @brief Method for adding (or replacing) the program of a key. The entry is written to the file by save().
+        /// @param key Key of the program.
+        /// @param program Program compiled from the key.
+        void insert(const ProgramCacheKey& key, const CompiledExpression& program);
+
+        /// @brief Method for writing every valid entry to the file, then mapping it again. The file is written to a temporary file
+        /// of a unique name next to the old one and renamed over it, so other processes never read a partial file, and processes
+        /// saving at once replace the file in turn.
+        /// @throws invalid_argument error if the file cannot be written.
+        void save();
+
+        /// @brief Method for accessing the number of entries held by the cache.
+        size_t getEntryCount() const;
+
+        /// @brief Method for accessing the counters of the cache.
+        const ProgramCacheStatistics& getStatistics() const;
+
+    private:
+        /// @brief Entry of the cache, pointing into the mapped file or into insertedPayloads.
+        struct Entry {
+            /// @brief FNV-1a hash of the payload.
+            uint64_t checksum;
+
+            /// @brief Serialized key and program.
+            std::string_view payload;
+        };
+
+        /// @brief Path of the file.
+        std::string path;
+
+        /// @brief Mapping of the file, nullptr if the file is missing or incompatible.
+        std::unique_ptr<MappedFile> file;
+
+        /// @brief Entries keyed by the hash of their key.
+        std::unordered_map<uint64_t, Entry> entries;
+
+        /// @brief Payloads of the entries inserted since the file was mapped, keyed by the hash of their key.
+        std::unordered_map<uint64_t, std::string> insertedPayloads;
+
+        /// @brief Counters of the cache.
+        ProgramCacheStatistics statistics;
+
+        /// @brief Reader of serialized values, failing instead of reading past the end of an entry.
+        class ByteReader;
+
+        /// @brief Private method for mapping the file and indexing its entries.
+        void load();
+
+        /// @brief Private function for serializing a program and its subprograms.
+        /// Instructions are written with their operator names instead of their function pointers.
+        /// @param buffer Buffer receiving the program.
+        /// @param program Program to serialize.
+        static void serializeProgram(std::string& buffer, const CompiledExpression& program);
+
+        /// @brief Private function for reading back a program written by serializeProgram(), checking that every register,
+        /// operand list, polynomial and subprogram it references exists, then binding its functions.
+        /// @param reader Reader positioned at the program.
+        /// @param compiler Compiler binding the functions.
+        /// @param evaluationMode Mode of the whole program.
+        /// @param program Reference receiving the program.
+        /// @returns false if the bytes do not hold a valid program.
+        static bool deserializeProgram(ByteReader& reader, const ExpressionCompiler& compiler, EvaluationMode evaluationMode, CompiledExpression& program);
+};
+
+#endif
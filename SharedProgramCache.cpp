@@ -0,0 +1,213 @@
+#include "SharedProgramCache.hpp"
+
+#include <mutex>
+#include <exception>
+#include <algorithm>
+
+/// @brief Counter giving every cache a unique identifier (0 marks the empty thread slots).
+static std::atomic<uint64_t> nextCacheIdentifier{1};
+
+/// @brief Estimated memory of a hash table node and of the clock position of an entry, added to its program and key.
+static constexpr size_t entryOverheadBytes = 64;
+
+SharedProgramCache::SharedProgramCache(size_t capacityBytes, size_t shardCount) :
+    identifier(nextCacheIdentifier.fetch_add(1, std::memory_order_relaxed)), shardCapacityBytes(capacityBytes / std::max<size_t>(shardCount, 1)),
+    shardCount(std::max<size_t>(shardCount, 1)), shards(new Shard[std::max<size_t>(shardCount, 1)]) {}
+
+SharedProgramCache& SharedProgramCache::getSharedCache() {
+    static SharedProgramCache sharedCache;
+    return sharedCache;
+}
+
+std::array<SharedProgramCache::ThreadSlot, SharedProgramCache::threadSlotCount>& SharedProgramCache::getThreadSlots() {
+    thread_local std::array<ThreadSlot, threadSlotCount> threadSlots;
+    return threadSlots;
+}
+
+uint64_t SharedProgramCache::hashKey(const ProgramCacheKey& key) {
+    // Hash the fields in order, ending every name with a 0 byte so that different splits of the same characters differ.
+    const char separator = 0;
+    uint64_t hash = ProgramCacheFile::hashBytes(key.source.data(), key.source.size());
+    for (const std::string& name : key.variableNames) {
+        hash = ProgramCacheFile::hashBytes(name.data(), name.size(), hash);
+        hash = ProgramCacheFile::hashBytes(&separator, 1, hash);
+    }
+    hash = ProgramCacheFile::hashBytes(&key.evaluationMode, sizeof(key.evaluationMode), hash);
+    hash = ProgramCacheFile::hashBytes(&key.mathAccuracy, sizeof(key.mathAccuracy), hash);
+    return ProgramCacheFile::hashBytes(&key.userFunctionFingerprint, sizeof(key.userFunctionFingerprint), hash);
+}
+
+bool SharedProgramCache::isSameKey(const ProgramCacheKey& firstKey, const ProgramCacheKey& secondKey) {
+    return firstKey.source == secondKey.source && firstKey.variableNames == secondKey.variableNames && firstKey.evaluationMode == secondKey.evaluationMode &&
+        firstKey.mathAccuracy == secondKey.mathAccuracy && firstKey.userFunctionFingerprint == secondKey.userFunctionFingerprint;
+}
+
+SharedProgramCache::Shard& SharedProgramCache::getShard(uint64_t hash) const {
+    // The low bits pick the thread slot, so the shard is picked by the high bits.
+    return this->shards[(hash >> 32) % this->shardCount];
+}
+
+std::shared_ptr<const CompiledExpression> SharedProgramCache::storeInThreadSlot(ThreadSlot& slot, const std::shared_ptr<const Entry>& entry, uint64_t generation) const {
+    // The program pointer shares the ownership of a copy of the entry pointer, so copying it only touches memory of this thread.
+    // The copy is overwritten in place if the slot holds the only references to it.
+    if (slot.owner != nullptr && slot.owner.use_count() == 2) {
+        slot.program = nullptr;
+        *slot.owner = entry;
+    } else {
+        slot.owner = std::make_shared<std::shared_ptr<const Entry>>(entry);
+    }
+    slot.cacheIdentifier = this->identifier;
+    slot.generation = generation;
+    slot.program = std::shared_ptr<const CompiledExpression>(slot.owner, &entry->program);
+    return slot.program;
+}
+
+std::shared_ptr<const CompiledExpression> SharedProgramCache::find(const ProgramCacheKey& key) {
+    // Check the slot of the calling thread first. A hit only reads shared memory.
+    uint64_t hash = hashKey(key), generation = this->generation.load(std::memory_order_acquire);
+    ThreadSlot& slot = getThreadSlots()[hash % threadSlotCount];
+    if (slot.cacheIdentifier == this->identifier && slot.generation == generation && (*slot.owner)->hash == hash && isSameKey((*slot.owner)->key, key)) {
+        const Entry& entry = **slot.owner;
+        if (!entry.isReferenced.load(std::memory_order_relaxed)) entry.isReferenced.store(true, std::memory_order_relaxed);
+        return slot.program;
+    }
+
+    // Otherwise look the key up in its shard. Entries of another key with the same hash are misses, replaced by the next insert().
+    Shard& shard = this->getShard(hash);
+    std::shared_ptr<const Entry> entry;
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.entries.find(hash);
+        if (found != shard.entries.end() && isSameKey(found->second->key, key)) entry = found->second;
+    }
+    if (entry == nullptr) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    if (!entry->isReferenced.load(std::memory_order_relaxed)) entry->isReferenced.store(true, std::memory_order_relaxed);
+    return this->storeInThreadSlot(slot, entry, generation);
+}
+
+std::shared_ptr<const CompiledExpression> SharedProgramCache::insert(const ProgramCacheKey& key, CompiledExpression program) {
+    uint64_t hash = hashKey(key), generation = this->generation.load(std::memory_order_acquire);
+    std::shared_ptr<const Entry> entry = this->insertEntry(key, hash, std::move(program));
+    return this->storeInThreadSlot(getThreadSlots()[hash % threadSlotCount], entry, generation);
+}
+
+std::shared_ptr<const SharedProgramCache::Entry> SharedProgramCache::insertEntry(const ProgramCacheKey& key, uint64_t hash, CompiledExpression program) {
+    // Build the entry before taking the lock.
+    auto entry = std::make_shared<Entry>();
+    entry->key = key;
+    entry->hash = hash;
+    entry->program = std::move(program);
+    entry->bytes = sizeof(Entry) + entryOverheadBytes + entry->program.getMemoryFootprint() + key.source.capacity();
+    for (const std::string& name : key.variableNames) entry->bytes += sizeof(std::string) + name.capacity();
+
+    // Keep the entry another thread has added first, replace an entry of another key with the same hash.
+    Shard& shard = this->getShard(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto [found, isInserted] = shard.entries.try_emplace(hash, entry);
+    if (!isInserted && isSameKey(found->second->key, key)) return found->second;
+    if (isInserted) shard.clock.push_back(hash);
+    else shard.bytes -= found->second->bytes;
+    found->second = entry;
+    shard.bytes += entry->bytes;
+    this->evict(shard, hash);
+    return entry;
+}
+
+std::shared_ptr<const CompiledExpression> SharedProgramCache::findOrCompile(const ProgramCacheKey& key, const std::function<CompiledExpression()>& compile) {
+    std::shared_ptr<const CompiledExpression> program = this->find(key);
+    if (program != nullptr) return program;
+
+    // Look the key up again with the shard locked, then wait for the compilation of another thread or register this one.
+    // Compilations of another key with the same hash are not waited for, the key is compiled without registering it.
+    uint64_t hash = hashKey(key), generation = this->generation.load(std::memory_order_acquire);
+    ThreadSlot& slot = getThreadSlots()[hash % threadSlotCount];
+    Shard& shard = this->getShard(hash);
+    std::promise<std::shared_ptr<const Entry>> promise;
+    bool isRegistered = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.entries.find(hash);
+        if (found != shard.entries.end() && isSameKey(found->second->key, key)) return this->storeInThreadSlot(slot, found->second, generation);
+        auto compilation = shard.compilations.find(hash);
+        if (compilation != shard.compilations.end() && isSameKey(compilation->second.first, key)) {
+            std::shared_future<std::shared_ptr<const Entry>> result = compilation->second.second;
+            lock.unlock();
+            return this->storeInThreadSlot(slot, result.get(), generation);
+        }
+        if (compilation == shard.compilations.end()) {
+            shard.compilations.emplace(hash, std::make_pair(key, promise.get_future().share()));
+            isRegistered = true;
+        }
+    }
+
+    // Compile without holding the lock, then hand the entry (or the exception) to the waiting threads.
+    std::shared_ptr<const Entry> entry;
+    try {
+        entry = this->insertEntry(key, hash, compile());
+    } catch (...) {
+        if (isRegistered) {
+            promise.set_exception(std::current_exception());
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.compilations.erase(hash);
+        }
+        throw;
+    }
+    if (isRegistered) {
+        promise.set_value(entry);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.compilations.erase(hash);
+    }
+    return this->storeInThreadSlot(slot, entry, generation);
+}
+
+void SharedProgramCache::evict(Shard& shard, uint64_t keptHash) {
+    // Sweep the clock: referenced entries get a second chance, the others are evicted. Two turns clear every bit.
+    for (size_t step = 0; shard.bytes > this->shardCapacityBytes && shard.clock.size() > 1 && step < 2 * shard.clock.size(); step++) {
+        if (shard.clockHand >= shard.clock.size()) shard.clockHand = 0;
+        uint64_t hash = shard.clock[shard.clockHand];
+        const Entry& entry = *shard.entries.at(hash);
+        if (hash == keptHash || entry.isReferenced.exchange(false, std::memory_order_relaxed)) {
+            shard.clockHand++;
+            continue;
+        }
+
+        // Move the last position into the evicted one, which the hand visits next.
+        shard.bytes -= entry.bytes;
+        shard.entries.erase(hash);
+        shard.clock[shard.clockHand] = shard.clock.back();
+        shard.clock.pop_back();
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        step = 0;
+    }
+}
+
+void SharedProgramCache::clear() {
+    // Invalidate the thread slots, then empty every shard.
+    this->generation.fetch_add(1, std::memory_order_acq_rel);
+    for (size_t index = 0; index < this->shardCount; index++) {
+        Shard& shard = this->shards[index];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.clock.clear();
+        shard.clockHand = 0;
+        shard.bytes = 0;
+    }
+}
+
+SharedProgramCacheStatistics SharedProgramCache::getStatistics() const {
+    SharedProgramCacheStatistics statistics;
+    for (size_t index = 0; index < this->shardCount; index++) {
+        const Shard& shard = this->shards[index];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        statistics.entries += shard.entries.size();
+        statistics.bytes += shard.bytes;
+        statistics.sharedHits += shard.hits.load(std::memory_order_relaxed);
+        statistics.misses += shard.misses.load(std::memory_order_relaxed);
+        statistics.evictions += shard.evictions.load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
@@ -0,0 +1,197 @@
+#ifndef __SHARED_PROGRAM_CACHE
+#define __SHARED_PROGRAM_CACHE
+
+#include "ProgramCacheFile.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <future>
+#include <shared_mutex>
+
+/// @brief Counters of a shared program cache, summed over its shards.
+struct SharedProgramCacheStatistics {
+    /// @brief Number of programs held by the shards.
+    size_t entries = 0;
+
+    /// @brief Estimated memory held by the programs and keys of the shards, in bytes.
+    size_t bytes = 0;
+
+    /// @brief Number of lookups answered by a shard. Lookups answered by the slots of the calling thread are not counted, so that
+    /// they never write shared memory.
+    size_t sharedHits = 0;
+
+    /// @brief Number of lookups without a program for the key.
+    size_t misses = 0;
+
+    /// @brief Number of programs evicted to stay within the capacity.
+    size_t evictions = 0;
+};
+
+/// @brief Cache of compiled programs shared by every calculator (and thread) of the process, keyed like ProgramCacheFile by the
+/// normalized expression, the variables, the mode, the accuracy and the user functions. Programs are immutable and returned as
+/// shared pointers, so evicting one never invalidates the programs being evaluated.
+/// Keys are spread over shards by their hash. Each shard holds its entries behind a reader-writer lock, and bounds their estimated
+/// memory (CompiledExpression::getMemoryFootprint()) to its part of the capacity with CLOCK eviction, an approximation of LRU:
+/// a lookup sets the reference bit of its entry, and the clock hand evicts the first entry whose bit is clear, clearing the bits it
+/// passes over. Every thread also keeps a direct-mapped table of threadSlotCount recently used programs per process, checked before
+/// the shards. A hit there takes no lock and writes no shared memory: the reference bit is only read (and written when the hand has
+/// cleared it), and the pointer returned counts its references in a control block owned by the thread. Thread slots may keep up to
+/// threadSlotCount evicted programs alive per thread, on top of the capacity. clear() invalidates them.
+class SharedProgramCache {
+    public:
+        /// @brief Default capacity of the cache, in bytes.
+        static constexpr size_t defaultCapacityBytes = 64 << 20;
+
+        /// @brief Default number of shards.
+        static constexpr size_t defaultShardCount = 64;
+
+        /// @brief Number of programs kept by every thread.
+        static constexpr size_t threadSlotCount = 64;
+
+        /// @brief Constructor for the shared program cache class.
+        /// @param capacityBytes Largest estimated memory held by the shards, split evenly between them.
+        /// @param shardCount Number of shards (at least 1).
+        explicit SharedProgramCache(size_t capacityBytes = defaultCapacityBytes, size_t shardCount = defaultShardCount);
+
+        SharedProgramCache(const SharedProgramCache&) = delete;
+        SharedProgramCache& operator=(const SharedProgramCache&) = delete;
+
+        /// @brief Method for accessing the cache shared by the whole process.
+        /// @returns Reference to the shared cache, created on first use with the default capacity.
+        static SharedProgramCache& getSharedCache();
+
+        /// @brief Method for looking up the program of a key. Thread-safe.
+        /// @param key Key of the program.
+        /// @returns The program, or nullptr if there is none for the key.
+        std::shared_ptr<const CompiledExpression> find(const ProgramCacheKey& key);
+
+        /// @brief Method for adding the program of a key, evicting other programs of its shard if it exceeds its capacity. Thread-safe.
+        /// @param key Key of the program.
+        /// @param program Program compiled from the key.
+        /// @returns The cached program, which is the one already cached if another thread has added the key first.
+        std::shared_ptr<const CompiledExpression> insert(const ProgramCacheKey& key, CompiledExpression program);
+
+        /// @brief Method for looking up the program of a key, compiling and adding it if there is none. Thread-safe. The program is
+        /// compiled without holding any lock, by the first thread missing the key: the other threads missing it meanwhile wait for
+        /// that compilation instead of compiling the key again.
+        /// @param key Key of the program.
+        /// @param compile Function compiling the program of the key.
+        /// @returns The cached program.
+        /// @throws The exceptions of compile, whose programs are not cached. Threads waiting for a compilation rethrow its exception.
+        std::shared_ptr<const CompiledExpression> findOrCompile(const ProgramCacheKey& key, const std::function<CompiledExpression()>& compile);
+
+        /// @brief Method for removing every program, including the ones kept by the threads. Programs still referenced stay valid.
+        void clear();
+
+        /// @brief Method for accessing the counters of the cache.
+        SharedProgramCacheStatistics getStatistics() const;
+
+    private:
+        /// @brief Program cached with its key.
+        struct Entry {
+            /// @brief Key of the program.
+            ProgramCacheKey key;
+
+            /// @brief Hash of the key.
+            uint64_t hash;
+
+            /// @brief Cached program.
+            CompiledExpression program;
+
+            /// @brief Estimated memory held by the entry, in bytes.
+            size_t bytes;
+
+            /// @brief Reference bit of the CLOCK eviction, set by the lookups.
+            mutable std::atomic<bool> isReferenced{false};
+        };
+
+        /// @brief Part of the cache holding the keys of the same hash bucket, on its own cache lines.
+        struct alignas(64) Shard {
+            /// @brief Lock of the entries, shared by the lookups.
+            mutable std::shared_mutex mutex;
+
+            /// @brief Entries keyed by the hash of their key.
+            std::unordered_map<uint64_t, std::shared_ptr<const Entry>> entries;
+
+            /// @brief Compilations in progress in findOrCompile(), keyed by the hash of their key, with the key they compile.
+            std::unordered_map<uint64_t, std::pair<ProgramCacheKey, std::shared_future<std::shared_ptr<const Entry>>>> compilations;
+
+            /// @brief Hashes of the entries, in the order the clock hand visits them.
+            std::vector<uint64_t> clock;
+
+            /// @brief Position of the clock hand.
+            size_t clockHand = 0;
+
+            /// @brief Estimated memory held by the entries, in bytes.
+            size_t bytes = 0;
+
+            /// @brief Counters of the shard.
+            std::atomic<size_t> hits{0}, misses{0}, evictions{0};
+        };
+
+        /// @brief Program kept by a thread.
+        struct ThreadSlot {
+            /// @brief Identifier of the cache the program comes from (0 for an empty slot).
+            uint64_t cacheIdentifier = 0;
+
+            /// @brief Generation of the cache when the program was looked up.
+            uint64_t generation = 0;
+
+            /// @brief Pointer to the entry of the program, owned by the thread (reused while no program returned from it is alive).
+            std::shared_ptr<std::shared_ptr<const Entry>> owner;
+
+            /// @brief Pointer to the program of the entry, sharing the control block of owner.
+            std::shared_ptr<const CompiledExpression> program;
+        };
+
+        /// @brief Identifier of the cache, unique in the process, so that thread slots never confuse two caches.
+        const uint64_t identifier;
+
+        /// @brief Generation of the cache, increased by clear() to invalidate the thread slots.
+        std::atomic<uint64_t> generation{1};
+
+        /// @brief Largest estimated memory held by each shard, in bytes.
+        const size_t shardCapacityBytes;
+
+        /// @brief Number of shards.
+        const size_t shardCount;
+
+        /// @brief Shards of the cache.
+        std::unique_ptr<Shard[]> shards;
+
+        /// @brief Private function for accessing the slots of the calling thread.
+        static std::array<ThreadSlot, threadSlotCount>& getThreadSlots();
+
+        /// @brief Private function for hashing a key with FNV-1a.
+        static uint64_t hashKey(const ProgramCacheKey& key);
+
+        /// @brief Private function for comparing two keys.
+        static bool isSameKey(const ProgramCacheKey& firstKey, const ProgramCacheKey& secondKey);
+
+        /// @brief Private method for accessing the shard of a hash.
+        Shard& getShard(uint64_t hash) const;
+
+        /// @brief Private method for storing an entry in a slot of the calling thread.
+        /// @param slot Slot of the hash of the entry.
+        /// @param entry Entry to store.
+        /// @param generation Generation of the cache read before the entry was looked up.
+        /// @returns The program of the entry, counting its references in a control block owned by the thread.
+        std::shared_ptr<const CompiledExpression> storeInThreadSlot(ThreadSlot& slot, const std::shared_ptr<const Entry>& entry, uint64_t generation) const;
+
+        /// @brief Private method for adding the program of a key to its shard, keeping the entry of another thread added first.
+        /// @param key Key of the program.
+        /// @param hash Hash of the key.
+        /// @param program Program compiled from the key.
+        /// @returns The cached entry.
+        std::shared_ptr<const Entry> insertEntry(const ProgramCacheKey& key, uint64_t hash, CompiledExpression program);
+
+        /// @brief Private method for evicting the entries of a shard until it fits its capacity, never evicting the given entry.
+        /// Must be called with the lock of the shard held exclusively.
+        /// @param shard Shard to shrink.
+        /// @param keptHash Hash of the entry just inserted.
+        void evict(Shard& shard, uint64_t keptHash);
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "Spreadsheet.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+Spreadsheet::Spreadsheet(WorkStealingThreadPool* pool) : pool(pool) {}
+
+uint32_t Spreadsheet::findOrCreateCell(const std::string& name) {
+    auto iterator = this->cellLookupTable.find(name);
+    if (iterator != this->cellLookupTable.end()) return iterator->second;
+
+    // Create an undefined cell, so the graph can already record who references it.
+    uint32_t id = static_cast<uint32_t>(this->cells.size());
+    this->cells.emplace_back();
+    this->cells.back().name = name;
+    this->cells.back().error = "EvalError: Cell " + name + " is not defined.\n";
+    this->cellLookupTable.emplace(name, id);
+    return id;
+}
+
+size_t Spreadsheet::setCell(const std::string& name, const std::string& formula, CompiledExpression program) {
+    // Resolve the referenced cells first, since creating cells may move the others.
+    uint32_t id = this->findOrCreateCell(name);
+    std::vector<uint32_t> dependencies;
+    for (const std::string& variableName : program.getVariableNames()) dependencies.push_back(this->findOrCreateCell(variableName));
+
+    // Reject references to the cell itself, then references to any cell downstream of it, which would close a cycle.
+    if (std::find(dependencies.begin(), dependencies.end(), id) != dependencies.end()) {
+        throw std::invalid_argument("EvalError: Cell " + name + " references itself.\n");
+    }
+    std::vector<char> isDownstream(this->cells.size(), 0);
+    std::vector<uint32_t> stack = {id};
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        for (uint32_t dependent : this->cells[current].dependents) {
+            if (!isDownstream[dependent]) {
+                isDownstream[dependent] = 1;
+                stack.push_back(dependent);
+            }
+        }
+    }
+    for (uint32_t dependency : dependencies) {
+        if (isDownstream[dependency]) {
+            std::string errorMessage = "EvalError: Cell " + name + " would reference itself through " + this->cells[dependency].name;
+            errorMessage += " (circular reference).\n";
+            throw std::invalid_argument(errorMessage);
+        }
+    }
+
+    // Move the edges of the cell from its old dependencies to the new ones.
+    Cell& cell = this->cells[id];
+    for (uint32_t dependency : cell.dependencies) {
+        std::vector<uint32_t>& dependents = this->cells[dependency].dependents;
+        dependents.erase(std::find(dependents.begin(), dependents.end(), id));
+    }
+    for (uint32_t dependency : dependencies) this->cells[dependency].dependents.push_back(id);
+    cell.formula = formula;
+    cell.program = std::move(program);
+    cell.dependencies = std::move(dependencies);
+    cell.isDefined = true;
+    return this->recompute(id);
+}
+
+size_t Spreadsheet::removeCell(const std::string& name) {
+    // Removing a cell which does not exist changes nothing.
+    auto iterator = this->cellLookupTable.find(name);
+    if (iterator == this->cellLookupTable.end() || !this->cells[iterator->second].isDefined) return 0;
+
+    // Drop the edges of the cell and its formula, but keep it in the graph for the cells referencing it.
+    Cell& cell = this->cells[iterator->second];
+    for (uint32_t dependency : cell.dependencies) {
+        std::vector<uint32_t>& dependents = this->cells[dependency].dependents;
+        dependents.erase(std::find(dependents.begin(), dependents.end(), iterator->second));
+    }
+    cell.dependencies.clear();
+    cell.formula.clear();
+    cell.program = CompiledExpression();
+    cell.isDefined = false;
+    return this->recompute(iterator->second);
+}
+
+bool Spreadsheet::hasCell(const std::string& name) const {
+    auto iterator = this->cellLookupTable.find(name);
+    return iterator != this->cellLookupTable.end() && this->cells[iterator->second].isDefined;
+}
+
+double Spreadsheet::getValue(const std::string& name) const {
+    auto iterator = this->cellLookupTable.find(name);
+    if (iterator == this->cellLookupTable.end()) throw std::invalid_argument("EvalError: Cell " + name + " is not defined.\n");
+    const Cell& cell = this->cells[iterator->second];
+    if (!cell.error.empty()) throw std::invalid_argument(cell.error);
+    return cell.value;
+}
+
+void Spreadsheet::getValidCells(std::vector<std::string>& names, std::vector<double>& values) const {
+    for (const Cell& cell : this->cells) {
+        if (cell.isDefined && cell.error.empty()) {
+            names.push_back(cell.name);
+            values.push_back(cell.value);
+        }
+    }
+}
+
+void Spreadsheet::print(std::ostream& output) const {
+    // Order the defined cells by name.
+    std::vector<const Cell*> definedCells;
+    for (const Cell& cell : this->cells) {
+        if (cell.isDefined) definedCells.push_back(&cell);
+    }
+    std::sort(definedCells.begin(), definedCells.end(), [](const Cell* first, const Cell* second) { return first->name < second->name; });
+
+    // Write the value of each cell, or its error (which ends the line).
+    for (const Cell* cell : definedCells) {
+        output << cell->name << " = " << cell->formula << " -> ";
+        if (cell->error.empty()) output << cell->value << '\n';
+        else output << cell->error;
+    }
+}
+
+void Spreadsheet::computeCell(Cell& cell, std::vector<double>& registers) const {
+    // Undefined cells only hold their error.
+    if (!cell.isDefined) {
+        cell.error = "EvalError: Cell " + cell.name + " is not defined.\n";
+        return;
+    }
+
+    // Gather the values of the dependencies after the registers, propagating their errors.
+    size_t registerCount = cell.program.getRegisterCount();
+    registers.resize(registerCount + cell.dependencies.size());
+    for (size_t slot = 0; slot < cell.dependencies.size(); slot++) {
+        const Cell& dependency = this->cells[cell.dependencies[slot]];
+        if (!dependency.error.empty()) {
+            cell.error = "EvalError: Cell " + cell.name + " references " + dependency.name;
+            cell.error += dependency.isDefined ? ", which holds an error.\n" : ", which is not defined.\n";
+            return;
+        }
+        registers[registerCount + slot] = dependency.value;
+    }
+
+    // Evaluate the formula, keeping the error it raises instead of the value.
+    try {
+        cell.value = cell.program.evaluate(registers.data() + registerCount, registers.data());
+        cell.error.clear();
+    } catch (std::invalid_argument& e) {
+        cell.error = e.what();
+    }
+}
+
+size_t Spreadsheet::recompute(uint32_t id) {
+    // Find the cells downstream of the changed one, counting for each the dependencies it must wait for.
+    std::unordered_map<uint32_t, uint32_t> pendingDependencies = {{id, 0}};
+    std::vector<uint32_t> stack = {id};
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        for (uint32_t dependent : this->cells[current].dependents) {
+            auto [iterator, isInserted] = pendingDependencies.try_emplace(dependent, 0);
+            iterator->second++;
+            if (isInserted) stack.push_back(dependent);
+        }
+    }
+
+    // Recompute level by level (Kahn's algorithm): the cells of a level only depend on cells of earlier levels,
+    // so they are independent of each other and large levels are split across the pool.
+    std::vector<uint32_t> level = {id}, nextLevel;
+    std::vector<double> registers;
+    while (!level.empty()) {
+        if (level.size() <= cellsPerTask) {
+            for (uint32_t cell : level) this->computeCell(this->cells[cell], registers);
+        } else {
+            WorkStealingThreadPool& pool = (this->pool != nullptr) ? *this->pool : WorkStealingThreadPool::getSharedPool();
+            pool.parallelFor(0, level.size(), cellsPerTask, [&](size_t begin, size_t end) {
+                std::vector<double> taskRegisters;
+                for (size_t index = begin; index < end; index++) this->computeCell(this->cells[level[index]], taskRegisters);
+            });
+        }
+
+        // Release the dependents whose last pending dependency has just been computed.
+        nextLevel.clear();
+        for (uint32_t cell : level) {
+            for (uint32_t dependent : this->cells[cell].dependents) {
+                if (--pendingDependencies[dependent] == 0) nextLevel.push_back(dependent);
+            }
+        }
+        std::swap(level, nextLevel);
+    }
+    return pendingDependencies.size();
+}
@@ -0,0 +1,111 @@
+#ifndef __SPREADSHEET
+#define __SPREADSHEET
+
+#include "ExpressionCompiler.hpp"
+#include "ThreadPool.hpp"
+#include <cmath>
+#include <ostream>
+
+/// @brief Class holding named cells defined by formulas over other cells, e.g. "a = 3", "b = a*2 + sin(c)" and "c = pi/4".
+/// The cells form a dependency graph. Redefining a cell recomputes only the cells downstream of it, in topological order:
+/// the affected cells are split into levels whose cells only depend on earlier levels, and each level is recomputed in parallel.
+/// Cells may reference cells which are not defined yet. They hold an error until the referenced cells are defined, and the same
+/// goes for cells depending on a cell whose formula fails (e.g. "sqrt(-1)"). Definitions closing a cycle are rejected.
+class Spreadsheet {
+    public:
+        /// @brief Constructor for the spreadsheet class.
+        /// @param pool Thread pool recomputing the large levels of cells (nullptr for the pool shared by the whole process,
+        /// only created once a level is large enough to need it).
+        Spreadsheet(WorkStealingThreadPool* pool = nullptr);
+
+        /// @brief Method for defining (or redefining) a cell, then recomputing it and every cell downstream of it.
+        /// @param name Name of the cell.
+        /// @param formula Source of the formula, kept for listings.
+        /// @param program Compiled formula, whose variables are the cells it references.
+        /// @returns Number of cells recomputed, including the cell itself.
+        /// @throws invalid_argument error if the formula references the cell itself, directly or through other cells.
+        /// The previous definition is kept in that case.
+        size_t setCell(const std::string& name, const std::string& formula, CompiledExpression program);
+
+        /// @brief Method for removing a cell. The cells referencing it hold an error until it is defined again.
+        /// @param name Name of the cell.
+        /// @returns Number of cells recomputed, or 0 if the cell does not exist.
+        size_t removeCell(const std::string& name);
+
+        /// @brief Method for checking whether a cell is defined.
+        /// @param name Name of the cell.
+        bool hasCell(const std::string& name) const;
+
+        /// @brief Method for reading the value of a cell.
+        /// @param name Name of the cell.
+        /// @returns Value of the cell.
+        /// @throws invalid_argument error if the cell is not defined, or holds an error (the error is rethrown).
+        double getValue(const std::string& name) const;
+
+        /// @brief Method for listing the defined cells whose value is valid, with their values.
+        /// @param names Vector receiving the names of the cells.
+        /// @param values Vector receiving the values, in the same order.
+        void getValidCells(std::vector<std::string>& names, std::vector<double>& values) const;
+
+        /// @brief Method for writing one "name = formula -> value" line per defined cell (the error instead of the value if any),
+        /// ordered by name.
+        /// @param output Stream receiving the lines.
+        void print(std::ostream& output) const;
+
+    private:
+        /// @brief Number of cells of a level recomputed by a single task. Smaller levels are recomputed on the calling thread.
+        static constexpr size_t cellsPerTask = 64;
+
+        /// @brief Cell of the graph. Cells referenced before being defined exist with isDefined set to false.
+        struct Cell {
+            /// @brief Name of the cell.
+            std::string name;
+
+            /// @brief Source of the formula.
+            std::string formula;
+
+            /// @brief Compiled formula.
+            CompiledExpression program;
+
+            /// @brief Cells referenced by the formula, ordered like the variables of the program.
+            std::vector<uint32_t> dependencies;
+
+            /// @brief Cells whose formula references this cell.
+            std::vector<uint32_t> dependents;
+
+            /// @brief Value of the cell, only meaningful if error is empty.
+            double value = NAN;
+
+            /// @brief Error raised while computing the cell (empty if the value is valid).
+            std::string error;
+
+            /// @brief Whether the cell has been defined (and not removed since).
+            bool isDefined = false;
+        };
+
+        /// @brief Cells, indexed by the ids used in the graph. Ids are never reused.
+        std::vector<Cell> cells;
+
+        /// @brief Table mapping cell names to their ids.
+        std::unordered_map<std::string, uint32_t> cellLookupTable;
+
+        /// @brief Thread pool recomputing the large levels of cells (nullptr for the shared pool).
+        WorkStealingThreadPool* pool;
+
+        /// @brief Private method for finding the id of a cell, creating an undefined cell if needed.
+        /// @param name Name of the cell.
+        /// @returns Id of the cell.
+        uint32_t findOrCreateCell(const std::string& name);
+
+        /// @brief Private method for computing a cell from the values of its dependencies.
+        /// @param cell Cell to compute.
+        /// @param registers Scratch register file, resized as needed.
+        void computeCell(Cell& cell, std::vector<double>& registers) const;
+
+        /// @brief Private method for recomputing a cell and every cell downstream of it, level by level.
+        /// @param id Id of the changed cell.
+        /// @returns Number of cells recomputed.
+        size_t recompute(uint32_t id);
+};
+
+#endif
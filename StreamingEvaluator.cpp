@@ -0,0 +1,478 @@
+#include "StreamingEvaluator.hpp"
+#include "IntegerArithmetic.hpp"
+#include "CharacterClassifier.hpp"
+
+#include <cctype>
+#include <algorithm>
+#include <charconv>
+#include <numbers>
+#include <stdexcept>
+
+StreamingEvaluator::StreamingEvaluator(
+    const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+    const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable,
+    const std::unordered_map<std::string, int>& operatorPrecedenceLookupTable,
+    const std::unordered_map<std::string, int>& functionLookupTable,
+    const UserFunctionTable& userFunctionLookupTable
+) : unaryOperatorLookupTable(&unaryOperatorLookupTable), binaryOperatorLookupTable(&binaryOperatorLookupTable),
+    operatorPrecedenceLookupTable(&operatorPrecedenceLookupTable), functionLookupTable(&functionLookupTable), userFunctionLookupTable(&userFunctionLookupTable),
+    characterOperators{} {
+    // Describe the single character operators and the negation once.
+    for (char character : {'+', '-', '*', '/', '%', '^', '!'}) this->characterOperators[character] = this->describeOperator(std::string(1, character), nullptr);
+    this->negationOperator = this->describeOperator("neg", nullptr);
+}
+
+StreamingValue StreamingEvaluator::evaluate(std::istream& input) {
+    this->reset();
+
+    try {
+        // Feed the stream one chunk at a time. The last read fails but may still have read characters.
+        std::string chunk(chunkSize, '\0');
+        while (input.read(chunk.data(), chunkSize) || input.gcount() > 0) this->feed(chunk.data(), static_cast<size_t>(input.gcount()));
+        return this->finish();
+    } catch (...) {
+        // Leave the evaluator ready for the next expression, then rethrow the error.
+        this->reset();
+        throw;
+    }
+}
+
+void StreamingEvaluator::feed(const char* characters, size_t length) {
+    // Append the characters to the incomplete token left by the previous call, then parse every complete token.
+    this->buffer.append(characters, length);
+    size_t consumedCharacterCount = this->scanTokens(false);
+
+    // Keep the incomplete token only.
+    this->buffer.erase(0, consumedCharacterCount);
+    this->bufferOffset += consumedCharacterCount;
+}
+
+StreamingValue StreamingEvaluator::finish() {
+    // Parse the last token, which cannot continue anymore.
+    this->bufferOffset += this->scanTokens(true);
+    this->buffer.clear();
+
+    // Handle a function name without its parenthesis at the end of the input.
+    if (!this->functionAwaitingParenthesis.empty()) {
+        std::string errorMessage = "MathError: Failed to parse " + this->functionAwaitingParenthesis;
+        errorMessage += "() at index " + std::to_string(this->bufferOffset) + " (cannot find corresponding parenthesis).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Handle no token expression.
+    if (this->tokenCount == 0) throw std::invalid_argument("ParseError: Found 0 tokens to parse.\n");
+
+    // Handle mismatching brackets exception.
+    if (this->numberOfLeftBrackets != this->numberOfRightBrackets) {
+        bool isLeftUnmatched = this->numberOfLeftBrackets > this->numberOfRightBrackets;
+        std::string errorMessage = "MathError: Found mismatched brackets (found ";
+        errorMessage += std::to_string(isLeftUnmatched ? this->numberOfLeftBrackets - this->numberOfRightBrackets : this->numberOfRightBrackets - this->numberOfLeftBrackets);
+        errorMessage += isLeftUnmatched ? " unmatched left bracket(s)).\n" : " unmatched right bracket(s)).\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Apply the operators left on the stack.
+    this->applyOperatorsUntilParenthesis();
+    if (!this->operatorStack.empty()) throw std::invalid_argument("MathError: Failed to find parenthesis pair when clearing stack.\n");
+
+    // Handle empty and excess operand expressions.
+    if (this->operandStack.empty()) throw std::invalid_argument("EvalError: Found excess operator(s).\n");
+    if (this->operandStack.size() > 1) throw std::invalid_argument("EvalError: Found excess operand(s).\n");
+
+    // Return the value, leaving the evaluator ready for the next expression.
+    StreamingValue result = this->operandStack.back();
+    this->reset();
+    return result;
+}
+
+void StreamingEvaluator::reset() {
+    this->buffer.clear();
+    this->bufferOffset = 0;
+    this->isNegativeSign = true;
+    this->functionAwaitingParenthesis.clear();
+    this->previousUserFunction = nullptr;
+    this->tokenCount = this->numberOfLeftBrackets = this->numberOfRightBrackets = 0;
+    this->operandStack.clear();
+    this->operatorStack.clear();
+    this->parenthesisStack.clear();
+}
+
+uint64_t StreamingEvaluator::getCharacterCount() const {
+    return this->bufferOffset + this->buffer.size();
+}
+
+size_t StreamingEvaluator::getPeakStackDepth() const {
+    return this->peakStackDepth;
+}
+
+size_t StreamingEvaluator::scanTokens(bool isEndOfInput) {
+    size_t index = 0;
+    while (index < this->buffer.size()) {
+        char character = this->buffer[index];
+
+        // Skip whitespace in bulk, including the newlines of generated files.
+        if (character == ' ' || character == '\n' || character == '\r' || character == '\t') {
+            index = skipWhitespace(this->buffer.data(), index, this->buffer.size());
+            continue;
+        }
+
+        // A function name must be followed by its parenthesis.
+        if (!this->functionAwaitingParenthesis.empty() && character != '(') {
+            std::string errorMessage = "MathError: Failed to parse " + this->functionAwaitingParenthesis;
+            errorMessage += "() at index " + std::to_string(this->bufferOffset + index) + " (cannot find corresponding parenthesis).\n";
+            throw std::invalid_argument(errorMessage);
+        }
+
+        // Remember the user function named by this token, so that its '(' opens a call.
+        const UserFunction* userFunction = nullptr;
+
+        switch (character) {
+            case '-':
+                // Parse '-' operator / sign according to the state of the tokenizer.
+                if (this->isNegativeSign) {
+                    this->pushPrefixOperator(this->negationOperator);
+                } else {
+                    this->pushOperator(this->characterOperators['-']);
+                    this->isNegativeSign = true;
+                }
+                index++;
+                break;
+
+            case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': case '.': {
+                // Wait for the next chunk if the number may continue.
+                size_t end = this->findNumberEnd(index, isEndOfInput);
+                if (end == std::string::npos) return index;
+
+                // Keep the number exactly if it is a 64-bit integer. Throw invalid_argument error if it is out of the range of double.
+                StreamingValue value;
+                const char* first = this->buffer.data() + index;
+                const char* last = this->buffer.data() + end;
+                std::from_chars_result integerResult = std::from_chars(first, last, value.integer);
+                value.isInteger = integerResult.ec == std::errc() && integerResult.ptr == last;
+                if (value.isInteger) value.value = static_cast<double>(value.integer);
+                else {
+                    std::from_chars_result result = std::from_chars(first, last, value.value);
+                    if (result.ec == std::errc::result_out_of_range) {
+                        throw std::invalid_argument("ParseError: Found number out of the range of double at index " + std::to_string(this->bufferOffset + index) + ".\n");
+                    }
+                    if (result.ec != std::errc() || result.ptr != last) {
+                        throw std::invalid_argument("MathError: Failed to parse number at index " + std::to_string(this->bufferOffset + index) + ".\n");
+                    }
+                }
+
+                this->pushOperand(value);
+                this->isNegativeSign = false;
+                index = end;
+                break;
+            }
+
+            case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+            case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z': {
+                // Find the end of the name. Wait for the next chunk if the name may continue.
+                size_t end = skipLowercaseLetters(this->buffer.data(), index, this->buffer.size());
+                if (end == this->buffer.size() && !isEndOfInput) return index;
+                std::string name = this->buffer.substr(index, end - index);
+
+                // Handle case if token is "log2" or "log_".
+                if (name == "log" && end < this->buffer.size() && (this->buffer[end] == '_' || this->buffer[end] == '2')) name += this->buffer[end++];
+
+                // Throw invalid_argument error if the name is not a valid token.
+                auto userFunctionEntry = this->userFunctionLookupTable->find(name);
+                auto functionEntry = this->functionLookupTable->find(name);
+                if (userFunctionEntry == this->userFunctionLookupTable->end() && functionEntry == this->functionLookupTable->end()) {
+                    std::string errorMessage = "MathError: Unrecognized token " + name;
+                    errorMessage += " at index " + std::to_string(this->bufferOffset + index) + ".\n";
+                    throw std::invalid_argument(errorMessage);
+                }
+
+                if (userFunctionEntry != this->userFunctionLookupTable->end()) {
+                    // User functions are called like the built-in functions.
+                    userFunction = userFunctionEntry->second.get();
+                    this->pushPrefixOperator(this->describeOperator(name, userFunction));
+                    this->functionAwaitingParenthesis = name;
+                } else {
+                    switch (functionEntry->second) {
+                        // Push the special constants (e, pi, phi) as operands.
+                        case 272:
+                            this->pushOperand({std::numbers::e, 0, false});
+                            this->isNegativeSign = false;
+                            break;
+                        case 314:
+                            this->pushOperand({std::numbers::pi, 0, false});
+                            this->isNegativeSign = false;
+                            break;
+                        case 1618:
+                            this->pushOperand({std::numbers::phi, 0, false});
+                            this->isNegativeSign = false;
+                            break;
+
+                        // "log_" takes its base right away, without parentheses.
+                        case 2:
+                            this->pushPrefixOperator(this->describeOperator(name, nullptr));
+                            break;
+
+                        default:
+                            this->pushPrefixOperator(this->describeOperator(name, nullptr));
+                            this->functionAwaitingParenthesis = name;
+                            break;
+                    }
+                }
+                index = end;
+                break;
+            }
+
+            case ',':
+                // Parse the separator of user function arguments.
+                this->separateArgument();
+                this->isNegativeSign = true;
+                index++;
+                break;
+
+            case '/': case '+': case '^': case '*': case '%':
+                // Parse all single character operators.
+                this->pushOperator(this->characterOperators[character]);
+                this->isNegativeSign = true;
+                index++;
+                break;
+
+            case '!':
+                // The factorial follows its operand, so a '-' after it is the subtraction operator.
+                this->pushOperator(this->characterOperators['!']);
+                this->isNegativeSign = false;
+                index++;
+                break;
+
+            case '(':
+                this->functionAwaitingParenthesis.clear();
+                this->openParenthesis();
+                this->numberOfLeftBrackets++;
+                this->isNegativeSign = true;
+                index++;
+                break;
+
+            case ')':
+                this->closeParenthesis();
+                this->numberOfRightBrackets++;
+                this->isNegativeSign = false;
+                index++;
+                break;
+
+            default: {
+                // Handle unrecognized token exception.
+                std::string errorMessage = "MathError: Found unrecognized token at index " + std::to_string(this->bufferOffset + index);
+                errorMessage += " (found ";
+                errorMessage += character;
+                errorMessage += ").\n";
+                throw std::invalid_argument(errorMessage);
+            }
+        }
+
+        this->previousUserFunction = userFunction;
+        this->tokenCount++;
+    }
+    return index;
+}
+
+size_t StreamingEvaluator::findNumberEnd(size_t start, bool isEndOfInput) const {
+    const std::string& input = this->buffer;
+    size_t length = start;
+
+    // Build the error message for a malformed number.
+    auto makeError = [&](const char* reason) {
+        std::string errorMessage = "MathError: Failed to parse number at index " + std::to_string(this->bufferOffset + start);
+        errorMessage += " (found ";
+        errorMessage += reason;
+        errorMessage += ").\n";
+        return std::invalid_argument(errorMessage);
+    };
+
+    // Get the first decimal digits before the exponent / floating point.
+    length = skipDigits(input.data(), length, input.size());
+    if (length == input.size()) return isEndOfInput ? length : std::string::npos;
+
+    // Parse the floating point and the digits following it.
+    if (input[length] == '.') {
+        length++;
+        if (length == input.size() && !isEndOfInput) return std::string::npos;
+        if (length == input.size() || !std::isdigit(input[length])) throw makeError("floating point without proceeding digit(s)");
+        length = skipDigits(input.data(), length, input.size());
+        if (length == input.size()) return isEndOfInput ? length : std::string::npos;
+        if (input[length] == '.') throw makeError("extra floating point");
+    }
+
+    // Parse the exponent.
+    if (input[length] == 'e') {
+        length++;
+        if (length == input.size() && !isEndOfInput) return std::string::npos;
+        if (length == input.size() || !(std::isdigit(input[length]) || input[length] == '-' || input[length] == '+')) {
+            throw makeError("exponent symbol without proceeding digit(s)");
+        }
+
+        // Skip the sign of the exponent.
+        if (input[length] == '-' || input[length] == '+') length++;
+        if (length == input.size() && !isEndOfInput) return std::string::npos;
+        if (length == input.size()) throw makeError("+- sign without proceeding digit(s)");
+
+        length = skipDigits(input.data(), length, input.size());
+        if (length == input.size() && !isEndOfInput) return std::string::npos;
+    }
+    return length;
+}
+
+void StreamingEvaluator::pushOperand(const StreamingValue& value) {
+    this->operandStack.push_back(value);
+    this->updatePeakStackDepth();
+}
+
+StreamingEvaluator::PendingOperator StreamingEvaluator::describeOperator(const std::string& name, const UserFunction* userFunction) const {
+    // Point at the key of the lookup table so that no string is copied.
+    PendingOperator pendingOperator{};
+    pendingOperator.userFunction = userFunction;
+    if (userFunction != nullptr) {
+        // User functions bind like the built-in functions.
+        pendingOperator.name = &this->userFunctionLookupTable->find(name)->first;
+        pendingOperator.precedence = 2;
+        return pendingOperator;
+    }
+
+    auto functionEntry = this->functionLookupTable->find(name);
+    pendingOperator.name = &functionEntry->first;
+    pendingOperator.precedence = this->operatorPrecedenceLookupTable->at(name);
+
+    // If the number assigned is odd, the operator is unary. Else, it is binary.
+    pendingOperator.isUnary = functionEntry->second & 1;
+    if (pendingOperator.isUnary) pendingOperator.unaryFunction = this->unaryOperatorLookupTable->at(name);
+    else pendingOperator.binaryFunction = this->binaryOperatorLookupTable->at(name);
+    return pendingOperator;
+}
+
+void StreamingEvaluator::pushOperator(const PendingOperator& pendingOperator) {
+    // Apply the operators binding at least as tightly, like the shunting-yard moves them to the output queue.
+    while (!this->operatorStack.empty() && this->operatorStack.back().name != nullptr && this->operatorStack.back().precedence >= pendingOperator.precedence) {
+        PendingOperator topOperator = this->operatorStack.back();
+        this->operatorStack.pop_back();
+        this->applyOperator(topOperator);
+    }
+    this->operatorStack.push_back(pendingOperator);
+    this->updatePeakStackDepth();
+}
+
+void StreamingEvaluator::pushPrefixOperator(const PendingOperator& pendingOperator) {
+    // The operators on the stack still wait for the operand this operator starts, e.g. '^' in "2^-3" or "2^sin(x)".
+    this->operatorStack.push_back(pendingOperator);
+    this->updatePeakStackDepth();
+}
+
+void StreamingEvaluator::openParenthesis() {
+    // Keep track of the arguments passed between each pair of parentheses.
+    this->parenthesisStack.push_back({this->previousUserFunction, 1});
+    this->operatorStack.push_back({nullptr, 4, false, nullptr, nullptr, nullptr});
+    this->updatePeakStackDepth();
+}
+
+void StreamingEvaluator::closeParenthesis() {
+    // Check if a user function has been given the right number of arguments.
+    if (!this->parenthesisStack.empty()) {
+        const OpenParenthesis& call = this->parenthesisStack.back();
+        if (call.userFunction != nullptr && call.argumentCount != call.userFunction->parameterNames.size()) {
+            std::string errorMessage = "ParseError: " + call.userFunction->name + " expects ";
+            errorMessage += std::to_string(call.userFunction->parameterNames.size()) + " argument(s), got ";
+            errorMessage += std::to_string(call.argumentCount) + ".\n";
+            throw std::invalid_argument(errorMessage);
+        }
+        this->parenthesisStack.pop_back();
+    }
+
+    // Apply the operators inside the parentheses, then drop the '('.
+    this->applyOperatorsUntilParenthesis();
+    if (this->operatorStack.empty()) throw std::invalid_argument("MathError: Failed to find parenthesis pair.\n");
+    this->operatorStack.pop_back();
+}
+
+void StreamingEvaluator::separateArgument() {
+    // Apply all operators of the current argument.
+    if (this->parenthesisStack.empty() || this->parenthesisStack.back().userFunction == nullptr) {
+        throw std::invalid_argument("ParseError: Found ',' outside of a user function call.\n");
+    }
+    this->applyOperatorsUntilParenthesis();
+    this->parenthesisStack.back().argumentCount++;
+}
+
+void StreamingEvaluator::applyOperatorsUntilParenthesis() {
+    while (!this->operatorStack.empty() && this->operatorStack.back().name != nullptr) {
+        PendingOperator topOperator = this->operatorStack.back();
+        this->operatorStack.pop_back();
+        this->applyOperator(topOperator);
+    }
+}
+
+void StreamingEvaluator::applyOperator(const PendingOperator& pendingOperator) {
+    const std::string& name = *pendingOperator.name;
+    StreamingValue result;
+
+    // If the operator is a user function, evaluate its compiled body on the arguments.
+    if (pendingOperator.userFunction != nullptr) {
+        // Throw error if there are not enough arguments.
+        size_t parameterCount = pendingOperator.userFunction->parameterNames.size();
+        if (this->operandStack.size() < parameterCount) {
+            std::string errorMessage = "EvalError: Failed to find argument(s) for " + name;
+            errorMessage += ".\n";
+            throw std::invalid_argument(errorMessage);
+        }
+
+        // Pop the arguments, the last one being on top of the stack.
+        std::vector<double> arguments(parameterCount);
+        for (size_t parameter = 0; parameter < parameterCount; parameter++) {
+            arguments[parameter] = this->operandStack[this->operandStack.size() - parameterCount + parameter].value;
+        }
+        this->operandStack.resize(this->operandStack.size() - parameterCount);
+
+        result.value = pendingOperator.userFunction->program.evaluate(arguments);
+        this->operandStack.push_back(result);
+        return;
+    }
+
+    if (pendingOperator.isUnary) {
+        // Throw error if there is an excess operator.
+        if (this->operandStack.empty()) throw std::invalid_argument("EvalError: Found excess operator(s).\n");
+        StreamingValue& operand = this->operandStack.back();
+
+        // Take the exact integer path if the operand is an integer and the result fits in 64 bits.
+        if (operand.isInteger && integerUnaryOperation(name, operand.integer, result.integer)) {
+            result.isInteger = true;
+            result.value = static_cast<double>(result.integer);
+        } else {
+            result.value = pendingOperator.unaryFunction(operand.value);
+        }
+        operand = result;
+        return;
+    }
+
+    // Throw error if there is an excess operator, or if there are not enough arguments.
+    if (this->operandStack.empty()) {
+        std::string errorMessage = "EvalError: Found excess operator(s) (found " + name;
+        errorMessage += ").\n";
+        throw std::invalid_argument(errorMessage);
+    }
+    if (this->operandStack.size() < 2) {
+        std::string errorMessage = "EvalError: Failed to find second argument for " + name;
+        errorMessage += ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+    StreamingValue secondOperand = this->operandStack.back();
+    this->operandStack.pop_back();
+    StreamingValue& firstOperand = this->operandStack.back();
+
+    // Take the exact integer path if both operands are integers and the result fits in 64 bits.
+    if (firstOperand.isInteger && secondOperand.isInteger && integerBinaryOperation(name, firstOperand.integer, secondOperand.integer, result.integer)) {
+        result.isInteger = true;
+        result.value = static_cast<double>(result.integer);
+    } else {
+        result.value = pendingOperator.binaryFunction(firstOperand.value, secondOperand.value);
+    }
+    firstOperand = result;
+}
+
+void StreamingEvaluator::updatePeakStackDepth() {
+    this->peakStackDepth = std::max(this->peakStackDepth, this->operandStack.size() + this->operatorStack.size());
+}
@@ -0,0 +1,187 @@
+#ifndef __STREAMING_EVALUATOR
+#define __STREAMING_EVALUATOR
+
+#include "ExpressionCompiler.hpp"
+#include <array>
+#include <istream>
+
+/// @brief Value held by the operand stack of the streaming evaluator.
+/// Integers are kept exactly as long as every operation on them has an exact 64-bit result.
+struct StreamingValue {
+    /// @brief Value rounded to double.
+    double value = 0;
+
+    /// @brief Exact value, only meaningful if isInteger is true.
+    int64_t integer = 0;
+
+    /// @brief Whether the value is an exact integer.
+    bool isInteger = false;
+};
+
+/// @brief Class for evaluating an expression read in chunks, without storing its tokens or its postfix notation.
+/// Tokens are fed to an incremental shunting-yard as soon as they are complete, and every operator leaving the operator stack
+/// is applied to the operand stack right away. Memory use therefore depends on the nesting depth, not on the expression length.
+/// Only a token cut by the end of a chunk is kept until the next chunk arrives.
+/// Evaluators are copyable, so the state reached after a prefix of the input can be saved and resumed later.
+class StreamingEvaluator {
+    public:
+        /// @brief Number of characters read from a stream at once.
+        static constexpr size_t chunkSize = 1 << 16;
+
+        /// @brief Constructor for the streaming evaluator class.
+        /// @param unaryOperatorLookupTable Kernels of the unary operators.
+        /// @param binaryOperatorLookupTable Kernels of the binary operators.
+        /// @param operatorPrecedenceLookupTable Precedence of the built-in operators and functions.
+        /// @param functionLookupTable Codes of the operators, functions and constants (odd = unary, even = binary).
+        /// @param userFunctionLookupTable Functions defined during the session.
+        StreamingEvaluator(
+            const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+            const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable,
+            const std::unordered_map<std::string, int>& operatorPrecedenceLookupTable,
+            const std::unordered_map<std::string, int>& functionLookupTable,
+            const UserFunctionTable& userFunctionLookupTable
+        );
+
+        /// @brief Method for evaluating the whole content of a stream.
+        /// @param input Stream holding the expression. Whitespace (including newlines) is ignored.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if the expression cannot be parsed or evaluated.
+        StreamingValue evaluate(std::istream& input);
+
+        /// @brief Method for feeding the next characters of the expression.
+        /// Complete tokens are parsed and evaluated right away; a token cut by the end of the characters is kept for the next call.
+        /// @param characters Pointer to the characters.
+        /// @param length Number of characters.
+        /// @throws invalid_argument error if the characters cannot be parsed or evaluated.
+        void feed(const char* characters, size_t length);
+
+        /// @brief Method for ending the input and computing the value of the expression.
+        /// @returns Value of the expression.
+        /// @throws invalid_argument error if the expression is incomplete or cannot be evaluated.
+        StreamingValue finish();
+
+        /// @brief Method for discarding the state, so that a new expression can be fed.
+        void reset();
+
+        /// @brief Method for accessing the number of characters fed so far.
+        uint64_t getCharacterCount() const;
+
+        /// @brief Method for accessing the largest number of entries held by the operand and operator stacks at once.
+        size_t getPeakStackDepth() const;
+
+    private:
+        /// @brief Entry of the operator stack.
+        struct PendingOperator {
+            /// @brief Name of the operator (key of the lookup tables), nullptr for '('.
+            const std::string* name;
+
+            /// @brief Precedence of the operator.
+            int precedence;
+
+            /// @brief Whether the operator takes a single operand.
+            bool isUnary;
+
+            /// @brief Kernel of the operator (the one matching isUnary), unused by user functions.
+            UnaryFunction unaryFunction;
+            BinaryFunction binaryFunction;
+
+            /// @brief User function called by the operator, nullptr for built-in operators.
+            const UserFunction* userFunction;
+        };
+
+        /// @brief Entry of the argument count stack, pushed for every '('.
+        struct OpenParenthesis {
+            /// @brief User function called with the parentheses, nullptr for plain parentheses.
+            const UserFunction* userFunction;
+
+            /// @brief Number of arguments found so far.
+            size_t argumentCount;
+        };
+
+        /// @brief Lookup tables owned by the calculator. Pointers keep the evaluator copyable.
+        const std::unordered_map<std::string, UnaryFunction>* unaryOperatorLookupTable;
+        const std::unordered_map<std::string, BinaryFunction>* binaryOperatorLookupTable;
+        const std::unordered_map<std::string, int>* operatorPrecedenceLookupTable;
+        const std::unordered_map<std::string, int>* functionLookupTable;
+        const UserFunctionTable* userFunctionLookupTable;
+
+        /// @brief Single character operators and negation, described once since they make up most tokens.
+        std::array<PendingOperator, 128> characterOperators;
+        PendingOperator negationOperator;
+
+        /// @brief Characters received but not consumed yet (the beginning of a token cut by the end of a chunk).
+        std::string buffer;
+
+        /// @brief Index of the first character of the buffer inside the whole input.
+        uint64_t bufferOffset = 0;
+
+        /// @brief Whether a '-' is a negative sign (true) or the subtraction operator (false), like in PrattParser::parseOperand.
+        bool isNegativeSign = true;
+
+        /// @brief Name of the function whose '(' is expected next, empty otherwise.
+        std::string functionAwaitingParenthesis;
+
+        /// @brief User function named by the previous token, nullptr otherwise.
+        const UserFunction* previousUserFunction = nullptr;
+
+        /// @brief Number of tokens and of parentheses found so far.
+        uint64_t tokenCount = 0, numberOfLeftBrackets = 0, numberOfRightBrackets = 0;
+
+        /// @brief Operand, operator and argument count stacks of the shunting-yard.
+        std::vector<StreamingValue> operandStack;
+        std::vector<PendingOperator> operatorStack;
+        std::vector<OpenParenthesis> parenthesisStack;
+
+        /// @brief Largest combined size of the operand and operator stacks.
+        size_t peakStackDepth = 0;
+
+        /// @brief Private method for parsing the tokens of the buffer.
+        /// @param isEndOfInput Whether no characters follow the buffer.
+        /// @returns Number of characters consumed. The rest of the buffer is an incomplete token.
+        size_t scanTokens(bool isEndOfInput);
+
+        /// @brief Private method for finding the end of the number starting at the given index, mirroring PrattParser::parseNumber().
+        /// @param start Index of the first character of the number.
+        /// @param isEndOfInput Whether no characters follow the buffer.
+        /// @returns Index past the number, or std::string::npos if the number may continue in the next chunk.
+        /// @throws invalid_argument error if the number is malformed.
+        size_t findNumberEnd(size_t start, bool isEndOfInput) const;
+
+        /// @brief Private method for pushing a number or constant to the operand stack.
+        void pushOperand(const StreamingValue& value);
+
+        /// @brief Private method for looking up the kernel and the precedence of an operator or function.
+        /// @param name Name of the operator (key of the function lookup table).
+        /// @param userFunction User function named by the token, nullptr for built-in operators.
+        /// @returns Entry ready to be pushed to the operator stack.
+        PendingOperator describeOperator(const std::string& name, const UserFunction* userFunction) const;
+
+        /// @brief Private method for handling an operator or function token, popping the operators binding at least as tightly first.
+        /// @param pendingOperator Operator to push.
+        void pushOperator(const PendingOperator& pendingOperator);
+
+        /// @brief Private method for handling a prefix operator (negative sign, function), which has no left operand to apply operators to.
+        /// @param pendingOperator Operator to push.
+        void pushPrefixOperator(const PendingOperator& pendingOperator);
+
+        /// @brief Private method for handling a '(' token.
+        void openParenthesis();
+
+        /// @brief Private method for handling a ')' token.
+        void closeParenthesis();
+
+        /// @brief Private method for handling a ',' token.
+        void separateArgument();
+
+        /// @brief Private method for popping the operators above the innermost '(' (or all of them) and applying them.
+        void applyOperatorsUntilParenthesis();
+
+        /// @brief Private method for applying an operator to the operand stack, mirroring Calculator::evaluatePostfixNotation.
+        /// @param pendingOperator Operator to apply.
+        void applyOperator(const PendingOperator& pendingOperator);
+
+        /// @brief Private method for recording the depth of the stacks.
+        void updatePeakStackDepth();
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "TableGenerator.hpp"
+
+#include <cmath>
+#include <thread>
+#include <barrier>
+#include <charconv>
+#include <stdexcept>
+#include <algorithm>
+
+uint64_t TableRange::getPointCount() const {
+    // Throw invalid_argument error if the step cannot reach the stop value.
+    if (!std::isfinite(this->start) || !std::isfinite(this->stop) || !std::isfinite(this->step) || this->step == 0 || (this->stop - this->start) / this->step < 0) {
+        throw std::invalid_argument("RangeError: Step must be non-zero and point from start towards stop.\n");
+    }
+
+    // Count the points, allowing for rounding errors so that stop itself is included (e.g. 0..1 step 0.1).
+    double quotient = (this->stop - this->start) / this->step;
+    return static_cast<uint64_t>(std::floor(quotient + quotient * 1e-12 + 1e-12)) + 1;
+}
+
+TableGenerator::TableGenerator(const CompiledExpression& program, unsigned threadCount) : program(program), threadCount(threadCount) {
+    // Check if the program is a function of exactly one variable.
+    if (program.getVariableNames().size() != 1) throw std::invalid_argument("RangeError: Tables require an expression of exactly one variable.\n");
+
+    // Use all hardware threads by default.
+    if (this->threadCount == 0) this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+}
+
+size_t TableGenerator::formatBlock(const TableRange& range, uint64_t firstPoint, uint64_t lastPoint, char* buffer, double* registers) const {
+    // Initialize pointer to the next free character.
+    char* position = buffer;
+
+    for (uint64_t point = firstPoint; point < lastPoint; point++) {
+        // Compute the point from its index to avoid accumulating rounding errors.
+        double variable = range.start + static_cast<double>(point) * range.step;
+
+        // Evaluate the program. Points outside the domain of an operator evaluate to nan.
+        double result;
+        try {
+            result = this->program.evaluate(&variable, registers);
+        } catch (std::exception&) {
+            result = NAN;
+        }
+
+        // Write the line using the shortest representation that round-trips. The raw kernels may return nan with its sign bit
+        // set (e.g. sqrt(-1) on x86), which to_chars would write as "-nan", so every nan is written as "nan".
+        position = std::to_chars(position, buffer + (lastPoint - firstPoint) * charactersPerPoint, variable).ptr;
+        *position++ = ',';
+        position = std::to_chars(position, buffer + (lastPoint - firstPoint) * charactersPerPoint, std::isnan(result) ? NAN : result).ptr;
+        *position++ = '\n';
+    }
+
+    // Return the number of characters written.
+    return static_cast<size_t>(position - buffer);
+}
+
+uint64_t TableGenerator::generate(const TableRange& range, std::ostream& output) {
+    // Compute the number of points, blocks, and rounds (one block per worker per round).
+    uint64_t pointCount = range.getPointCount();
+    uint64_t blockCount = (pointCount + pointsPerBlock - 1) / pointsPerBlock;
+    uint64_t roundCount = (blockCount + this->threadCount - 1) / this->threadCount;
+
+    // Allocate two sets of buffers: workers fill one set while the other one is written.
+    std::vector<std::vector<char>> buffers[2];
+    std::vector<size_t> lengths[2];
+    for (int set = 0; set < 2; set++) {
+        buffers[set].assign(this->threadCount, std::vector<char>(pointsPerBlock * charactersPerPoint));
+        lengths[set].assign(this->threadCount, 0);
+    }
+
+    // Declare lambda variable to write a full set of buffers in block order.
+    auto writeSet = [&](int set) {
+        for (unsigned worker = 0; worker < this->threadCount; worker++) {
+            output.write(buffers[set][worker].data(), static_cast<std::streamsize>(lengths[set][worker]));
+        }
+    };
+
+    // Start the workers. Every round ends at the barrier, after which the set just filled is written by this thread.
+    std::barrier roundBarrier(static_cast<std::ptrdiff_t>(this->threadCount) + 1);
+    std::vector<std::thread> workers;
+    for (unsigned worker = 0; worker < this->threadCount; worker++) {
+        workers.emplace_back([&, worker]() {
+            std::vector<double> registers(this->program.getRegisterCount());
+            for (uint64_t round = 0; round < roundCount; round++) {
+                // Compute the block assigned to this worker, if there is one left.
+                uint64_t block = round * this->threadCount + worker;
+                uint64_t firstPoint = std::min(block * pointsPerBlock, pointCount);
+                uint64_t lastPoint = std::min(firstPoint + pointsPerBlock, pointCount);
+                lengths[round % 2][worker] = this->formatBlock(range, firstPoint, lastPoint, buffers[round % 2][worker].data(), registers.data());
+                roundBarrier.arrive_and_wait();
+            }
+        });
+    }
+
+    // Write the set filled during the previous round while the workers fill the other one.
+    for (uint64_t round = 0; round < roundCount; round++) {
+        if (round > 0) writeSet(static_cast<int>((round - 1) % 2));
+        roundBarrier.arrive_and_wait();
+    }
+
+    // Wait for the workers, write the last set, and flush once.
+    for (std::thread& worker : workers) worker.join();
+    if (roundCount > 0) writeSet(static_cast<int>((roundCount - 1) % 2));
+    output.flush();
+    return pointCount;
+}
@@ -0,0 +1,68 @@
+#ifndef __TABLE_GENERATOR
+#define __TABLE_GENERATOR
+
+#include "ExpressionCompiler.hpp"
+#include <ostream>
+
+/// @brief Grid of points a single variable is swept over (start, start + step, ..., up to and including stop).
+struct TableRange {
+    /// @brief Name of the swept variable.
+    std::string variableName;
+
+    /// @brief First point of the grid.
+    double start;
+
+    /// @brief Last point of the grid (included if it lies on the grid).
+    double stop;
+
+    /// @brief Distance between two points. Must be non-zero and point from start towards stop.
+    double step;
+
+    /// @brief Method for computing the number of points on the grid.
+    /// @throws invalid_argument error if the step is zero, not finite, or points away from stop.
+    uint64_t getPointCount() const;
+};
+
+/// @brief Class for evaluating a compiled expression of one variable over a grid and streaming "x,f(x)" lines.
+/// The grid is split into fixed-size blocks computed by worker threads, and written in order while the next blocks are computed,
+/// so memory use does not depend on the number of points.
+class TableGenerator {
+    public:
+        /// @brief Constructor for the table generator class.
+        /// @param program Compiled expression of exactly one variable.
+        /// @param threadCount Number of worker threads (0 uses the number of hardware threads).
+        /// @throws invalid_argument error if the program does not have exactly one variable.
+        TableGenerator(const CompiledExpression& program, unsigned threadCount = 0);
+
+        /// @brief Method for evaluating the program over the grid and writing one "x,f(x)" line per point.
+        /// Points outside the domain of an operator are written as nan (or inf for unchecked programs).
+        /// @param range Grid to evaluate the program over.
+        /// @param output Stream receiving the lines.
+        /// @returns Number of lines written.
+        /// @throws invalid_argument error if the range is invalid.
+        uint64_t generate(const TableRange& range, std::ostream& output);
+
+    private:
+        /// @brief Number of points computed by a worker before its buffer is written.
+        static constexpr uint64_t pointsPerBlock = 16384;
+
+        /// @brief Upper bound of the number of characters written per point.
+        static constexpr size_t charactersPerPoint = 64;
+
+        /// @brief Program evaluated at every point.
+        const CompiledExpression& program;
+
+        /// @brief Number of worker threads.
+        unsigned threadCount;
+
+        /// @brief Private method for evaluating one block of points into a character buffer.
+        /// @param range Grid to evaluate the program over.
+        /// @param firstPoint Index of the first point of the block.
+        /// @param lastPoint Index past the last point of the block.
+        /// @param buffer Buffer holding at least (lastPoint - firstPoint) * charactersPerPoint characters.
+        /// @param registers Scratch register file of the worker.
+        /// @returns Number of characters written into the buffer.
+        size_t formatBlock(const TableRange& range, uint64_t firstPoint, uint64_t lastPoint, char* buffer, double* registers) const;
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+/// @brief Pool the calling thread is a worker of (nullptr for threads outside any pool).
+static thread_local const WorkStealingThreadPool* currentPool = nullptr;
+
+/// @brief Index of the calling thread inside currentPool.
+static thread_local size_t currentWorkerIndex = 0;
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned threadCount) {
+    // Use all hardware threads by default.
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // Create one queue per worker, plus the queue shared by threads outside the pool.
+    for (unsigned index = 0; index <= threadCount; index++) this->queues.push_back(std::make_unique<TaskQueue>());
+
+    // Start the workers.
+    for (unsigned index = 0; index < threadCount; index++) this->workers.emplace_back(&WorkStealingThreadPool::runWorker, this, index);
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    // Wake up every worker and wait for them to leave their loop. The flag is set under the sleep mutex, so that no worker can
+    // check it and miss the notification before it waits.
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->isStopping.store(true);
+    }
+    this->sleepCondition.notify_all();
+    for (std::thread& worker : this->workers) worker.join();
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::getSharedPool() {
+    static WorkStealingThreadPool sharedPool;
+    return sharedPool;
+}
+
+unsigned WorkStealingThreadPool::getThreadCount() const {
+    return static_cast<unsigned>(this->workers.size());
+}
+
+size_t WorkStealingThreadPool::getOwnQueueIndex() const {
+    return (currentPool == this) ? currentWorkerIndex : this->workers.size();
+}
+
+void WorkStealingThreadPool::runTask(Task* task) {
+    // Run the function, keeping its exception for the thread waiting on the task.
+    try {
+        (*task->function)();
+    } catch (...) {
+        task->exception = std::current_exception();
+    }
+
+    // Publish the completion last: the task lives on the stack of the waiting thread.
+    task->isDone.store(true, std::memory_order_release);
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::takeTask(size_t ownQueueIndex) {
+    // Take the newest task of the own queue.
+    {
+        std::lock_guard<std::mutex> lock(this->queues[ownQueueIndex]->mutex);
+        if (!this->queues[ownQueueIndex]->tasks.empty()) {
+            Task* task = this->queues[ownQueueIndex]->tasks.back();
+            this->queues[ownQueueIndex]->tasks.pop_back();
+            this->pendingTaskCount.fetch_sub(1);
+            return task;
+        }
+    }
+
+    // Otherwise steal the oldest task of another queue. Old tasks are the largest ones in a fork-join recursion.
+    for (size_t offset = 1; offset < this->queues.size(); offset++) {
+        TaskQueue& queue = *this->queues[(ownQueueIndex + offset) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            Task* task = queue.tasks.front();
+            queue.tasks.pop_front();
+            this->pendingTaskCount.fetch_sub(1);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool WorkStealingThreadPool::reclaimTask(size_t queueIndex, Task* task) {
+    // Search the queue from the back, where the task has most likely been left.
+    std::lock_guard<std::mutex> lock(this->queues[queueIndex]->mutex);
+    std::deque<Task*>& tasks = this->queues[queueIndex]->tasks;
+    auto iterator = std::find(tasks.rbegin(), tasks.rend(), task);
+    if (iterator == tasks.rend()) return false;
+
+    // Remove the task so that nobody else can take it.
+    tasks.erase(std::next(iterator).base());
+    this->pendingTaskCount.fetch_sub(1);
+    return true;
+}
+
+void WorkStealingThreadPool::runWorker(unsigned workerIndex) {
+    // Register the thread as a worker of this pool.
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    while (!this->isStopping.load()) {
+        // Run tasks as long as there are any.
+        Task* task = this->takeTask(workerIndex);
+        if (task != nullptr) {
+            runTask(task);
+            continue;
+        }
+
+        // Sleep until a task is pushed. Tasks are counted under the sleep mutex, so a task pushed after the check wakes the worker.
+        std::unique_lock<std::mutex> lock(this->sleepMutex);
+        this->sleepCondition.wait(lock, [this]() {
+            return this->isStopping.load() || this->pendingTaskCount.load() > 0;
+        });
+    }
+}
+
+void WorkStealingThreadPool::invokeInParallel(const std::function<void()>& first, const std::function<void()>& second) {
+    // Count the task under the sleep mutex, so that a worker either sees it when it checks for tasks or is already waiting for the
+    // notification. Counting it before pushing it keeps the count from going below 0 when a worker takes the task at once.
+    Task task;
+    task.function = &first;
+    size_t ownQueueIndex = this->getOwnQueueIndex();
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->pendingTaskCount.fetch_add(1);
+    }
+
+    // Push the first function to the own queue, where idle workers can steal it.
+    {
+        std::lock_guard<std::mutex> lock(this->queues[ownQueueIndex]->mutex);
+        this->queues[ownQueueIndex]->tasks.push_back(&task);
+    }
+    this->sleepCondition.notify_one();
+
+    // Run the second function on this thread.
+    std::exception_ptr secondException;
+    try {
+        second();
+    } catch (...) {
+        secondException = std::current_exception();
+    }
+
+    // Run the first function too if it has not been stolen. Otherwise help with other tasks until the thief is done.
+    if (this->reclaimTask(ownQueueIndex, &task)) {
+        runTask(&task);
+    } else {
+        while (!task.isDone.load(std::memory_order_acquire)) {
+            Task* otherTask = this->takeTask(ownQueueIndex);
+            (otherTask != nullptr) ? runTask(otherTask) : std::this_thread::yield();
+        }
+    }
+
+    // Rethrow the first exception, if any.
+    if (task.exception) std::rethrow_exception(task.exception);
+    if (secondException) std::rethrow_exception(secondException);
+}
+
+void WorkStealingThreadPool::parallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+    // Process small ranges directly.
+    if (end - begin <= std::max<size_t>(grainSize, 1)) {
+        if (begin < end) body(begin, end);
+        return;
+    }
+
+    // Split the range in halves, letting other workers steal the first half.
+    size_t middle = begin + (end - begin) / 2;
+    this->invokeInParallel(
+        [&]() { this->parallelFor(begin, middle, grainSize, body); },
+        [&]() { this->parallelFor(middle, end, grainSize, body); }
+    );
+}
@@ -0,0 +1,114 @@
+#ifndef __THREAD_POOL
+#define __THREAD_POOL
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+/// @brief Fork-join thread pool where every worker owns a deque of tasks.
+/// Workers push and pop their own tasks at the back (newest first, which keeps the working set small) and steal
+/// from the front of the other deques when they run out of work. Threads waiting for a stolen task keep running
+/// other tasks instead of blocking, so nested parallelism cannot deadlock.
+class WorkStealingThreadPool {
+    public:
+        /// @brief Constructor for the work-stealing thread pool class.
+        /// @param threadCount Number of worker threads (0 uses the number of hardware threads).
+        explicit WorkStealingThreadPool(unsigned threadCount = 0);
+
+        /// @brief Destructor for the work-stealing thread pool class. Waits for the workers to finish.
+        ~WorkStealingThreadPool();
+
+        WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+        WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+        /// @brief Method for accessing the pool shared by the whole process.
+        /// @returns Reference to the shared pool, created on first use with one worker per hardware thread.
+        static WorkStealingThreadPool& getSharedPool();
+
+        /// @brief Method for running two functions, possibly in parallel, and waiting for both.
+        /// The second function runs on the calling thread while the first one may be stolen.
+        /// @param first First function.
+        /// @param second Second function.
+        /// @throws The first exception thrown by either function.
+        void invokeInParallel(const std::function<void()>& first, const std::function<void()>& second);
+
+        /// @brief Method for running a function over a range split into chunks, by recursively halving the range.
+        /// @param begin First index of the range.
+        /// @param end Index past the last index of the range.
+        /// @param grainSize Largest chunk processed without splitting further.
+        /// @param body Function called with [chunkBegin, chunkEnd) for every chunk.
+        /// @throws The first exception thrown by the body.
+        void parallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+        /// @brief Method for accessing the number of worker threads.
+        unsigned getThreadCount() const;
+
+    private:
+        /// @brief Task pushed by invokeInParallel(), owned by the stack frame of the caller.
+        struct Task {
+            /// @brief Function to run.
+            const std::function<void()>* function;
+
+            /// @brief Set once the function has returned (or thrown).
+            std::atomic<bool> isDone{false};
+
+            /// @brief Exception thrown by the function, if any.
+            std::exception_ptr exception;
+        };
+
+        /// @brief Deque of tasks owned by one worker (or shared by external threads, for the last deque).
+        struct TaskQueue {
+            /// @brief Mutex guarding the deque.
+            std::mutex mutex;
+
+            /// @brief Tasks waiting to be run.
+            std::deque<Task*> tasks;
+        };
+
+        /// @brief Task queues, one per worker followed by one for threads that do not belong to the pool.
+        std::vector<std::unique_ptr<TaskQueue>> queues;
+
+        /// @brief Worker threads.
+        std::vector<std::thread> workers;
+
+        /// @brief Number of tasks pushed and not yet taken, used to let idle workers sleep. Only increased under sleepMutex.
+        std::atomic<size_t> pendingTaskCount{0};
+
+        /// @brief Set (under sleepMutex) when the pool is being destroyed.
+        std::atomic<bool> isStopping{false};
+
+        /// @brief Mutex and condition variable used to wake sleeping workers.
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+
+        /// @brief Private method for the main loop of a worker.
+        /// @param workerIndex Index of the worker.
+        void runWorker(unsigned workerIndex);
+
+        /// @brief Private method for finding the index of the queue owned by the calling thread.
+        /// @returns The worker index, or the index of the shared queue for threads outside the pool.
+        size_t getOwnQueueIndex() const;
+
+        /// @brief Private method for taking a task, first from the given queue (newest first), then from the others (oldest first).
+        /// @param ownQueueIndex Index of the queue owned by the caller.
+        /// @returns The task, or nullptr if every queue is empty.
+        Task* takeTask(size_t ownQueueIndex);
+
+        /// @brief Private method for removing a specific task from the back of a queue if nobody stole it yet.
+        /// @param queueIndex Index of the queue the task has been pushed to.
+        /// @param task Task to remove.
+        /// @returns true if the task has been removed (the caller runs it), false if it has been stolen.
+        bool reclaimTask(size_t queueIndex, Task* task);
+
+        /// @brief Private method for running a task and recording its completion.
+        /// @param task Task to run.
+        static void runTask(Task* task);
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "VectorEvaluator.hpp"
+#include "VectorKernels.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+VectorEvaluator::VectorEvaluator(
+    const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+    const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable
+) : unaryOperatorLookupTable(unaryOperatorLookupTable), binaryOperatorLookupTable(binaryOperatorLookupTable) {}
+
+std::vector<double> VectorEvaluator::evaluate(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<std::vector<double>>& variableValues) {
+    // Bind the variable slots to the given values.
+    std::vector<const std::vector<double>*> boundVariables;
+    boundVariables.reserve(variableValues.size());
+    for (const std::vector<double>& value : variableValues) boundVariables.push_back(&value);
+
+    Operand result = this->evaluateInstructions(postfixProgram, boundVariables);
+    return (result.variable != nullptr) ? *result.variable : std::move(result.temporary);
+}
+
+VectorEvaluator::Operand VectorEvaluator::evaluateInstructions(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<const std::vector<double>*>& boundVariables) {
+    // Walk the bytecode like Calculator::evaluatePostfixNotation. The parser only emits well-formed bytecode.
+    std::vector<Operand> operandStack;
+    for (const PostfixInstruction& instruction : postfixProgram) {
+        switch (instruction.operationCode) {
+            case PostfixOperationCode::pushNumber:
+                operandStack.push_back({nullptr, {instruction.number}});
+                break;
+
+            case PostfixOperationCode::pushVariable:
+                // Refer to the elements of the variable instead of copying them.
+                operandStack.push_back({boundVariables.at(instruction.variableSlot), {}});
+                break;
+
+            case PostfixOperationCode::buildVector: {
+                // Gather the elements of the literal, each of which must be a scalar.
+                Operand literal;
+                literal.temporary.resize(instruction.elementCount);
+                for (size_t element = 0; element < instruction.elementCount; element++) {
+                    const std::vector<double>& elements = operandStack[operandStack.size() - instruction.elementCount + element].getElements();
+                    if (elements.size() != 1) throw std::invalid_argument("EvalError: Found vector inside a vector literal (expected scalar elements).\n");
+                    literal.temporary[element] = elements[0];
+                }
+                operandStack.resize(operandStack.size() - instruction.elementCount);
+                operandStack.push_back(std::move(literal));
+                break;
+            }
+
+            case PostfixOperationCode::applyUnaryOperator: {
+                Operand result = this->applyUnaryOperator(instruction.name, operandStack.back());
+                operandStack.back() = std::move(result);
+                break;
+            }
+
+            case PostfixOperationCode::applyBinaryOperator: {
+                Operand secondOperand = std::move(operandStack.back());
+                operandStack.pop_back();
+                Operand result = this->applyBinaryOperator(instruction.name, operandStack.back(), secondOperand);
+                operandStack.back() = std::move(result);
+                break;
+            }
+
+            case PostfixOperationCode::callUserFunction: {
+                // Evaluate the body of the function with its parameters bound to the arguments.
+                size_t parameterCount = instruction.userFunction->parameterNames.size();
+                std::vector<Operand> arguments(std::make_move_iterator(operandStack.end() - parameterCount), std::make_move_iterator(operandStack.end()));
+                operandStack.resize(operandStack.size() - parameterCount);
+                std::vector<const std::vector<double>*> boundArguments;
+                for (const Operand& argument : arguments) boundArguments.push_back(&argument.getElements());
+
+                // Copy the result if it refers to an argument, which goes out of scope.
+                Operand result = this->evaluateInstructions(instruction.userFunction->postfixBody, boundArguments);
+                if (result.variable != nullptr) result = {nullptr, *result.variable};
+                operandStack.push_back(std::move(result));
+                break;
+            }
+        }
+    }
+    return std::move(operandStack.back());
+}
+
+VectorEvaluator::Operand VectorEvaluator::applyUnaryOperator(const std::string& name, Operand& operand) const {
+    // Write over the operand if it is a temporary, otherwise allocate the result once.
+    // Moving a vector keeps its buffer, so the operand elements stay where they are.
+    const std::vector<double>& elements = operand.getElements();
+    const double* operandData = elements.data();
+    size_t count = elements.size();
+    Operand result;
+    if (operand.variable == nullptr) result.temporary = std::move(operand.temporary);
+    else result.temporary.resize(count);
+
+    applyUnaryElementwise(findVectorKernel(name), this->unaryOperatorLookupTable.at(name), operandData, result.temporary.data(), count);
+    return result;
+}
+
+VectorEvaluator::Operand VectorEvaluator::applyBinaryOperator(const std::string& name, Operand& firstOperand, Operand& secondOperand) const {
+    const std::vector<double>& firstElements = firstOperand.getElements();
+    const std::vector<double>& secondElements = secondOperand.getElements();
+
+    // Broadcast single-element operands to the length of the other one.
+    size_t count = std::max(firstElements.size(), secondElements.size());
+    bool isFirstBroadcast = firstElements.size() == 1 && count != 1, isSecondBroadcast = secondElements.size() == 1 && count != 1;
+    if ((firstElements.size() != count && !isFirstBroadcast) || (secondElements.size() != count && !isSecondBroadcast)) {
+        std::string errorMessage = "EvalError: Cannot apply " + name;
+        errorMessage += " element-wise to vectors of lengths " + std::to_string(firstElements.size()) + " and ";
+        errorMessage += std::to_string(secondElements.size()) + ".\n";
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Write over a temporary operand of the result length, otherwise allocate the result once.
+    // Moving a vector keeps its buffer, so the operand elements stay where they are.
+    const double* firstData = firstElements.data();
+    const double* secondData = secondElements.data();
+    Operand result;
+    if (firstOperand.variable == nullptr && !isFirstBroadcast) result.temporary = std::move(firstOperand.temporary);
+    else if (secondOperand.variable == nullptr && !isSecondBroadcast) result.temporary = std::move(secondOperand.temporary);
+    else result.temporary.resize(count);
+
+    applyBinaryElementwise(findVectorKernel(name), this->binaryOperatorLookupTable.at(name), firstData, isFirstBroadcast, secondData, isSecondBroadcast, result.temporary.data(), count);
+    return result;
+}
@@ -0,0 +1,65 @@
+#ifndef __VECTOR_EVALUATOR
+#define __VECTOR_EVALUATOR
+
+#include "ExpressionCompiler.hpp"
+
+/// @brief Evaluator applying postfix bytecode element-wise to vectors, e.g. "[1, 2, 3.5]^2 + x" for a vector x.
+/// Every operator of the lookup tables applies to each element, and single-element values (numbers, constants)
+/// are broadcast to the length of the other operand. Each operation costs one dispatch for the whole vector and
+/// writes its result into a single allocation, reused in place when an operand is a temporary of the same length.
+/// Elements are doubles: unlike the interactive scalar path, there is no exact integer arithmetic.
+class VectorEvaluator {
+    public:
+        /// @brief Constructor for the vector evaluator class.
+        /// @param unaryOperatorLookupTable Table mapping unary operator names to their functions.
+        /// @param binaryOperatorLookupTable Table mapping binary operator names to their functions.
+        VectorEvaluator(
+            const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable,
+            const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable
+        );
+
+        /// @brief Method for evaluating bytecode element-wise.
+        /// @param postfixProgram Bytecode emitted by the parser.
+        /// @param variableValues Values of the variables, ordered by their slot (single-element vectors for scalars).
+        /// @returns Elements of the result (a single element if every operand is a scalar).
+        /// @throws invalid_argument error if the lengths of two operands differ, or if an operator is called outside its domain.
+        std::vector<double> evaluate(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<std::vector<double>>& variableValues);
+
+    private:
+        /// @brief Value on the operand stack, either referring to a variable or owning its elements.
+        struct Operand {
+            /// @brief Elements of the variable the operand refers to (nullptr for temporaries).
+            const std::vector<double>* variable = nullptr;
+
+            /// @brief Elements owned by a temporary.
+            std::vector<double> temporary;
+
+            /// @brief Method for accessing the elements.
+            const std::vector<double>& getElements() const { return (this->variable != nullptr) ? *this->variable : this->temporary; }
+        };
+
+        const std::unordered_map<std::string, UnaryFunction>& unaryOperatorLookupTable;
+        const std::unordered_map<std::string, BinaryFunction>& binaryOperatorLookupTable;
+
+        /// @brief Private method for evaluating bytecode with variables bound to the given elements.
+        /// @param postfixProgram Bytecode to evaluate.
+        /// @param boundVariables Elements the variable slots of the bytecode refer to.
+        /// @returns The result.
+        Operand evaluateInstructions(const std::vector<PostfixInstruction>& postfixProgram, const std::vector<const std::vector<double>*>& boundVariables);
+
+        /// @brief Private method for applying a unary operator element-wise.
+        /// @param name Operator name.
+        /// @param operand Operand, overwritten if it is a temporary.
+        /// @returns The result.
+        Operand applyUnaryOperator(const std::string& name, Operand& operand) const;
+
+        /// @brief Private method for applying a binary operator element-wise, broadcasting single-element operands.
+        /// @param name Operator name.
+        /// @param firstOperand First operand, overwritten if it is a temporary of the result length.
+        /// @param secondOperand Second operand, overwritten if it is a temporary of the result length.
+        /// @returns The result.
+        /// @throws invalid_argument error if the lengths of the operands differ and neither has a single element.
+        Operand applyBinaryOperator(const std::string& name, Operand& firstOperand, Operand& secondOperand) const;
+};
+
+#endif
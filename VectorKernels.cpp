@@ -0,0 +1,223 @@
+#include "VectorKernels.hpp"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define VECTOR_KERNELS_SSE2
+#if defined(__GNUC__)
+#define VECTOR_KERNELS_AVX
+#endif
+#endif
+
+namespace {
+
+/// @brief Function for applying a kernel to one element.
+template <VectorKernel kernel>
+inline double applyScalar(double first, double second) {
+    if constexpr (kernel == VectorKernel::add) return first + second;
+    if constexpr (kernel == VectorKernel::subtract) return first - second;
+    if constexpr (kernel == VectorKernel::multiply) return first * second;
+    if constexpr (kernel == VectorKernel::divide) return first / second;
+    if constexpr (kernel == VectorKernel::negate) return -first;
+    if constexpr (kernel == VectorKernel::absolute) return std::fabs(first);
+    return std::sqrt(first);
+}
+
+#ifdef VECTOR_KERNELS_SSE2
+/// @brief Function for applying a kernel to 2 elements.
+template <VectorKernel kernel>
+inline __m128d applySse2(__m128d first, __m128d second) {
+    if constexpr (kernel == VectorKernel::add) return _mm_add_pd(first, second);
+    if constexpr (kernel == VectorKernel::subtract) return _mm_sub_pd(first, second);
+    if constexpr (kernel == VectorKernel::multiply) return _mm_mul_pd(first, second);
+    if constexpr (kernel == VectorKernel::divide) return _mm_div_pd(first, second);
+    if constexpr (kernel == VectorKernel::negate) return _mm_xor_pd(first, _mm_set1_pd(-0.0));
+    if constexpr (kernel == VectorKernel::absolute) return _mm_andnot_pd(_mm_set1_pd(-0.0), first);
+    return _mm_sqrt_pd(first);
+}
+#endif
+
+#ifdef VECTOR_KERNELS_AVX
+/// @brief Function for applying a kernel to 4 elements.
+template <VectorKernel kernel>
+__attribute__((target("avx"))) inline __m256d applyAvx(__m256d first, __m256d second) {
+    if constexpr (kernel == VectorKernel::add) return _mm256_add_pd(first, second);
+    if constexpr (kernel == VectorKernel::subtract) return _mm256_sub_pd(first, second);
+    if constexpr (kernel == VectorKernel::multiply) return _mm256_mul_pd(first, second);
+    if constexpr (kernel == VectorKernel::divide) return _mm256_div_pd(first, second);
+    if constexpr (kernel == VectorKernel::negate) return _mm256_xor_pd(first, _mm256_set1_pd(-0.0));
+    if constexpr (kernel == VectorKernel::absolute) return _mm256_andnot_pd(_mm256_set1_pd(-0.0), first);
+    return _mm256_sqrt_pd(first);
+}
+
+/// @brief Function for applying a kernel 4 elements at a time.
+/// @returns Index of the first element left to the narrower loops.
+template <VectorKernel kernel>
+__attribute__((target("avx"))) size_t applyAvxBlocks(const double* first, bool isFirstBroadcast, const double* second, bool isSecondBroadcast, double* result, size_t count) {
+    __m256d firstBroadcast = _mm256_set1_pd(*first), secondBroadcast = _mm256_set1_pd(*second);
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        __m256d firstBlock = isFirstBroadcast ? firstBroadcast : _mm256_loadu_pd(first + index);
+        __m256d secondBlock = isSecondBroadcast ? secondBroadcast : _mm256_loadu_pd(second + index);
+        _mm256_storeu_pd(result + index, applyAvx<kernel>(firstBlock, secondBlock));
+    }
+    return index;
+}
+
+/// @brief Function for evaluating a polynomial with Estrin's scheme, 4 elements at a time.
+/// @returns Index of the first element left to the narrower loops.
+__attribute__((target("avx"))) size_t evaluatePolynomialAvxBlocks(const double* coefficients, size_t coefficientCount, const double* operand, double* result, size_t count) {
+    __m256d terms[(maximumPolynomialDegree + 2) / 2];
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        // Combine the coefficients in pairs, then the pairs of terms with x^2, x^4, ... until a single term is left.
+        __m256d x = _mm256_loadu_pd(operand + index), power = _mm256_mul_pd(x, x);
+        size_t termCount = 0;
+        for (size_t coefficient = 0; coefficient < coefficientCount; coefficient += 2) {
+            terms[termCount] = _mm256_set1_pd(coefficients[coefficient]);
+            if (coefficient + 1 < coefficientCount) terms[termCount] = _mm256_add_pd(terms[termCount], _mm256_mul_pd(_mm256_set1_pd(coefficients[coefficient + 1]), x));
+            termCount++;
+        }
+        while (termCount > 1) {
+            size_t nextTermCount = 0;
+            for (size_t term = 0; term < termCount; term += 2) {
+                terms[nextTermCount++] = (term + 1 < termCount) ? _mm256_add_pd(terms[term], _mm256_mul_pd(terms[term + 1], power)) : terms[term];
+            }
+            termCount = nextTermCount;
+            power = _mm256_mul_pd(power, power);
+        }
+        _mm256_storeu_pd(result + index, terms[0]);
+    }
+    return index;
+}
+
+/// @brief Whether the processor supports AVX, checked once.
+const bool isAvxSupported = __builtin_cpu_supports("avx");
+#endif
+
+/// @brief Function for applying a kernel with the widest available instructions.
+/// Unary kernels ignore the second operand, which then points at the first one.
+template <VectorKernel kernel>
+void applyKernel(const double* first, bool isFirstBroadcast, const double* second, bool isSecondBroadcast, double* result, size_t count) {
+    if (count == 0) return;
+    size_t index = 0;
+#if defined(VECTOR_KERNELS_AVX)
+    if (isAvxSupported) index = applyAvxBlocks<kernel>(first, isFirstBroadcast, second, isSecondBroadcast, result, count);
+#endif
+#if defined(VECTOR_KERNELS_SSE2)
+    __m128d firstBroadcast = _mm_set1_pd(*first), secondBroadcast = _mm_set1_pd(*second);
+    for (; index + 2 <= count; index += 2) {
+        __m128d firstBlock = isFirstBroadcast ? firstBroadcast : _mm_loadu_pd(first + index);
+        __m128d secondBlock = isSecondBroadcast ? secondBroadcast : _mm_loadu_pd(second + index);
+        _mm_storeu_pd(result + index, applySse2<kernel>(firstBlock, secondBlock));
+    }
+#endif
+
+    // Apply the kernel to the remaining elements one at a time.
+    for (; index < count; index++) {
+        result[index] = applyScalar<kernel>(first[isFirstBroadcast ? 0 : index], second[isSecondBroadcast ? 0 : index]);
+    }
+}
+
+/// @brief Overloads of the lane operations used by evaluateEstrin, for scalars and SSE2 blocks.
+inline double broadcastLanes(double value, double) { return value; }
+inline double addLanes(double first, double second) { return first + second; }
+inline double multiplyLanes(double first, double second) { return first * second; }
+#ifdef VECTOR_KERNELS_SSE2
+inline __m128d broadcastLanes(double value, __m128d) { return _mm_set1_pd(value); }
+inline __m128d addLanes(__m128d first, __m128d second) { return _mm_add_pd(first, second); }
+inline __m128d multiplyLanes(__m128d first, __m128d second) { return _mm_mul_pd(first, second); }
+#endif
+
+/// @brief Function for evaluating a polynomial with Estrin's scheme on one scalar or SSE2 block.
+template <typename Lanes>
+inline Lanes evaluateEstrin(const double* coefficients, size_t coefficientCount, Lanes x) {
+    // Combine the coefficients in pairs, then the pairs of terms with x^2, x^4, ... until a single term is left.
+    Lanes terms[(maximumPolynomialDegree + 2) / 2];
+    Lanes power = multiplyLanes(x, x);
+    size_t termCount = 0;
+    for (size_t coefficient = 0; coefficient < coefficientCount; coefficient += 2) {
+        terms[termCount] = broadcastLanes(coefficients[coefficient], x);
+        if (coefficient + 1 < coefficientCount) terms[termCount] = addLanes(terms[termCount], multiplyLanes(broadcastLanes(coefficients[coefficient + 1], x), x));
+        termCount++;
+    }
+    while (termCount > 1) {
+        size_t nextTermCount = 0;
+        for (size_t term = 0; term < termCount; term += 2) {
+            terms[nextTermCount++] = (term + 1 < termCount) ? addLanes(terms[term], multiplyLanes(terms[term + 1], power)) : terms[term];
+        }
+        termCount = nextTermCount;
+        power = multiplyLanes(power, power);
+    }
+    return terms[0];
+}
+
+/// @brief Function for checking whether the operands are inside the domain of the kernel, so that it matches the scalar function.
+/// Division requires nonzero denominators and sqrt positive operands (nan fails both tests).
+bool isInsideDomain(VectorKernel kernel, const double* operand, size_t count) {
+    if (kernel != VectorKernel::divide && kernel != VectorKernel::squareRoot) return true;
+    bool isInside = true;
+    for (size_t index = 0; index < count; index++) {
+        isInside &= (kernel == VectorKernel::divide) ? (operand[index] != 0) : (operand[index] > 0);
+    }
+    return isInside;
+}
+
+}
+
+VectorKernel findVectorKernel(const std::string& name) {
+    if (name == "+") return VectorKernel::add;
+    if (name == "-") return VectorKernel::subtract;
+    if (name == "*") return VectorKernel::multiply;
+    if (name == "/") return VectorKernel::divide;
+    if (name == "neg") return VectorKernel::negate;
+    if (name == "abs") return VectorKernel::absolute;
+    if (name == "sqrt") return VectorKernel::squareRoot;
+    return VectorKernel::none;
+}
+
+void applyUnaryElementwise(VectorKernel kernel, UnaryFunction function, const double* operand, double* result, size_t count) {
+    // Take the SIMD path if the operator has a kernel and every element is inside its domain.
+    if (isInsideDomain(kernel, operand, count)) {
+        switch (kernel) {
+            case VectorKernel::negate: applyKernel<VectorKernel::negate>(operand, false, operand, false, result, count); return;
+            case VectorKernel::absolute: applyKernel<VectorKernel::absolute>(operand, false, operand, false, result, count); return;
+            case VectorKernel::squareRoot: applyKernel<VectorKernel::squareRoot>(operand, false, operand, false, result, count); return;
+            default: break;
+        }
+    }
+
+    // Call the function of the operator on every element.
+    for (size_t index = 0; index < count; index++) result[index] = function(operand[index]);
+}
+
+void applyBinaryElementwise(VectorKernel kernel, BinaryFunction function, const double* firstOperand, bool isFirstBroadcast, const double* secondOperand, bool isSecondBroadcast, double* result, size_t count) {
+    // Take the SIMD path if the operator has a kernel and every denominator is nonzero.
+    if (isInsideDomain(kernel, secondOperand, isSecondBroadcast ? 1 : count)) {
+        switch (kernel) {
+            case VectorKernel::add: applyKernel<VectorKernel::add>(firstOperand, isFirstBroadcast, secondOperand, isSecondBroadcast, result, count); return;
+            case VectorKernel::subtract: applyKernel<VectorKernel::subtract>(firstOperand, isFirstBroadcast, secondOperand, isSecondBroadcast, result, count); return;
+            case VectorKernel::multiply: applyKernel<VectorKernel::multiply>(firstOperand, isFirstBroadcast, secondOperand, isSecondBroadcast, result, count); return;
+            case VectorKernel::divide: applyKernel<VectorKernel::divide>(firstOperand, isFirstBroadcast, secondOperand, isSecondBroadcast, result, count); return;
+            default: break;
+        }
+    }
+
+    // Call the function of the operator on every pair of elements.
+    for (size_t index = 0; index < count; index++) {
+        result[index] = function(firstOperand[isFirstBroadcast ? 0 : index], secondOperand[isSecondBroadcast ? 0 : index]);
+    }
+}
+
+void evaluatePolynomialElementwise(const double* coefficients, size_t coefficientCount, const double* operand, double* result, size_t count) {
+    // Evaluate the elements with the widest available instructions, then the remaining ones one at a time.
+    size_t index = 0;
+#if defined(VECTOR_KERNELS_AVX)
+    if (isAvxSupported) index = evaluatePolynomialAvxBlocks(coefficients, coefficientCount, operand, result, count);
+#endif
+#if defined(VECTOR_KERNELS_SSE2)
+    for (; index + 2 <= count; index += 2) _mm_storeu_pd(result + index, evaluateEstrin(coefficients, coefficientCount, _mm_loadu_pd(operand + index)));
+#endif
+    for (; index < count; index++) result[index] = evaluateEstrin(coefficients, coefficientCount, operand[index]);
+}
@@ -0,0 +1,54 @@
+#ifndef __VECTOR_KERNELS
+#define __VECTOR_KERNELS
+
+#include "ExpressionCompiler.hpp"
+
+/// Kernels applying the operators of the lookup tables element-wise to arrays of doubles, with scalar broadcasting.
+/// The arithmetic operators ('+', '-', '*', '/', neg, abs, sqrt) run 4 elements at a time with AVX when the processor
+/// supports it (checked once at run time), and 2 at a time with SSE2 otherwise. Every other operator calls the function
+/// of its lookup table once per element. '/' and sqrt only take the fast path when no element is outside their domain,
+/// so domain errors are still reported (or produce nan / inf) exactly like the scalar function does.
+
+/// @brief Highest degree of the polynomials evaluated by evaluatePolynomialElementwise().
+constexpr size_t maximumPolynomialDegree = 32;
+
+/// @brief Operators with a SIMD kernel.
+enum class VectorKernel : uint8_t { none, add, subtract, multiply, divide, negate, absolute, squareRoot };
+
+/// @brief Function for finding the SIMD kernel of an operator.
+/// @param name Operator name, e.g. "+" or "sqrt".
+/// @returns The kernel, or VectorKernel::none if the operator is applied one element at a time.
+VectorKernel findVectorKernel(const std::string& name);
+
+/// @brief Function for applying a unary operator element-wise.
+/// @param kernel SIMD kernel of the operator (VectorKernel::none to call function on every element).
+/// @param function Function of the operator, called for the elements the kernel does not handle.
+/// @param operand Pointer to the operand elements.
+/// @param result Pointer to the result elements (may be equal to operand).
+/// @param count Number of elements.
+/// @throws invalid_argument error if function throws on an element.
+void applyUnaryElementwise(VectorKernel kernel, UnaryFunction function, const double* operand, double* result, size_t count);
+
+/// @brief Function for applying a binary operator element-wise, broadcasting single-element operands.
+/// @param kernel SIMD kernel of the operator (VectorKernel::none to call function on every element).
+/// @param function Function of the operator, called for the elements the kernel does not handle.
+/// @param firstOperand Pointer to the first operand elements.
+/// @param isFirstBroadcast Whether the first operand is a single element used at every position.
+/// @param secondOperand Pointer to the second operand elements.
+/// @param isSecondBroadcast Whether the second operand is a single element used at every position.
+/// @param result Pointer to the result elements (may be equal to a non-broadcast operand).
+/// @param count Number of elements.
+/// @throws invalid_argument error if function throws on an element.
+void applyBinaryElementwise(VectorKernel kernel, BinaryFunction function, const double* firstOperand, bool isFirstBroadcast, const double* secondOperand, bool isSecondBroadcast, double* result, size_t count);
+
+/// @brief Function for evaluating a polynomial element-wise with Estrin's scheme.
+/// Pairs of coefficients are combined as c[2i] + c[2i+1]*x, then pairs of those with x^2, x^4, ..., which shortens the chain
+/// of dependent operations from the degree (Horner's scheme) to its logarithm. Rounding may differ slightly from Horner's scheme.
+/// @param coefficients Pointer to the coefficients, lowest degree first.
+/// @param coefficientCount Number of coefficients, between 1 and maximumPolynomialDegree + 1.
+/// @param operand Pointer to the operand elements.
+/// @param result Pointer to the result elements (may be equal to operand).
+/// @param count Number of elements.
+void evaluatePolynomialElementwise(const double* coefficients, size_t coefficientCount, const double* operand, double* result, size_t count);
+
+#endif
@@ -0,0 +1,63 @@
+// Benchmark for the parallel evaluation of long associative chains.
+// Compiles a sum of one million terms "sin(k*x)", then evaluates it with thread pools of 1, 2, 4, ... hardware threads,
+// and compares the compensated parallel result with a naive left-to-right sum and a long double reference.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. benchmarks/AssociativeReductionBenchmark.cpp $(ls *.cpp | grep -v main.cpp) -o AssociativeReductionBenchmark
+// Usage:
+//     ./AssociativeReductionBenchmark [termCount] [repetitions]
+
+#include "Calculator.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int main(int argc, char** argv) {
+    size_t termCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+    double x = 0.3;
+
+    // Build the expression along with the naive and the reference sums of its terms.
+    std::string expression;
+    double naiveSum = 0;
+    long double referenceSum = 0;
+    for (size_t k = 1; k <= termCount; k++) {
+        if (k > 1) expression += '+';
+        expression += "sin(" + std::to_string(k) + "*x)";
+        double term = std::sin(static_cast<double>(k) * x);
+        naiveSum += term;
+        referenceSum += term;
+    }
+
+    // Compile the expression once.
+    Calculator calculator;
+    auto compileStart = std::chrono::steady_clock::now();
+    CompiledExpression program = calculator.compileExpression(expression, {"x"}, EvaluationMode::unchecked);
+    double compileSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - compileStart).count();
+    std::printf("%zu terms, compiled in %.3f s, %zu parallel reduction terms\n", termCount, compileSeconds, program.getStatistics().parallelReductionTerms);
+
+    // Evaluate with an increasing number of threads, keeping the best time of every pool size.
+    std::vector<double> registers(program.getRegisterCount());
+    unsigned hardwareThreadCount = std::max(1u, std::thread::hardware_concurrency());
+    double result = 0, singleThreadSeconds = 0;
+    for (unsigned threadCount = 1; threadCount <= hardwareThreadCount; threadCount *= 2) {
+        WorkStealingThreadPool pool(threadCount);
+        double bestSeconds = INFINITY;
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            auto start = std::chrono::steady_clock::now();
+            result = program.evaluate(&x, registers.data(), pool);
+            bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        if (threadCount == 1) singleThreadSeconds = bestSeconds;
+        std::printf("%3u thread(s): %8.3f ms, speedup %.2fx\n", threadCount, bestSeconds * 1e3, singleThreadSeconds / bestSeconds);
+    }
+
+    // Compare the accuracy of the compensated and the naive sums.
+    std::printf("compensated: %.17g (error %.3g)\n", result, static_cast<double>(std::fabs(result - referenceSum)));
+    std::printf("naive:       %.17g (error %.3g)\n", naiveSum, static_cast<double>(std::fabs(naiveSum - referenceSum)));
+    return 0;
+}
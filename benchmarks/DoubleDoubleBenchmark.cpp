@@ -0,0 +1,151 @@
+// Benchmark for the double-double evaluation mode (see DoubleDouble.hpp).
+// For every double-double operator, draws random double-double operands over a typical range and reports the largest relative
+// error, in bits, against a __float128 reference (113 bits, computed with libquadmath). Then times a few expressions evaluated
+// element-wise in double-double (Calculator::evaluateExtendedPrecision()), element-wise in double (Calculator::evaluateElementwise())
+// and by a compiled program on blocks of rows (CompiledExpression::evaluateBlock()), and reports the slowdown of double-double.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. benchmarks/DoubleDoubleBenchmark.cpp $(ls *.cpp | grep -v main.cpp) -lquadmath -o DoubleDoubleBenchmark
+// Usage:
+//     ./DoubleDoubleBenchmark [sampleCount] [rowCount] [repetitions]
+
+#include "Calculator.hpp"
+
+#include <quadmath.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+/// @brief Operator benchmarked, with the range of its operands and its reference.
+struct BenchmarkedOperator {
+    const char* name;
+    ExtendedUnaryFunction unaryFunction;
+    ExtendedBinaryFunction binaryFunction;
+    __float128 (*unaryReference)(__float128);
+    __float128 (*binaryReference)(__float128, __float128);
+    double firstStart, firstStop, secondStart, secondStop;
+};
+
+static __float128 addReference(__float128 first, __float128 second) { return first + second; }
+static __float128 subtractReference(__float128 first, __float128 second) { return first - second; }
+static __float128 multiplyReference(__float128 first, __float128 second) { return first * second; }
+static __float128 divideReference(__float128 first, __float128 second) { return first / second; }
+static __float128 secantReference(__float128 angle) { return 1 / cosq(angle); }
+static __float128 cotangentReference(__float128 angle) { return 1 / tanq(angle); }
+
+/// @brief Function for drawing a double-double uniformly over [start, stop), with a random low part.
+static DoubleDouble drawOperand(std::mt19937_64& generator, double start, double stop) {
+    std::uniform_real_distribution<double> distribution(start, stop), fraction(-0.5, 0.5);
+    double high = distribution(generator);
+    return extendedAdd({high, 0}, {std::ldexp(fraction(generator), std::ilogb(high) - 52), 0});
+}
+
+/// @brief Function for measuring the best time of a few repetitions of a call.
+template <typename Call>
+static double measureSeconds(int repetitions, Call call) {
+    double bestSeconds = INFINITY;
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        auto start = std::chrono::steady_clock::now();
+        call();
+        bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return bestSeconds;
+}
+
+int main(int argc, char** argv) {
+    size_t sampleCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t rowCount = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1 << 16;
+    int repetitions = (argc > 3) ? std::atoi(argv[3]) : 5;
+
+    const BenchmarkedOperator operators[] = {
+        {"+", nullptr, extendedAdd, nullptr, addReference, -1e3, 1e3, -1e3, 1e3},
+        {"-", nullptr, extendedSubtract, nullptr, subtractReference, 0.5, 2, 0.5, 2},
+        {"*", nullptr, extendedMultiply, nullptr, multiplyReference, -1e3, 1e3, -1e3, 1e3},
+        {"/", nullptr, extendedDivide, nullptr, divideReference, -1e3, 1e3, 1e-3, 1e3},
+        {"^", nullptr, extendedPower, nullptr, powq, 0.1, 10, -20, 20},
+        {"%", nullptr, extendedModulo, nullptr, fmodq, 0, 1e3, 0.5, 10},
+        {"log_", nullptr, extendedLogarithm, nullptr, [](__float128 base, __float128 power) { return logq(power) / logq(base); }, 1.5, 10, 1e-3, 1e3},
+        {"sqrt", extendedSquareRoot, nullptr, sqrtq, nullptr, 0, 1e6},
+        {"cbrt", extendedCubeRoot, nullptr, cbrtq, nullptr, -1e6, 1e6},
+        {"exp", extendedExponential, nullptr, expq, nullptr, -50, 50},
+        {"ln", extendedNaturalLogarithm, nullptr, logq, nullptr, 1e-3, 1e6},
+        {"log2", extendedBase2Logarithm, nullptr, log2q, nullptr, 1e-3, 1e6},
+        {"log", extendedBase10Logarithm, nullptr, log10q, nullptr, 1e-3, 1e6},
+        {"sin", extendedSine, nullptr, sinq, nullptr, -100, 100},
+        {"cos", extendedCosine, nullptr, cosq, nullptr, -100, 100},
+        {"tan", extendedTangent, nullptr, tanq, nullptr, -1.5, 1.5},
+        {"sec", extendedSecant, nullptr, secantReference, nullptr, -1.5, 1.5},
+        {"cot", extendedCotangent, nullptr, cotangentReference, nullptr, 0.05, 3},
+        {"asin", extendedArcsine, nullptr, asinq, nullptr, -1, 1},
+        {"acos", extendedArccosine, nullptr, acosq, nullptr, -1, 1},
+        {"atan", extendedArctangent, nullptr, atanq, nullptr, -100, 100},
+        {"sinh", extendedHyperbolicSine, nullptr, sinhq, nullptr, -20, 20},
+        {"cosh", extendedHyperbolicCosine, nullptr, coshq, nullptr, -20, 20},
+        {"tanh", extendedHyperbolicTangent, nullptr, tanhq, nullptr, -5, 5},
+        {"asinh", extendedHyperbolicArcsine, nullptr, asinhq, nullptr, -1e3, 1e3},
+        {"acosh", extendedHyperbolicArccosine, nullptr, acoshq, nullptr, 1, 1e3},
+        {"atanh", extendedHyperbolicArctangent, nullptr, atanhq, nullptr, -0.99, 0.99}
+    };
+
+    // Measure the errors of every operator, in bits of relative accuracy (double gives 53 at best).
+    std::printf("%-6s %14s %16s\n", "op", "max rel error", "accurate bits");
+    std::mt19937_64 generator(42);
+    for (const BenchmarkedOperator& benchmarked : operators) {
+        double maximumRelativeError = 0;
+        for (size_t sample = 0; sample < sampleCount; sample++) {
+            DoubleDouble first = drawOperand(generator, benchmarked.firstStart, benchmarked.firstStop), second, result;
+            __float128 firstReference = static_cast<__float128>(first.high) + first.low, reference;
+            if (benchmarked.unaryFunction) {
+                result = benchmarked.unaryFunction(first);
+                reference = benchmarked.unaryReference(firstReference);
+            } else {
+                second = drawOperand(generator, benchmarked.secondStart, benchmarked.secondStop);
+                result = benchmarked.binaryFunction(first, second);
+                reference = benchmarked.binaryReference(firstReference, static_cast<__float128>(second.high) + second.low);
+            }
+            if (reference == 0 || !std::isfinite(result.high)) continue;
+            __float128 relativeError = fabsq((static_cast<__float128>(result.high) + result.low - reference) / reference);
+            maximumRelativeError = std::max(maximumRelativeError, static_cast<double>(relativeError));
+        }
+        std::printf("%-6s %14.3g %16.1f\n", benchmarked.name, maximumRelativeError, (maximumRelativeError == 0) ? 113.0 : -std::log2(maximumRelativeError));
+    }
+
+    // Time a few expressions over rowCount rows.
+    Calculator calculator;
+    std::uniform_real_distribution<double> distribution(0.5, 2);
+    std::vector<double> x(rowCount), y(rowCount);
+    for (size_t row = 0; row < rowCount; row++) {
+        x[row] = distribution(generator);
+        y[row] = distribution(generator);
+    }
+    std::vector<std::vector<double>> values = {x, y};
+    std::vector<DoubleDoubleVector> extendedValues(2);
+    for (size_t variable = 0; variable < 2; variable++) {
+        extendedValues[variable].high = values[variable];
+        extendedValues[variable].low.assign(rowCount, 0);
+    }
+
+    const char* expressions[] = {"x*y + x/y - 3*x", "sqrt(x*x + y*y)/(x + y)", "(x + 0.1)*(y - 0.2)*(x - y) + 1/3", "sin(x)*exp(y) + ln(x + y)"};
+    std::printf("\n%-36s %16s %16s %16s %10s\n", "expression", "dd Melem/s", "double Melem/s", "block Melem/s", "dd/double");
+    for (const char* expression : expressions) {
+        double extendedSeconds = measureSeconds(repetitions, [&]() { calculator.evaluateExtendedPrecision(expression, {"x", "y"}, extendedValues); });
+        double elementwiseSeconds = measureSeconds(repetitions, [&]() { calculator.evaluateElementwise(expression, {"x", "y"}, values); });
+
+        // Evaluate the compiled program on blocks of rows small enough for the registers to stay in cache.
+        const size_t blockSize = 1024;
+        CompiledExpression program = calculator.compileExpression(expression, {"x", "y"}, EvaluationMode::unchecked);
+        std::vector<double> registers(program.getRegisterCount() * blockSize), results(rowCount);
+        double blockSeconds = measureSeconds(repetitions, [&]() {
+            for (size_t row = 0; row < rowCount; row += blockSize) {
+                const double* columns[] = {x.data() + row, y.data() + row};
+                program.evaluateBlock(columns, std::min(blockSize, rowCount - row), registers.data(), results.data() + row);
+            }
+        });
+        std::printf("%-36s %16.1f %16.1f %16.1f %9.1fx\n", expression, rowCount / extendedSeconds * 1e-6, rowCount / elementwiseSeconds * 1e-6,
+            rowCount / blockSeconds * 1e-6, extendedSeconds / elementwiseSeconds);
+    }
+    return 0;
+}
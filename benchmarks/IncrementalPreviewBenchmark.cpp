@@ -0,0 +1,90 @@
+// Benchmark for the keystroke-to-result latency of the live preview (see IncrementalEvaluator.hpp).
+// Builds an expression of about 10k characters, then measures the time taken to preview it after every keystroke while it is typed,
+// and after single-character edits (insert, then delete) at random positions. Each latency is compared against evaluating the
+// whole text from scratch, and the previewed values are checked against it.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. benchmarks/IncrementalPreviewBenchmark.cpp $(ls *.cpp | grep -v main.cpp) -o IncrementalPreviewBenchmark
+// Usage:
+//     ./IncrementalPreviewBenchmark [characterCount] [editCount]
+
+#include "Calculator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+
+/// @brief Latencies of a series of previews, in microseconds.
+struct LatencyStatistics {
+    double total = 0, maximum = 0;
+    size_t count = 0;
+
+    void add(double microseconds) {
+        total += microseconds;
+        maximum = std::max(maximum, microseconds);
+        count++;
+    }
+};
+
+/// @brief Function for previewing a text, recording the latency and whether the result matches the reference.
+/// @returns true if both evaluations agree (same value, or both fail).
+static bool preview(IncrementalEvaluator& evaluator, Calculator& calculator, const std::string& text, LatencyStatistics& incremental, LatencyStatistics& scratch) {
+    double value = NAN, reference = NAN;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        value = evaluator.update(text).value;
+    } catch (std::invalid_argument&) {}
+    auto middle = std::chrono::steady_clock::now();
+    try {
+        std::istringstream input(text);
+        reference = calculator.evaluateStream(input).value;
+    } catch (std::invalid_argument&) {}
+    auto stop = std::chrono::steady_clock::now();
+    incremental.add(std::chrono::duration<double, std::micro>(middle - start).count());
+    scratch.add(std::chrono::duration<double, std::micro>(stop - middle).count());
+    return value == reference || (std::isnan(value) && std::isnan(reference));
+}
+
+static void report(const char* name, const LatencyStatistics& incremental, const LatencyStatistics& scratch) {
+    std::printf("%-8s %8zu %12.2f %12.2f %12.2f %12.2f\n", name, incremental.count, incremental.total / incremental.count, incremental.maximum,
+        scratch.total / scratch.count, scratch.maximum);
+}
+
+int main(int argc, char** argv) {
+    size_t characterCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    size_t editCount = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 2000;
+
+    // Build a sum of terms mixing functions, parentheses and powers.
+    const char* terms[] = {"sin(0.5)*3", "(2+7)/4", "sqrt(16)^2", "ln(10)-1", "cos(pi/3)", "2^10%7", "abs(-4.25)", "exp(0.1)*(1-0.3)"};
+    std::mt19937_64 generator(42);
+    std::string expression = "1";
+    while (expression.size() < characterCount) expression += std::string(" + ") + terms[generator() % 8];
+
+    Calculator calculator;
+    IncrementalEvaluator evaluator = calculator.createIncrementalEvaluator();
+    size_t mismatchCount = 0;
+    std::printf("%-8s %8s %12s %12s %12s %12s\n", "edits", "count", "mean us", "max us", "scratch mean", "scratch max");
+
+    // Type the expression one character at a time.
+    LatencyStatistics typing, typingScratch;
+    for (size_t length = 1; length <= expression.size(); length++) {
+        mismatchCount += !preview(evaluator, calculator, expression.substr(0, length), typing, typingScratch);
+    }
+    report("typing", typing, typingScratch);
+
+    // Insert a digit at a random position, then delete it again.
+    LatencyStatistics editing, editingScratch;
+    for (size_t edit = 0; edit < editCount; edit++) {
+        size_t position = generator() % (expression.size() + 1);
+        std::string edited = expression;
+        edited.insert(position, 1, static_cast<char>('0' + generator() % 10));
+        mismatchCount += !preview(evaluator, calculator, edited, editing, editingScratch);
+        mismatchCount += !preview(evaluator, calculator, expression, editing, editingScratch);
+    }
+    report("random", editing, editingScratch);
+
+    if (mismatchCount > 0) std::printf("%zu previews differ from the evaluation from scratch.\n", mismatchCount);
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Benchmark for the warm start given by the program cache file (see ProgramCacheFile.hpp).
+// Compiles a few thousand generated formulas without cache, then through a fresh cache file which is saved, then again through
+// the saved file mapped by a new cache, as a restarted process would. The programs read back are checked to evaluate exactly like
+// the compiled ones. Finally one byte of every entry is flipped, and every entry must be reported stale and recompiled.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. benchmarks/ProgramCacheBenchmark.cpp $(ls *.cpp | grep -v main.cpp) -o ProgramCacheBenchmark
+// Usage:
+//     ./ProgramCacheBenchmark [formulaCount] [cachePath]
+
+#include "Calculator.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+/// @brief Function for compiling every formula, optionally through a cache.
+/// @returns Seconds taken.
+static double compileAll(Calculator& calculator, const std::vector<std::string>& formulas, std::vector<CompiledExpression>& programs) {
+    auto start = std::chrono::steady_clock::now();
+    programs.clear();
+    for (const std::string& formula : formulas) programs.push_back(calculator.compileExpression(formula, {"x", "y", "z"}, EvaluationMode::unchecked));
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Function for counting the programs that do not evaluate exactly like the reference ones at a few points.
+static size_t countMismatches(const std::vector<CompiledExpression>& programs, const std::vector<CompiledExpression>& references) {
+    size_t mismatchCount = 0;
+    for (size_t index = 0; index < programs.size(); index++) {
+        for (double x : {-1.5, 0.25, 2.0}) {
+            std::vector<double> values = {x, 0.5 * x + 1, 3 - x};
+            double value = programs[index].evaluate(values), reference = references[index].evaluate(values);
+            if (std::memcmp(&value, &reference, sizeof(double)) != 0) {
+                mismatchCount++;
+                break;
+            }
+        }
+    }
+    return mismatchCount;
+}
+
+int main(int argc, char** argv) {
+    size_t formulaCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    std::string cachePath = (argc > 2) ? argv[2] : "ProgramCacheBenchmark.cache";
+    std::remove(cachePath.c_str());
+
+    // Generate formulas mixing polynomials, shared subexpressions, trigonometric functions of the same operand and folded constants.
+    const char* terms[] = {"3*x^4 - 2*x^3 + x - 7", "sin(y)^2 + cos(y)*tan(y)", "sqrt(x^2 + y^2 + 1)", "exp(-z/10)*ln(1 + x^2)",
+        "(2^10 + 17 % 5)*z", "abs(x - y)/(1 + abs(z))", "log2(1 + y^2) - log(1 + z^2)", "sinh(x/4) + atan(y - z)"};
+    std::mt19937_64 generator(7);
+    std::vector<std::string> formulas;
+    for (size_t index = 0; index < formulaCount; index++) {
+        std::string formula = std::to_string(index);
+        size_t termCount = 2 + generator() % 6;
+        for (size_t term = 0; term < termCount; term++) formula += ((generator() % 2) ? " + " : " - ") + std::to_string(generator() % 100) + "*(" + terms[generator() % 8] + ")";
+        formulas.push_back(formula);
+    }
+
+    // Compile without cache.
+    std::vector<CompiledExpression> references, programs;
+    Calculator coldCalculator;
+    double coldSeconds = compileAll(coldCalculator, formulas, references);
+
+    // Compile through an empty cache, then save it.
+    double populateSeconds, saveSeconds;
+    {
+        ProgramCacheFile cache(cachePath);
+        Calculator calculator;
+        calculator.setProgramCache(&cache);
+        populateSeconds = compileAll(calculator, formulas, programs);
+        auto saveStart = std::chrono::steady_clock::now();
+        cache.save();
+        saveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - saveStart).count();
+    }
+
+    // Map the saved file like a restarted process, then read every program back.
+    auto loadStart = std::chrono::steady_clock::now();
+    ProgramCacheFile cache(cachePath);
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+    Calculator calculator;
+    calculator.setProgramCache(&cache);
+    double warmSeconds = compileAll(calculator, formulas, programs);
+    const ProgramCacheStatistics& statistics = cache.getStatistics();
+    size_t mismatchCount = countMismatches(programs, references);
+
+    std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+    std::printf("formulas: %zu, cache file: %.1f KiB, entries: %zu\n", formulaCount, static_cast<double>(file.tellg()) / 1024, statistics.loadedEntries);
+    std::printf("%-24s %12s %16s\n", "", "total ms", "us per formula");
+    std::printf("%-24s %12.2f %16.2f\n", "compile (no cache)", coldSeconds * 1e3, coldSeconds * 1e6 / formulaCount);
+    std::printf("%-24s %12.2f %16.2f\n", "compile + insert", populateSeconds * 1e3, populateSeconds * 1e6 / formulaCount);
+    std::printf("%-24s %12.2f %16.2f\n", "save", saveSeconds * 1e3, saveSeconds * 1e6 / formulaCount);
+    std::printf("%-24s %12.2f %16.2f\n", "map + index", loadSeconds * 1e3, loadSeconds * 1e6 / formulaCount);
+    std::printf("%-24s %12.2f %16.2f\n", "read back (warm start)", warmSeconds * 1e3, warmSeconds * 1e6 / formulaCount);
+    std::printf("warm start speedup: %.1fx, hits: %zu, misses: %zu, programs differing from the compiled ones: %zu\n",
+        coldSeconds / (loadSeconds + warmSeconds), statistics.hits, statistics.misses, mismatchCount);
+
+    // Flip the last byte of every entry (the end of its statistics), then check that every entry is recompiled.
+    {
+        std::fstream corrupted(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+        std::string bytes((std::istreambuf_iterator<char>(corrupted)), std::istreambuf_iterator<char>());
+        size_t offset = 24;
+        while (offset + 24 <= bytes.size()) {
+            uint64_t payloadSize;
+            std::memcpy(&payloadSize, bytes.data() + offset + 16, sizeof(payloadSize));
+            offset += 24 + payloadSize;
+            bytes[offset - 1] ^= 1;
+        }
+        corrupted.seekp(0);
+        corrupted.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    ProgramCacheFile corruptedCache(cachePath);
+    Calculator recompilingCalculator;
+    recompilingCalculator.setProgramCache(&corruptedCache);
+    compileAll(recompilingCalculator, formulas, programs);
+    std::printf("corrupted file: %zu stale entries recompiled, programs differing: %zu\n", corruptedCache.getStatistics().staleEntries, countMismatches(programs, references));
+    std::remove(cachePath.c_str());
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Benchmark for the program cache shared by the threads of a process (see SharedProgramCache.hpp).
+// Every thread owns a calculator, as the workers of a server would, and repeatedly draws a formula from a Zipfian distribution
+// over a few thousand generated formulas, looks its program up with Calculator::compileSharedExpression() (compiling it on a miss)
+// and evaluates it at one point. Reports the lookups per second from 1 to 64 threads, and the scaling efficiency: the throughput over
+// the single-thread throughput times the number of threads that can run at once (at most the number of hardware threads). The same
+// loop over a cache guarded by a single mutex is measured alongside.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. benchmarks/SharedProgramCacheBenchmark.cpp $(ls *.cpp | grep -v main.cpp) -o SharedProgramCacheBenchmark
+// Usage:
+//     ./SharedProgramCacheBenchmark [formulaCount] [zipfExponent] [capacityKiB] [milliseconds]
+
+#include "Calculator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+
+/// @brief Cache guarded by a single mutex, the baseline the shards are compared with.
+class LockedProgramCache {
+    public:
+        std::shared_ptr<const CompiledExpression> findOrCompile(Calculator& calculator, const std::string& formula) {
+            std::string source = ProgramCacheFile::normalizeSource(formula);
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto found = this->programs.find(source);
+                if (found != this->programs.end()) return found->second;
+            }
+            auto program = std::make_shared<const CompiledExpression>(calculator.compileExpression(formula, {"x", "y"}, EvaluationMode::unchecked));
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->programs.emplace(source, program).first->second;
+        }
+
+    private:
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const CompiledExpression>> programs;
+};
+
+/// @brief Function for running threadCount workers for the given duration.
+/// @returns Lookups per second, summed over the workers.
+template <typename Lookup>
+static double measureThroughput(size_t threadCount, const std::vector<std::string>& formulas, const std::vector<double>& cumulativeWeights, int milliseconds, Lookup lookup) {
+    std::atomic<bool> isRunning{true};
+    std::atomic<size_t> readyCount{0};
+    std::vector<size_t> lookupCounts(threadCount * 8, 0);
+    std::vector<std::thread> workers;
+    for (size_t thread = 0; thread < threadCount; thread++) {
+        workers.emplace_back([&, thread]() {
+            Calculator calculator;
+            std::mt19937_64 generator(thread + 1);
+            std::uniform_real_distribution<double> uniform(0, 1);
+            std::vector<double> values = {uniform(generator) + 0.5, uniform(generator) + 0.5};
+            size_t lookupCount = 0;
+            double checksum = 0;
+            readyCount++;
+            while (readyCount.load() < threadCount) std::this_thread::yield();
+
+            // Draw a formula from the Zipfian distribution, look its program up and evaluate it.
+            while (isRunning.load(std::memory_order_relaxed)) {
+                size_t rank = std::lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), uniform(generator)) - cumulativeWeights.begin();
+                std::shared_ptr<const CompiledExpression> program = lookup(calculator, formulas[std::min(rank, formulas.size() - 1)]);
+                checksum += program->evaluate(values);
+                lookupCount++;
+            }
+            lookupCounts[thread * 8] = lookupCount + (checksum == 0.125);
+        });
+    }
+
+    // Start timing once every worker is ready.
+    while (readyCount.load() < threadCount) std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    isRunning = false;
+    for (std::thread& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t totalCount = 0;
+    for (size_t count : lookupCounts) totalCount += count;
+    return totalCount / seconds;
+}
+
+int main(int argc, char** argv) {
+    size_t formulaCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4000;
+    double zipfExponent = (argc > 2) ? std::atof(argv[2]) : 1.0;
+    size_t capacityKiB = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 16384;
+    int milliseconds = (argc > 4) ? std::atoi(argv[4]) : 500;
+
+    // Generate formulas from a few terms, and the cumulative Zipfian weights of their ranks.
+    const char* terms[] = {"3*x^4 - 2*x^3 + x - 7", "sin(y)^2 + cos(y)*tan(y)", "sqrt(x^2 + y^2 + 1)", "exp(-y/10)*ln(1 + x^2)",
+        "abs(x - y)/(1 + abs(y))", "log2(1 + y^2) - log(1 + x^2)", "sinh(x/4) + atan(y - x)", "x*y + x/y - 3*x"};
+    std::mt19937_64 generator(7);
+    std::vector<std::string> formulas;
+    std::vector<double> cumulativeWeights;
+    double totalWeight = 0;
+    for (size_t index = 0; index < formulaCount; index++) {
+        std::string formula = std::to_string(index);
+        size_t termCount = 2 + generator() % 4;
+        for (size_t term = 0; term < termCount; term++) formula += " + " + std::to_string(generator() % 100) + "*(" + terms[generator() % 8] + ")";
+        formulas.push_back(formula);
+        totalWeight += 1 / std::pow(static_cast<double>(index + 1), zipfExponent);
+        cumulativeWeights.push_back(totalWeight);
+    }
+    for (double& weight : cumulativeWeights) weight /= totalWeight;
+
+    // Warm both caches up on one thread, so the timed runs measure lookups rather than the first compilations.
+    SharedProgramCache sharedCache(capacityKiB * 1024);
+    LockedProgramCache lockedCache;
+    auto sharedLookup = [&](Calculator& calculator, const std::string& formula) {
+        calculator.setSharedProgramCache(&sharedCache);
+        return calculator.compileSharedExpression(formula, {"x", "y"}, EvaluationMode::unchecked);
+    };
+    auto lockedLookup = [&](Calculator& calculator, const std::string& formula) { return lockedCache.findOrCompile(calculator, formula); };
+    measureThroughput(1, formulas, cumulativeWeights, milliseconds, sharedLookup);
+    measureThroughput(1, formulas, cumulativeWeights, milliseconds, lockedLookup);
+
+    std::printf("formulas: %zu, zipf exponent: %.2f, capacity: %zu KiB, hardware threads: %u\n", formulaCount, zipfExponent, capacityKiB, std::thread::hardware_concurrency());
+    std::printf("%8s %16s %12s %16s %12s\n", "threads", "shared Mlookup/s", "efficiency", "locked Mlookup/s", "efficiency");
+    double sharedSingle = 0, lockedSingle = 0;
+    size_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threadCount : {1, 2, 4, 8, 16, 32, 64}) {
+        double shared = measureThroughput(threadCount, formulas, cumulativeWeights, milliseconds, sharedLookup);
+        double locked = measureThroughput(threadCount, formulas, cumulativeWeights, milliseconds, lockedLookup);
+        if (threadCount == 1) {
+            sharedSingle = shared;
+            lockedSingle = locked;
+        }
+        size_t runningCount = std::min(threadCount, hardwareThreadCount);
+        std::printf("%8zu %16.2f %11.0f%% %16.2f %11.0f%%\n", threadCount, shared * 1e-6, 100 * shared / (sharedSingle * runningCount),
+            locked * 1e-6, 100 * locked / (lockedSingle * runningCount));
+    }
+
+    SharedProgramCacheStatistics statistics = sharedCache.getStatistics();
+    std::printf("shared cache: %zu entries, %.1f KiB, %zu shard hits, %zu misses, %zu evictions\n", statistics.entries, statistics.bytes / 1024.0,
+        statistics.sharedHits, statistics.misses, statistics.evictions);
+    return 0;
+}
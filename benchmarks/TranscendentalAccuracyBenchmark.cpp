@@ -0,0 +1,134 @@
+// Benchmark for the accuracy tiers of the transcendental functions (see FastMath.hpp).
+// For sin, cos, exp, ln, log2 and log, samples operands across the whole domain (log-uniform magnitudes, plus a dense
+// interval around the reduction range), then reports for every tier the largest error in ulps and the largest relative error
+// against a long double reference, and the throughput of the element-wise (SIMD) and the scalar forms with their speed-ups over
+// the C library (the libm tier). The scalar forms of the 1ulp and 4ulp tiers call the C library, so they differ from the element-wise form.
+// Then compares, for every tier, the fused sincos with separate sin and cos calls on the same operands.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. benchmarks/TranscendentalAccuracyBenchmark.cpp $(ls *.cpp | grep -v main.cpp) -o TranscendentalAccuracyBenchmark
+// Usage:
+//     ./TranscendentalAccuracyBenchmark [sampleCount] [repetitions]
+
+#include "FastMath.hpp"
+
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+/// @brief Function benchmarked, with its domain and its reference.
+struct BenchmarkedFunction {
+    const char* name;
+    UnaryFunction function;
+    long double (*reference)(long double);
+    double smallestMagnitude, largestMagnitude;
+    bool isPositive;
+    double denseStart, denseStop;
+};
+
+/// @brief Function for drawing operands: half log-uniform over the magnitudes of the domain, half uniform over the dense interval.
+static std::vector<double> drawOperands(const BenchmarkedFunction& function, size_t sampleCount) {
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> exponent(std::log2(function.smallestMagnitude), std::log2(function.largestMagnitude));
+    std::uniform_real_distribution<double> dense(function.denseStart, function.denseStop);
+    std::vector<double> operands(sampleCount);
+    for (size_t index = 0; index < sampleCount; index++) {
+        if (index % 2 == 0) operands[index] = dense(generator);
+        else operands[index] = std::exp2(exponent(generator)) * ((function.isPositive || generator() % 2 == 0) ? 1 : -1);
+    }
+    return operands;
+}
+
+int main(int argc, char** argv) {
+    size_t sampleCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    const BenchmarkedFunction functions[] = {
+        {"sin", std::sin, sinl, 1e-300, 5e5, false, -4, 4},
+        {"cos", std::cos, cosl, 1e-300, 5e5, false, -4, 4},
+        {"exp", std::exp, expl, 1e-300, 708, false, -10, 10},
+        {"ln", std::log, logl, DBL_MIN, DBL_MAX, true, 0.5, 2},
+        {"log2", std::log2, log2l, DBL_MIN, DBL_MAX, true, 0.5, 2},
+        {"log", std::log10, log10l, DBL_MIN, DBL_MAX, true, 0.5, 2}
+    };
+    const MathAccuracy tiers[] = {MathAccuracy::library, MathAccuracy::oneUlp, MathAccuracy::fourUlps, MathAccuracy::approximate};
+
+    std::printf("%-5s %-5s %10s %12s %14s %14s %8s %8s\n", "func", "tier", "max ulps", "max rel", "block Melem/s", "scalar Melem/s", "block x", "scalar x");
+    for (const BenchmarkedFunction& function : functions) {
+        std::vector<double> operands = drawOperands(function, sampleCount), results(sampleCount);
+        std::vector<long double> references(sampleCount);
+        for (size_t index = 0; index < sampleCount; index++) references[index] = function.reference(operands[index]);
+
+        FastFunction fastFunction = findFastFunction(function.name);
+        double libraryBlockSeconds = 0, libraryScalarSeconds = 0;
+        for (MathAccuracy tier : tiers) {
+            // Time the element-wise form, keeping the best repetition.
+            double bestBlockSeconds = INFINITY;
+            for (int repetition = 0; repetition < repetitions; repetition++) {
+                auto start = std::chrono::steady_clock::now();
+                applyFastFunctionElementwise(fastFunction, tier, function.function, operands.data(), results.data(), sampleCount);
+                bestBlockSeconds = std::min(bestBlockSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            // Measure the errors, in ulps of the correctly rounded result and relative to the reference.
+            double maximumUlps = 0, maximumRelativeError = 0;
+            for (size_t index = 0; index < sampleCount; index++) {
+                long double reference = references[index];
+                double rounded = static_cast<double>(reference);
+                if (rounded == 0) continue;
+                long double ulp = std::ldexp(1.0L, std::ilogb(rounded) - 52);
+                maximumUlps = std::max(maximumUlps, static_cast<double>(std::fabs(results[index] - reference) / ulp));
+                maximumRelativeError = std::max(maximumRelativeError, static_cast<double>(std::fabs((results[index] - reference) / reference)));
+            }
+
+            // Time the scalar form, checking that it matches the element-wise one.
+            double bestScalarSeconds = INFINITY;
+            size_t mismatchCount = 0;
+            for (int repetition = 0; repetition < repetitions; repetition++) {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t index = 0; index < sampleCount; index++) {
+                    double result = evaluateFastFunction(fastFunction, tier, function.function, operands[index]);
+                    mismatchCount += (result != results[index]);
+                }
+                bestScalarSeconds = std::min(bestScalarSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            // The library tier comes first, and is the baseline of the speed-ups.
+            if (tier == MathAccuracy::library) {
+                libraryBlockSeconds = bestBlockSeconds;
+                libraryScalarSeconds = bestScalarSeconds;
+            }
+            std::printf("%-5s %-5s %10.3f %12.3g %14.1f %14.1f %7.2fx %7.2fx", function.name, getMathAccuracyName(tier), maximumUlps, maximumRelativeError,
+                sampleCount / bestBlockSeconds * 1e-6, sampleCount / bestScalarSeconds * 1e-6, libraryBlockSeconds / bestBlockSeconds, libraryScalarSeconds / bestScalarSeconds);
+            if (mismatchCount > 0) std::printf("  (%zu scalar results differ)", mismatchCount / repetitions);
+            std::printf("\n");
+        }
+    }
+
+    // Time sin and cos computed together against two separate element-wise calls, checking that the results are identical.
+    std::vector<double> operands = drawOperands(functions[0], sampleCount), sines(sampleCount), cosines(sampleCount), separateSines(sampleCount), separateCosines(sampleCount);
+    std::printf("\n%-6s %-5s %14s %14s\n", "func", "tier", "fused Melem/s", "sin+cos Melem/s");
+    for (MathAccuracy tier : tiers) {
+        double bestFusedSeconds = INFINITY, bestSeparateSeconds = INFINITY;
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            auto start = std::chrono::steady_clock::now();
+            applySineCosineElementwise(tier, operands.data(), sines.data(), cosines.data(), sampleCount);
+            auto middle = std::chrono::steady_clock::now();
+            applyFastFunctionElementwise(FastFunction::sine, tier, std::sin, operands.data(), separateSines.data(), sampleCount);
+            applyFastFunctionElementwise(FastFunction::cosine, tier, std::cos, operands.data(), separateCosines.data(), sampleCount);
+            auto stop = std::chrono::steady_clock::now();
+            bestFusedSeconds = std::min(bestFusedSeconds, std::chrono::duration<double>(middle - start).count());
+            bestSeparateSeconds = std::min(bestSeparateSeconds, std::chrono::duration<double>(stop - middle).count());
+        }
+        size_t mismatchCount = 0;
+        for (size_t index = 0; index < sampleCount; index++) mismatchCount += (sines[index] != separateSines[index] || cosines[index] != separateCosines[index]);
+
+        std::printf("%-6s %-5s %14.1f %14.1f", "sincos", getMathAccuracyName(tier), sampleCount / bestFusedSeconds * 1e-6, sampleCount / bestSeparateSeconds * 1e-6);
+        if (mismatchCount > 0) std::printf("  (%zu results differ)", mismatchCount);
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -1,23 +1,68 @@
 #include "Calculator.hpp"
+#include "FastMath.hpp"
 
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 
 using namespace std;
 
-int main(void){
+int main(int argumentCount, char** arguments){
     // Create calculator object.
     Calculator calculator;
 
     // Declare variable to store user command.
     int command;
 
+    // Evaluate an expression on every row of a CSV file instead of showing the menu,
+    // e.g. calc --csv data.csv --expr "price*qty*(1-disc)" --out result.csv (the output defaults to the standard output).
+    // --accuracy selects polynomial approximations of sin, cos, exp and the logarithms instead of the C library (libm).
+    if (argumentCount > 1) {
+        const char* usage = "Usage: calc --csv <input.csv> --expr <expression> [--out <output.csv>] [--accuracy <libm|1ulp|4ulp|1e-7>]\n";
+        std::string csvPath, expression, outputPath, accuracyName = "libm";
+        for (int index = 1; index < argumentCount; index++) {
+            std::string option = arguments[index];
+            if (option == "--csv" && index + 1 < argumentCount) csvPath = arguments[++index];
+            else if (option == "--expr" && index + 1 < argumentCount) expression = arguments[++index];
+            else if (option == "--out" && index + 1 < argumentCount) outputPath = arguments[++index];
+            else if (option == "--accuracy" && index + 1 < argumentCount) accuracyName = arguments[++index];
+            else {
+                cerr << usage;
+                return 1;
+            }
+        }
+        if (csvPath.empty() || expression.empty()) {
+            cerr << usage;
+            return 1;
+        }
+
+        try {
+            MathAccuracy mathAccuracy = findMathAccuracy(accuracyName);
+            if (outputPath.empty()) {
+                calculator.evaluateCsv(expression, csvPath, cout, mathAccuracy);
+                return 0;
+            }
+            std::ofstream output(outputPath, std::ios::binary);
+            uint64_t rowCount = output ? calculator.evaluateCsv(expression, csvPath, output, mathAccuracy) : 0;
+            if (!output) {
+                cerr << "Got FileError: Failed to write " << outputPath << ".\n";
+                return 1;
+            }
+            cout << "Wrote " << rowCount << " row(s) to " << outputPath << ".\n";
+        } catch (std::invalid_argument &e) {
+            cerr << "Got " << e.what();
+            return 1;
+        }
+        return 0;
+    }
+
     // Greet the user.
     cout << "Welcome\n";
 
     while(1) {
         // Print currently held value if there is a number.
-        if (std::isnan(calculator.getCurrentValue())) cout << "Options:\n0: Insert expression\n1: Print history\n2: Undo operation\n3: Clear history\n9: Quit\nInsert command: ";
-        else cout << "Options:\n0: Insert expression\n1: Print history\n2: Undo operation\n3: Clear history\n9: Quit\nCurrent value: " << calculator.getCurrentValue() << "\nInsert command: ";
+        if (std::isnan(calculator.getCurrentValue())) cout << "Options:\n0: Insert expression\n1: Print history\n2: Undo operation\n3: Clear history\n4: Compile expression\n5: Tabulate expression\n6: Evaluate file\n7: Export history\n8: Solve equation\n10: Integrate expression\n9: Quit\nInsert command: ";
+        else cout << "Options:\n0: Insert expression\n1: Print history\n2: Undo operation\n3: Clear history\n4: Compile expression\n5: Tabulate expression\n6: Evaluate file\n7: Export history\n8: Solve equation\n10: Integrate expression\n9: Quit\nCurrent value: " << calculator.getCurrentValue() << "\nInsert command: ";
 
         // Ask for input and handle invalid command.
         if (!(cin >> command)) {
@@ -67,9 +112,102 @@ int main(void){
                 calculator.clearHistory();
                 break;
             
+            case 4:
+                try {
+                    // Ask for the expression and the names of its variables, with their optional ranges.
+                    std::string expression;
+                    std::vector<std::string> variableNames;
+                    std::vector<Interval> variableRanges;
+                    cout << "Insert expression: ";
+                    std::getline(cin, expression);
+                    cout << "Insert variable names (separated by spaces, optionally with ranges, e.g. x in [0.1, 10] y): ";
+                    std::string variableLine;
+                    std::getline(cin, variableLine);
+
+                    // Compile the expression and print the generated program. Ranges let the compiler prove operations safe.
+                    if (calculator.parseVariableDeclarations(variableLine, variableNames, variableRanges)) {
+                        cout << calculator.compileExpression(expression, variableNames, variableRanges).disassemble();
+                    } else {
+                        cout << calculator.compileExpression(expression, variableNames).disassemble();
+                    }
+                } catch (std::invalid_argument &e) {
+                    cout << "Got " << e.what();
+                }
+                break;
+
+            case 5:
+                try {
+                    // Ask for the table command, then stream the table to the standard output.
+                    std::string command;
+                    cout << "Insert table command (e.g. table sin(x) x=0..1 step 0.1): ";
+                    std::getline(cin, command);
+                    uint64_t lineCount = calculator.tabulateExpression(command, cout);
+                    cout << "Wrote " << lineCount << " line(s).\n";
+                } catch (std::invalid_argument &e) {
+                    cout << "Got " << e.what();
+                }
+                break;
+
+            case 6:
+                try {
+                    // Ask for the path of the file holding the expression, then evaluate it while reading it.
+                    std::string path;
+                    cout << "Insert file path: ";
+                    std::getline(cin, path);
+                    calculator.evaluateFile(path);
+                } catch (std::runtime_error &r) {
+                    cout << "Got " << r.what();
+                } catch (std::invalid_argument &e) {
+                    cout << "Got " << e.what();
+                }
+                break;
+
+            case 7:
+                try {
+                    // Ask for the path of the exported file, whose extension selects the format.
+                    std::string path;
+                    cout << "Insert file path (.csv or .json): ";
+                    std::getline(cin, path);
+                    uint64_t entryCount = calculator.exportHistory(path);
+                    cout << "Exported " << entryCount << " log(s) to " << path << ".\n";
+                } catch (std::invalid_argument &e) {
+                    cout << "Got " << e.what();
+                }
+                break;
+
+            case 8:
+                try {
+                    // Ask for the solve command, then print every root found.
+                    std::string command;
+                    cout << "Insert solve command (e.g. solve cos(x) = x x=0..1): ";
+                    std::getline(cin, command);
+                    std::vector<EquationRoot> roots = calculator.solveEquation(command);
+                    cout << std::setprecision(17);
+                    for (const EquationRoot& root : roots) cout << "Root: " << root.value << " (residual " << root.residual << ", " << root.evaluationCount << " evaluation(s))\n";
+                    cout << std::setprecision(6) << "Found " << roots.size() << " root(s).\n";
+                } catch (std::invalid_argument &e) {
+                    cout << "Got " << e.what();
+                }
+                break;
+
             case 9:
                 return 0;
 
+            case 10:
+                try {
+                    // Ask for the integral, then print it with its error estimate.
+                    std::string command;
+                    cout << "Insert integral (e.g. integrate(sin(x)^2, x, 0, 2*pi)): ";
+                    std::getline(cin, command);
+                    IntegrationResult result = calculator.integrateExpression(command);
+                    cout << std::setprecision(17) << "Result: " << result.value << " (estimated error " << std::setprecision(3) << result.errorEstimate;
+                    cout << ", " << result.evaluationCount << " evaluation(s) on " << result.intervalCount << " subinterval(s))\n" << std::setprecision(6);
+                    if (!result.isConverged) cout << "Warning: The evaluation budget ran out before the requested accuracy was reached.\n";
+                } catch (std::invalid_argument &e) {
+                    cout << "Got " << e.what();
+                }
+                break;
+
             default:
                 cout << "Invalid command (Not a number). Insert 9 to quit.\nInsert command: ";
                 while (!(cin >> command)) {
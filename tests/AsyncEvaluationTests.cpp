@@ -0,0 +1,135 @@
+// Tests of the asynchronous evaluation (see Calculator::evaluateAsync() and EvaluationBudget.hpp): the step and time budgets,
+// the cancellation, and the lifetime of the evaluation relative to the calculator.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/AsyncEvaluationTests.cpp $(ls *.cpp | grep -v main.cpp) -o AsyncEvaluationTests
+// Usage:
+//     ./AsyncEvaluationTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+/// @brief Function for building the sum of termCount ones, interpreted as 2*termCount - 1 instructions.
+static std::string makeSumOfOnes(size_t termCount) {
+    std::string expression = "1";
+    expression.reserve(2 * termCount);
+    for (size_t term = 1; term < termCount; term++) expression += "+1";
+    return expression;
+}
+
+/// @brief Function for running a call and returning the message of the invalid_argument error it throws ("" if none).
+template <typename Function>
+static std::string getErrorMessage(Function function) {
+    try {
+        function();
+    } catch (const std::invalid_argument& error) {
+        return error.what();
+    }
+    return "";
+}
+
+/// @brief Function for reading the number of steps reported by a budget error, e.g. "... after 1234 step(s).\n".
+static uint64_t getReportedStepCount(const std::string& message) {
+    size_t position = message.rfind("after ");
+    return (position == std::string::npos) ? UINT64_MAX : std::stoull(message.substr(position + 6));
+}
+
+/// @brief Function for testing that the step budget stops the evaluation exactly once it is exceeded.
+static void testStepBudget(Calculator& calculator) {
+    std::string expression = makeSumOfOnes(1000);
+    EvaluationLimits limits;
+
+    // The 1999 instructions fit in a budget of 1999 steps, but not in one step less.
+    limits.maximumStepCount = 1999;
+    StreamingValue result = calculator.evaluateAsync(expression, limits).get();
+    check(result.isInteger && result.integer == 1000, "sum within the step budget");
+    limits.maximumStepCount = 1998;
+    check(getErrorMessage([&]() { calculator.evaluateAsync(expression, limits).get(); }) == "BudgetError: Exceeded the budget of 1998 step(s).\n", "budget one step short");
+    limits.maximumStepCount = 500;
+    check(getErrorMessage([&]() { calculator.evaluateAsync(expression, limits).get(); }) == "BudgetError: Exceeded the budget of 500 step(s).\n", "budget of 500 steps");
+
+    // Calls to user functions are charged the instructions of their compiled body: square(3) costs the push, the call and the product.
+    calculator.defineFunction("def square(x) = x*x");
+    limits.maximumStepCount = 2;
+    check(getErrorMessage([&]() { calculator.evaluateAsync("square(3)", limits).get(); }) == "BudgetError: Exceeded the budget of 2 step(s).\n", "user function over the step budget");
+    limits.maximumStepCount = 3;
+    check(calculator.evaluateAsync("square(3)", limits).get().value == 9, "user function within the step budget");
+}
+
+/// @brief Function for testing that the time budget stops long evaluations soon after the deadline, reporting their progress.
+static void testTimeBudget(Calculator& calculator, const std::string& longExpression) {
+    EvaluationLimits limits;
+    limits.timeLimit = std::chrono::milliseconds(50);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::string message = getErrorMessage([&]() { calculator.evaluateAsync(longExpression, limits).get(); });
+    double elapsedMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::string expectedPrefix = "BudgetError: Exceeded the time budget of 50000 us after ";
+    check(message.compare(0, expectedPrefix.size(), expectedPrefix) == 0, "time budget message (got \"" + message + "\")");
+    check(elapsedMilliseconds < 1000, "time budget stopped after " + std::to_string(elapsedMilliseconds) + " ms");
+
+    // Stopping during the parse reports no step, during the evaluation part of the program.
+    check(getReportedStepCount(message) < 2 * 1000000 - 1, "steps reported by the time budget (" + std::to_string(getReportedStepCount(message)) + ")");
+
+    // A time budget long enough lets the evaluation finish.
+    limits.timeLimit = std::chrono::seconds(60);
+    check(calculator.evaluateAsync(makeSumOfOnes(1000), limits).get().integer == 1000, "sum within the time budget");
+}
+
+/// @brief Function for testing the cancellation of running and of not yet started evaluations.
+static void testCancellation(Calculator& calculator, const std::string& longExpression) {
+    // Cancel a running evaluation, which must stop soon after.
+    EvaluationLimits limits;
+    std::future<StreamingValue> future = calculator.evaluateAsync(longExpression, limits);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    limits.cancellationToken.cancel();
+    std::string message = getErrorMessage([&]() { future.get(); });
+    double elapsedMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::string expectedPrefix = "BudgetError: Evaluation has been cancelled after ";
+    check(message.compare(0, expectedPrefix.size(), expectedPrefix) == 0, "cancellation message (got \"" + message + "\")");
+    check(getReportedStepCount(message) < 2 * 1000000 - 1, "steps reported by the cancellation (" + std::to_string(getReportedStepCount(message)) + ")");
+    check(elapsedMilliseconds < 1000, "cancellation took effect after " + std::to_string(elapsedMilliseconds) + " ms");
+
+    // A token cancelled before the call stops the evaluation before it has consumed any step.
+    check(getErrorMessage([&]() { calculator.evaluateAsync("1+2", limits).get(); }) == "BudgetError: Evaluation has been cancelled after 0 step(s).\n", "evaluation cancelled beforehand");
+
+    // Copies of the token share its state; a fresh token is not cancelled.
+    EvaluationLimits copiedLimits = limits;
+    check(copiedLimits.cancellationToken.isCancelled(), "copied token cancelled");
+    check(!EvaluationLimits().cancellationToken.isCancelled(), "fresh token not cancelled");
+}
+
+/// @brief Function for testing that evaluations neither read the calculator nor see definitions made after the call.
+static void testLifetime(const std::string& longExpression) {
+    // Destroy the calculator while its evaluations run: they only hold copies of its tables.
+    std::unique_ptr<Calculator> calculator = std::make_unique<Calculator>();
+    calculator->defineFunction("def f(x) = 2*x + 1");
+    std::future<StreamingValue> sumFuture = calculator->evaluateAsync(longExpression);
+    std::future<StreamingValue> functionFuture = calculator->evaluateAsync("f(20) + sin(0) + 2^10");
+    calculator.reset();
+    check(sumFuture.get().integer == 1000000, "long sum outliving the calculator");
+    check(functionFuture.get().value == 41 + 1024, "user function outliving the calculator");
+
+    // Redefining a function after the call does not change the running evaluation.
+    Calculator otherCalculator;
+    otherCalculator.defineFunction("def g(x) = x + 1");
+    std::future<StreamingValue> future = otherCalculator.evaluateAsync(longExpression + "+g(1)");
+    otherCalculator.defineFunction("def g(x) = x + 100");
+    check(future.get().value == 1000002, "function snapshot taken at the call");
+    check(otherCalculator.evaluateAsync("g(1)").get().value == 101, "redefined function seen by later calls");
+}
+
+int main() {
+    Calculator calculator;
+    std::string longExpression = makeSumOfOnes(1000000);
+    testStepBudget(calculator);
+    testTimeBudget(calculator, longExpression);
+    testCancellation(calculator, longExpression);
+    testLifetime(longExpression);
+    return reportChecks("AsyncEvaluationTests");
+}
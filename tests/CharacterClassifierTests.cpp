@@ -0,0 +1,101 @@
+// Tests of the character classifier (see CharacterClassifier.hpp), compared with a scalar loop: runs of every length up to
+// several 32-byte blocks from unaligned starts, so that they end before, at and after the boundaries of the 16- and 32-byte
+// blocks and in the scalar tail, every byte value as the end of a run, and runs continuing past the given length.
+// The blocks use AVX2 when the processor supports it, and SSE2 otherwise.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/CharacterClassifierTests.cpp $(ls *.cpp | grep -v main.cpp) -o CharacterClassifierTests
+// Usage:
+//     ./CharacterClassifierTests
+
+#include "CharacterClassifier.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+/// @brief Class of characters skipped by one of the functions, with the characters it holds.
+struct CharacterClass {
+    const char* name;
+    size_t (*skip)(const char*, size_t, size_t);
+    std::string members;
+};
+
+/// @brief Function for skipping the members of a class one character at a time, the reference of the tests.
+static size_t skipScalar(const CharacterClass& characterClass, const char* characters, size_t index, size_t length) {
+    while (index < length && characterClass.members.find(characters[index]) != std::string::npos) index++;
+    return index;
+}
+
+/// @brief Function for testing runs of every length from unaligned starts, ended by a non-member or by the given length.
+static void testRunLengths(const CharacterClass& characterClass) {
+    std::mt19937 generator(33);
+    size_t mismatchCount = 0, callCount = 0;
+    for (size_t length = 0; length <= 100; length++) {
+        for (size_t index = 0; index <= std::min<size_t>(length, 40); index++) {
+            for (size_t runLength = 0; index + runLength <= length; runLength++) {
+                // Fill the run with random members, followed by a non-member, and more members past the length, which must not be read.
+                std::vector<char> characters(length + 64);
+                for (char& character : characters) character = characterClass.members[generator() % characterClass.members.size()];
+                if (index + runLength < length) characters[index + runLength] = '+';
+                size_t expected = index + runLength;
+                size_t actual = characterClass.skip(characters.data(), index, length);
+                mismatchCount += actual != expected || skipScalar(characterClass, characters.data(), index, length) != expected;
+                callCount++;
+            }
+        }
+    }
+    check(mismatchCount == 0, std::string(characterClass.name) + ": " + std::to_string(callCount) + " runs of every length up to 100 (" +
+        std::to_string(mismatchCount) + " mismatch(es))");
+}
+
+/// @brief Function for testing every byte value ending a run at every position of the first blocks.
+static void testEndingBytes(const CharacterClass& characterClass) {
+    size_t mismatchCount = 0;
+    const size_t length = 80;
+    std::vector<char> characters(length);
+    for (size_t index = 0; index < 4; index++) {
+        for (size_t position = index; position < length; position++) {
+            for (int byte = 0; byte < 256; byte++) {
+                for (size_t fill = 0; fill < length; fill++) characters[fill] = characterClass.members[fill % characterClass.members.size()];
+                characters[position] = static_cast<char>(byte);
+                size_t expected = skipScalar(characterClass, characters.data(), index, length);
+                mismatchCount += characterClass.skip(characters.data(), index, length) != expected;
+            }
+        }
+    }
+    check(mismatchCount == 0, std::string(characterClass.name) + ": every byte ending a run (" + std::to_string(mismatchCount) + " mismatch(es))");
+}
+
+/// @brief Function for testing random texts mixing members and other characters, skipped from every index.
+static void testRandomTexts(const CharacterClass& characterClass) {
+    std::mt19937 generator(16);
+    size_t mismatchCount = 0;
+    for (int text = 0; text < 200; text++) {
+        // Long runs of members, broken by random bytes.
+        std::vector<char> characters(1 + generator() % 300);
+        size_t breakProbability = 1 + generator() % 64;
+        for (char& character : characters) {
+            character = (generator() % breakProbability == 0) ? static_cast<char>(generator() % 256) : characterClass.members[generator() % characterClass.members.size()];
+        }
+        for (size_t index = 0; index <= characters.size(); index++) {
+            mismatchCount += characterClass.skip(characters.data(), index, characters.size()) != skipScalar(characterClass, characters.data(), index, characters.size());
+        }
+    }
+    check(mismatchCount == 0, std::string(characterClass.name) + ": random texts (" + std::to_string(mismatchCount) + " mismatch(es))");
+}
+
+int main() {
+    const CharacterClass characterClasses[] = {
+        {"skipWhitespace", skipWhitespace, " \t\n\r"},
+        {"skipDigits", skipDigits, "0123456789"},
+        {"skipLowercaseLetters", skipLowercaseLetters, "abcdefghijklmnopqrstuvwxyz"}
+    };
+    for (const CharacterClass& characterClass : characterClasses) {
+        testRunLengths(characterClass);
+        testEndingBytes(characterClass);
+        testRandomTexts(characterClass);
+    }
+    return reportChecks("CharacterClassifierTests");
+}
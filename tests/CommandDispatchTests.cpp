@@ -0,0 +1,116 @@
+// Tests of the commands typed at the expression prompt (see Calculator::evaluatePostfixNotation()), checking which command
+// each input is routed to from the printed output.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/CommandDispatchTests.cpp $(ls *.cpp | grep -v main.cpp) -o CommandDispatchTests
+// Usage:
+//     ./CommandDispatchTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/// @brief Function for typing a line at the expression prompt, the way option 0 of the menu does.
+/// @returns Everything printed, including the error if the input has been rejected.
+static std::string typeInput(Calculator& calculator, const std::string& line) {
+    std::istringstream input(line + "\n");
+    std::ostringstream output;
+    std::streambuf* inputBuffer = std::cin.rdbuf(input.rdbuf());
+    std::streambuf* outputBuffer = std::cout.rdbuf(output.rdbuf());
+    try {
+        calculator.getExpressionFromUser();
+        calculator.evaluatePostfixNotation();
+    } catch (std::invalid_argument& e) {
+        std::cout << "Got " << e.what();
+        calculator.reset();
+    }
+    std::cin.rdbuf(inputBuffer);
+    std::cout.rdbuf(outputBuffer);
+    return output.str();
+}
+
+/// @brief Function for checking that the output of an input contains the given text.
+static void checkOutput(Calculator& calculator, const std::string& line, const std::string& expectedText) {
+    std::string output = typeInput(calculator, line);
+    check(output.find(expectedText) != std::string::npos, "\"" + line + "\" printed \"" + expectedText + "\" (printed \"" + output + "\")");
+}
+
+/// @brief Function for testing that only "<name> = <expression>" inputs assign cells.
+static void testCellDispatch(Calculator& calculator) {
+    checkOutput(calculator, "a = 3", "Result: 3");
+    checkOutput(calculator, "  b=a*2 + 1", "Result: 7");
+    checkOutput(calculator, "a = 5", "Recomputed 2 cell(s)");
+    checkOutput(calculator, "b", "Result: 11");
+
+    // Other inputs containing '=' are parsed as expressions, and their '=' is reported.
+    checkOutput(calculator, "2 + 3 = 5", "ParseError: Found '=' at index 6");
+    checkOutput(calculator, "(a) = 2", "ParseError: Found '='");
+    checkOutput(calculator, "3a = 2", "Got");
+    checkOutput(calculator, "sin = 2", "Invalid cell name sin");
+    check(typeInput(calculator, "2 + 3 = 5").find("Recomputed") == std::string::npos, "no cell assigned by \"2 + 3 = 5\"");
+}
+
+/// @brief Function for testing that only calls of an aggregate function name are routed to the column aggregates.
+static void testAggregateDispatch(Calculator& calculator, const std::string& path) {
+    checkOutput(calculator, "sum(x^2, x in " + path + ":price)", "Result: 9.5");
+    checkOutput(calculator, "  max (x, x in " + path + ":price)", "Result: 2.5");
+    checkOutput(calculator, "def g(a, b) = a*b", "Defined function");
+    checkOutput(calculator, "sum(g(x, 2), x in " + path + ":qty)", "Result: 18");
+    checkOutput(calculator, "mean(x, x in " + path + ")", "ParseError: Expected an aggregate");
+
+    // Expressions containing " in " elsewhere are not aggregates, and user functions take precedence over aggregate names.
+    check(typeInput(calculator, "2 in 3").find("aggregate") == std::string::npos, "\"2 in 3\" parsed as an expression");
+    checkOutput(calculator, "def mean(a, b) = (a + b)/2", "Defined function");
+    checkOutput(calculator, "mean(2, 4)", "Result: 3");
+}
+
+/// @brief Function for testing that the prompt reads session variables and user functions as they are when the input is typed.
+static void testSessionDispatch(Calculator& calculator) {
+    check(typeInput(calculator, "let v = 3").find("Got") == std::string::npos, "v assigned");
+    checkOutput(calculator, "v + 1", "Result: 4");
+    check(typeInput(calculator, "let v = 5").find("Got") == std::string::npos, "v reassigned");
+    checkOutput(calculator, "v + 1", "Result: 6");
+    checkOutput(calculator, "def f(x) = x + 1", "Defined function");
+    checkOutput(calculator, "f(2)", "Result: 3");
+    checkOutput(calculator, "def f(x) = x*10", "Defined function");
+    checkOutput(calculator, "f(2)", "Result: 20");
+    checkOutput(calculator, "f(v)", "Result: 50");
+}
+
+/// @brief Function for testing that the column mode of the command line (calc --csv ... --expr ...) binds the columns with
+/// valid variable names, and only those.
+static void testCsvDispatch(Calculator& calculator, const std::string& path) {
+    std::ostringstream output;
+    check(calculator.evaluateCsv("price*qty", path, output) == 3, "price*qty evaluated on every row");
+    check(output.str() == "result\n3\n10\n-3\n", "price*qty wrote \"" + output.str() + "\"");
+    checkThrows([&]() { calculator.evaluateCsv("cost*2", path, output); }, "MathError: Unrecognized token cost", "missing column");
+    checkThrows([&]() { calculator.evaluateCsv("2 + 3", path, output); }, "EvalError: CSV evaluation requires an expression of at least one column", "expression without columns");
+}
+
+/// @brief Function for testing the integrals typed at the prompt, with the limits given as arguments or as a range.
+static void testIntegralDispatch(Calculator& calculator) {
+    checkOutput(calculator, "integrate(x^2, x, 0, 3)", "Result: 9 ");
+    checkOutput(calculator, "integrate(x^2, x=0..3)", "Result: 9 ");
+    checkOutput(calculator, "integrate(g(x, 2), x = 1 .. 2)", "Result: 3 ");
+    checkOutput(calculator, "integrate(x^2, x=0)", "ParseError: Expected an integral");
+}
+
+int main() {
+    // Read the inputs from std::cin rather than from the line editor.
+    if (std::freopen("/dev/null", "r", stdin) == nullptr) return 1;
+    Calculator calculator;
+    testCellDispatch(calculator);
+    testSessionDispatch(calculator);
+
+    // Write a small CSV file for the commands reading one.
+    const std::string path = "CommandDispatchTests.csv";
+    std::ofstream(path) << "price,qty\n1.5,2\n2.5,4\n-1,3\n";
+    testAggregateDispatch(calculator, path);
+    testCsvDispatch(calculator, path);
+    std::remove(path.c_str());
+    testIntegralDispatch(calculator);
+    return reportChecks("CommandDispatchTests");
+}
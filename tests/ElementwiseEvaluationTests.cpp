@@ -0,0 +1,34 @@
+// Tests of the element-wise evaluations of the calculator, in double (see VectorEvaluator.hpp) and in double-double precision
+// (see ExtendedPrecisionEvaluator.hpp).
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/ElementwiseEvaluationTests.cpp $(ls *.cpp | grep -v main.cpp) -o ElementwiseEvaluationTests
+// Usage:
+//     ./ElementwiseEvaluationTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+/// @brief Function for testing that both evaluations validate their variables the same way.
+static void testVariableValidation(Calculator& calculator) {
+    checkThrows([&]() { calculator.evaluateElementwise("x + y", {"x", "y"}, {{1}}); }, "EvalError: Expected 2 variable value(s), got 1", "missing value");
+    checkThrows([&]() { calculator.evaluateExtendedPrecision("x + y", {"x", "y"}, {{{1}, {0}}}); }, "EvalError: Expected 2 variable value(s), got 1", "missing double-double value");
+    checkThrows([&]() { calculator.evaluateElementwise("sin + 1", {"sin"}, {{1}}); }, "ParseError: Invalid variable name sin", "function name as a variable");
+    checkThrows([&]() { calculator.evaluateExtendedPrecision("sin + 1", {"sin"}, {{{1}, {0}}}); }, "ParseError: Invalid variable name sin", "function name as a double-double variable");
+}
+
+/// @brief Function for testing the values of element-wise evaluations, with broadcasting.
+static void testValues(Calculator& calculator) {
+    std::vector<double> elements = calculator.evaluateElementwise("[1, 2, 3]^2 + x", {"x"}, {{0.5}});
+    check(elements == std::vector<double>({1.5, 4.5, 9.5}), "[1, 2, 3]^2 + x");
+    DoubleDoubleVector extended = calculator.evaluateExtendedPrecision("x/3", {"x"}, {{{1, 2}, {0, 0}}});
+    check(extended.size() == 2 && formatDoubleDouble({extended.high[0], extended.low[0]}) == "0.3333333333333333333333333333333", "1/3 in double-double");
+    checkThrows([&]() { calculator.evaluateElementwise("[1, 2] + [1, 2, 3]"); }, "EvalError", "vectors of different lengths");
+}
+
+int main() {
+    Calculator calculator;
+    testVariableValidation(calculator);
+    testValues(calculator);
+    return reportChecks("ElementwiseEvaluationTests");
+}
@@ -0,0 +1,327 @@
+// Tests of the programs compiled by ExpressionCompiler (see ExpressionCompiler.hpp), checked against the interpreter of the
+// calculator and against known values.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/ExpressionCompilerTests.cpp $(ls *.cpp | grep -v main.cpp) -o ExpressionCompilerTests
+// Usage:
+//     ./ExpressionCompilerTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+/// @brief Function for evaluating a compiled program on a block of rows holding the same values.
+/// @returns Value of the first row.
+static double evaluateBlock(const CompiledExpression& program, const std::vector<double>& variableValues) {
+    const size_t count = 8;
+    std::vector<std::vector<double>> columns;
+    std::vector<const double*> columnPointers;
+    for (double value : variableValues) columns.emplace_back(count, value);
+    for (const std::vector<double>& column : columns) columnPointers.push_back(column.data());
+    std::vector<double> registers(program.getRegisterCount() * count), results(count);
+    program.evaluateBlock(columnPointers.data(), count, registers.data(), results.data());
+    return results[0];
+}
+
+/// @brief Function for running a call, returning the first line of the invalid_argument error it throws (empty if none).
+template <typename Function>
+static std::string getErrorMessage(Function function) {
+    try {
+        function();
+    } catch (const std::invalid_argument& error) {
+        std::string message = error.what();
+        return message.substr(0, message.find('\n'));
+    }
+    return "";
+}
+
+/// @brief Function for testing that checked sec, csc and cot report their operand, compiled (fused with other calls of the same
+/// operand or not, on a row or on a block) as interpreted.
+static void testCheckedTrigonometricErrors(Calculator& calculator) {
+    struct ErrorCase {
+        const char* expression;
+        const char* interpretedExpression;
+        double angle;
+        const char* expectedError;
+    };
+    const ErrorCase errorCases[] = {
+        {"csc(x)", "csc(0)", 0.0, "DomainError: csc(0) is not defined."},
+        {"sin(x) + csc(x)", "sin(0) + csc(0)", 0.0, "DomainError: csc(0) is not defined."},
+        {"sin(x) + csc(x)", nullptr, -0.0, "DomainError: csc(-0) is not defined."},
+        {"cot(x)", "cot(0)", 0.0, "DomainError: cot(0) is not defined."},
+        {"sin(x) + cot(x)", "sin(0) + cot(0)", 0.0, "DomainError: cot(0) is not defined."},
+        {"cos(x)*cot(x)", nullptr, -0.0, "DomainError: cot(-0) is not defined."},
+        {"cos(x)*sec(x) + tan(x)", "cos(0)*sec(0) + tan(0)", 0.0, ""},
+    };
+    for (const ErrorCase& errorCase : errorCases) {
+        CompiledExpression program = calculator.compileExpression(errorCase.expression, {"x"});
+        std::string description = std::string(errorCase.expression) + " at " + (std::signbit(errorCase.angle) ? "-0" : "0");
+        std::string compiledError = getErrorMessage([&]() { program.evaluate({errorCase.angle}); });
+        check(compiledError == errorCase.expectedError, description + " compiled threw \"" + compiledError + "\"");
+        std::string blockError = getErrorMessage([&]() { evaluateBlock(program, {errorCase.angle}); });
+        check(blockError == errorCase.expectedError, description + " on a block threw \"" + blockError + "\"");
+        if (errorCase.interpretedExpression == nullptr) continue;
+        std::string interpretedError = getErrorMessage([&]() { calculator.evaluateAsync(errorCase.interpretedExpression).get(); });
+        check(interpretedError == errorCase.expectedError, description + " interpreted threw \"" + interpretedError + "\"");
+    }
+
+    // Programs read back from a program cache file bind the same checks.
+    const std::string path = "ExpressionCompilerTests.cache";
+    {
+        ProgramCacheFile cache(path);
+        calculator.setProgramCache(&cache);
+        calculator.compileExpression("sin(x) + cot(x) + sec(x)", {"x"});
+        cache.save();
+    }
+    ProgramCacheFile cache(path);
+    calculator.setProgramCache(&cache);
+    CompiledExpression cachedProgram = calculator.compileExpression("sin(x) + cot(x) + sec(x)", {"x"});
+    check(cache.getStatistics().hits == 1, "checked fused program read back");
+    std::string cachedError = getErrorMessage([&]() { cachedProgram.evaluate({-0.0}); });
+    check(cachedError == "DomainError: cot(-0) is not defined.", "read back program threw \"" + cachedError + "\"");
+    calculator.setProgramCache(nullptr);
+    std::remove(path.c_str());
+
+    // The fused calls compute the values of the functions, and their derivatives.
+    for (double angle : {0.3, -1.2, 2.5}) {
+        CompiledExpression program = calculator.compileExpression("sin(x) + cot(x) + csc(x) + sec(x)", {"x"});
+        double sine = std::sin(angle), cosine = std::cos(angle);
+        checkClose(program.evaluate({angle}), sine + cosine / sine + 1 / sine + 1 / cosine, 1e-15, "fused trigonometric calls at " + std::to_string(angle));
+        double derivative = 0;
+        std::vector<double> registers(program.getRegisterCount()), tangents(program.getRegisterCount());
+        program.evaluateDerivative(&angle, 0, registers.data(), tangents.data(), derivative);
+        double expectedDerivative = cosine - 1 / (sine * sine) - cosine / (sine * sine) + sine / (cosine * cosine);
+        checkClose(derivative, expectedDerivative, 1e-14, "derivative of the fused trigonometric calls at " + std::to_string(angle));
+    }
+}
+
+/// @brief Function for counting the sincos instructions of a compiled program, from its listing.
+static size_t countSineCosineInstructions(const CompiledExpression& program) {
+    std::string listing = program.disassemble();
+    size_t count = 0;
+    for (size_t position = listing.find(" = sincos "); position != std::string::npos; position = listing.find(" = sincos ", position + 1)) count++;
+    return count;
+}
+
+/// @brief Function for testing that the compiler fuses the trigonometric calls of one operand into a single sincos instruction
+/// read by all of them, and only those, while the unfused calls and the interpreter keep the C library results.
+static void testTrigonometricFusion(Calculator& calculator) {
+    // Every function of x reads the one sincos instruction of x; calls of other operands are left alone.
+    CompiledExpression program = calculator.compileExpression("sin(x) + cos(x) + tan(x) + sec(x) + csc(x) + cot(x) + sin(y)*tan(x + 1)", {"x", "y"});
+    check(countSineCosineInstructions(program) == 1, "one sincos instruction for the six calls of x");
+    check(program.getStatistics().fusedTrigonometricCalls == 6, "six calls of x fused (" + std::to_string(program.getStatistics().fusedTrigonometricCalls) + ")");
+    for (double x : {0.3, -1.2, 2.5, 100.0}) {
+        double sine = std::sin(x), cosine = std::cos(x), y = 0.5;
+        double expected = sine + cosine + sine / cosine + 1 / cosine + 1 / sine + cosine / sine + std::sin(y) * std::tan(x + 1);
+        checkClose(program.evaluate({x, y}), expected, 1e-14, "six fused calls at " + std::to_string(x));
+        checkClose(evaluateBlock(program, {x, y}), expected, 1e-14, "six fused calls on a block at " + std::to_string(x));
+    }
+
+    // A pair is enough to fuse, including operands merged by common subexpression elimination; single calls are not fused.
+    check(countSineCosineInstructions(calculator.compileExpression("sin(x)*tan(x)", {"x"})) == 1, "sin(x)*tan(x) fused");
+    check(countSineCosineInstructions(calculator.compileExpression("sin(x + 1)/cos(1 + x)", {"x"})) == 1, "sin(x + 1)/cos(1 + x) fused");
+    check(countSineCosineInstructions(calculator.compileExpression("sin(x) + sin(y)", {"x", "y"})) == 0, "sin(x) + sin(y) not fused");
+    check(countSineCosineInstructions(calculator.compileExpression("tan(x)", {"x"})) == 0, "tan(x) alone not fused");
+    check(calculator.compileExpression("tan(x)", {"x"}, EvaluationMode::unchecked).getStatistics().fusedTrigonometricCalls == 0, "unchecked tan(x) alone not fused");
+
+    // The same tan and cot outside of a fused group are the C library functions, checked or not, compiled or interpreted.
+    CompiledExpression tangentProgram = calculator.compileExpression("tan(x)", {"x"}), cotangentProgram = calculator.compileExpression("cot(x)", {"x"});
+    CompiledExpression uncheckedTangentProgram = calculator.compileExpression("tan(x)", {"x"}, EvaluationMode::unchecked);
+    size_t mismatchCount = 0;
+    for (double x = -20; x < 20; x += 0.37) {
+        double expectedTangent = std::tan(x), expectedCotangent = std::cos(x) / std::sin(x);
+        mismatchCount += tangentProgram.evaluate({x}) != expectedTangent || uncheckedTangentProgram.evaluate({x}) != expectedTangent || cotangentProgram.evaluate({x}) != expectedCotangent;
+    }
+    check(mismatchCount == 0, "checked and unchecked tan and cot against the C library (" + std::to_string(mismatchCount) + " mismatch(es))");
+    check(calculator.evaluateAsync("tan(1.2)").get().value == std::tan(1.2), "interpreted tan(1.2) against the C library");
+}
+
+/// @brief Function for testing that common subexpression elimination merges repeated and commuted subtrees without changing
+/// the results.
+static void testCommonSubexpressionElimination(Calculator& calculator) {
+    CompiledExpression program = calculator.compileExpression("sin(x)^2 + sin(x)*cos(x) + sqrt(sin(x))", {"x"});
+    check(program.getStatistics().eliminatedOperations == 2, "two of the three sin(x) calls eliminated");
+    check(program.getStatistics().operationsAfterElimination == program.getStatistics().operationsBeforeElimination - 2, "operations counted after elimination");
+    for (double x : {0.7, 2.0, 3.1}) {
+        double sine = std::sin(x);
+        checkClose(program.evaluate({x}), sine * sine + sine * std::cos(x) + std::sqrt(sine), 1e-15, "sin(x)^2 + sin(x)*cos(x) + sqrt(sin(x)) at " + std::to_string(x));
+    }
+    CompiledExpression commutedProgram = calculator.compileExpression("(x + 1)*(1 + x) - exp(x*2)/exp(2*x)", {"x"});
+    check(commutedProgram.getStatistics().eliminatedOperations == 3, "commuted operands of '+' and '*' merged");
+    checkClose(commutedProgram.evaluate({0.7}), 1.7 * 1.7 - 1, 1e-15, "(x + 1)*(1 + x) - exp(x*2)/exp(2*x)");
+}
+
+/// @brief Function for testing that operations on constants are folded at compile time, exactly for pure-integer subexpressions,
+/// giving the results of the same operations evaluated at run time.
+static void testConstantFolding(Calculator& calculator) {
+    struct FoldingCase {
+        const char* expression;
+        const char* unfoldedExpression;
+        size_t foldedOperations;
+    };
+    const FoldingCase foldingCases[] = {
+        {"2*3 + x", "a*b + x", 1},
+        {"2^62 + 17 % 5 + x", "a^c + d % m + x", 3},
+        {"20! + x", "n! + x", 1},
+        {"-2^2 + x", "-a^a + x", 2},
+        {"sqrt(2)/3*x", "sqrt(a)/b*x", 2},
+    };
+    const std::vector<std::string> variableNames = {"x", "a", "b", "c", "d", "m", "n"};
+    const std::vector<double> variableValues = {0.25, 2, 3, 62, 17, 5, 20};
+    for (const FoldingCase& foldingCase : foldingCases) {
+        CompiledExpression program = calculator.compileExpression(foldingCase.expression, variableNames);
+        CompiledExpression unfoldedProgram = calculator.compileExpression(foldingCase.unfoldedExpression, variableNames);
+        std::string description = foldingCase.expression;
+        check(program.getStatistics().foldedOperations == foldingCase.foldedOperations, description + " folded " + std::to_string(program.getStatistics().foldedOperations) + " operation(s)");
+        check(unfoldedProgram.getStatistics().foldedOperations == 0, std::string(foldingCase.unfoldedExpression) + " not folded");
+        checkClose(program.evaluate(variableValues), unfoldedProgram.evaluate(variableValues), 0, description + " against " + foldingCase.unfoldedExpression);
+    }
+}
+
+/// @brief Function for testing the exact evaluation of pure-integer expressions, and its fallback to double on overflow.
+static void testIntegerPath(Calculator& calculator) {
+    struct IntegerCase {
+        const char* expression;
+        bool isInteger;
+        int64_t integer;
+        double value;
+    };
+    const IntegerCase integerCases[] = {
+        {"2^62 + 17 % 5", true, 4611686018427387906, 4611686018427387906.0},
+        {"20!", true, 2432902008176640000, 2432902008176640000.0},
+        {"9223372036854775807 - 1", true, 9223372036854775806, 9223372036854775806.0},
+        {"7 - 4*3", true, -5, -5},
+
+        // Overflowing results are computed in double.
+        {"21!", false, 0, 51090942171709440000.0},
+        {"2^63", false, 0, 9223372036854775808.0},
+        {"9223372036854775807 + 1", false, 0, 9223372036854775808.0},
+
+        // Division and non-integer operands leave the integers.
+        {"7/2", false, 0, 3.5},
+        {"2^-1", false, 0, 0.5},
+    };
+    for (const IntegerCase& integerCase : integerCases) {
+        StreamingValue result = calculator.evaluateAsync(integerCase.expression).get();
+        std::string description = integerCase.expression;
+        check(result.isInteger == integerCase.isInteger, description + (integerCase.isInteger ? " kept exact" : " computed in double"));
+        if (integerCase.isInteger) check(result.integer == integerCase.integer, description + " = " + std::to_string(result.integer));
+        checkClose(result.value, integerCase.value, 1e-15, description + " rounded to double");
+        checkClose(calculator.compileExpression(description).evaluate({}), integerCase.value, 1e-15, description + " folded");
+    }
+}
+
+/// @brief Function for testing that powers of double bases give the results of pow, checked and unchecked, compiled, folded and
+/// interpreted, including results which only avoid underflow or overflow because pow rounds once.
+static void testPowerAgainstLibrary(Calculator& calculator) {
+    CompiledExpression program = calculator.compileExpression("x^n", {"x", "n"});
+    CompiledExpression uncheckedProgram = calculator.compileExpression("x^n", {"x", "n"}, EvaluationMode::unchecked);
+    std::mt19937_64 generator(30);
+    std::uniform_real_distribution<double> baseDistribution(-10, 10);
+    size_t mismatchCount = 0, caseCount = 0;
+    for (int exponent = -20; exponent <= 20; exponent++) {
+        for (int sample = 0; sample < 200; sample++) {
+            double base = baseDistribution(generator), expected = std::pow(base, exponent);
+            caseCount++;
+            if (program.evaluate({base, static_cast<double>(exponent)}) != expected) mismatchCount++;
+            if (uncheckedProgram.evaluate({base, static_cast<double>(exponent)}) != expected) mismatchCount++;
+        }
+    }
+    check(mismatchCount == 0, std::to_string(mismatchCount) + " of " + std::to_string(2 * caseCount) + " powers of random bases differ from pow");
+
+    // Constant powers are folded and interpreted with pow as well. The interpreter rounds results below 1e-13 to 0.
+    for (const char* expression : {"1e20^-16", "1e-20^16", "0.1^16", "1.1^-16", "(-3.7)^15", "1e-30^-11"}) {
+        std::string description = expression;
+        double base = std::strtod(expression + (expression[0] == '(' ? 1 : 0), nullptr);
+        double expected = std::pow(base, std::strtod(std::strchr(expression, '^') + 1, nullptr));
+        checkClose(calculator.compileExpression(description).evaluate({}), expected, 0, description + " folded");
+        if (std::fabs(expected) >= 1e-13) checkClose(calculator.evaluateAsync(description).get().value, expected, 0, description + " interpreted");
+    }
+    check(calculator.compileExpression("1e20^-16").evaluate({}) > 0, "1e20^-16 does not underflow to 0");
+}
+
+/// @brief Function for testing the verdicts of the interval analysis, and that the programs it compiles give the checked results.
+static void testIntervalDomainSafety(Calculator& calculator) {
+    struct DomainCase {
+        const char* expression;
+        Interval range;
+        size_t provenSafeOperations;
+        const char* warningPrefix;
+    };
+    const DomainCase domainCases[] = {
+        {"ln(x) + sqrt(x)", {0.1, 10}, 2, nullptr},
+        {"acos(x/10)", {0.1, 10}, 2, nullptr},
+        {"1/(x - 20)", {0.1, 10}, 1, nullptr},
+        {"ln(x - 1)", {0.1, 10}, 0, "DomainWarning: ln(x - 1) may be called outside its domain (x > 0): its operand lies in [-0.9, 9]."},
+        {"acos(x/5)", {0.1, 10}, 1, "DomainWarning: acos(x / 5) may be called outside its domain"},
+        {"1/(x - 5)", {0.1, 10}, 0, "DomainWarning: 1 / (x - 5) may be called outside its domain (denominator != 0)"},
+        {"ln(x)", {}, 0, "DomainWarning: ln(x) may be called outside its domain"},
+    };
+    for (const DomainCase& domainCase : domainCases) {
+        CompiledExpression program = calculator.compileExpression(domainCase.expression, {"x"}, {domainCase.range});
+        CompiledExpression checkedProgram = calculator.compileExpression(domainCase.expression, {"x"});
+        std::string description = domainCase.expression;
+        const std::vector<std::string>& warnings = program.getDomainWarnings();
+        check(program.getStatistics().provenSafeOperations == domainCase.provenSafeOperations, description + " proved " + std::to_string(program.getStatistics().provenSafeOperations) + " operation(s) safe");
+        if (domainCase.warningPrefix == nullptr) check(warnings.empty(), description + " has no warning");
+        else check(warnings.size() == 1 && warnings[0].compare(0, std::strlen(domainCase.warningPrefix), domainCase.warningPrefix) == 0, description + " warned");
+
+        // Inside the range, the programs agree with the checked program, and the operations left checked still throw.
+        for (double x : {0.1, 0.5, 1.5, 3.0, 7.25, 10.0}) {
+            std::string checkedError = getErrorMessage([&]() { checkedProgram.evaluate({x}); });
+            std::string error = getErrorMessage([&]() { program.evaluate({x}); });
+            check(error == checkedError, description + " at " + std::to_string(x) + " threw \"" + error + "\"");
+            if (checkedError.empty()) checkClose(program.evaluate({x}), checkedProgram.evaluate({x}), 0, description + " at " + std::to_string(x));
+        }
+    }
+}
+
+/// @brief Function for testing that the intervals of powers enclose the results of the '^' kernel at random points of random
+/// ranges, for integer and non-integer exponents.
+static void testPowerEnclosure() {
+    std::mt19937_64 generator(49);
+    std::uniform_real_distribution<double> boundDistribution(-4, 4), fractionDistribution(0, 1);
+    size_t escapeCount = 0, caseCount = 0;
+    for (int exponent = -20; exponent <= 20; exponent++) {
+        for (int sample = 0; sample < 100; sample++) {
+            double first = boundDistribution(generator), second = boundDistribution(generator);
+            Interval base{std::min(first, second), std::max(first, second)};
+            Interval result = propagateBinaryInterval("^", base, {static_cast<double>(exponent), static_cast<double>(exponent)});
+            for (double point : {base.lower, base.upper, base.lower + fractionDistribution(generator) * (base.upper - base.lower)}) {
+                double value = std::pow(point, exponent);
+                caseCount++;
+                if (!std::isnan(value) && (value < result.lower || value > result.upper)) escapeCount++;
+            }
+        }
+    }
+
+    // Non-negative bases with non-integer exponents, and results at the edges of the range of double.
+    for (int sample = 0; sample < 2000; sample++) {
+        Interval base{fractionDistribution(generator) * 10, 0}, exponent{boundDistribution(generator) * 5, 0};
+        base.upper = base.lower + fractionDistribution(generator);
+        exponent.upper = exponent.lower + fractionDistribution(generator);
+        Interval result = propagateBinaryInterval("^", base, exponent);
+        double value = std::pow(base.lower + fractionDistribution(generator) * (base.upper - base.lower), exponent.lower + fractionDistribution(generator) * (exponent.upper - exponent.lower));
+        caseCount++;
+        if (value < result.lower || value > result.upper) escapeCount++;
+    }
+    check(escapeCount == 0, std::to_string(escapeCount) + " of " + std::to_string(caseCount) + " powers outside their interval");
+    Interval tiny = propagateBinaryInterval("^", {1e20, 1e20}, {-16, -16});
+    check(tiny.lower <= std::pow(1e20, -16) && std::pow(1e20, -16) <= tiny.upper && tiny.upper > 0, "1e20^-16 enclosed");
+}
+
+int main() {
+    Calculator calculator;
+    testCheckedTrigonometricErrors(calculator);
+    testTrigonometricFusion(calculator);
+    testCommonSubexpressionElimination(calculator);
+    testConstantFolding(calculator);
+    testIntegerPath(calculator);
+    testPowerAgainstLibrary(calculator);
+    testIntervalDomainSafety(calculator);
+    testPowerEnclosure();
+    return reportChecks("ExpressionCompilerTests");
+}
@@ -0,0 +1,143 @@
+// Tests of the accuracy tiers of the transcendental functions (see FastMath.hpp): the error bound of every tier against a
+// long double reference over the domain of the approximations, and which form (polynomial or C library) each path takes.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/FastMathTests.cpp $(ls *.cpp | grep -v main.cpp) -o FastMathTests
+// Usage:
+//     ./FastMathTests
+
+#include "Calculator.hpp"
+#include "FastMath.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <cfloat>
+#include <cstring>
+#include <random>
+#include <tuple>
+
+/// @brief Function tested, with the domain of its approximation and its reference.
+struct TestedFunction {
+    const char* name;
+    UnaryFunction function;
+    long double (*reference)(long double);
+    double smallestMagnitude, largestMagnitude;
+    bool isPositive;
+    double denseStart, denseStop;
+};
+
+/// @brief Function for drawing operands: half log-uniform over the magnitudes of the domain, half uniform over the interval
+/// around the reduction range.
+static std::vector<double> drawOperands(const TestedFunction& function, size_t sampleCount) {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> exponent(std::log2(function.smallestMagnitude), std::log2(function.largestMagnitude));
+    std::uniform_real_distribution<double> dense(function.denseStart, function.denseStop);
+    std::vector<double> operands(sampleCount);
+    for (size_t index = 0; index < sampleCount; index++) {
+        if (index % 2 == 0) operands[index] = dense(generator);
+        else operands[index] = std::exp2(exponent(generator)) * ((function.isPositive || generator() % 2 == 0) ? 1 : -1);
+    }
+    return operands;
+}
+
+/// @brief Function for measuring the error of a result in ulps of the correctly rounded one.
+static double getUlpError(double result, long double reference) {
+    double rounded = static_cast<double>(reference);
+    if (rounded == 0) return (result == 0) ? 0 : INFINITY;
+    return static_cast<double>(std::fabs(result - reference) / std::ldexp(1.0L, std::ilogb(rounded) - 52));
+}
+
+/// @brief Function for testing the error bound of every tier, and that the scalar form of each tier takes the documented path.
+static void testErrorBounds() {
+    const TestedFunction functions[] = {
+        {"sin", std::sin, sinl, 1e-300, 5e5, false, -4, 4},
+        {"cos", std::cos, cosl, 1e-300, 5e5, false, -4, 4},
+        {"exp", std::exp, expl, 1e-300, 708, false, -10, 10},
+        {"ln", std::log, logl, DBL_MIN, DBL_MAX, true, 0.5, 2},
+        {"log2", std::log2, log2l, DBL_MIN, DBL_MAX, true, 0.5, 2},
+        {"log", std::log10, log10l, DBL_MIN, DBL_MAX, true, 0.5, 2}
+    };
+    const size_t sampleCount = 200000;
+
+    for (const TestedFunction& function : functions) {
+        std::vector<double> operands = drawOperands(function, sampleCount), results(sampleCount);
+        FastFunction fastFunction = findFastFunction(function.name);
+        for (MathAccuracy tier : {MathAccuracy::oneUlp, MathAccuracy::fourUlps, MathAccuracy::approximate}) {
+            std::string description = std::string(function.name) + " at " + getMathAccuracyName(tier);
+
+            // Measure the element-wise form, which runs the polynomials, against the reference.
+            applyFastFunctionElementwise(fastFunction, tier, function.function, operands.data(), results.data(), sampleCount);
+            double maximumUlps = 0, maximumRelativeError = 0;
+            for (size_t index = 0; index < sampleCount; index++) {
+                long double reference = function.reference(operands[index]);
+                maximumUlps = std::max(maximumUlps, getUlpError(results[index], reference));
+                if (reference != 0) maximumRelativeError = std::max(maximumRelativeError, static_cast<double>(std::fabs((results[index] - reference) / reference)));
+            }
+            if (tier == MathAccuracy::oneUlp) check(maximumUlps <= 1, description + " within 1 ulp (" + std::to_string(maximumUlps) + ")");
+            else if (tier == MathAccuracy::fourUlps) check(maximumUlps <= 4, description + " within 4 ulps (" + std::to_string(maximumUlps) + ")");
+            else check(maximumRelativeError <= 1e-7, description + " within 1e-7 (" + std::to_string(maximumRelativeError) + ")");
+
+            // The scalar form calls the C library at the 1 ulp and 4 ulps tiers, and matches the element-wise form at the 1e-7 tier.
+            size_t mismatchCount = 0;
+            for (size_t index = 0; index < sampleCount; index++) {
+                double expected = (tier == MathAccuracy::approximate) ? results[index] : function.function(operands[index]);
+                double result = evaluateFastFunction(fastFunction, tier, function.function, operands[index]);
+                mismatchCount += std::memcmp(&result, &expected, sizeof(double)) != 0;
+            }
+            check(mismatchCount == 0, description + " scalar form (" + std::to_string(mismatchCount) + " mismatch(es))");
+        }
+    }
+}
+
+/// @brief Function for testing that operands outside the range of the approximations reach the fallback in every form.
+static void testFallbacks() {
+    const std::vector<double> trigonometricOperands = {NAN, INFINITY, -INFINITY, 0.0, -0.0, 1e6, -1e6, 1e300};
+    const std::vector<double> exponentialOperands = {NAN, INFINITY, -INFINITY, 709, -709, 800, -800};
+    const std::vector<double> logarithmOperands = {NAN, INFINITY, -INFINITY, 0.0, -0.0, -1.0, 1e-310, DBL_MIN / 2};
+    const std::tuple<const char*, UnaryFunction, const std::vector<double>*> functions[] = {
+        {"sin", std::sin, &trigonometricOperands}, {"cos", std::cos, &trigonometricOperands}, {"exp", std::exp, &exponentialOperands},
+        {"ln", std::log, &logarithmOperands}, {"log2", std::log2, &logarithmOperands}, {"log", std::log10, &logarithmOperands}
+    };
+    for (const auto& [name, function, operands] : functions) {
+        for (MathAccuracy tier : {MathAccuracy::oneUlp, MathAccuracy::fourUlps, MathAccuracy::approximate}) {
+            std::vector<double> results(operands->size());
+            applyFastFunctionElementwise(findFastFunction(name), tier, function, operands->data(), results.data(), operands->size());
+            for (size_t index = 0; index < operands->size(); index++) {
+                double operand = (*operands)[index], expected = function(operand);
+                double scalarResult = evaluateFastFunction(findFastFunction(name), tier, function, operand);
+                std::string description = std::string(name) + "(" + std::to_string(operand) + ") at " + getMathAccuracyName(tier);
+                check(std::memcmp(&results[index], &expected, sizeof(double)) == 0, description + " element-wise");
+                check(std::memcmp(&scalarResult, &expected, sizeof(double)) == 0, description + " scalar");
+            }
+        }
+    }
+}
+
+/// @brief Function for testing the tiers through compiled programs: row by row at the C library, in blocks at the tier.
+static void testCompiledPrograms(Calculator& calculator) {
+    std::vector<double> xs(1000);
+    for (size_t index = 0; index < xs.size(); index++) xs[index] = 0.01 + 0.37 * index;
+    for (MathAccuracy tier : {MathAccuracy::oneUlp, MathAccuracy::fourUlps}) {
+        CompiledExpression program = calculator.compileExpression("exp(-x/100) + ln(x) + log2(x)", {"x"}, EvaluationMode::checked, tier);
+        std::vector<double> registers(program.getRegisterCount() * xs.size()), results(xs.size());
+        const double* columns[] = {xs.data()};
+        program.evaluateBlock(columns, xs.size(), registers.data(), results.data());
+        size_t mismatchCount = 0;
+        double maximumUlps = 0;
+        for (size_t index = 0; index < xs.size(); index++) {
+            double x = xs[index];
+            mismatchCount += program.evaluate({x}) != std::exp(-x / 100) + std::log(x) + std::log2(x);
+            maximumUlps = std::max(maximumUlps, getUlpError(results[index], expl(-x / 100.0L) + logl(x) + log2l(x)));
+        }
+        std::string description = std::string("compiled program at ") + getMathAccuracyName(tier);
+        check(mismatchCount == 0, description + " evaluated row by row with the C library (" + std::to_string(mismatchCount) + " mismatch(es))");
+        check(maximumUlps <= 8, description + " in blocks (" + std::to_string(maximumUlps) + " ulps)");
+    }
+}
+
+int main() {
+    Calculator calculator;
+    testErrorBounds();
+    testFallbacks();
+    testCompiledPrograms(calculator);
+    return reportChecks("FastMathTests");
+}
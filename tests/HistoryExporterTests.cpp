@@ -0,0 +1,245 @@
+// Tests of the history export (see HistoryExporter.hpp): CSV and JSON files read back by independent parsers, with equations
+// holding quotes, commas, line breaks and control characters, results which must round-trip exactly, non-finite results, and
+// histories larger than a write.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/HistoryExporterTests.cpp $(ls *.cpp | grep -v main.cpp) -o HistoryExporterTests
+// Usage:
+//     ./HistoryExporterTests
+
+#include "HistoryExporter.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <bit>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <charconv>
+
+/// @brief Entry of the history, as read back from an export.
+struct Entry {
+    std::string equation;
+    double result;
+
+    /// @brief Whether the result is JSON's null, which stands for a non-finite result.
+    bool isNull = false;
+};
+
+/// @brief Function for reading a CSV export (RFC 4180: quoted fields, with doubled quotes, may hold commas and line breaks).
+/// @returns false if the text is not a well-formed export.
+static bool parseCsv(const std::string& text, std::vector<Entry>& entries) {
+    entries.clear();
+    const std::string header = "equation,result\n";
+    if (text.compare(0, header.size(), header) != 0) return false;
+    size_t position = header.size();
+    while (position < text.size()) {
+        // Read the equation, quoted or up to the comma.
+        Entry entry;
+        if (text[position] == '"') {
+            for (position++; ; position++) {
+                if (position >= text.size()) return false;
+                if (text[position] == '"') {
+                    if (position + 1 < text.size() && text[position + 1] == '"') position++;
+                    else break;
+                }
+                entry.equation += text[position];
+            }
+            position++;
+        } else {
+            while (position < text.size() && text[position] != ',') {
+                if (text[position] == '"' || text[position] == '\n' || text[position] == '\r') return false;
+                entry.equation += text[position++];
+            }
+        }
+        if (position >= text.size() || text[position] != ',') return false;
+
+        // Read the result up to the end of the line.
+        size_t end = text.find('\n', ++position);
+        if (end == std::string::npos) return false;
+        std::from_chars_result parsed = std::from_chars(text.data() + position, text.data() + end, entry.result);
+        if (parsed.ec != std::errc() || parsed.ptr != text.data() + end) return false;
+        entries.push_back(entry);
+        position = end + 1;
+    }
+    return true;
+}
+
+/// @brief Function for reading a JSON string, decoding its escapes.
+/// @returns false if the string is malformed, or holds raw control characters.
+static bool parseJsonString(const std::string& text, size_t& position, std::string& value) {
+    if (position >= text.size() || text[position++] != '"') return false;
+    while (position < text.size() && text[position] != '"') {
+        unsigned char character = static_cast<unsigned char>(text[position++]);
+        if (character < 0x20) return false;
+        if (character != '\\') {
+            value += static_cast<char>(character);
+            continue;
+        }
+        if (position >= text.size()) return false;
+        switch (text[position++]) {
+            case '"': value += '"'; break;
+            case '\\': value += '\\'; break;
+            case '/': value += '/'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                unsigned int codePoint = 0;
+                if (position + 4 > text.size()) return false;
+                std::from_chars_result parsed = std::from_chars(text.data() + position, text.data() + position + 4, codePoint, 16);
+                if (parsed.ptr != text.data() + position + 4 || codePoint >= 0x80) return false;
+                value += static_cast<char>(codePoint);
+                position += 4;
+                break;
+            }
+            default: return false;
+        }
+    }
+    return position++ < text.size();
+}
+
+/// @brief Function for reading a JSON export: an array of {"equation": string, "result": number or null} objects.
+/// @returns false if the text is not a well-formed export.
+static bool parseJson(const std::string& text, std::vector<Entry>& entries) {
+    entries.clear();
+    size_t position = 0;
+    auto skipJsonWhitespace = [&]() { while (position < text.size() && std::string(" \n\r\t").find(text[position]) != std::string::npos) position++; };
+    auto expect = [&](const std::string& token) {
+        skipJsonWhitespace();
+        if (text.compare(position, token.size(), token) != 0) return false;
+        position += token.size();
+        return true;
+    };
+
+    if (!expect("[")) return false;
+    skipJsonWhitespace();
+    if (position < text.size() && text[position] == ']') {
+        position++;
+    } else {
+        while (true) {
+            Entry entry;
+            if (!expect("{") || !expect("\"equation\"") || !expect(":")) return false;
+            skipJsonWhitespace();
+            if (!parseJsonString(text, position, entry.equation)) return false;
+            if (!expect(",") || !expect("\"result\"") || !expect(":")) return false;
+            skipJsonWhitespace();
+            if (expect("null")) {
+                entry.isNull = true;
+                entry.result = 0;
+            } else {
+                // JSON numbers: an optional minus, no leading '+', no nan or inf.
+                if (position >= text.size() || (text[position] != '-' && (text[position] < '0' || text[position] > '9'))) return false;
+                size_t end = text.find_first_not_of("0123456789+-.eE", position);
+                std::from_chars_result parsed = std::from_chars(text.data() + position, text.data() + end, entry.result);
+                if (parsed.ec != std::errc() || parsed.ptr != text.data() + end) return false;
+                position = end;
+            }
+            if (!expect("}")) return false;
+            entries.push_back(entry);
+            if (expect("]")) break;
+            if (!expect(",")) return false;
+        }
+    }
+    skipJsonWhitespace();
+    return position == text.size();
+}
+
+/// @brief Function for exporting a history, given oldest first, in a format.
+static std::string exportEntries(const std::vector<Entry>& entries, HistoryFormat format) {
+    LinkedList history;
+    for (const Entry& entry : entries) history.insertNode(entry.equation, entry.result);
+    std::ostringstream output;
+    check(exportHistory(history, format, output) == entries.size(), "number of entries exported");
+    return output.str();
+}
+
+/// @brief Function for checking that an export reads back as the history, bit for bit (non-finite results as null in JSON).
+static void checkRoundTrip(const std::vector<Entry>& entries, HistoryFormat format, const std::string& description) {
+    std::string text = exportEntries(entries, format);
+    std::vector<Entry> readEntries;
+    bool isParsed = (format == HistoryFormat::csv) ? parseCsv(text, readEntries) : parseJson(text, readEntries);
+    check(isParsed, description + " well formed");
+    check(readEntries.size() == entries.size(), description + " number of entries read back");
+    size_t mismatchCount = 0;
+    for (size_t index = 0; index < std::min(entries.size(), readEntries.size()); index++) {
+        const Entry& expected = entries[index];
+        const Entry& actual = readEntries[index];
+        bool isResultEqual;
+        if (format == HistoryFormat::json && !std::isfinite(expected.result)) isResultEqual = actual.isNull;
+        else if (std::isnan(expected.result)) isResultEqual = std::isnan(actual.result);
+        else isResultEqual = !actual.isNull && std::bit_cast<uint64_t>(actual.result) == std::bit_cast<uint64_t>(expected.result);
+        mismatchCount += actual.equation != expected.equation || !isResultEqual;
+    }
+    check(mismatchCount == 0, description + " entries read back (" + std::to_string(mismatchCount) + " mismatch(es))");
+}
+
+/// @brief Function for testing equations which must be quoted or escaped, and results which must round-trip.
+static void testSpecialEntries() {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const std::vector<Entry> entries = {
+        {"1+2", 3},
+        {"max(1,2)", 2},
+        {"\"quoted\"", 1},
+        {"\"", 0},
+        {"a\"\"b,\"", -1},
+        {"line\nbreak", 0.1},
+        {"carriage\rreturn", 1e-300},
+        {"crlf\r\n", -2.5},
+        {"tab\tand\x01\x1f control", 42},
+        {"back\\slash/", 1e300},
+        {"caf\xc3\xa9 \xe2\x88\x9a", 7},
+        {" leading and trailing spaces ", -0.0},
+        {",", 1.0 / 3.0},
+        {"0/0", std::numeric_limits<double>::quiet_NaN()},
+        {"1/0", infinity},
+        {"-1/0", -infinity},
+        {"denormal", std::numeric_limits<double>::denorm_min()},
+        {"largest", std::numeric_limits<double>::max()},
+        {"smallest", std::numeric_limits<double>::lowest()},
+        {"integer", 9007199254740993.0}
+    };
+    checkRoundTrip(entries, HistoryFormat::csv, "CSV of special entries");
+    checkRoundTrip(entries, HistoryFormat::json, "JSON of special entries");
+
+    // Exact texts of a few entries, and of empty histories.
+    check(exportEntries({{"max(1,2)", 2}, {"say \"hi\"", 0.5}, {"0/0", std::numeric_limits<double>::quiet_NaN()}, {"1/0", -infinity}}, HistoryFormat::csv) ==
+        "equation,result\n\"max(1,2)\",2\n\"say \"\"hi\"\"\",0.5\n0/0,nan\n1/0,-inf\n", "CSV text");
+    check(exportEntries({{"a\"\\\n\x01", 0.1}, {"1/0", infinity}}, HistoryFormat::json) ==
+        "[\n  {\"equation\": \"a\\\"\\\\\\n\\u0001\", \"result\": 0.1},\n  {\"equation\": \"1/0\", \"result\": null}\n]\n", "JSON text");
+    check(exportEntries({}, HistoryFormat::csv) == "equation,result\n", "empty CSV");
+    check(exportEntries({}, HistoryFormat::json) == "[]\n", "empty JSON");
+
+    check(findHistoryFormat("history.json") == HistoryFormat::json && findHistoryFormat("history.csv") == HistoryFormat::csv, "formats of the extensions");
+    check(findHistoryFormat("json") == HistoryFormat::csv && findHistoryFormat("history.json.txt") == HistoryFormat::csv, "formats of other paths");
+}
+
+/// @brief Function for testing random equations (any byte but the empty equation) and random results, over several writes.
+static void testRandomEntries() {
+    std::mt19937_64 generator(27);
+    std::vector<Entry> entries;
+    size_t byteCount = 0;
+    while (byteCount < 3 * (1 << 20)) {
+        // Equations mostly of printable characters, with special characters in some.
+        Entry entry;
+        size_t length = 1 + generator() % 200;
+        bool hasSpecialCharacters = generator() % 4 == 0;
+        for (size_t index = 0; index < length; index++) {
+            entry.equation += hasSpecialCharacters && generator() % 8 == 0 ? static_cast<char>(generator() % 256) : static_cast<char>(' ' + generator() % 95);
+        }
+
+        // Results of any bit pattern, including subnormals, infinities and NaNs.
+        entry.result = std::bit_cast<double>(generator());
+        entries.push_back(entry);
+        byteCount += length;
+    }
+    checkRoundTrip(entries, HistoryFormat::csv, "CSV of " + std::to_string(entries.size()) + " random entries");
+    checkRoundTrip(entries, HistoryFormat::json, "JSON of " + std::to_string(entries.size()) + " random entries");
+}
+
+int main() {
+    testSpecialEntries();
+    testRandomEntries();
+    return reportChecks("HistoryExporterTests");
+}
@@ -0,0 +1,142 @@
+// Tests of the incremental evaluator previewing expressions while they are typed (see IncrementalEvaluator.hpp): the characters
+// re-parsed after appends and after edits before, at and after a checkpoint, recovery from errors, and random edits checked
+// against evaluations from scratch.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/IncrementalEvaluatorTests.cpp $(ls *.cpp | grep -v main.cpp) -o IncrementalEvaluatorTests
+// Usage:
+//     ./IncrementalEvaluatorTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <random>
+
+/// @brief Number of characters between two checkpoints.
+static constexpr size_t checkpointInterval = IncrementalEvaluator::checkpointInterval;
+
+/// @brief Function for building the sum of termCount ones, "1+1+...+1".
+static std::string makeSumOfOnes(size_t termCount) {
+    std::string expression = "1";
+    for (size_t term = 1; term < termCount; term++) expression += "+1";
+    return expression;
+}
+
+/// @brief Function for evaluating a text, returning its value or its error message.
+static std::string evaluate(IncrementalEvaluator& evaluator, const std::string& text) {
+    try {
+        StreamingValue value = evaluator.update(text);
+        return value.isInteger ? std::to_string(value.integer) : std::to_string(value.value);
+    } catch (const std::invalid_argument& error) {
+        return error.what();
+    }
+}
+
+/// @brief Function for testing the characters parsed after appends and after edits around the checkpoints.
+static void testCheckpoints(Calculator& calculator) {
+    IncrementalEvaluator evaluator = calculator.createIncrementalEvaluator();
+    std::string text = makeSumOfOnes(1000);
+    check(evaluate(evaluator, text) == "1000" && evaluator.getParsedCharacterCount() == text.size(), "whole text parsed first");
+
+    // Appending only parses the new characters, and so does evaluating the same text again (none).
+    text += "+2";
+    check(evaluate(evaluator, text) == "1002" && evaluator.getParsedCharacterCount() == 2, "appended characters parsed alone");
+    check(evaluate(evaluator, text) == "1002" && evaluator.getParsedCharacterCount() == 0, "unchanged text not parsed");
+
+    // Edits resume from the last checkpoint at or before the first changed character. Even indexes hold the ones.
+    struct EditCase {
+        size_t position;
+        char replacement;
+        const char* expected;
+    };
+    const EditCase editCases[] = {
+        {1500, '3', "1004"},   // After several checkpoints.
+        {2 * checkpointInterval, '5', "1008"},   // At a checkpoint, which stays valid.
+        {2 * checkpointInterval - 1, '-', "998"},   // Just before a checkpoint: '+' becomes '-', subtracting the 5.
+        {checkpointInterval + 2, '0', "997"},   // Just after a checkpoint.
+        {10, '2', "998"},   // Before the first checkpoint.
+        {0, '0', "997"}   // At the first character.
+    };
+    for (const EditCase& editCase : editCases) {
+        text[editCase.position] = editCase.replacement;
+        std::string description = "edit at " + std::to_string(editCase.position);
+        check(evaluate(evaluator, text) == editCase.expected, description + " value");
+        size_t expectedParsedCount = text.size() - editCase.position / checkpointInterval * checkpointInterval;
+        check(evaluator.getParsedCharacterCount() == expectedParsedCount, description + " parsed " + std::to_string(evaluator.getParsedCharacterCount()) + " character(s)");
+    }
+
+    // Deleting the end of the text keeps the checkpoints before it, and typing again appends to the shorter text.
+    text.resize(600);
+    check(evaluate(evaluator, text) == "EvalError: Failed to find second argument for +.\n", "text cut after a '+'");
+    check(evaluator.getParsedCharacterCount() == 600 - 2 * checkpointInterval, "cut text parsed from the last checkpoint");
+    text += "7";
+    IncrementalEvaluator freshEvaluator = calculator.createIncrementalEvaluator();
+    check(evaluate(evaluator, text) == evaluate(freshEvaluator, text) && evaluator.getParsedCharacterCount() == 1, "digit typed after the cut text");
+}
+
+/// @brief Function for testing that edits after a failure resume correctly, whether the failure stopped the parse or the end.
+static void testErrorRecovery(Calculator& calculator) {
+    IncrementalEvaluator evaluator = calculator.createIncrementalEvaluator();
+    std::string text = makeSumOfOnes(500);
+    check(evaluate(evaluator, text) == "500", "sum of 500 ones");
+
+    // An error in the middle of the text stops the parse halfway; fixing it parses again from the checkpoint before it.
+    std::string brokenText = text;
+    brokenText[700] = ')';
+    check(evaluate(evaluator, brokenText).find("Error: ") != std::string::npos, "misplaced bracket rejected");
+    check(evaluate(evaluator, text) == "500", "bracket removed");
+    check(evaluator.getParsedCharacterCount() == text.size() - 700 / checkpointInterval * checkpointInterval, "parse resumed from the checkpoint before the error");
+
+    // Unclosed brackets are only reported at the end, and closing them appends.
+    check(evaluate(evaluator, text + "*(2").find("MathError") == 0, "unclosed bracket rejected");
+    check(evaluate(evaluator, text + "*(2)") == "501" && evaluator.getParsedCharacterCount() == 1, "closing bracket appended");
+}
+
+/// @brief Function for testing random edits (insertions, deletions and replacements) against evaluations from scratch.
+static void testRandomEdits(Calculator& calculator) {
+    IncrementalEvaluator evaluator = calculator.createIncrementalEvaluator();
+    std::mt19937 generator(11);
+    const std::string alphabet = "0123456789+-*/()^. ";
+    std::string text = makeSumOfOnes(400);
+    size_t mismatchCount = 0, overParsedCount = 0, boundedEditCount = 0;
+    bool isPreviousTextValid = evaluate(evaluator, text) == "400";
+    for (int edit = 0; edit < 2000; edit++) {
+        // Apply an edit at a random position, sometimes at the end.
+        std::string previousText = text;
+        size_t position = (edit % 4 == 0) ? text.size() : generator() % (text.size() + 1);
+        char character = alphabet[generator() % alphabet.size()];
+        switch (generator() % 3) {
+            case 0: text.insert(position, 1, character); break;
+            case 1: if (position < text.size()) text.erase(position, 1); break;
+            case 2: if (position < text.size()) text[position] = character; break;
+        }
+        if (text.empty()) text = "1";
+
+        // Compare with a new evaluator, which parses the whole text. Restart from a valid text once the text has many errors.
+        IncrementalEvaluator freshEvaluator = calculator.createIncrementalEvaluator();
+        std::string result = evaluate(evaluator, text);
+        mismatchCount += result != evaluate(freshEvaluator, text);
+
+        // After a valid text, whose checkpoints have all been saved, at most the characters after the checkpoint before the first
+        // changed one are parsed.
+        if (isPreviousTextValid) {
+            size_t prefixLength = 0;
+            while (prefixLength < std::min(text.size(), previousText.size()) && text[prefixLength] == previousText[prefixLength]) prefixLength++;
+            overParsedCount += evaluator.getParsedCharacterCount() > text.size() - prefixLength / checkpointInterval * checkpointInterval;
+            boundedEditCount++;
+        }
+        isPreviousTextValid = result.find("Error") == std::string::npos;
+        if (!isPreviousTextValid && generator() % 8 == 0) text = makeSumOfOnes(200 + generator() % 400);
+    }
+    check(mismatchCount == 0, "random edits against evaluations from scratch (" + std::to_string(mismatchCount) + " mismatch(es))");
+    check(boundedEditCount > 100 && overParsedCount == 0, "random edits after valid texts parsed from the checkpoint before the edit (" +
+        std::to_string(overParsedCount) + " of " + std::to_string(boundedEditCount) + " over)");
+}
+
+int main() {
+    Calculator calculator;
+    testCheckpoints(calculator);
+    testErrorRecovery(calculator);
+    testRandomEdits(calculator);
+    return reportChecks("IncrementalEvaluatorTests");
+}
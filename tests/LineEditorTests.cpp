@@ -0,0 +1,108 @@
+// Tests of the line editor (see LineEditor.hpp): decoding of the keystrokes from the bytes of the terminal, and editing of the
+// line by the keys, including the end of the input.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/LineEditorTests.cpp $(ls *.cpp | grep -v main.cpp) -o LineEditorTests
+// Usage:
+//     ./LineEditorTests
+
+#include "LineEditor.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <vector>
+
+typedef LineEditor::Key Key;
+typedef LineEditor::EditResult EditResult;
+
+/// @brief Function for creating a byte source reading the bytes of a string, then -1 forever.
+static LineEditor::ByteSource makeByteSource(const std::string& bytes, size_t& position) {
+    return [&bytes, &position]() { return (position < bytes.size()) ? static_cast<unsigned char>(bytes[position++]) : -1; };
+}
+
+/// @brief Function for decoding a single keystroke, checking that it consumes every byte.
+static Key decodeOnly(const std::string& bytes, char& character) {
+    size_t position = 0;
+    Key key = LineEditor::decodeKey(makeByteSource(bytes, position), character);
+    check(position == bytes.size(), "all " + std::to_string(bytes.size()) + " byte(s) of a keystroke consumed");
+    return key;
+}
+
+/// @brief Function for editing a line from the bytes typed, like LineEditor::readLine() does in raw mode.
+/// @param result Reference receiving the result of the last key.
+/// @returns The line, after at most one key per byte plus one.
+static std::string editLine(const std::string& bytes, EditResult& result) {
+    size_t position = 0, cursor = 0;
+    std::string line;
+    LineEditor::ByteSource readByte = makeByteSource(bytes, position);
+    result = EditResult::editing;
+    for (size_t keyCount = 0; keyCount <= bytes.size() && result == EditResult::editing; keyCount++) {
+        char character = 0;
+        Key key = LineEditor::decodeKey(readByte, character);
+        result = LineEditor::applyKey(key, character, line, cursor);
+    }
+    return line;
+}
+
+/// @brief Function for testing the keys decoded from single bytes and from escape sequences.
+static void testKeyDecoding() {
+    char character = 0;
+    check(decodeOnly("a", character) == Key::character && character == 'a', "printable character");
+    check(decodeOnly("~", character) == Key::character && character == '~', "last printable character");
+    check(decodeOnly("\r", character) == Key::enter && decodeOnly("\n", character) == Key::enter, "Enter");
+    check(decodeOnly("\x7f", character) == Key::backspace && decodeOnly("\b", character) == Key::backspace, "Backspace");
+    check(decodeOnly("\x01", character) == Key::home && decodeOnly("\x05", character) == Key::end, "Ctrl-A and Ctrl-E");
+    check(decodeOnly("\x15", character) == Key::clear, "Ctrl-U");
+    check(decodeOnly("\x04", character) == Key::endOfTransmission, "Ctrl-D");
+    check(decodeOnly("", character) == Key::endOfFile, "end of the input");
+    check(decodeOnly("\x02", character) == Key::ignored && decodeOnly("\xc3", character) == Key::ignored, "other control characters and bytes");
+
+#ifndef _WIN32
+    // Escape sequences of the special keys, in their CSI (ESC [) and SS3 (ESC O) forms.
+    check(decodeOnly("\x1b[C", character) == Key::right && decodeOnly("\x1b[D", character) == Key::left, "arrows");
+    check(decodeOnly("\x1bOC", character) == Key::right && decodeOnly("\x1bOD", character) == Key::left, "arrows in application mode");
+    check(decodeOnly("\x1b[H", character) == Key::home && decodeOnly("\x1b[F", character) == Key::end, "Home and End");
+    check(decodeOnly("\x1bOH", character) == Key::home && decodeOnly("\x1bOF", character) == Key::end, "Home and End in application mode");
+    check(decodeOnly("\x1b[1~", character) == Key::home && decodeOnly("\x1b[7~", character) == Key::home, "numbered Home");
+    check(decodeOnly("\x1b[4~", character) == Key::end && decodeOnly("\x1b[8~", character) == Key::end, "numbered End");
+    check(decodeOnly("\x1b[3~", character) == Key::deleteCharacter, "Delete");
+    check(decodeOnly("\x1b[5~", character) == Key::ignored && decodeOnly("\x1b[A", character) == Key::ignored, "Page Up and Up ignored");
+    check(decodeOnly("\x1b[15~", character) == Key::ignored, "F5 ignored");
+    check(decodeOnly("\x1bx", character) == Key::ignored, "Alt-x ignored");
+
+    // Sequences cut by the end of the input are ignored, and the end of the input follows.
+    size_t position = 0;
+    std::string truncated = "\x1b[3";
+    LineEditor::ByteSource readByte = makeByteSource(truncated, position);
+    check(LineEditor::decodeKey(readByte, character) == Key::ignored, "sequence cut by the end of the input");
+    check(LineEditor::decodeKey(readByte, character) == Key::endOfFile, "end of the input after a cut sequence");
+#endif
+}
+
+/// @brief Function for testing the edits of the keys, and the results ending the line.
+static void testEditing() {
+    EditResult result;
+    check(editLine("1+2\r", result) == "1+2" && result == EditResult::accepted, "line entered");
+    check(editLine("abc\x01X\x05Y\r", result) == "XabcY", "Ctrl-A and Ctrl-E");
+    check(editLine("abc\x7f\x7f\r", result) == "a", "Backspace");
+    check(editLine("\x7fxy\r", result) == "xy", "Backspace on an empty line");
+    check(editLine("abc\x01\x04\r", result) == "bc", "Ctrl-D deletes the character under the cursor");
+    check(editLine("abc\x04\r", result) == "abc" && result == EditResult::accepted, "Ctrl-D at the end of a line does nothing");
+    check(editLine("abc\x15z\r", result) == "z", "Ctrl-U");
+    check(editLine("\x04", result).empty() && result == EditResult::ended, "Ctrl-D on an empty line ends the input");
+#ifndef _WIN32
+    check(editLine("abd\x1b[DX\x1b[C\x1b[3~Y\r", result) == "abXdY", "arrows and Delete");
+    check(editLine("ab\x1b[H\x1b[3~\x1b[F!\r", result) == "b!", "Home, Delete and End");
+    check(editLine("ab\x1b[D\x1b[D\x1b[D\x1b[Cx\r", result) == "axb", "Left stops at the start of the line");
+#endif
+
+    // A closed input ends the editing: the line typed so far is entered, and an empty line ends the input.
+    check(editLine("1+2", result) == "1+2" && result == EditResult::accepted, "closed input after a line");
+    check(editLine("", result).empty() && result == EditResult::ended, "closed input on an empty line");
+    check(editLine("ab\x01", result) == "ab" && result == EditResult::accepted, "closed input with the cursor inside the line");
+}
+
+int main() {
+    testKeyDecoding();
+    testEditing();
+    return reportChecks("LineEditorTests");
+}
@@ -0,0 +1,95 @@
+// Tests of the equation solver (see EquationSolver.hpp) and of the numerical integrator (see NumericalIntegrator.hpp), checking
+// that they converge to known roots and integrals, and report the cases where they cannot.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/NumericalMethodsTests.cpp $(ls *.cpp | grep -v main.cpp) -o NumericalMethodsTests
+// Usage:
+//     ./NumericalMethodsTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+/// @brief Function for testing the roots found from a guess, in a bracket and on a grid.
+static void testSolverConvergence(Calculator& calculator) {
+    struct SolverCase {
+        const char* command;
+        std::vector<double> expectedRoots;
+    };
+    const double pi = std::acos(-1.0);
+    const SolverCase solverCases[] = {
+        {"solve cos(x) = x x=0.5", {0.7390851332151607}},
+        {"x^2 - 2 x=1", {std::sqrt(2.0)}},
+        {"solve x^3 = 2 x=0..2", {std::cbrt(2.0)}},
+        {"solve sin(x) = 0.5 x=0..20 step 0.1", {pi / 6, 5 * pi / 6, pi / 6 + 2 * pi, 5 * pi / 6 + 2 * pi, pi / 6 + 4 * pi, 5 * pi / 6 + 4 * pi, pi / 6 + 6 * pi}},
+    };
+    for (const SolverCase& solverCase : solverCases) {
+        std::vector<EquationRoot> roots = calculator.solveEquation(solverCase.command);
+        std::string description = solverCase.command;
+        check(roots.size() == solverCase.expectedRoots.size(), description + " found " + std::to_string(roots.size()) + " root(s)");
+        for (size_t root = 0; root < std::min(roots.size(), solverCase.expectedRoots.size()); root++) {
+            checkClose(roots[root].value, solverCase.expectedRoots[root], 1e-15, description + ", root " + std::to_string(root));
+            check(std::fabs(roots[root].residual) < 1e-14, description + ", residual of root " + std::to_string(root));
+            check(roots[root].evaluationCount <= 20, description + ", root " + std::to_string(root) + " refined in " + std::to_string(roots[root].evaluationCount) + " evaluations");
+        }
+    }
+    checkThrows([&]() { calculator.solveEquation("solve x^2 = -1 x=0..2"); }, "EvalError: Expected the expression to change sign between 0 and 2", "bracket without a sign change");
+    checkThrows([&]() { calculator.solveEquation("solve x^2 + 1 x=0.5"); }, "EvalError: No root found around the guess 0.5", "guess without a root");
+}
+
+/// @brief Function for testing that sign changes across a pole are not reported as roots, in a bracket or on a grid.
+static void testSolverDiscontinuities(Calculator& calculator) {
+    checkThrows([&]() { calculator.solveEquation("solve tan(x) x=1..2"); }, "EvalError: No root in the bracket between 1 and 2 (discontinuity at 1.57079632679489", "pole of tan(x) in a bracket");
+    checkThrows([&]() { calculator.solveEquation("solve 1/(x-1) x=0..3"); }, "EvalError: No root in the bracket between 0 and 3 (discontinuity at 0.9999999999999", "pole of 1/(x-1) in a bracket");
+    checkThrows([&]() { calculator.solveEquation("solve 1/(x-1) = 0 x=0.5"); }, "EvalError: No root found around the guess 0.5", "pole of 1/(x-1) near a guess");
+
+    // On a grid, the poles are dropped and the roots kept.
+    const double pi = std::acos(-1.0);
+    std::vector<EquationRoot> roots = calculator.solveEquation("solve tan(x) x=0.5..7 step 0.1");
+    check(roots.size() == 2, "tan(x) on a grid found " + std::to_string(roots.size()) + " root(s)");
+    for (size_t root = 0; root < std::min<size_t>(roots.size(), 2); root++) checkClose(roots[root].value, (root + 1) * pi, 1e-15, "root " + std::to_string(root) + " of tan(x)");
+    check(calculator.solveEquation("solve 1/(x-1) x=0..3 step 0.3").empty(), "no root of 1/(x-1) on a grid");
+    check(calculator.solveEquation("solve 1/(x-1) x=0..3 step 0.25").empty(), "no root of 1/(x-1) on a grid through its pole");
+    roots = calculator.solveEquation("solve ln(x) x=0..2 step 0.5");
+    check(roots.size() == 1 && roots[0].value == 1, "root of ln(x) next to its pole at the end of the grid");
+}
+
+/// @brief Function for testing the integrals of smooth, singular and oscillating expressions, and their error estimates.
+static void testIntegratorConvergence(Calculator& calculator) {
+    struct IntegralCase {
+        const char* command;
+        double expectedValue;
+        double tolerance;
+    };
+    const double pi = std::acos(-1.0);
+    const IntegralCase integralCases[] = {
+        {"integrate(sin(x)^2, x, 0, 2*pi)", pi, 1e-15},
+        {"integrate(exp(-(x^2)), x=-10..10)", std::sqrt(pi), 1e-15},
+        {"integrate(x^2, x, 3, 0)", -9, 1e-15},
+        {"integrate(1/sqrt(x), x, 0, 1)", 2, 1e-10},
+    };
+    for (const IntegralCase& integralCase : integralCases) {
+        IntegrationResult result = calculator.integrateExpression(integralCase.command);
+        std::string description = integralCase.command;
+        check(result.isConverged, description + " converged");
+        checkClose(result.value, integralCase.expectedValue, integralCase.tolerance, description);
+        check(result.errorEstimate <= 1e-9 * std::fabs(integralCase.expectedValue), description + " error estimate " + std::to_string(result.errorEstimate));
+        check(std::fabs(result.value - integralCase.expectedValue) <= std::max(result.errorEstimate, 1e-15 * std::fabs(integralCase.expectedValue)) * 10, description + " error within its estimate");
+    }
+
+    // A budget too small for the requested accuracy is reported, and so are integrands which are not finite.
+    IntegrationResult result = calculator.integrateExpression("integrate(sin(1/x), x, 0.001, 1)", 1e-12, 1000);
+    check(!result.isConverged, "sin(1/x) not converged within 1000 evaluations");
+    check(result.evaluationCount <= 1000, "sin(1/x) stopped within the budget (" + std::to_string(result.evaluationCount) + " evaluations)");
+    checkThrows([&]() { calculator.integrateExpression("integrate(1/x, x, -1, 1)"); }, "EvalError: The integrand is inf at 0", "pole inside the range");
+}
+
+int main() {
+    Calculator calculator;
+    testSolverConvergence(calculator);
+    testSolverDiscontinuities(calculator);
+    testIntegratorConvergence(calculator);
+    return reportChecks("NumericalMethodsTests");
+}
@@ -0,0 +1,285 @@
+// Tests of the parallel evaluations of the calculator, checking that their results do not depend on the number of threads nor on
+// the scheduling, match the sequential results, and that errors raised on worker threads reach the caller.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/ParallelEvaluationTests.cpp $(ls *.cpp | grep -v main.cpp) -o ParallelEvaluationTests
+// Usage:
+//     ./ParallelEvaluationTests
+
+#include "Calculator.hpp"
+#include "ThreadPool.hpp"
+#include "ColumnAggregator.hpp"
+#include "CsvColumnEvaluator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/// @brief Numbers of threads of the pools the results are compared across.
+static const unsigned threadCounts[] = {1, 2, 3, 8};
+
+/// @brief Function for comparing two doubles bit for bit.
+static bool isSameBits(double first, double second) {
+    return std::memcmp(&first, &second, sizeof(double)) == 0;
+}
+
+/// @brief Function for testing that long chains of '+' / '-' and '*' evaluate to the same bits with any pool, including pools
+/// shared by concurrent evaluations, and to the exact or sequential result.
+static void testAssociativeChains(Calculator& calculator) {
+    const size_t termCount = 50000;
+    std::string sumExpression, alternatingExpression, productExpression;
+    long double referenceSum = 0, referenceProduct = 1;
+    for (size_t k = 1; k <= termCount; k++) {
+        sumExpression += (k > 1 ? "+sin(" : "sin(") + std::to_string(k) + "*x)";
+        alternatingExpression += (k == 1 ? "" : (k % 2 == 0 ? "-" : "+")) + std::to_string(k) + "*x";
+        productExpression += (k > 1 ? "*(1+x/" : "(1+x/") + std::to_string(k * k) + ")";
+        referenceSum += std::sin(static_cast<double>(k) * 0.3);
+        referenceProduct *= 1 + 0.3L / (static_cast<long double>(k) * k);
+    }
+    CompiledExpression sumProgram = calculator.compileExpression(sumExpression, {"x"});
+    CompiledExpression alternatingProgram = calculator.compileExpression(alternatingExpression, {"x"});
+    CompiledExpression productProgram = calculator.compileExpression(productExpression, {"x"});
+    check(sumProgram.getStatistics().parallelReductionTerms == termCount, "sum rebalanced into a parallel reduction");
+    check(productProgram.getStatistics().parallelReductionTerms == termCount, "product rebalanced into a parallel reduction");
+
+    // Every pool gives the bits of the single-thread pool.
+    double x = 0.3, one = 1;
+    WorkStealingThreadPool sequentialPool(1);
+    std::vector<double> registers(std::max({sumProgram.getRegisterCount(), alternatingProgram.getRegisterCount(), productProgram.getRegisterCount()}));
+    double sequentialSum = sumProgram.evaluate(&x, registers.data(), sequentialPool);
+    double sequentialProduct = productProgram.evaluate(&x, registers.data(), sequentialPool);
+    for (unsigned threadCount : threadCounts) {
+        WorkStealingThreadPool pool(threadCount);
+        for (int repetition = 0; repetition < 3; repetition++) {
+            std::string description = " with " + std::to_string(threadCount) + " thread(s), repetition " + std::to_string(repetition);
+            check(isSameBits(sumProgram.evaluate(&x, registers.data(), pool), sequentialSum), "sum" + description);
+            check(isSameBits(productProgram.evaluate(&x, registers.data(), pool), sequentialProduct), "product" + description);
+            check(alternatingProgram.evaluate(&one, registers.data(), pool) == -static_cast<double>(termCount / 2), "alternating sum" + description);
+        }
+    }
+    checkClose(sequentialSum, static_cast<double>(referenceSum), 1e-13, "compensated sum against the long double sum");
+    checkClose(sequentialProduct, static_cast<double>(referenceProduct), 1e-11, "product against the long double product");
+
+    // The interpreter evaluates the chains from left to right, on one thread.
+    std::string interpretedSumExpression = sumExpression, interpretedAlternatingExpression = alternatingExpression;
+    for (size_t position = 0; (position = interpretedSumExpression.find('x', position)) != std::string::npos;) interpretedSumExpression.replace(position, 1, "0.3");
+    for (size_t position = 0; (position = interpretedAlternatingExpression.find('x', position)) != std::string::npos;) interpretedAlternatingExpression.replace(position, 1, "1");
+    checkClose(calculator.evaluateAsync(interpretedSumExpression).get().value, sequentialSum, 1e-11, "sum against the interpreter");
+    check(calculator.evaluateAsync(interpretedAlternatingExpression).get().value == -static_cast<double>(termCount / 2), "alternating sum of the interpreter");
+
+    // Threads evaluating the programs at once on one pool steal each other's groups and still get the same bits.
+    WorkStealingThreadPool sharedPool(4);
+    std::vector<int> mismatchCounts(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < mismatchCounts.size(); index++) {
+        threads.emplace_back([&, index]() {
+            std::vector<double> threadRegisters(registers.size());
+            for (int repetition = 0; repetition < 5; repetition++) {
+                if (!isSameBits(sumProgram.evaluate(&x, threadRegisters.data(), sharedPool), sequentialSum)) mismatchCounts[index]++;
+                if (!isSameBits(productProgram.evaluate(&x, threadRegisters.data(), sharedPool), sequentialProduct)) mismatchCounts[index]++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    check(std::count(mismatchCounts.begin(), mismatchCounts.end(), 0) == 4, "concurrent evaluations on a shared pool");
+
+    // A domain error raised in a group evaluated by a worker reaches the caller.
+    CompiledExpression failingProgram = calculator.compileExpression(sumExpression + "+sqrt(x-1)", {"x"});
+    for (unsigned threadCount : threadCounts) {
+        WorkStealingThreadPool pool(threadCount);
+        checkThrows([&]() { failingProgram.evaluate(&x, registers.data(), pool); }, "DomainError", "error of a group with " + std::to_string(threadCount) + " thread(s)");
+    }
+}
+
+/// @brief Function for writing a CSV file of rowCount rows spanning several chunks, with an id and a value column holding
+/// the shortest representations of its values.
+/// @returns The values of the value column.
+static std::vector<double> writeCsvFile(const std::string& path, size_t rowCount) {
+    std::vector<double> values;
+    std::ofstream file(path);
+    file << "id,value\n";
+    for (size_t row = 0; row < rowCount; row++) {
+        double value = static_cast<double>((row * 7919) % 100003) / 1000 - 50;
+        values.push_back(value);
+        char buffer[32];
+        file << row << ',' << std::string_view(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer) << '\n';
+    }
+    return values;
+}
+
+/// @brief Function for testing that the column aggregates of a file of several chunks evaluate to the same bits with any pool,
+/// including pools shared by concurrent aggregations, and to the sequential result.
+static void testColumnAggregates(Calculator& calculator, const std::string& path, const std::vector<double>& values) {
+    const AggregateFunction functions[] = {AggregateFunction::sum, AggregateFunction::mean, AggregateFunction::minimum, AggregateFunction::maximum, AggregateFunction::standardDeviation};
+    const char* functionNames[] = {"sum", "mean", "min", "max", "stddev"};
+    CompiledExpression program = calculator.compileExpression("x^2 - 3*x", {"x"});
+
+    // Reduce the values sequentially in long double.
+    long double sum = 0, squaredDeviationSum = 0;
+    double minimum = HUGE_VAL, maximum = -HUGE_VAL;
+    for (double value : values) {
+        double term = value * value - 3 * value;
+        sum += term;
+        minimum = std::min(minimum, term);
+        maximum = std::max(maximum, term);
+    }
+    long double mean = sum / values.size();
+    for (double value : values) squaredDeviationSum += (value * value - 3 * value - mean) * (value * value - 3 * value - mean);
+    const double expectedValues[] = {static_cast<double>(sum), static_cast<double>(mean), minimum, maximum, static_cast<double>(std::sqrt(squaredDeviationSum / values.size()))};
+
+    // Every pool gives the bits of the single-thread pool, and of the aggregates typed at the prompt.
+    WorkStealingThreadPool sequentialPool(1);
+    ColumnAggregator sequentialAggregator(program, sequentialPool);
+    for (size_t index = 0; index < std::size(functions); index++) {
+        double sequentialValue = sequentialAggregator.aggregate(functions[index], path, "value");
+        std::string name = functionNames[index];
+        check(sequentialAggregator.getValueCount() == values.size(), name + " reduced every row");
+        checkClose(sequentialValue, expectedValues[index], 1e-13, name + " against the long double reduction");
+        check(isSameBits(calculator.aggregateColumn(name + "(x^2 - 3*x, x in " + path + ":value)"), sequentialValue), name + " typed at the prompt");
+        for (unsigned threadCount : threadCounts) {
+            WorkStealingThreadPool pool(threadCount);
+            ColumnAggregator aggregator(program, pool);
+            for (int repetition = 0; repetition < 2; repetition++) {
+                check(isSameBits(aggregator.aggregate(functions[index], path, "value"), sequentialValue), name + " with " + std::to_string(threadCount) + " thread(s), repetition " + std::to_string(repetition));
+            }
+        }
+    }
+
+    // Threads aggregating at once on one pool steal each other's chunks and still get the same bits.
+    double sequentialSum = sequentialAggregator.aggregate(AggregateFunction::sum, path, "value");
+    double sequentialDeviation = sequentialAggregator.aggregate(AggregateFunction::standardDeviation, path, "value");
+    WorkStealingThreadPool sharedPool(4);
+    std::vector<int> mismatchCounts(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < mismatchCounts.size(); index++) {
+        threads.emplace_back([&, index]() {
+            ColumnAggregator aggregator(program, sharedPool);
+            for (int repetition = 0; repetition < 3; repetition++) {
+                if (!isSameBits(aggregator.aggregate(AggregateFunction::sum, path, "value"), sequentialSum)) mismatchCounts[index]++;
+                if (!isSameBits(aggregator.aggregate(AggregateFunction::standardDeviation, path, "value"), sequentialDeviation)) mismatchCounts[index]++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    check(std::count(mismatchCounts.begin(), mismatchCounts.end(), 0) == 4, "concurrent aggregates on a shared pool");
+
+    // A domain error raised in a chunk reduced by a worker reaches the caller.
+    CompiledExpression failingProgram = calculator.compileExpression("sqrt(x + 49)", {"x"});
+    for (unsigned threadCount : threadCounts) {
+        WorkStealingThreadPool pool(threadCount);
+        ColumnAggregator aggregator(failingProgram, pool);
+        checkThrows([&]() { aggregator.aggregate(AggregateFunction::sum, path, "value"); }, "DomainError", "error of a chunk with " + std::to_string(threadCount) + " thread(s)");
+    }
+}
+
+/// @brief Function for evaluating a program of id and value on every row on its own, the way the column mode writes them.
+/// @returns The lines of the results, nan for the rows outside the domain.
+static std::string evaluateRows(const CompiledExpression& program, const std::vector<double>& values) {
+    std::string text = "result\n";
+    char buffer[32];
+    for (size_t row = 0; row < values.size(); row++) {
+        double result = NAN;
+        try {
+            result = program.evaluate({static_cast<double>(row), values[row]});
+        } catch (const std::invalid_argument&) {}
+        text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), std::isnan(result) ? NAN : result).ptr);
+        text += '\n';
+    }
+    return text;
+}
+
+/// @brief Function for testing that the column mode writes the same lines with any pool, including pools shared by concurrent
+/// evaluations, in file order, and that they are the results of evaluating the program on every row sequentially.
+static void testCsvColumnMode(Calculator& calculator, const std::string& path, const std::vector<double>& values) {
+    // The calculator compiles the expression unchecked, checked programs fall back to evaluating the rows of failing blocks one by one.
+    CompiledExpression uncheckedProgram = calculator.compileExpression("sqrt(value) + id/7", {"id", "value"}, EvaluationMode::unchecked);
+    CompiledExpression program = calculator.compileExpression("sqrt(value) + id/7", {"id", "value"});
+    std::string expectedText = evaluateRows(program, values);
+
+    // Every pool writes the lines of the sequential evaluation, and so does the column mode of the calculator.
+    std::ostringstream calculatorOutput;
+    check(calculator.evaluateCsv("sqrt(value) + id/7", path, calculatorOutput) == values.size(), "calculator wrote every row");
+    check(calculatorOutput.str() == evaluateRows(uncheckedProgram, values), "calculator column mode against the sequential evaluation");
+    for (unsigned threadCount : threadCounts) {
+        WorkStealingThreadPool pool(threadCount);
+        CsvColumnEvaluator evaluator(program, pool);
+        for (int repetition = 0; repetition < 2; repetition++) {
+            std::ostringstream output;
+            std::string description = " with " + std::to_string(threadCount) + " thread(s), repetition " + std::to_string(repetition);
+            check(evaluator.evaluate(path, output) == values.size(), "every row written" + description);
+            check(output.str() == expectedText, "rows in file order" + description);
+        }
+    }
+
+    // Threads evaluating the file at once on one pool steal each other's chunks and still write the same lines.
+    WorkStealingThreadPool sharedPool(4);
+    std::vector<int> mismatchCounts(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < mismatchCounts.size(); index++) {
+        threads.emplace_back([&, index]() {
+            CsvColumnEvaluator evaluator(program, sharedPool);
+            for (int repetition = 0; repetition < 3; repetition++) {
+                std::ostringstream output;
+                evaluator.evaluate(path, output);
+                if (output.str() != expectedText) mismatchCounts[index]++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    check(std::count(mismatchCounts.begin(), mismatchCounts.end(), 0) == 4, "concurrent column evaluations on a shared pool");
+}
+
+/// @brief Function for testing that idle workers sleep without polling, and that the tasks pushed while they sleep wake them.
+static void testIdleWorkers() {
+    // Idle pools must not use the processor: 64 workers polling every millisecond used about 28% of a core.
+    std::vector<std::unique_ptr<WorkStealingThreadPool>> pools;
+    for (int pool = 0; pool < 8; pool++) {
+        pools.push_back(std::make_unique<WorkStealingThreadPool>(8));
+        pools.back()->parallelFor(0, 64, 1, [](size_t, size_t) {});
+    }
+    std::clock_t start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    double idleMilliseconds = 1000.0 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    check(idleMilliseconds < 50, "64 idle workers used " + std::to_string(idleMilliseconds) + " ms of processor time in 500 ms");
+
+    // Sleeping workers take part in the next tasks, which block long enough for them to be stolen.
+    std::mutex threadIdMutex;
+    std::vector<std::thread::id> threadIds;
+    pools[0]->parallelFor(0, 64, 1, [&](size_t, size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> lock(threadIdMutex);
+        if (std::find(threadIds.begin(), threadIds.end(), std::this_thread::get_id()) == threadIds.end()) threadIds.push_back(std::this_thread::get_id());
+    });
+    check(threadIds.size() > 1, "sleeping workers woken by new tasks (" + std::to_string(threadIds.size()) + " thread(s) ran them)");
+
+    // Pools destroyed while their workers fall asleep must wake them all to stop.
+    for (int pool = 0; pool < 200; pool++) {
+        WorkStealingThreadPool shortLivedPool(4);
+        if (pool % 2 == 0) shortLivedPool.parallelFor(0, 8, 1, [](size_t, size_t) {});
+    }
+    check(true, "200 short-lived pools stopped");
+}
+
+int main() {
+    Calculator calculator;
+    testAssociativeChains(calculator);
+
+    // Write a CSV file of about 3 MiB, several chunks of the parallel readers, for the aggregates and the column mode.
+    const std::string path = "ParallelEvaluationTests.csv";
+    std::vector<double> values = writeCsvFile(path, 200000);
+    testColumnAggregates(calculator, path, values);
+    testCsvColumnMode(calculator, path, values);
+    std::remove(path.c_str());
+    testIdleWorkers();
+    return reportChecks("ParallelEvaluationTests");
+}
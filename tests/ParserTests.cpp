@@ -0,0 +1,65 @@
+// Tests of the Pratt parser (see PrattParser.hpp), through the programs compiled from its bytecode and the interpreter.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/ParserTests.cpp $(ls *.cpp | grep -v main.cpp) -o ParserTests
+// Usage:
+//     ./ParserTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <limits>
+
+/// @brief Function for evaluating a constant expression with the interpreter.
+static double interpret(Calculator& calculator, const std::string& expression) {
+    return calculator.evaluateAsync(expression).get().value;
+}
+
+/// @brief Function for testing literals out of the range of double, which must be rejected rather than read as 0.
+static void testOutOfRangeLiterals(Calculator& calculator) {
+    for (const char* literal : {"1e400", "1e-400", "2.5e99999999999", "1e-99999999999", "123456789e320"}) {
+        std::string expression = literal;
+        checkThrows([&]() { calculator.compileExpression(expression); }, "ParseError", "compiling " + expression);
+        checkThrows([&]() { interpret(calculator, expression); }, "ParseError", "interpreting " + expression);
+        checkThrows([&]() { calculator.evaluateExtendedPrecision(expression); }, "ParseError", "evaluating " + expression + " in double-double");
+        checkThrows([&]() { calculator.compileExpression("x + " + expression, {"x"}); }, "ParseError", "compiling x + " + expression);
+    }
+
+    // Literals at the edges of the range are kept, including subnormal ones.
+    checkClose(calculator.compileExpression("1.7976931348623157e308").evaluate({}), 1.7976931348623157e308, 0, "largest double");
+    checkClose(calculator.compileExpression("1e-310").evaluate({}), 1e-310, 0, "subnormal literal");
+    checkClose(calculator.compileExpression("0e99999999999").evaluate({}), 0, 0, "zero with a huge exponent");
+    checkClose(interpret(calculator, "1e308*10"), std::numeric_limits<double>::infinity(), 0, "overflowing product");
+}
+
+/// @brief Function for testing the precedence and associativity of the operators, compiled and interpreted alike.
+static void testPrecedence(Calculator& calculator) {
+    struct PrecedenceCase {
+        const char* expression;
+        double expectedValue;
+    };
+    const PrecedenceCase precedenceCases[] = {
+        {"2 + 3*4", 14}, {"(2 + 3)*4", 20}, {"10 - 4 - 3", 3}, {"64/4/2", 8}, {"7 % 4 * 2", 6}, {"2 + 3 * 4 ^ 2 / 8", 8},
+
+        // '^' is left-associative, and unary minus binds tighter than '^' and '!'.
+        {"2^3^2", 64}, {"-2^2", 4}, {"2*-3", -6}, {"2^-1", 0.5}, {"3!^2", 36}, {"-(2^2)", -4},
+
+        // Functions apply to their parenthesized argument only.
+        {"sqrt(16) + 1", 5}, {"log_2(8)*2", 6}, {"-sin(0) + cos(0)^2", 1},
+    };
+    for (const PrecedenceCase& precedenceCase : precedenceCases) {
+        std::string expression = precedenceCase.expression;
+        checkClose(interpret(calculator, expression), precedenceCase.expectedValue, 1e-15, "interpreted " + expression);
+        checkClose(calculator.compileExpression(expression).evaluate({}), precedenceCase.expectedValue, 1e-15, "compiled " + expression);
+        checkClose(calculator.compileExpression(expression + " + x", {"x"}).evaluate({0}), precedenceCase.expectedValue, 1e-15, "compiled " + expression + " + x");
+    }
+    checkThrows([&]() { interpret(calculator, "-3!"); }, "Math error: Negative input given to factorial", "unary minus applied before '!'");
+    checkThrows([&]() { interpret(calculator, "sqrt 16"); }, "MathError", "function without parentheses");
+}
+
+int main() {
+    Calculator calculator;
+    testOutOfRangeLiterals(calculator);
+    testPrecedence(calculator);
+    return reportChecks("ParserTests");
+}
@@ -0,0 +1,127 @@
+// Tests of the polynomial instructions of compiled programs (see ExpressionCompiler.hpp and VectorKernels.hpp): which sums of
+// monomials the compiler turns into one instruction, and the agreement of the two schemes evaluating it, Horner's for single
+// evaluations and Estrin's for blocks, within the rounding error bound of a polynomial.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/PolynomialEvaluationTests.cpp $(ls *.cpp | grep -v main.cpp) -o PolynomialEvaluationTests
+// Usage:
+//     ./PolynomialEvaluationTests
+
+#include "Calculator.hpp"
+#include "VectorKernels.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <random>
+#include <limits>
+
+/// @brief Function for evaluating a program of one variable on a block of elements.
+static std::vector<double> evaluateBlock(const CompiledExpression& program, const std::vector<double>& elements) {
+    const double* column = elements.data();
+    std::vector<double> registers(program.getRegisterCount() * elements.size()), results(elements.size());
+    program.evaluateBlock(&column, elements.size(), registers.data(), results.data());
+    return results;
+}
+
+/// @brief Function for building the expression of a polynomial, e.g. "-7 + 1*x^1 - 2*x^3 + 3*x^4" (zero terms omitted).
+static std::string makeExpression(const std::vector<double>& coefficients) {
+    std::string expression = std::to_string(static_cast<long long>(coefficients[0]));
+    for (size_t degree = 1; degree < coefficients.size(); degree++) {
+        if (coefficients[degree] == 0) continue;
+        expression += (coefficients[degree] < 0 ? " - " : " + ") + std::to_string(static_cast<long long>(std::fabs(coefficients[degree]))) + "*x^" + std::to_string(degree);
+    }
+    return expression;
+}
+
+/// @brief Function for testing which polynomials the compiler evaluates with a single instruction: a degree of at least 2
+/// with a power, up to maximumPolynomialDegree, and the coefficients shown in the listing.
+static void testSelection(Calculator& calculator) {
+    auto countPolynomials = [&](const std::string& expression) { return calculator.compileExpression(expression, {"x"}).getStatistics().recognizedPolynomials; };
+    check(countPolynomials("x + 1") == 0 && countPolynomials("2*x*3 - x") == 0, "degree 1 left to the operators");
+    check(countPolynomials("x*x + 1") == 0, "products of the variable without a power left to the operators");
+    check(countPolynomials("x^2") == 1 && countPolynomials("x^2 + 1") == 1, "degree 2 evaluated as a polynomial");
+    check(countPolynomials("x^" + std::to_string(maximumPolynomialDegree) + " + 1") == 1, "highest degree evaluated as a polynomial");
+    check(countPolynomials("x^" + std::to_string(maximumPolynomialDegree + 1) + " + 1") == 0, "degree above the highest left to the operators");
+    check(countPolynomials("x^20*x^20 + x") == 1, "only x^20 evaluated as a polynomial, the product above the highest degree left to the operators");
+    check(countPolynomials("sin(x)^3 - sin(x) + 1") == 1, "polynomial in a subexpression");
+    check(countPolynomials("x^2.5 + x^2") == 1, "only x^2 evaluated as a polynomial, the non-integer power left to the operators");
+
+    // The listing shows the coefficients, lowest degree first, with the missing powers as zeros.
+    CompiledExpression program = calculator.compileExpression("3*x^4 - 2*x^3 + x - 7", {"x"});
+    check(program.disassemble().find(" = poly r0 [-7, 1, 0, -2, 3]\n") != std::string::npos, "coefficients listed");
+
+    // Above the highest degree, the operators compute the same values as the polynomial instruction would.
+    std::string highDegree = "x^" + std::to_string(maximumPolynomialDegree + 1) + " - x^2";
+    CompiledExpression highDegreeProgram = calculator.compileExpression(highDegree, {"x"});
+    std::vector<double> elements = {-1.0, -0.5, 0.0, 0.75, 1.0, 1.01};
+    std::vector<double> results = evaluateBlock(highDegreeProgram, elements);
+    for (size_t index = 0; index < elements.size(); index++) {
+        double expected = std::pow(elements[index], static_cast<double>(maximumPolynomialDegree + 1)) - elements[index] * elements[index];
+        checkClose(highDegreeProgram.evaluate({elements[index]}), expected, 1e-15, highDegree + " at " + std::to_string(elements[index]));
+        checkClose(results[index], expected, 1e-15, highDegree + " on a block at " + std::to_string(elements[index]));
+    }
+}
+
+/// @brief Function for testing that Horner's scheme (single evaluations) and Estrin's scheme (blocks) agree on polynomials of
+/// every degree. Both errors are below gamma(2n)*sum(|c_i|*|x|^i), with gamma(k) = k*u/(1 - k*u) and u = 2^-53, since every
+/// term goes through at most 2n roundings; they are measured against a long double Horner evaluation.
+static void testSchemeAgreement(Calculator& calculator) {
+    std::mt19937 generator(40);
+    std::uniform_int_distribution<int> coefficientDistribution(-1000, 1000);
+    const double unitRoundoff = std::numeric_limits<double>::epsilon() / 2;
+
+    // Points spread over [-1.25, 1.25], plus the edges: 4k + 3 elements, so that the blocks of 4 end with a pair and a single element.
+    std::vector<double> elements;
+    for (int index = 0; index <= 1000; index++) elements.push_back(-1.25 + 2.5 * index / 1000 + (index % 7) * 1e-5);
+    elements.insert(elements.end(), {0.0, -0.0, 0.5, 1.0, -1.0, 1e-300});
+
+    size_t differingCount = 0;
+    for (size_t degree = 2; degree <= maximumPolynomialDegree; degree++) {
+        std::vector<double> coefficients(degree + 1);
+        for (double& coefficient : coefficients) coefficient = coefficientDistribution(generator);
+        if (coefficients[degree] == 0) coefficients[degree] = 1;
+        std::string expression = makeExpression(coefficients);
+        CompiledExpression program = calculator.compileExpression(expression, {"x"});
+        std::string description = "degree " + std::to_string(degree);
+        check(program.getStatistics().recognizedPolynomials == 1, description + " compiled to a polynomial instruction");
+
+        // Evaluate the elements one at a time (Horner's scheme) and as a block (Estrin's scheme).
+        std::vector<double> estrinResults = evaluateBlock(program, elements);
+        std::vector<double> kernelResults(elements.size());
+        evaluatePolynomialElementwise(coefficients.data(), coefficients.size(), elements.data(), kernelResults.data(), elements.size());
+        double gamma = 2 * degree * unitRoundoff / (1 - 2 * degree * unitRoundoff);
+        size_t hornerOverCount = 0, estrinOverCount = 0, disagreementCount = 0, hornerMismatchCount = 0, estrinMismatchCount = 0;
+        for (size_t index = 0; index < elements.size(); index++) {
+            double x = elements[index];
+            double horner = coefficients[degree], hornerResult = program.evaluate({x});
+            long double reference = coefficients[degree], absoluteSum = std::fabs(coefficients[degree]);
+            for (size_t power = degree; power > 0; power--) {
+                horner = horner * x + coefficients[power - 1];
+                reference = reference * x + coefficients[power - 1];
+                absoluteSum = absoluteSum * std::fabs(x) + std::fabs(coefficients[power - 1]);
+            }
+            double bound = static_cast<double>(gamma * absoluteSum);
+            hornerOverCount += std::fabs(static_cast<double>(hornerResult - reference)) > bound;
+            estrinOverCount += std::fabs(static_cast<double>(estrinResults[index] - reference)) > bound;
+            disagreementCount += std::fabs(hornerResult - estrinResults[index]) > 2 * bound;
+
+            // The single evaluations are Horner's scheme and the blocks Estrin's scheme, to the bit.
+            hornerMismatchCount += hornerResult != horner;
+            estrinMismatchCount += estrinResults[index] != kernelResults[index];
+            differingCount += hornerResult != estrinResults[index];
+        }
+        check(hornerOverCount == 0 && estrinOverCount == 0, description + " errors within the bound (" + std::to_string(hornerOverCount) + " Horner and " +
+            std::to_string(estrinOverCount) + " Estrin evaluation(s) over)");
+        check(disagreementCount == 0, description + " schemes agree within twice the bound");
+        check(hornerMismatchCount == 0 && estrinMismatchCount == 0, description + " single evaluations with Horner's scheme, blocks with Estrin's");
+    }
+
+    // The schemes round differently, so the checks above tell them apart.
+    check(differingCount > 0, "schemes round differently on " + std::to_string(differingCount) + " evaluation(s)");
+}
+
+int main() {
+    Calculator calculator;
+    testSelection(calculator);
+    testSchemeAgreement(calculator);
+    return reportChecks("PolynomialEvaluationTests");
+}
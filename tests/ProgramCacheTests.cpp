@@ -0,0 +1,153 @@
+// Tests of the caches of compiled programs (see ProgramCacheFile.hpp and SharedProgramCache.hpp): programs calling user functions
+// must never be served after a function they call has been redefined, and defining other functions or reassigning session
+// variables must not evict them. Caches of the same file may be saved at once.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/ProgramCacheTests.cpp $(ls *.cpp | grep -v main.cpp) -o ProgramCacheTests
+// Usage:
+//     ./ProgramCacheTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+/// @brief Function for testing the file cache across redefinitions of the user functions.
+static void testFileCacheStaleness(const std::string& path) {
+    std::remove(path.c_str());
+    {
+        ProgramCacheFile cache(path);
+        Calculator calculator;
+        calculator.setProgramCache(&cache);
+        calculator.defineFunction("def f(x) = x + 1");
+        calculator.defineFunction("def h(x) = f(x)*2");
+        checkClose(calculator.compileExpression("f(2)").evaluate({}), 3, 0, "f(2) before the redefinition");
+        checkClose(calculator.compileExpression("h(2)").evaluate({}), 6, 0, "h(2) before the redefinition");
+
+        // Redefining f changes the programs calling it, but not h, which keeps its snapshot of f.
+        calculator.defineFunction("def f(x) = x*10");
+        checkClose(calculator.compileExpression("f(2)").evaluate({}), 20, 0, "f(2) after the redefinition");
+        checkClose(calculator.compileExpression("h(2)").evaluate({}), 6, 0, "h(2) after the redefinition of f");
+        calculator.defineFunction("def h(x) = f(x) - 1");
+        checkClose(calculator.compileExpression("h(2)").evaluate({}), 19, 0, "h(2) after the redefinition of h");
+
+        // Defining a function keeps the programs which do not call it.
+        checkClose(calculator.compileExpression("x^2 + f(x)", {"x"}).evaluate({3}), 39, 0, "x^2 + f(x)");
+        size_t hitCount = cache.getStatistics().hits;
+        calculator.defineFunction("def g(y) = y - 4");
+        checkClose(calculator.compileExpression("x^2 + f(x)", {"x"}).evaluate({3}), 39, 0, "x^2 + f(x) after defining g");
+        check(cache.getStatistics().hits == hitCount + 1, "defining g keeps the program of x^2 + f(x)");
+
+        cache.save();
+    }
+
+    // A warm start reads the programs back, keyed by the same fingerprints.
+    ProgramCacheFile cache(path);
+    Calculator calculator;
+    calculator.setProgramCache(&cache);
+    calculator.defineFunction("def f(x) = x*10");
+    checkClose(calculator.compileExpression("f(2)").evaluate({}), 20, 0, "f(2) after a warm start");
+    check(cache.getStatistics().hits == 1, "f(2) read back after a warm start");
+    calculator.defineFunction("def f(x) = x + 1");
+    checkClose(calculator.compileExpression("f(2)").evaluate({}), 3, 0, "f(2) with the first definition after a warm start");
+    std::remove(path.c_str());
+}
+
+/// @brief Function for testing the shared cache across calculators defining different functions of the same name.
+static void testSharedCacheStaleness() {
+    SharedProgramCache cache;
+    Calculator first, second;
+    first.setSharedProgramCache(&cache);
+    second.setSharedProgramCache(&cache);
+    first.defineFunction("def f(x) = x + 1");
+    second.defineFunction("def f(x) = x - 1");
+    checkClose(first.compileSharedExpression("f(x)", {"x"})->evaluate({5}), 6, 0, "f(5) of the first calculator");
+    checkClose(second.compileSharedExpression("f(x)", {"x"})->evaluate({5}), 4, 0, "f(5) of the second calculator");
+
+    // Programs calling no user function are shared by both, and stay cached when functions are defined.
+    std::shared_ptr<const CompiledExpression> program = first.compileSharedExpression("sin(x)^2", {"x"});
+    second.defineFunction("def g(x) = 2*x");
+    check(second.compileSharedExpression("sin(x)^2", {"x"}) == program, "sin(x)^2 shared after defining g");
+    second.defineFunction("def f(x) = x + 1");
+    check(second.compileSharedExpression("f(x)", {"x"}) == first.compileSharedExpression("f(x)", {"x"}), "f(x) shared by equal definitions");
+}
+
+/// @brief Function for testing that session variables cannot go stale in cached programs: programs and user functions never read
+/// them, so reassigning one keeps every cached program valid.
+static void testSessionVariables(const std::string& path) {
+    std::remove(path.c_str());
+    ProgramCacheFile cache(path);
+    Calculator calculator;
+    calculator.setProgramCache(&cache);
+    calculator.assignVariable("let v = 3");
+    checkThrows([&]() { calculator.compileExpression("v + 1"); }, "MathError: Unrecognized token v", "session variable not compiled");
+    checkThrows([&]() { calculator.defineFunction("def f(x) = x + v"); }, "MathError: Unrecognized token v", "session variable not read by a function");
+
+    // Variables of the same name are given their value at evaluation time.
+    checkClose(calculator.compileExpression("v + 1", {"v"}).evaluate({5}), 6, 0, "v + 1 as a program of v");
+    calculator.assignVariable("let v = 5");
+    size_t hitCount = cache.getStatistics().hits;
+    checkClose(calculator.compileExpression("v + 1", {"v"}).evaluate({2}), 3, 0, "v + 1 after reassigning v");
+    check(cache.getStatistics().hits == hitCount + 1, "reassigning v keeps the program of v + 1");
+    std::remove(path.c_str());
+}
+
+/// @brief Function for testing caches of the same file saved at once: every save must replace the file with a complete one, and
+/// no temporary file may be left behind.
+static void testConcurrentSaves(const std::string& path) {
+    const size_t writerCount = 4, expressionCount = 50, saveCount = 20;
+    std::remove(path.c_str());
+    std::atomic<size_t> failureCount = 0;
+    std::vector<std::thread> writers;
+    for (size_t writer = 0; writer < writerCount; writer++) {
+        writers.emplace_back([&, writer]() {
+            ProgramCacheFile cache(path);
+            Calculator calculator;
+            calculator.setProgramCache(&cache);
+            for (size_t save = 0; save < saveCount; save++) {
+                for (size_t expression = 0; expression < expressionCount; expression++) {
+                    calculator.compileExpression("x*" + std::to_string(writer) + " + " + std::to_string(expression), {"x"});
+                }
+                try {
+                    cache.save();
+                } catch (const std::invalid_argument&) {
+                    failureCount++;
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers) writer.join();
+    check(failureCount == 0, std::to_string(failureCount) + " of " + std::to_string(writerCount * saveCount) + " concurrent saves failed");
+
+    // The file holds the complete set of entries of the last writer, and no temporary file is left next to it.
+    ProgramCacheFile cache(path);
+    Calculator calculator;
+    calculator.setProgramCache(&cache);
+    size_t mismatchCount = 0;
+    for (size_t writer = 0; writer < writerCount; writer++) {
+        for (size_t expression = 0; expression < expressionCount; expression++) {
+            double value = calculator.compileExpression("x*" + std::to_string(writer) + " + " + std::to_string(expression), {"x"}).evaluate({2});
+            if (value != static_cast<double>(2 * writer + expression)) mismatchCount++;
+        }
+    }
+    check(cache.getStatistics().loadedEntries >= expressionCount, "file saved at once holds " + std::to_string(cache.getStatistics().loadedEntries) + " entries");
+    check(cache.getStatistics().staleEntries == 0 && mismatchCount == 0, "no corrupted entry in a file saved at once");
+    size_t temporaryFileCount = 0;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(".")) {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, path.size(), path) == 0 && name.size() > path.size()) temporaryFileCount++;
+    }
+    check(temporaryFileCount == 0, std::to_string(temporaryFileCount) + " temporary file(s) left");
+    std::remove(path.c_str());
+}
+
+int main() {
+    testFileCacheStaleness("ProgramCacheTests.cache");
+    testSharedCacheStaleness();
+    testSessionVariables("ProgramCacheTests.cache");
+    testConcurrentSaves("ProgramCacheTests.cache");
+    return reportChecks("ProgramCacheTests");
+}
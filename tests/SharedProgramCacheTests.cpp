@@ -0,0 +1,121 @@
+// Tests of the cache of compiled programs shared by threads (see SharedProgramCache.hpp) under contention: a key missed by many
+// threads at once is compiled once, and keys added concurrently are all kept.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/SharedProgramCacheTests.cpp $(ls *.cpp | grep -v main.cpp) -o SharedProgramCacheTests
+// Usage:
+//     ./SharedProgramCacheTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <thread>
+
+/// @brief Number of threads of the tests.
+static const size_t threadCount = 8;
+
+/// @brief Function for building the key of an expression of x.
+static ProgramCacheKey makeKey(const std::string& expression) {
+    ProgramCacheKey key;
+    key.source = expression;
+    key.variableNames = {"x"};
+    return key;
+}
+
+/// @brief Function for testing that threads missing the same key at once compile it once and share its program, and that a failed
+/// compilation is reported to every waiting thread without being cached.
+static void testSameKeyCompiledOnce() {
+    SharedProgramCache cache;
+    ProgramCacheKey key = makeKey("x^2 + 1");
+    std::atomic<size_t> compilationCount = 0;
+    std::vector<std::shared_ptr<const CompiledExpression>> programs(threadCount);
+    std::latch start(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < threadCount; index++) {
+        threads.emplace_back([&, index]() {
+            Calculator calculator;
+            start.arrive_and_wait();
+            programs[index] = cache.findOrCompile(key, [&]() {
+                compilationCount++;
+
+                // Keep the compilation in flight long enough for every thread to miss the key.
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                return calculator.compileExpression(key.source, key.variableNames);
+            });
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    check(compilationCount == 1, "same key compiled once by " + std::to_string(threadCount) + " threads (compiled " + std::to_string(compilationCount) + " times)");
+    bool isShared = true;
+    for (const std::shared_ptr<const CompiledExpression>& program : programs) isShared = isShared && program != nullptr && program.get() == programs[0].get();
+    check(isShared, "every thread got the same program");
+    checkClose(programs[0]->evaluate({3}), 10, 0, "program of x^2 + 1");
+    check(cache.getStatistics().entries == 1, "one entry for the key");
+
+    // Every thread waiting for a failed compilation rethrows its error, and the next lookup compiles the key again.
+    ProgramCacheKey failingKey = makeKey("x +");
+    std::atomic<size_t> failureCount = 0;
+    compilationCount = 0;
+    std::latch failingStart(threadCount);
+    threads.clear();
+    for (size_t index = 0; index < threadCount; index++) {
+        threads.emplace_back([&]() {
+            Calculator calculator;
+            failingStart.arrive_and_wait();
+            try {
+                cache.findOrCompile(failingKey, [&]() {
+                    compilationCount++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    return calculator.compileExpression(failingKey.source, failingKey.variableNames);
+                });
+            } catch (const std::invalid_argument&) {
+                failureCount++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    check(compilationCount == 1, "failing key compiled once (compiled " + std::to_string(compilationCount) + " times)");
+    check(failureCount == threadCount, "every thread got the compilation error");
+    check(cache.find(failingKey) == nullptr, "failed compilation not cached");
+    Calculator calculator;
+    checkThrows([&]() { cache.findOrCompile(failingKey, [&]() { return calculator.compileExpression(failingKey.source, failingKey.variableNames); }); }, "EvalError", "failing key compiled again");
+}
+
+/// @brief Function for testing that distinct keys added by concurrent threads, into the same shards, are all kept.
+static void testNoLostInserts() {
+    const size_t keysPerThread = 200;
+    SharedProgramCache cache(SharedProgramCache::defaultCapacityBytes, 4);
+    std::latch start(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < threadCount; index++) {
+        threads.emplace_back([&, index]() {
+            Calculator calculator;
+            start.arrive_and_wait();
+            for (size_t keyIndex = 0; keyIndex < keysPerThread; keyIndex++) {
+                ProgramCacheKey key = makeKey("x + " + std::to_string(index * keysPerThread + keyIndex));
+                if (keyIndex % 2 == 0) cache.insert(key, calculator.compileExpression(key.source, key.variableNames));
+                else cache.findOrCompile(key, [&]() { return calculator.compileExpression(key.source, key.variableNames); });
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    SharedProgramCacheStatistics statistics = cache.getStatistics();
+    check(statistics.entries == threadCount * keysPerThread, "every key added (" + std::to_string(statistics.entries) + " entries)");
+    check(statistics.evictions == 0, "no key evicted");
+    size_t foundCount = 0;
+    for (size_t keyIndex = 0; keyIndex < threadCount * keysPerThread; keyIndex++) {
+        std::shared_ptr<const CompiledExpression> program = cache.find(makeKey("x + " + std::to_string(keyIndex)));
+        if (program != nullptr && program->evaluate({0.5}) == keyIndex + 0.5) foundCount++;
+    }
+    check(foundCount == threadCount * keysPerThread, "every key found with its program (" + std::to_string(foundCount) + " found)");
+}
+
+int main() {
+    testSameKeyCompiledOnce();
+    testNoLostInserts();
+    return reportChecks("SharedProgramCacheTests");
+}
@@ -0,0 +1,160 @@
+// Tests of the spreadsheet of named cells (see Spreadsheet.hpp): recomputation of the cells downstream of an edit, level by
+// level, cycle detection, forward references, errors propagated to dependents, and removal of referenced cells.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/SpreadsheetTests.cpp $(ls *.cpp | grep -v main.cpp) -o SpreadsheetTests
+// Usage:
+//     ./SpreadsheetTests
+
+#include "Calculator.hpp"
+#include "Spreadsheet.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <sstream>
+
+/// @brief Function for defining a cell of a spreadsheet, compiling its formula over the referenced cells.
+/// @returns Number of cells recomputed.
+static size_t define(Spreadsheet& spreadsheet, Calculator& calculator, const std::string& name, const std::string& formula, const std::vector<std::string>& referencedNames = {}) {
+    return spreadsheet.setCell(name, formula, calculator.compileExpression(formula, referencedNames));
+}
+
+/// @brief Function for reading the error held by a cell (empty if its value is valid).
+static std::string getError(const Spreadsheet& spreadsheet, const std::string& name) {
+    try {
+        spreadsheet.getValue(name);
+    } catch (const std::invalid_argument& error) {
+        return error.what();
+    }
+    return "";
+}
+
+/// @brief Function for testing that an edit recomputes exactly the cells downstream of it, after all of their dependencies.
+static void testRecomputation(Calculator& calculator) {
+    // Diamond: b and c depend on a, d on both, e on d and b, so e must wait for the level of d.
+    Spreadsheet spreadsheet;
+    check(define(spreadsheet, calculator, "a", "3") == 1, "first cell recomputed alone");
+    check(define(spreadsheet, calculator, "b", "a + 1", {"a"}) == 1, "cell b");
+    check(define(spreadsheet, calculator, "c", "a*2", {"a"}) == 1, "cell c");
+    check(define(spreadsheet, calculator, "d", "b + c", {"b", "c"}) == 1, "cell d");
+    check(define(spreadsheet, calculator, "e", "d*b", {"d", "b"}) == 1, "cell e");
+    check(define(spreadsheet, calculator, "f", "7") == 1, "unrelated cell f");
+    check(spreadsheet.getValue("e") == 40, "e = (4 + 6)*4");
+
+    // Editing a recomputes the five cells of the diamond, editing c only c, d and e, and editing f only f.
+    check(define(spreadsheet, calculator, "a", "5") == 5, "editing a recomputes a, b, c, d and e");
+    check(spreadsheet.getValue("d") == 16 && spreadsheet.getValue("e") == 96, "diamond recomputed in order (e = (6 + 10)*6)");
+    check(define(spreadsheet, calculator, "c", "a - 5", {"a"}) == 3, "editing c recomputes c, d and e");
+    check(spreadsheet.getValue("e") == 36, "e = (6 + 0)*6");
+    check(define(spreadsheet, calculator, "f", "8") == 1, "editing an unrelated cell recomputes it alone");
+
+    // Redefining a cell moves its edges: once b depends on f instead of a, editing a skips b, and editing f reaches d and e.
+    check(define(spreadsheet, calculator, "b", "f", {"f"}) == 3, "redefining b recomputes b, d and e");
+    check(define(spreadsheet, calculator, "a", "1") == 4, "editing a recomputes a, c, d and e once b has left");
+    check(define(spreadsheet, calculator, "f", "2") == 4, "editing f recomputes f, b, d and e");
+    check(spreadsheet.getValue("e") == (2 + (1 - 5)) * 2, "values after moving the edges");
+
+    // A long chain is recomputed level by level, and a wide level (larger than a task) across the pool.
+    WorkStealingThreadPool pool(4);
+    Spreadsheet largeSpreadsheet(&pool);
+    define(largeSpreadsheet, calculator, "x", "1");
+    std::string previousName = "x";
+    for (int index = 0; index < 300; index++) {
+        std::string name = "chain" + std::string(1, static_cast<char>('a' + index % 26)) + std::string(1, static_cast<char>('a' + index / 26));
+        define(largeSpreadsheet, calculator, name, previousName + " + 1", {previousName});
+        previousName = name;
+    }
+    std::vector<std::string> wideNames;
+    std::string sumFormula;
+    for (int index = 0; index < 500; index++) {
+        std::string name = "wide" + std::string(1, static_cast<char>('a' + index % 26)) + std::string(1, static_cast<char>('a' + index / 26));
+        define(largeSpreadsheet, calculator, name, "x*" + std::to_string(index), {"x"});
+        wideNames.push_back(name);
+        sumFormula += (index == 0 ? "" : " + ") + name;
+    }
+    define(largeSpreadsheet, calculator, "total", sumFormula, wideNames);
+    check(largeSpreadsheet.getValue(previousName) == 301 && largeSpreadsheet.getValue("total") == 124750, "chain of 300 cells and sum of 500 cells");
+    check(define(largeSpreadsheet, calculator, "x", "2") == 1 + 300 + 500 + 1, "editing x recomputes the chain, the wide level and the total");
+    check(largeSpreadsheet.getValue(previousName) == 302 && largeSpreadsheet.getValue("total") == 249500, "chain and wide level recomputed");
+}
+
+/// @brief Function for testing that definitions closing a cycle are rejected, keeping the previous definition.
+static void testCycleDetection(Calculator& calculator) {
+    Spreadsheet spreadsheet;
+    define(spreadsheet, calculator, "a", "1");
+    define(spreadsheet, calculator, "b", "a + 1", {"a"});
+    define(spreadsheet, calculator, "c", "b*10", {"b"});
+    check(getError(spreadsheet, "c").empty() && spreadsheet.getValue("c") == 20, "chain a -> b -> c");
+
+    // Direct self references and longer cycles are both rejected.
+    checkThrows([&]() { define(spreadsheet, calculator, "a", "a + 1", {"a"}); }, "EvalError: Cell a references itself", "self reference");
+    checkThrows([&]() { define(spreadsheet, calculator, "a", "c - 1", {"c"}); }, "EvalError: Cell a would reference itself through c (circular reference)", "cycle through b and c");
+    checkThrows([&]() { define(spreadsheet, calculator, "b", "c", {"c"}); }, "EvalError: Cell b would reference itself through c", "cycle of two cells");
+
+    // The rejected definitions changed nothing: editing a still recomputes a, b and c.
+    check(spreadsheet.getValue("a") == 1 && spreadsheet.getValue("c") == 20, "values kept after the rejected definitions");
+    check(define(spreadsheet, calculator, "a", "2") == 3 && spreadsheet.getValue("c") == 30, "edges kept after the rejected definitions");
+
+    // Cycles through cells which are not defined yet are rejected as well.
+    define(spreadsheet, calculator, "p", "q + 1", {"q"});
+    checkThrows([&]() { define(spreadsheet, calculator, "q", "p*2", {"p"}); }, "EvalError: Cell q would reference itself through p", "cycle through a forward reference");
+    check(!spreadsheet.hasCell("q"), "rejected cell left undefined");
+
+    // The same rejections reach the calculator.
+    Calculator sessionCalculator;
+    sessionCalculator.assignCell("m = 1");
+    sessionCalculator.assignCell("n = m + 1");
+    checkThrows([&]() { sessionCalculator.assignCell("m = n*2"); }, "EvalError: Cell m would reference itself through n", "cycle assigned to the calculator");
+}
+
+/// @brief Function for testing forward references, errors propagated downstream, and removing referenced cells.
+static void testErrorsAndRemoval(Calculator& calculator) {
+    Spreadsheet spreadsheet;
+
+    // Cells referencing undefined cells hold an error until they are defined.
+    check(define(spreadsheet, calculator, "b", "z*2", {"z"}) == 1, "forward reference");
+    check(getError(spreadsheet, "b") == "EvalError: Cell b references z, which is not defined.\n", "forward reference error");
+    check(!spreadsheet.hasCell("z"), "referenced cell not defined");
+    check(define(spreadsheet, calculator, "z", "4") == 2 && spreadsheet.getValue("b") == 8, "defining z recomputes b");
+
+    // Errors raised by a formula propagate to every cell downstream, and clear when the formula is fixed.
+    define(spreadsheet, calculator, "c", "b + 1", {"b"});
+    check(define(spreadsheet, calculator, "z", "sqrt(-1)") == 3, "failing formula recomputes its dependents");
+    check(getError(spreadsheet, "z").compare(0, 11, "DomainError") == 0, "failing formula holds its error");
+    check(getError(spreadsheet, "b") == "EvalError: Cell b references z, which holds an error.\n", "error propagated to b");
+    check(getError(spreadsheet, "c") == "EvalError: Cell c references b, which holds an error.\n", "error propagated to c");
+    define(spreadsheet, calculator, "z", "1");
+    check(spreadsheet.getValue("c") == 3, "errors cleared by fixing the formula");
+
+    // Removing a referenced cell recomputes its dependents, which then report it as not defined.
+    check(spreadsheet.removeCell("z") == 3, "removing z recomputes z, b and c");
+    check(!spreadsheet.hasCell("z") && spreadsheet.hasCell("b"), "z removed, b kept");
+    check(getError(spreadsheet, "z") == "EvalError: Cell z is not defined.\n", "removed cell error");
+    check(getError(spreadsheet, "b") == "EvalError: Cell b references z, which is not defined.\n", "dependent of the removed cell");
+    check(getError(spreadsheet, "c") == "EvalError: Cell c references b, which holds an error.\n", "cell downstream of the removed cell");
+    check(spreadsheet.removeCell("z") == 0 && spreadsheet.removeCell("never") == 0, "removing cells which are not defined");
+
+    // Listings only show the defined cells, by name, with their values or errors.
+    std::vector<std::string> names;
+    std::vector<double> values;
+    spreadsheet.getValidCells(names, values);
+    check(names.empty(), "no valid cell while z is removed");
+    std::ostringstream listing;
+    spreadsheet.print(listing);
+    check(listing.str() == "b = z*2 -> EvalError: Cell b references z, which is not defined.\nc = b + 1 -> EvalError: Cell c references b, which holds an error.\n", "listing after the removal");
+
+    // Defining the cell again restores its dependents; a removed cell may also be redefined without its old dependencies.
+    check(define(spreadsheet, calculator, "z", "10") == 3 && spreadsheet.getValue("c") == 21, "z defined again");
+    define(spreadsheet, calculator, "y", "z", {"z"});
+    spreadsheet.removeCell("y");
+    check(define(spreadsheet, calculator, "z", "11") == 3, "removed y no longer depends on z");
+    spreadsheet.getValidCells(names, values);
+    check(names.size() == 3, "three valid cells (" + std::to_string(names.size()) + ")");
+}
+
+int main() {
+    Calculator calculator;
+    testRecomputation(calculator);
+    testCycleDetection(calculator);
+    testErrorsAndRemoval(calculator);
+    return reportChecks("SpreadsheetTests");
+}
@@ -0,0 +1,49 @@
+// Tests of the evaluator of expressions streamed in chunks (see StreamingEvaluator.hpp).
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/StreamingEvaluatorTests.cpp $(ls *.cpp | grep -v main.cpp) -o StreamingEvaluatorTests
+// Usage:
+//     ./StreamingEvaluatorTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <limits>
+#include <sstream>
+
+/// @brief Function for evaluating an expression held in a string as a stream.
+static StreamingValue evaluateString(Calculator& calculator, const std::string& expression) {
+    std::istringstream input(expression);
+    return calculator.evaluateStream(input);
+}
+
+/// @brief Function for testing literals out of the range of double, alone and cut by the end of a chunk.
+static void testOutOfRangeLiterals(Calculator& calculator) {
+    for (const char* literal : {"1e400", "1e-400", "2.5e99999999999", "123456789e320"}) {
+        std::string expression = literal;
+        checkThrows([&]() { evaluateString(calculator, expression); }, "ParseError", "streaming " + expression);
+
+        // Place the literal across the boundary of the first two chunks.
+        std::string longExpression;
+        while (longExpression.size() + 3 < StreamingEvaluator::chunkSize) longExpression += "1+";
+        longExpression += expression;
+        checkThrows([&]() { evaluateString(calculator, longExpression); }, "ParseError", "streaming " + expression + " across chunks");
+    }
+    checkClose(evaluateString(calculator, "1e-310").value, 1e-310, 0, "subnormal literal");
+    checkClose(evaluateString(calculator, "0.5e308*4").value, std::numeric_limits<double>::infinity(), 0, "overflowing product");
+}
+
+/// @brief Function for testing the values of a few streamed expressions, with exact integers.
+static void testValues(Calculator& calculator) {
+    StreamingValue value = evaluateString(calculator, "9007199254740993 - 1");
+    check(value.isInteger && value.integer == 9007199254740992, "integer kept exactly");
+    checkClose(evaluateString(calculator, "2^3^2 - 10/4").value, 61.5, 0, "left-associative power");
+    checkClose(evaluateString(calculator, "-(1.5e3 + .5)*2").value, -3001, 0, "decimal literals");
+}
+
+int main() {
+    Calculator calculator;
+    testOutOfRangeLiterals(calculator);
+    testValues(calculator);
+    return reportChecks("StreamingEvaluatorTests");
+}
@@ -0,0 +1,121 @@
+// Tests of the table command (see Calculator::tabulateExpression() and TableGenerator.hpp): parsing of the command and of its
+// range, the points of the grid, the values written outside the domain, and the order of the lines across blocks and threads.
+//
+// Build from the repository root:
+//     g++ -std=c++20 -O2 -pthread -I. tests/TableGeneratorTests.cpp $(ls *.cpp | grep -v main.cpp) -o TableGeneratorTests
+// Usage:
+//     ./TableGeneratorTests
+
+#include "Calculator.hpp"
+#include "tests/TestHarness.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+
+/// @brief Function for running a table command, returning its output.
+/// @param lineCount Reference receiving the number of lines reported.
+static std::string tabulate(Calculator& calculator, const std::string& command, uint64_t& lineCount, unsigned threadCount = 2) {
+    std::ostringstream output;
+    lineCount = calculator.tabulateExpression(command, output, threadCount);
+    return output.str();
+}
+
+/// @brief Function for counting the lines of an output.
+static size_t countLines(const std::string& output) {
+    return static_cast<size_t>(std::count(output.begin(), output.end(), '\n'));
+}
+
+/// @brief Function for testing the syntax of the command: the optional keyword, expressions holding spaces, and the range.
+static void testCommandParsing(Calculator& calculator) {
+    uint64_t lineCount;
+    std::string expected = "0,0\n0.25,0.0625\n0.5,0.25\n0.75,0.5625\n1,1\n";
+    check(tabulate(calculator, "table x^2 x=0..1 step 0.25", lineCount) == expected && lineCount == 5, "table x^2 x=0..1 step 0.25");
+    check(tabulate(calculator, "x^2 x=0..1 step 0.25", lineCount) == expected, "table command without its keyword");
+    check(tabulate(calculator, "table  x * x   x=0..1  step 0.25 ", lineCount) == expected, "expression holding spaces");
+    check(tabulate(calculator, "table 2*t + 1 t=-1..1 step 1", lineCount) == "-1,-1\n0,1\n1,3\n", "other variable name and negative start");
+    check(tabulate(calculator, "table x x=1e-3..3e-3 step 1e-3", lineCount) == "0.001,0.001\n0.002,0.002\n0.003,0.003\n", "exponents in the range");
+
+    // Malformed commands are parse errors.
+    for (const char* command : {"", "table", "table x^2", "table x^2 x=0..1", "table x^2 x=0..1 step", "table x=0..1 step 0.1",
+                                "table x^2 x0..1 step 0.1", "table x^2 x=0.1 step 0.1", "table x^2 x=1..0=2 step 0.1", "table x^2 x=a..1 step 0.1",
+                                "table x^2 x=0..1.5.5 step 0.1", "table x^2 x=0..1 step 0.1abc", "table x^2 x=0..1 by 0.1"}) {
+        checkThrows([&]() { tabulate(calculator, command, lineCount); }, "ParseError", std::string("command \"") + command + "\"");
+    }
+
+    // Expressions of other variables cannot be compiled.
+    checkThrows([&]() { tabulate(calculator, "table x*y x=0..1 step 0.5", lineCount); }, "MathError", "expression of an undeclared variable");
+}
+
+/// @brief Function for testing the points of the grid: the end point, rounding of the step, descending grids, and invalid ranges.
+static void testGridPoints(Calculator& calculator) {
+    uint64_t lineCount;
+
+    // Points are computed as start + index*step, and the stop is included despite the rounding of the step.
+    std::string output = tabulate(calculator, "table x x=0..1 step 0.1", lineCount);
+    check(lineCount == 11 && countLines(output) == 11, "11 points from 0 to 1 by 0.1 (" + std::to_string(lineCount) + ")");
+    check(output.compare(output.size() - 4, 4, "1,1\n") == 0, "stop 1 included");
+    check(output.find("0.30000000000000004,0.30000000000000004\n") != std::string::npos, "third point computed as 3*0.1");
+    check(tabulate(calculator, "table x x=0..0.95 step 0.1", lineCount).rfind("0.9,0.9\n") != std::string::npos && lineCount == 10, "stop off the grid excluded");
+    check(tabulate(calculator, "table x x=0..3 step 1e-5", lineCount).size() > 0 && lineCount == 300001, "300001 points from 0 to 3 by 1e-5");
+
+    // Descending grids take a negative step, and a single point needs any step.
+    check(tabulate(calculator, "table x x=1..0 step -0.5", lineCount) == "1,1\n0.5,0.5\n0,0\n", "descending grid");
+    check(tabulate(calculator, "table x x=2..2 step 7", lineCount) == "2,2\n" && lineCount == 1, "single point");
+
+    // Steps of zero, pointing away from the stop, or ranges not finite are range errors.
+    for (const char* command : {"table x x=0..1 step 0", "table x x=0..1 step -0.1", "table x x=1..0 step 0.1", "table x x=0..inf step 1",
+                                "table x x=-inf..0 step 1", "table x x=0..1 step nan", "table x x=0..1 step inf"}) {
+        checkThrows([&]() { tabulate(calculator, command, lineCount); }, "RangeError", std::string("command \"") + command + "\"");
+    }
+}
+
+/// @brief Function for testing the values written outside the domain of the operators, never "-nan".
+static void testValuesOutsideDomain(Calculator& calculator) {
+    uint64_t lineCount;
+    check(tabulate(calculator, "table sqrt(x) x=-1..1 step 1", lineCount) == "-1,nan\n0,0\n1,1\n", "sqrt of a negative number written as nan");
+    check(tabulate(calculator, "table (x - x)/(x - x) x=0..1 step 1", lineCount) == "0,nan\n1,nan\n", "0/0 written as nan");
+    check(tabulate(calculator, "table ln(x) x=-1..1 step 1", lineCount) == "-1,nan\n0,-inf\n1,0\n", "logarithm of negative numbers and of 0");
+    check(tabulate(calculator, "table 1/x x=-1..1 step 1", lineCount) == "-1,-1\n0,inf\n1,1\n", "division by 0 written as inf");
+    check(tabulate(calculator, "table acos(x) x=-3..3 step 1", lineCount).find("-nan") == std::string::npos, "acos never written as -nan");
+}
+
+/// @brief Function for testing that the lines are written in order across block and round boundaries, whatever the number of
+/// threads, against a table computed point by point.
+static void testBlockBoundaries(Calculator& calculator) {
+    // 16384 points per block: cover whole blocks, a partial last block, and fewer blocks than threads.
+    for (uint64_t pointCount : {1ull, 16383ull, 16384ull, 16385ull, 5 * 16384ull + 7}) {
+        double start = -3, step = 0.001;
+        CompiledExpression program = calculator.compileExpression("x^3 - 2*x", {"x"}, EvaluationMode::unchecked);
+        std::string expected;
+        char line[64];
+        for (uint64_t point = 0; point < pointCount; point++) {
+            double x = start + static_cast<double>(point) * step;
+            char* position = std::to_chars(line, line + sizeof(line), x).ptr;
+            *position++ = ',';
+            position = std::to_chars(position, line + sizeof(line), program.evaluate({x})).ptr;
+            *position++ = '\n';
+            expected.append(line, position);
+        }
+
+        // The stop is the last point itself, computed the same way.
+        std::string stopString(line, std::to_chars(line, line + sizeof(line), start + static_cast<double>(pointCount - 1) * step).ptr);
+        std::string command = "table x^3 - 2*x x=-3.." + stopString + " step 0.001";
+        for (unsigned threadCount : {1u, 2u, 3u, 8u}) {
+            uint64_t lineCount;
+            std::string output = tabulate(calculator, command, lineCount, threadCount);
+            std::string description = std::to_string(pointCount) + " point(s) on " + std::to_string(threadCount) + " thread(s)";
+            check(lineCount == pointCount, description + " counted (" + std::to_string(lineCount) + ")");
+            check(output == expected, description + " in order");
+        }
+    }
+}
+
+int main() {
+    Calculator calculator;
+    testCommandParsing(calculator);
+    testGridPoints(calculator);
+    testValuesOutsideDomain(calculator);
+    testBlockBoundaries(calculator);
+    return reportChecks("TableGeneratorTests");
+}
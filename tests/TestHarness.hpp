@@ -0,0 +1,59 @@
+#ifndef __TEST_HARNESS
+#define __TEST_HARNESS
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <stdexcept>
+
+/// @brief Number of checks made by the test program, and number of them which have failed.
+inline int checkCount = 0, failureCount = 0;
+
+/// @brief Function for recording a check, printing its description if it has failed.
+/// @param condition Whether the check has passed.
+/// @param description Description of the check.
+inline void check(bool condition, const std::string& description) {
+    checkCount++;
+    if (condition) return;
+    failureCount++;
+    std::printf("FAILED: %s\n", description.c_str());
+}
+
+/// @brief Function for checking that a value is within a tolerance of the expected one, relative to the larger magnitude of both
+/// (absolute below 1). nan only matches nan, and infinities only match themselves.
+/// @param actual Value computed.
+/// @param expected Value expected.
+/// @param tolerance Largest relative error.
+/// @param description Description of the check.
+inline void checkClose(double actual, double expected, double tolerance, const std::string& description) {
+    bool isClose = (std::isnan(expected) || std::isinf(expected)) ? (std::isnan(expected) ? std::isnan(actual) : actual == expected) :
+        std::abs(actual - expected) <= tolerance * std::max({1.0, std::abs(actual), std::abs(expected)});
+    check(isClose, description + " (expected " + std::to_string(expected) + ", got " + std::to_string(actual) + ")");
+}
+
+/// @brief Function for checking that a call throws an invalid_argument error whose message starts with the given prefix.
+/// @param function Call expected to throw.
+/// @param messagePrefix Expected start of the message, e.g. "ParseError".
+/// @param description Description of the check.
+template <typename Function>
+void checkThrows(Function function, const std::string& messagePrefix, const std::string& description) {
+    try {
+        function();
+    } catch (const std::invalid_argument& error) {
+        std::string message = error.what();
+        check(message.compare(0, messagePrefix.size(), messagePrefix) == 0, description + " (threw \"" + message.substr(0, message.find('\n')) + "\")");
+        return;
+    }
+    check(false, description + " (did not throw)");
+}
+
+/// @brief Function for printing the number of checks passed.
+/// @param suiteName Name of the test program.
+/// @returns Exit status of the test program: 0 if every check has passed, 1 otherwise.
+inline int reportChecks(const char* suiteName) {
+    std::printf("%s: %d of %d checks passed\n", suiteName, checkCount - failureCount, checkCount);
+    return (failureCount == 0) ? 0 : 1;
+}
+
+#endif